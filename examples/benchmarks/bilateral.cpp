@@ -0,0 +1,79 @@
+/*******************************************************
+ * Copyright (c) 2015, ArrayFire
+ * All rights reserved.
+ *
+ * This file is distributed under 3-clause BSD license.
+ * The complete license agreement can be obtained at:
+ * http://arrayfire.com/licenses/BSD-3-Clause
+ ********************************************************/
+
+#include <arrayfire.h>
+#include <stdio.h>
+#include <math.h>
+#include <cstdlib>
+
+using namespace af;
+
+// create a small wrapper to benchmark
+static array A;      // input image
+static float S;      // spatial sigma
+static const float C = 30.f;
+static void fn_exact()
+{
+    array B = bilateral(A, S, C);
+    B.eval();
+}
+
+static void fn_approx()
+{
+    array B = bilateralApprox(A, S, C);
+    B.eval();
+}
+
+int main(int argc, char ** argv)
+{
+    try {
+        int device = argc > 1 ? atoi(argv[1]) : 0;
+        setDevice(device);
+        info();
+
+        // Smooth gradient with a step edge and noise
+        const int W = 640, H = 480;
+        array x = range(dim4(W, H), 0);
+        array y = range(dim4(W, H), 1);
+        A = 50 + 100 * (x > W / 2).as(f32) + 0.1f * y + 10 * randn(W, H);
+
+        printf("Benchmark %d-by-%d bilateral filter, chromatic sigma %g\n", W, H, C);
+        const float sigmas[] = {2, 5, 11, 32, 64};
+        for (int i = 0; i < 5; i++) {
+            S = sigmas[i];
+            double approx_time = timeit(fn_approx); // time in seconds
+            array approx = bilateralApprox(A, S, C);
+
+            // The exact filter clamps the spatial sigma to 11.5
+            if (S <= 11.5f) {
+                double exact_time = timeit(fn_exact);
+                array exact = bilateral(A, S, C);
+                float err = mean<float>(abs(exact - approx));
+                printf("sigma %4.1f: exact %9.3f ms, approx %9.3f ms, mean abs error %6.3f\n",
+                       S, exact_time * 1e3, approx_time * 1e3, err);
+            } else {
+                printf("sigma %4.1f: exact         -   , approx %9.3f ms\n",
+                       S, approx_time * 1e3);
+            }
+            fflush(stdout);
+        }
+    } catch (af::exception& e) {
+        fprintf(stderr, "%s\n", e.what());
+        throw;
+    }
+
+    #ifdef WIN32 // pause in Windows
+    if (!(argc == 2 && argv[1][0] == '-')) {
+        printf("hit [enter]...");
+        fflush(stdout);
+        getchar();
+    }
+    #endif
+    return 0;
+}
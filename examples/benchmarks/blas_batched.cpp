@@ -0,0 +1,57 @@
+/*******************************************************
+ * Copyright (c) 2015, ArrayFire
+ * All rights reserved.
+ *
+ * This file is distributed under 3-clause BSD license.
+ * The complete license agreement can be obtained at:
+ * http://arrayfire.com/licenses/BSD-3-Clause
+ ********************************************************/
+
+#include <arrayfire.h>
+#include <stdio.h>
+#include <math.h>
+#include <cstdlib>
+
+using namespace af;
+
+// create a small wrapper to benchmark
+static array A; // populated before each timing
+static void fn()
+{
+    array B = matmul(A, A);  // one matrix multiply per batch
+    B.eval();                // ensure evaluated
+}
+
+int main(int argc, char ** argv)
+{
+    try {
+        int device = argc > 1 ? atoi(argv[1]) : 0;
+        setDevice(device);
+        info();
+
+        printf("Benchmark batched N-by-N matrix multiply\n");
+        for (int n = 2; n <= 64; n *= 2) {
+            const int batch = (1 << 22) / (n * n);
+
+            printf("%2d x %2d x %7d: ", n, n, batch);
+            A = randu(n, n, batch);
+            double time = timeit(fn); // time in seconds
+            double gflops = 2.0 * pow(n, 3) * batch / (time * 1e9);
+
+            printf("%8.3f ms, %6.2f Gflops\n", time * 1e3, gflops);
+            fflush(stdout);
+        }
+    } catch (af::exception& e) {
+        fprintf(stderr, "%s\n", e.what());
+        throw;
+    }
+
+    #ifdef WIN32 // pause in Windows
+    if (!(argc == 2 && argv[1][0] == '-')) {
+        printf("hit [enter]...");
+        fflush(stdout);
+        getchar();
+    }
+    #endif
+    return 0;
+}
@@ -0,0 +1,100 @@
+/*******************************************************
+ * Copyright (c) 2015, ArrayFire
+ * All rights reserved.
+ *
+ * This file is distributed under 3-clause BSD license.
+ * The complete license agreement can be obtained at:
+ * http://arrayfire.com/licenses/BSD-3-Clause
+ ********************************************************/
+
+#include <arrayfire.h>
+#include <stdio.h>
+#include <math.h>
+#include <cstdlib>
+
+using namespace af;
+
+// create a small wrapper to benchmark
+static array A;         // signal
+static array F;         // filter
+static array C, R;      // column and row factors of F
+static convDomain D;    // domain
+static void fn()
+{
+    array B = convolve2(A, F, AF_CONV_DEFAULT, D);
+    B.eval();
+}
+
+static void fn_sep()
+{
+    array B = convolve(C, R, A);
+    B.eval();
+}
+
+static double nextpow2(double n)
+{
+    return pow(2, ceil(log2(n)));
+}
+
+int main(int argc, char ** argv)
+{
+    try {
+        int device = argc > 1 ? atoi(argv[1]) : 0;
+        setDevice(device);
+        info();
+
+        const int N = 1024;
+        A = randu(N, N);
+
+        // Time per unit of work of each route, the constants of the cost
+        // model of AF_CONV_AUTO are their ratios to the spatial one
+        const int K = 9;
+        C = randu(K);
+        R = randu(K);
+        F = matmul(C, R.T());
+
+        D = AF_CONV_SPATIAL;
+        double spatial = timeit(fn) / ((double)N * N * K * K);
+        double separable = timeit(fn_sep) / ((double)N * N * 2 * K);
+        D = AF_CONV_FREQ;
+        double P = nextpow2(N + K - 1) * nextpow2(N + K - 1);
+        double freq = timeit(fn) / (P * log2(P) * 3);
+
+        printf("Cost model for %d-by-%d signal, %d-by-%d filter\n", N, N, K, K);
+        printf("CONV_SEPARABLE_COST = %.2f\n", separable / spatial);
+        printf("CONV_FREQ_COST      = %.2f\n", freq / spatial);
+
+        const int M = 512;
+        A = randu(M, M);
+        printf("\nBenchmark %d-by-%d convolution, random and rank one filters\n", M, M);
+        for (int W = 3; W <= 33; W = 2 * W - 1) {
+            array f = randu(W, W);
+            array g = matmul(randu(W), randu(1, W));
+            double times[2][3];
+            for (int r = 0; r < 2; r++) {
+                F = r ? g : f;
+                D = AF_CONV_SPATIAL; times[r][0] = timeit(fn);
+                D = AF_CONV_FREQ;    times[r][1] = timeit(fn);
+                D = AF_CONV_AUTO;    times[r][2] = timeit(fn);
+            }
+
+            printf("%2d x %2d: random spatial %9.3f ms, freq %9.3f ms, auto %9.3f ms | "
+                   "rank one spatial %9.3f ms, freq %9.3f ms, auto %9.3f ms\n", W, W,
+                   times[0][0] * 1e3, times[0][1] * 1e3, times[0][2] * 1e3,
+                   times[1][0] * 1e3, times[1][1] * 1e3, times[1][2] * 1e3);
+            fflush(stdout);
+        }
+    } catch (af::exception& e) {
+        fprintf(stderr, "%s\n", e.what());
+        throw;
+    }
+
+    #ifdef WIN32 // pause in Windows
+    if (!(argc == 2 && argv[1][0] == '-')) {
+        printf("hit [enter]...");
+        fflush(stdout);
+        getchar();
+    }
+    #endif
+    return 0;
+}
@@ -0,0 +1,75 @@
+/*******************************************************
+ * Copyright (c) 2015, ArrayFire
+ * All rights reserved.
+ *
+ * This file is distributed under 3-clause BSD license.
+ * The complete license agreement can be obtained at:
+ * http://arrayfire.com/licenses/BSD-3-Clause
+ ********************************************************/
+
+#include <arrayfire.h>
+#include <stdio.h>
+#include <math.h>
+#include <cstdlib>
+
+using namespace af;
+
+// create a small wrapper to benchmark
+static const int NUM = 8;
+static array A, B; // populated before each timing
+static array C[NUM];
+
+// Outputs derived from the same intermediate expression
+static void buildOutputs()
+{
+    array D = sqrt(A * A + B * B);
+    for (int i = 0; i < NUM; i++) {
+        C[i] = D * (i + 1) + B;
+    }
+}
+
+static void evalSeparate()
+{
+    buildOutputs();
+    for (int i = 0; i < NUM; i++) C[i].eval();
+}
+
+static void evalTogether()
+{
+    buildOutputs();
+    array *arrays[NUM];
+    for (int i = 0; i < NUM; i++) arrays[i] = &C[i];
+    eval(NUM, arrays);
+}
+
+int main(int argc, char ** argv)
+{
+    try {
+        int device = argc > 1 ? atoi(argv[1]) : 0;
+        setDevice(device);
+        info();
+
+        printf("Benchmark %d outputs of sqrt(A * A + B * B)\n", NUM);
+        for (int n = 256; n <= 1024; n *= 2) {
+            A = randu(n, n);
+            B = randu(n, n);
+            double separate = timeit(evalSeparate); // time in seconds
+            double together = timeit(evalTogether);
+            printf("%5d x %5d: separate %9.3f ms, together %9.3f ms\n",
+                   n, n, separate * 1e3, together * 1e3);
+            fflush(stdout);
+        }
+    } catch (af::exception& e) {
+        fprintf(stderr, "%s\n", e.what());
+        throw;
+    }
+
+    #ifdef WIN32 // pause in Windows
+    if (!(argc == 2 && argv[1][0] == '-')) {
+        printf("hit [enter]...");
+        fflush(stdout);
+        getchar();
+    }
+    #endif
+    return 0;
+}
@@ -0,0 +1,64 @@
+/*******************************************************
+ * Copyright (c) 2015, ArrayFire
+ * All rights reserved.
+ *
+ * This file is distributed under 3-clause BSD license.
+ * The complete license agreement can be obtained at:
+ * http://arrayfire.com/licenses/BSD-3-Clause
+ ********************************************************/
+
+#include <arrayfire.h>
+#include <stdio.h>
+#include <math.h>
+#include <cstdlib>
+
+using namespace af;
+
+// create a small wrapper to benchmark
+static array A; // populated before each timing
+static void fn()
+{
+    // Same shape every time, only the first call has to plan
+    for (int i = 0; i < 100; i++) {
+        array B = fft(A);
+        B.eval();
+    }
+}
+
+int main(int argc, char ** argv)
+{
+    try {
+        int device = argc > 1 ? atoi(argv[1]) : 0;
+        setDevice(device);
+        info();
+
+        printf("Benchmark 100 1D ffts of N elements with and without plan cache\n");
+        for (int M = 6; M <= 14; M += 2) {
+            int N = (1 << M);
+
+            A = randu(N, c32);
+
+            setFFTPlanCacheSize(0);
+            double uncached = timeit(fn); // time in seconds
+
+            setFFTPlanCacheSize(5);
+            double cached = timeit(fn);
+
+            printf("%6d: uncached %8.3f ms, cached %8.3f ms, %5.1fx\n",
+                   N, uncached * 1e3, cached * 1e3, uncached / cached);
+            fflush(stdout);
+        }
+    } catch (af::exception& e) {
+        fprintf(stderr, "%s\n", e.what());
+        throw;
+    }
+
+    #ifdef WIN32 // pause in Windows
+    if (!(argc == 2 && argv[1][0] == '-')) {
+        printf("hit [enter]...");
+        fflush(stdout);
+        getchar();
+    }
+    #endif
+    return 0;
+}
@@ -0,0 +1,73 @@
+/*******************************************************
+ * Copyright (c) 2015, ArrayFire
+ * All rights reserved.
+ *
+ * This file is distributed under 3-clause BSD license.
+ * The complete license agreement can be obtained at:
+ * http://arrayfire.com/licenses/BSD-3-Clause
+ ********************************************************/
+
+#include <arrayfire.h>
+#include <stdio.h>
+#include <math.h>
+#include <cstdlib>
+
+using namespace af;
+
+// create a small wrapper to benchmark
+static array A, F; // populated before each timing
+
+static void fn_c2c()
+{
+    array B = fft2(A);
+    B.eval();
+}
+
+static void fn_r2c()
+{
+    array B = fft2R2C(A);
+    B.eval();
+}
+
+static void fn_convolve()
+{
+    array C = fftConvolve2(A, F);
+    C.eval();
+}
+
+int main(int argc, char ** argv)
+{
+    try {
+        int device = argc > 1 ? atoi(argv[1]) : 0;
+        setDevice(device);
+        info();
+
+        printf("Benchmark real N-by-N 2D ffts and fft convolutions with a 63x63 filter\n");
+        F = randu(63, 63);
+        for (int M = 7; M <= 11; M++) {
+            int N = (1 << M);
+
+            A = randu(N, N);
+
+            double c2c = timeit(fn_c2c); // time in seconds
+            double r2c = timeit(fn_r2c);
+            double conv = timeit(fn_convolve);
+
+            printf("%5d: fft2 %8.3f ms, fft2R2C %8.3f ms, fftConvolve2 %8.3f ms\n",
+                   N, c2c * 1e3, r2c * 1e3, conv * 1e3);
+            fflush(stdout);
+        }
+    } catch (af::exception& e) {
+        fprintf(stderr, "%s\n", e.what());
+        throw;
+    }
+
+    #ifdef WIN32 // pause in Windows
+    if (!(argc == 2 && argv[1][0] == '-')) {
+        printf("hit [enter]...");
+        fflush(stdout);
+        getchar();
+    }
+    #endif
+    return 0;
+}
@@ -0,0 +1,65 @@
+/*******************************************************
+ * Copyright (c) 2015, ArrayFire
+ * All rights reserved.
+ *
+ * This file is distributed under 3-clause BSD license.
+ * The complete license agreement can be obtained at:
+ * http://arrayfire.com/licenses/BSD-3-Clause
+ ********************************************************/
+
+#include <arrayfire.h>
+#include <stdio.h>
+#include <math.h>
+#include <cstdlib>
+
+using namespace af;
+
+// create a small wrapper to benchmark
+static array Q;     // query descriptors
+static array T;     // train descriptors
+static unsigned K;  // number of matches per query
+static void fn()
+{
+    array idx, dist;
+    hammingMatcher(idx, dist, Q, T, 0, K);
+    idx.eval();
+    dist.eval();
+}
+
+int main(int argc, char ** argv)
+{
+    try {
+        int device = argc > 1 ? atoi(argv[1]) : 0;
+        setDevice(device);
+        info();
+
+        // 256 bit descriptors, as computed by orb
+        const int nQuery = 500;
+        Q = randu(32, nQuery, u8);
+
+        printf("Benchmark Hamming matcher of %d 256-bit query descriptors\n", nQuery);
+        for (int nTrain = 10000; nTrain <= 1000000; nTrain *= 10) {
+            T = randu(32, nTrain, u8);
+
+            printf("%8d train:", nTrain);
+            for (K = 1; K <= 16; K *= 4) {
+                double time = timeit(fn); // time in seconds
+                printf("  k = %2u %9.3f ms", K, time * 1e3);
+            }
+            printf("\n");
+            fflush(stdout);
+        }
+    } catch (af::exception& e) {
+        fprintf(stderr, "%s\n", e.what());
+        throw;
+    }
+
+    #ifdef WIN32 // pause in Windows
+    if (!(argc == 2 && argv[1][0] == '-')) {
+        printf("hit [enter]...");
+        fflush(stdout);
+        getchar();
+    }
+    #endif
+    return 0;
+}
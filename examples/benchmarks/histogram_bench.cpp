@@ -0,0 +1,63 @@
+/*******************************************************
+ * Copyright (c) 2015, ArrayFire
+ * All rights reserved.
+ *
+ * This file is distributed under 3-clause BSD license.
+ * The complete license agreement can be obtained at:
+ * http://arrayfire.com/licenses/BSD-3-Clause
+ ********************************************************/
+
+#include <arrayfire.h>
+#include <stdio.h>
+#include <math.h>
+#include <cstdlib>
+
+using namespace af;
+
+// create a small wrapper to benchmark
+static array A; // populated before each timing
+static void fn()
+{
+    array B = histogram(A, 256, 0, 255);
+    B.eval();
+}
+
+static void fn_eq()
+{
+    array B = histEqual(A, histogram(A, 256, 0, 255));
+    B.eval();
+}
+
+int main(int argc, char ** argv)
+{
+    try {
+        int device = argc > 1 ? atoi(argv[1]) : 0;
+        setDevice(device);
+        info();
+
+        array img = 255 * randu(3840, 2160, 3);
+
+        printf("Benchmark 256 bin histogram of a 3840-by-2160 RGB image\n");
+        A = img.as(u8);
+        double u8_time = timeit(fn); // time in seconds
+        A = img;
+        double f32_time = timeit(fn);
+        printf("u8 %9.3f ms, f32 %9.3f ms\n", u8_time * 1e3, f32_time * 1e3);
+
+        printf("Benchmark histogram equalization of a 3840-by-2160 image\n");
+        A = img(span, span, 0);
+        printf("f32 %9.3f ms\n", timeit(fn_eq) * 1e3);
+    } catch (af::exception& e) {
+        fprintf(stderr, "%s\n", e.what());
+        throw;
+    }
+
+    #ifdef WIN32 // pause in Windows
+    if (!(argc == 2 && argv[1][0] == '-')) {
+        printf("hit [enter]...");
+        fflush(stdout);
+        getchar();
+    }
+    #endif
+    return 0;
+}
@@ -0,0 +1,80 @@
+/*******************************************************
+ * Copyright (c) 2015, ArrayFire
+ * All rights reserved.
+ *
+ * This file is distributed under 3-clause BSD license.
+ * The complete license agreement can be obtained at:
+ * http://arrayfire.com/licenses/BSD-3-Clause
+ ********************************************************/
+
+#include <arrayfire.h>
+#include <stdio.h>
+#include <math.h>
+#include <cstdlib>
+
+using namespace af;
+
+// create a small wrapper to benchmark
+static array A, B, C; // populated before each timing
+static array I;       // indices
+static int N;         // rows of the arrays
+static void sliceExpr()
+{
+    array D = (A * B + C)(span, seq(0, 10));
+    D.eval();
+}
+
+static void reverseExpr()
+{
+    array D = (A * B + C)(seq(N - 1, 0, -1), span);
+    D.eval();
+}
+
+static void gatherExpr()
+{
+    array D = (A * B + C)(I, span);
+    D.eval();
+}
+
+static void gather()
+{
+    array D = A(I, span);
+    D.eval();
+}
+
+int main(int argc, char ** argv)
+{
+    try {
+        int device = argc > 1 ? atoi(argv[1]) : 0;
+        setDevice(device);
+        info();
+
+        const int n = N = 2048;
+        A = randu(n, n);
+        B = randu(n, n);
+        C = randu(n, n);
+        I = (randu(n / 4) * n).as(u32);
+
+        printf("Benchmark indexing of %d x %d arrays\n", n, n);
+        printf("11 columns of an expression : %9.3f ms\n", timeit(sliceExpr) * 1e3);
+        fflush(stdout);
+        printf("Reversed rows of an expression: %9.3f ms\n", timeit(reverseExpr) * 1e3);
+        fflush(stdout);
+        printf("%d random rows of an expression: %9.3f ms\n", n / 4, timeit(gatherExpr) * 1e3);
+        fflush(stdout);
+        printf("%d random rows of an array: %9.3f ms\n", n / 4, timeit(gather) * 1e3);
+        fflush(stdout);
+    } catch (af::exception& e) {
+        fprintf(stderr, "%s\n", e.what());
+        throw;
+    }
+
+    #ifdef WIN32 // pause in Windows
+    if (!(argc == 2 && argv[1][0] == '-')) {
+        printf("hit [enter]...");
+        fflush(stdout);
+        getchar();
+    }
+    #endif
+    return 0;
+}
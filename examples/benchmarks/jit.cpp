@@ -0,0 +1,81 @@
+/*******************************************************
+ * Copyright (c) 2015, ArrayFire
+ * All rights reserved.
+ *
+ * This file is distributed under 3-clause BSD license.
+ * The complete license agreement can be obtained at:
+ * http://arrayfire.com/licenses/BSD-3-Clause
+ ********************************************************/
+
+#include <arrayfire.h>
+#include <stdio.h>
+#include <math.h>
+#include <cstdlib>
+
+using namespace af;
+
+// create a small wrapper to benchmark
+static array A, B, C; // populated before each timing
+static bool fuse;     // evaluate the whole expression at once or op by op
+
+static array step(const array &in)
+{
+    if (!fuse) in.eval();
+    return in;
+}
+
+// 10 element wise operations
+static void fn()
+{
+    array T = step(A * B);
+    T = step(T + C);
+    T = step(T * 0.5f);
+    T = step(T - A);
+    array D = step(B + 1.0f);
+    T = step(T / D);
+    T = step(sin(T));
+    array E = step(C * C);
+    T = step(T + E);
+    T = step(abs(T));
+    T.eval();
+}
+
+int main(int argc, char ** argv)
+{
+    try {
+        int device = argc > 1 ? atoi(argv[1]) : 0;
+        setDevice(device);
+        info();
+
+        printf("Benchmark 10 element wise operations on N elements\n");
+        for (int M = 16; M <= 24; M += 2) {
+            int N = (1 << M);
+
+            A = randu(N);
+            B = randu(N);
+            C = randu(N);
+
+            fuse = false;
+            double unfused = timeit(fn); // time in seconds
+
+            fuse = true;
+            double fused = timeit(fn);
+
+            printf("%9d: unfused %8.3f ms, fused %8.3f ms, %6.0f Melems/s\n",
+                   N, unfused * 1e3, fused * 1e3, N / (fused * 1e6));
+            fflush(stdout);
+        }
+    } catch (af::exception& e) {
+        fprintf(stderr, "%s\n", e.what());
+        throw;
+    }
+
+    #ifdef WIN32 // pause in Windows
+    if (!(argc == 2 && argv[1][0] == '-')) {
+        printf("hit [enter]...");
+        fflush(stdout);
+        getchar();
+    }
+    #endif
+    return 0;
+}
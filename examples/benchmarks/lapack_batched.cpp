@@ -0,0 +1,87 @@
+/*******************************************************
+ * Copyright (c) 2015, ArrayFire
+ * All rights reserved.
+ *
+ * This file is distributed under 3-clause BSD license.
+ * The complete license agreement can be obtained at:
+ * http://arrayfire.com/licenses/BSD-3-Clause
+ ********************************************************/
+
+#include <arrayfire.h>
+#include <stdio.h>
+#include <math.h>
+#include <cstdlib>
+
+using namespace af;
+
+// create a small wrapper to benchmark
+static array A, B; // populated before each timing
+static const int LOOP = 1000;
+
+static void solveBatched()
+{
+    array X = solve(A, B);
+    X.eval();
+}
+
+static void inverseBatched()
+{
+    array X = inverse(A);
+    X.eval();
+}
+
+static void choleskyBatched()
+{
+    array X;
+    cholesky(X, A);
+    X.eval();
+}
+
+// Solves the first LOOP systems one at a time
+static void solveLoop()
+{
+    for (int i = 0; i < LOOP; i++) {
+        array Ai = A(span, span, i);
+        array Bi = B(span, span, i);
+        array X = solve(Ai, Bi);
+        X.eval();
+    }
+}
+
+int main(int argc, char ** argv)
+{
+    try {
+        int device = argc > 1 ? atoi(argv[1]) : 0;
+        setDevice(device);
+        info();
+
+        const int num = 100000;
+        for (int n = 4; n <= 16; n += 2) {
+            // Symmetric and diagonally dominant, so positive definite
+            array R = randu(n, n, num);
+            A = R + transpose(R) + 2 * n * identity(dim4(n, n, num));
+            A.eval();
+            B = randu(n, 1, num);
+
+            printf("%d x %d, %d matrices\n", n, n, num);
+            printf("  solve   : %9.3f ms\n", timeit(solveBatched) * 1e3);
+            printf("  inverse : %9.3f ms\n", timeit(inverseBatched) * 1e3);
+            printf("  cholesky: %9.3f ms\n", timeit(choleskyBatched) * 1e3);
+            printf("  solve, one matrix at a time: %9.3f ms\n",
+                   timeit(solveLoop) * 1e3 * num / LOOP);
+            fflush(stdout);
+        }
+    } catch (af::exception& e) {
+        fprintf(stderr, "%s\n", e.what());
+        throw;
+    }
+
+    #ifdef WIN32 // pause in Windows
+    if (!(argc == 2 && argv[1][0] == '-')) {
+        printf("hit [enter]...");
+        fflush(stdout);
+        getchar();
+    }
+    #endif
+    return 0;
+}
@@ -0,0 +1,66 @@
+/*******************************************************
+ * Copyright (c) 2015, ArrayFire
+ * All rights reserved.
+ *
+ * This file is distributed under 3-clause BSD license.
+ * The complete license agreement can be obtained at:
+ * http://arrayfire.com/licenses/BSD-3-Clause
+ ********************************************************/
+
+#include <arrayfire.h>
+#include <stdio.h>
+#include <math.h>
+#include <cstdlib>
+
+using namespace af;
+
+// create a small wrapper to benchmark
+static array A; // populated before each timing
+static void fn_all()
+{
+    float val = median<float>(A);
+    (void)val;
+}
+
+static void fn_dim()
+{
+    array B = median(A, 0);
+    B.eval();
+}
+
+int main(int argc, char ** argv)
+{
+    try {
+        int device = argc > 1 ? atoi(argv[1]) : 0;
+        setDevice(device);
+        info();
+
+        printf("Benchmark median of all the values\n");
+        for (int n = 1000000; n <= 100000000; n *= 10) {
+            A = randu(n);
+            double time = timeit(fn_all); // time in seconds
+            printf("%10d: %9.3f ms\n", n, time * 1e3);
+            fflush(stdout);
+        }
+
+        printf("Benchmark median of columns\n");
+        for (int n = 16; n <= 4096; n *= 4) {
+            A = randu(n, (1 << 24) / n);
+            double time = timeit(fn_dim);
+            printf("%4d x %7d: %9.3f ms\n", n, (1 << 24) / n, time * 1e3);
+            fflush(stdout);
+        }
+    } catch (af::exception& e) {
+        fprintf(stderr, "%s\n", e.what());
+        throw;
+    }
+
+    #ifdef WIN32 // pause in Windows
+    if (!(argc == 2 && argv[1][0] == '-')) {
+        printf("hit [enter]...");
+        fflush(stdout);
+        getchar();
+    }
+    #endif
+    return 0;
+}
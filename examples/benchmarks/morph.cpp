@@ -0,0 +1,61 @@
+/*******************************************************
+ * Copyright (c) 2015, ArrayFire
+ * All rights reserved.
+ *
+ * This file is distributed under 3-clause BSD license.
+ * The complete license agreement can be obtained at:
+ * http://arrayfire.com/licenses/BSD-3-Clause
+ ********************************************************/
+
+#include <arrayfire.h>
+#include <stdio.h>
+#include <math.h>
+#include <cstdlib>
+
+using namespace af;
+
+// create a small wrapper to benchmark
+static array A; // populated before each timing
+static int W;   // window size
+static void fn()
+{
+    array B = minfilt(A, W, W);
+    B.eval();
+}
+
+int main(int argc, char ** argv)
+{
+    try {
+        int device = argc > 1 ? atoi(argv[1]) : 0;
+        setDevice(device);
+        info();
+
+        // One 4K frame
+        array img = randu(3840, 2160);
+
+        printf("Benchmark 3840-by-2160 minimum filter\n");
+        for (W = 3; W <= 31; W += 4) {
+            A = (255 * img).as(u8);
+            double u8_time = timeit(fn); // time in seconds
+
+            A = img;
+            double f32_time = timeit(fn);
+
+            printf("%2d x %2d: u8 %8.3f ms, f32 %8.3f ms\n",
+                   W, W, u8_time * 1e3, f32_time * 1e3);
+            fflush(stdout);
+        }
+    } catch (af::exception& e) {
+        fprintf(stderr, "%s\n", e.what());
+        throw;
+    }
+
+    #ifdef WIN32 // pause in Windows
+    if (!(argc == 2 && argv[1][0] == '-')) {
+        printf("hit [enter]...");
+        fflush(stdout);
+        getchar();
+    }
+    #endif
+    return 0;
+}
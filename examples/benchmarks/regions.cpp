@@ -0,0 +1,61 @@
+/*******************************************************
+ * Copyright (c) 2015, ArrayFire
+ * All rights reserved.
+ *
+ * This file is distributed under 3-clause BSD license.
+ * The complete license agreement can be obtained at:
+ * http://arrayfire.com/licenses/BSD-3-Clause
+ ********************************************************/
+
+#include <arrayfire.h>
+#include <stdio.h>
+#include <math.h>
+#include <cstdlib>
+
+using namespace af;
+
+// create a small wrapper to benchmark
+static array A;                 // binary image, populated before each timing
+static af::connectivity C;      // connectivity
+static void fn()
+{
+    array B = regions(A, C);
+    B.eval();
+}
+
+int main(int argc, char ** argv)
+{
+    try {
+        int device = argc > 1 ? atoi(argv[1]) : 0;
+        setDevice(device);
+        info();
+
+        printf("Benchmark N-by-N connected components, 50%% random pixels\n");
+        for (int N = 256; N <= 2048; N *= 2) {
+            A = randu(N, N) < 0.5;
+            A.eval();
+
+            C = AF_CONNECTIVITY_4;
+            double conn4_time = timeit(fn); // time in seconds
+
+            C = AF_CONNECTIVITY_8;
+            double conn8_time = timeit(fn);
+
+            printf("%4d x %4d: 4-connected %9.3f ms, 8-connected %9.3f ms\n",
+                   N, N, conn4_time * 1e3, conn8_time * 1e3);
+            fflush(stdout);
+        }
+    } catch (af::exception& e) {
+        fprintf(stderr, "%s\n", e.what());
+        throw;
+    }
+
+    #ifdef WIN32 // pause in Windows
+    if (!(argc == 2 && argv[1][0] == '-')) {
+        printf("hit [enter]...");
+        fflush(stdout);
+        getchar();
+    }
+    #endif
+    return 0;
+}
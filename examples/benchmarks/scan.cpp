@@ -0,0 +1,62 @@
+/*******************************************************
+ * Copyright (c) 2015, ArrayFire
+ * All rights reserved.
+ *
+ * This file is distributed under 3-clause BSD license.
+ * The complete license agreement can be obtained at:
+ * http://arrayfire.com/licenses/BSD-3-Clause
+ ********************************************************/
+
+#include <arrayfire.h>
+#include <stdio.h>
+#include <math.h>
+#include <cstdlib>
+
+using namespace af;
+
+// create a small wrapper to benchmark
+static array A; // populated before each timing
+static int D;   // dimension scanned
+static void fn()
+{
+    array B = accum(A, D);
+    B.eval();
+}
+
+int main(int argc, char ** argv)
+{
+    try {
+        int device = argc > 1 ? atoi(argv[1]) : 0;
+        setDevice(device);
+        info();
+
+        printf("Benchmark accum of a vector\n");
+        for (int n = 1 << 16; n <= 1 << 24; n *= 4) {
+            A = randu(n);
+            D = 0;
+            double time = timeit(fn); // time in seconds
+            printf("%9d: %9.3f ms\n", n, time * 1e3);
+            fflush(stdout);
+        }
+
+        printf("Benchmark accum of 4096 x 4096 along each dimension\n");
+        A = randu(4096, 4096);
+        for (D = 0; D < 2; D++) {
+            double time = timeit(fn);
+            printf("dim %d: %9.3f ms\n", D, time * 1e3);
+            fflush(stdout);
+        }
+    } catch (af::exception& e) {
+        fprintf(stderr, "%s\n", e.what());
+        throw;
+    }
+
+    #ifdef WIN32 // pause in Windows
+    if (!(argc == 2 && argv[1][0] == '-')) {
+        printf("hit [enter]...");
+        fflush(stdout);
+        getchar();
+    }
+    #endif
+    return 0;
+}
@@ -0,0 +1,83 @@
+/*******************************************************
+ * Copyright (c) 2015, ArrayFire
+ * All rights reserved.
+ *
+ * This file is distributed under 3-clause BSD license.
+ * The complete license agreement can be obtained at:
+ * http://arrayfire.com/licenses/BSD-3-Clause
+ ********************************************************/
+
+#include <arrayfire.h>
+#include <stdio.h>
+#include <math.h>
+#include <cstdlib>
+
+using namespace af;
+
+// create a small wrapper to benchmark
+static array A, V; // populated before each timing
+static unsigned D; // dimension to sort along
+
+static void fn_sort()
+{
+    array B = sort(A, D);
+    B.eval();
+}
+
+static void fn_sort_index()
+{
+    array B, I;
+    sort(B, I, A, D);
+    B.eval();
+    I.eval();
+}
+
+static void fn_sort_by_key()
+{
+    array K, W;
+    sort(K, W, A, V, D);
+    K.eval();
+    W.eval();
+}
+
+static void bench(const char *name, dim_t d0, dim_t d1, dtype ty)
+{
+    A = randu(d0, d1, ty);
+    V = randu(d0, d1);
+
+    for (D = 0; D < 2; D++) {
+        printf("%-12s %7lld x %-5lld dim %u: sort %8.3f ms, index %8.3f ms, by key %8.3f ms\n",
+               name, (long long)d0, (long long)d1, D,
+               timeit(fn_sort) * 1e3, timeit(fn_sort_index) * 1e3,
+               timeit(fn_sort_by_key) * 1e3); // time in seconds
+        fflush(stdout);
+    }
+}
+
+int main(int argc, char ** argv)
+{
+    try {
+        int device = argc > 1 ? atoi(argv[1]) : 0;
+        setDevice(device);
+        info();
+
+        printf("Benchmark sorting a single long column and a batch of columns\n");
+        bench("f32", 1 << 20, 1, f32);
+        bench("f32", 1024, 1024, f32);
+        bench("u32", 1 << 20, 1, u32);
+        bench("u32", 1024, 1024, u32);
+        bench("f64", 1024, 1024, f64);
+    } catch (af::exception& e) {
+        fprintf(stderr, "%s\n", e.what());
+        throw;
+    }
+
+    #ifdef WIN32 // pause in Windows
+    if (!(argc == 2 && argv[1][0] == '-')) {
+        printf("hit [enter]...");
+        fflush(stdout);
+        getchar();
+    }
+    #endif
+    return 0;
+}
@@ -0,0 +1,81 @@
+/*******************************************************
+ * Copyright (c) 2015, ArrayFire
+ * All rights reserved.
+ *
+ * This file is distributed under 3-clause BSD license.
+ * The complete license agreement can be obtained at:
+ * http://arrayfire.com/licenses/BSD-3-Clause
+ ********************************************************/
+
+#include <arrayfire.h>
+#include <stdio.h>
+#include <math.h>
+#include <cstdlib>
+
+using namespace af;
+
+// Time to the first result of some functions, which includes compiling their
+// kernels on the OpenCL backend. Run it once with an empty cache directory
+// for the cold startup, then again for the warm one:
+//
+//   AF_OPENCL_CACHE_DIR=/tmp/af_cache ./benchmark_startup_opencl
+//   AF_OPENCL_CACHE_DIR=/tmp/af_cache ./benchmark_startup_opencl
+//
+// AF_OPENCL_DISABLE_CACHE=1 measures the startup without the cache.
+
+static double first(const char *name, array (*fn)(const array &), const array &in)
+{
+    timer start = timer::start();
+    array out = fn(in);
+    out.eval();
+    sync();
+    double time = timer::stop(start);
+    printf("%-12s: %9.3f ms\n", name, time * 1e3);
+    fflush(stdout);
+    return time;
+}
+
+static array fn_jit(const array &in)     { return sin(in) * 2 + cos(in); }
+static array fn_sum(const array &in)     { return sum(in); }
+static array fn_accum(const array &in)   { return accum(in); }
+static array fn_sort(const array &in)    { return sort(in); }
+static array fn_matmul(const array &in)  { return matmul(in, in); }
+static array fn_convolve(const array &in){ return convolve(in, constant(1, 5, 5)); }
+static array fn_transpose(const array &in){ return transpose(in); }
+
+int main(int argc, char ** argv)
+{
+    try {
+        int device = argc > 1 ? atoi(argv[1]) : 0;
+        timer start = timer::start();
+        setDevice(device);
+        info();
+        printf("%-12s: %9.3f ms\n", "setDevice", timer::stop(start) * 1e3);
+
+        array A = randu(256, 256);
+        A.eval();
+        sync();
+
+        double total = 0;
+        total += first("jit"      , fn_jit      , A);
+        total += first("sum"      , fn_sum      , A);
+        total += first("accum"    , fn_accum    , A);
+        total += first("sort"     , fn_sort     , A);
+        total += first("matmul"   , fn_matmul   , A);
+        total += first("convolve" , fn_convolve , A);
+        total += first("transpose", fn_transpose, A);
+        printf("%-12s: %9.3f ms\n", "total", total * 1e3);
+    } catch (af::exception& e) {
+        fprintf(stderr, "%s\n", e.what());
+        throw;
+    }
+
+    #ifdef WIN32 // pause in Windows
+    if (!(argc == 2 && argv[1][0] == '-')) {
+        printf("hit [enter]...");
+        fflush(stdout);
+        getchar();
+    }
+    #endif
+    return 0;
+}
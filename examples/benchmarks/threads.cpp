@@ -0,0 +1,116 @@
+/*******************************************************
+ * Copyright (c) 2015, ArrayFire
+ * All rights reserved.
+ *
+ * This file is distributed under 3-clause BSD license.
+ * The complete license agreement can be obtained at:
+ * http://arrayfire.com/licenses/BSD-3-Clause
+ ********************************************************/
+
+#include <arrayfire.h>
+#include <stdio.h>
+#include <math.h>
+#include <cstdlib>
+
+using namespace af;
+
+// create a small wrapper to benchmark
+static array A, B, F, M; // populated before each timing
+
+static void fn_reduce()
+{
+    array S = sum(A, 1);
+    S.eval();
+}
+
+static void fn_jit()
+{
+    array T = sin(A) * B + cos(B) / (A + 1.0f);
+    T.eval();
+}
+
+static void fn_convolve()
+{
+    array C = convolve2(A, F);
+    C.eval();
+}
+
+static void fn_erode()
+{
+    array E = erode(A, M);
+    E.eval();
+}
+
+static void fn_medfilt()
+{
+    array D = medfilt(A, 3, 3);
+    D.eval();
+}
+
+static void fn_transpose()
+{
+    array T = A.T();
+    T.eval();
+}
+
+static void fn_resize()
+{
+    array R = resize(A, 2048, 2048, AF_INTERP_BILINEAR);
+    R.eval();
+}
+
+static void bench(const char *name, void (*fn)(), int max_threads)
+{
+    printf("%-10s", name);
+    double serial = 0;
+    for (int n = 1; n <= max_threads; n *= 2) {
+        setNumThreads(n);
+        double t = timeit(fn); // time in seconds
+        if (n == 1) serial = t;
+        printf(" %3d: %8.3f ms (%4.1fx)", n, t * 1e3, serial / t);
+        fflush(stdout);
+    }
+    printf("\n");
+}
+
+int main(int argc, char ** argv)
+{
+    try {
+        int device = argc > 1 ? atoi(argv[1]) : 0;
+        setDevice(device);
+        info();
+
+        setNumThreads(0);
+        int max_threads = getNumThreads();
+
+        A = randu(1024, 1024);
+        B = randu(1024, 1024);
+        F = randu(5, 5);
+        M = constant(1, 5, 5);
+
+        printf("Benchmark CPU kernels on a 1024x1024 image with 1 to %d threads\n",
+               max_threads);
+        bench("reduce",    fn_reduce,    max_threads);
+        bench("jit",       fn_jit,       max_threads);
+        bench("convolve",  fn_convolve,  max_threads);
+        bench("erode",     fn_erode,     max_threads);
+        bench("medfilt",   fn_medfilt,   max_threads);
+        bench("transpose", fn_transpose, max_threads);
+        bench("resize",    fn_resize,    max_threads);
+
+        // Back to the default number of threads
+        setNumThreads(0);
+    } catch (af::exception& e) {
+        fprintf(stderr, "%s\n", e.what());
+        throw;
+    }
+
+    #ifdef WIN32 // pause in Windows
+    if (!(argc == 2 && argv[1][0] == '-')) {
+        printf("hit [enter]...");
+        fflush(stdout);
+        getchar();
+    }
+    #endif
+    return 0;
+}
@@ -0,0 +1,66 @@
+/*******************************************************
+ * Copyright (c) 2015, ArrayFire
+ * All rights reserved.
+ *
+ * This file is distributed under 3-clause BSD license.
+ * The complete license agreement can be obtained at:
+ * http://arrayfire.com/licenses/BSD-3-Clause
+ ********************************************************/
+
+#include <arrayfire.h>
+#include <stdio.h>
+#include <math.h>
+#include <cstdlib>
+
+using namespace af;
+
+// create a small wrapper to benchmark
+static array A; // populated before each timing
+static void normalize()
+{
+    array B = tile(mean(A, 0), A.dims(0)) - A;
+    B.eval();
+}
+
+static void tileOnly()
+{
+    array B = tile(A, 2, 2);
+    B.eval();
+}
+
+int main(int argc, char ** argv)
+{
+    try {
+        int device = argc > 1 ? atoi(argv[1]) : 0;
+        setDevice(device);
+        info();
+
+        printf("Benchmark tile(mean(A, 0), A.dims(0)) - A\n");
+        for (int n = 512; n <= 4096; n *= 2) {
+            A = randu(n, n);
+            double time = timeit(normalize); // time in seconds
+            printf("%5d x %5d: %9.3f ms\n", n, n, time * 1e3);
+            fflush(stdout);
+        }
+
+        printf("Benchmark tile(A, 2, 2)\n");
+        for (int n = 512; n <= 2048; n *= 2) {
+            A = randu(n, n);
+            double time = timeit(tileOnly);
+            printf("%5d x %5d: %9.3f ms\n", n, n, time * 1e3);
+            fflush(stdout);
+        }
+    } catch (af::exception& e) {
+        fprintf(stderr, "%s\n", e.what());
+        throw;
+    }
+
+    #ifdef WIN32 // pause in Windows
+    if (!(argc == 2 && argv[1][0] == '-')) {
+        printf("hit [enter]...");
+        fflush(stdout);
+        getchar();
+    }
+    #endif
+    return 0;
+}
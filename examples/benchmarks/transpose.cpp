@@ -0,0 +1,74 @@
+/*******************************************************
+ * Copyright (c) 2015, ArrayFire
+ * All rights reserved.
+ *
+ * This file is distributed under 3-clause BSD license.
+ * The complete license agreement can be obtained at:
+ * http://arrayfire.com/licenses/BSD-3-Clause
+ ********************************************************/
+
+#include <arrayfire.h>
+#include <stdio.h>
+#include <math.h>
+#include <cstdlib>
+
+using namespace af;
+
+// create a small wrapper to benchmark
+static array A; // populated before each timing
+
+static void fn_transpose()
+{
+    array B = transpose(A);
+    B.eval();
+}
+
+static void fn_transpose_conj()
+{
+    array B = transpose(A, true);
+    B.eval();
+}
+
+static void fn_transpose_inplace()
+{
+    transposeInPlace(A);
+}
+
+int main(int argc, char ** argv)
+{
+    try {
+        int device = argc > 1 ? atoi(argv[1]) : 0;
+        setDevice(device);
+        info();
+
+        printf("Benchmark N-by-N transposes\n");
+        dtype types[] = {f32, c32};
+        const char *names[] = {"f32", "c32"};
+        for (int t = 0; t < 2; t++) {
+            for (int M = 10; M <= 13; M++) {
+                int N = (1 << M);
+
+                A = randu(N, N, types[t]);
+                A.eval();
+
+                printf("%s %5d: transpose %8.3f ms, conjugate %8.3f ms, in place %8.3f ms\n",
+                       names[t], N, timeit(fn_transpose) * 1e3,
+                       timeit(fn_transpose_conj) * 1e3,
+                       timeit(fn_transpose_inplace) * 1e3); // time in seconds
+                fflush(stdout);
+            }
+        }
+    } catch (af::exception& e) {
+        fprintf(stderr, "%s\n", e.what());
+        throw;
+    }
+
+    #ifdef WIN32 // pause in Windows
+    if (!(argc == 2 && argv[1][0] == '-')) {
+        printf("hit [enter]...");
+        fflush(stdout);
+        getchar();
+    }
+    #endif
+    return 0;
+}
@@ -237,16 +237,49 @@ namespace af
     */
     AFAPI array accum(const array &in, const int dim = 0);
 
+    /**
+       C++ Interface for a scan of an array with any of the binary operations
+
+       \param[in] in is the input array
+       \param[in] dim The dimension along which the scan is performed
+       \param[in] op is the operation combining the values: add, multiply, min or max
+       \param[in] inclusive_scan when true, element i includes the value of \p in at i.
+                  When false, it only combines the values before i, and the first
+                  element is the identity of \p op.
+       \return the output containing the scan of the input
+
+       \note Only \ref AF_BINARY_ADD inclusive scans are supported by the CUDA and OpenCL backends.
+
+       \ingroup scan_func_accum
+    */
+    AFAPI array scan(const array &in, const int dim = 0,
+                     binaryOp op = AF_BINARY_ADD, bool inclusive_scan = true);
+
     /**
        C++ Interface for finding the locations of non-zero values in an array
 
        \param[in] in is the input array.
        \return linear indices where \p in is non-zero
 
+       \note The indices are of type \ref u32, or \ref u64 when \p in has more than 2^32 - 1 elements.
+
        \ingroup scan_func_where
     */
     AFAPI array where(const array &in);
 
+    /**
+       C++ Interface for finding the locations and the values of the non-zero elements of an array
+
+       \param[out] idx will contain the linear indices where \p in is non-zero
+       \param[out] values will contain the values of \p in at \p idx
+       \param[in] in is the input array.
+
+       \note This is not supported by the CUDA and OpenCL backends yet.
+
+       \ingroup scan_func_where
+    */
+    AFAPI void where(array &idx, array &values, const array &in);
+
     /**
        C++ Interface for calculating first order differences in an array
 
@@ -279,7 +312,7 @@ namespace af
 
        \ingroup sort_func_sort
 
-       \note \p dim is currently restricted to 0.
+       \note Only the CPU backend supports \p dim other than 0.
     */
     AFAPI array sort(const array &in, const unsigned dim = 0, const bool isAscending = true);
 
@@ -294,7 +327,7 @@ namespace af
 
        \ingroup sort_func_sort
 
-       \note \p dim is currently restricted to 0.
+       \note Only the CPU backend supports \p dim other than 0.
     */
     AFAPI void  sort(array &out, array &indices, const array &in, const unsigned dim = 0,
                      const bool isAscending = true);
@@ -310,7 +343,7 @@ namespace af
 
        \ingroup sort_func_sort
 
-       \note \p dim is currently restricted to 0.
+       \note Only the CPU backend supports \p dim other than 0.
     */
     AFAPI void  sort(array &out_keys, array &out_values, const array &keys, const array &values,
                      const unsigned dim = 0, const bool isAscending = true);
@@ -349,6 +382,57 @@ namespace af
        \ingroup set_func_intersect
     */
     AFAPI array setIntersect(const array &first, const array &second, const bool is_unique=false);
+
+    /**
+       C++ Interface for getting unique values and the locations of their first occurrence
+
+       \param[out] values will contain the unique values from \p in
+       \param[out] idx will contain the index in \p in of the first occurrence of every value
+       \param[in] in is the input array
+       \param[in] in_order if true, the values are in the order of their first occurrence
+                  instead of ascending order
+
+       \note This is only supported by the CPU backend.
+
+       \ingroup set_func_unique
+    */
+    AFAPI void setUnique(array &values, array &idx, const array &in, const bool in_order=false);
+
+    /**
+       C++ Interface for performing union of two arrays with the locations of the values
+
+       \param[out] values will contain the union of \p first and \p second
+       \param[out] idx will contain the index of the first occurrence of every value in
+                   the elements of \p first followed by the elements of \p second
+       \param[in] first is the first array
+       \param[in] second is the second array
+       \param[in] in_order if true, the values are in the order of their first occurrence
+                  instead of ascending order
+
+       \note This is only supported by the CPU backend.
+
+       \ingroup set_func_union
+    */
+    AFAPI void setUnion(array &values, array &idx, const array &first, const array &second,
+                        const bool in_order=false);
+
+    /**
+       C++ Interface for performing intersect of two arrays with the locations of the values
+
+       \param[out] values will contain the intersection of \p first and \p second
+       \param[out] first_idx will contain the index in \p first of the first occurrence of every value
+       \param[out] second_idx will contain the index in \p second of the first occurrence of every value
+       \param[in] first is the first array
+       \param[in] second is the second array
+       \param[in] in_order if true, the values are in the order of their first occurrence in
+                  \p first instead of ascending order
+
+       \note This is only supported by the CPU backend.
+
+       \ingroup set_func_intersect
+    */
+    AFAPI void setIntersect(array &values, array &first_idx, array &second_idx,
+                            const array &first, const array &second, const bool in_order=false);
 }
 #endif
 
@@ -606,6 +690,22 @@ extern "C" {
     */
     AFAPI af_err af_accum(af_array *out, const af_array in, const int dim);
 
+    /**
+       C Interface for a scan of an array with any of the binary operations
+
+       \param[out] out will contain the scan of the input
+       \param[in] in is the input array
+       \param[in] dim The dimension along which the scan is performed
+       \param[in] op is the operation combining the values: add, multiply, min or max
+       \param[in] inclusive_scan selects an inclusive scan when true and an exclusive one otherwise
+       \return \ref AF_SUCCESS if the execution completes properly
+
+       \note Only \ref AF_BINARY_ADD inclusive scans are supported by the CUDA and OpenCL backends.
+
+       \ingroup scan_func_accum
+    */
+    AFAPI af_err af_scan(af_array *out, const af_array in, const int dim, af_binary_op op, bool inclusive_scan);
+
     /**
        C Interface for finding the locations of non-zero values in an array
 
@@ -613,10 +713,26 @@ extern "C" {
        \param[in] in is the input array.
        \return \ref AF_SUCCESS if the execution completes properly
 
+       \note The indices are of type \ref u32, or \ref u64 when \p in has more than 2^32 - 1 elements.
+
        \ingroup scan_func_where
     */
     AFAPI af_err af_where(af_array *idx, const af_array in);
 
+    /**
+       C Interface for finding the locations and the values of the non-zero elements of an array
+
+       \param[out] idx will contain the linear indices where \p in is non-zero
+       \param[out] vals will contain the values of \p in at \p idx
+       \param[in] in is the input array.
+       \return \ref AF_SUCCESS if the execution completes properly
+
+       \note This is not supported by the CUDA and OpenCL backends yet.
+
+       \ingroup scan_func_where
+    */
+    AFAPI af_err af_where_values(af_array *idx, af_array *vals, const af_array in);
+
     /**
        C Interface for calculating first order differences in an array
 
@@ -652,7 +768,7 @@ extern "C" {
 
        \ingroup sort_func_sort
 
-       \note \p dim is currently restricted to 0.
+       \note Only the CPU backend supports \p dim other than 0.
     */
     AFAPI af_err af_sort(af_array *out, const af_array in, const unsigned dim, const bool isAscending);
 
@@ -668,7 +784,7 @@ extern "C" {
 
        \ingroup sort_func_sort
 
-       \note \p dim is currently restricted to 0.
+       \note Only the CPU backend supports \p dim other than 0.
     */
     AFAPI af_err af_sort_index(af_array *out, af_array *indices, const af_array in,
                                const unsigned dim, const bool isAscending);
@@ -685,7 +801,7 @@ extern "C" {
 
        \ingroup sort_func_sort
 
-       \note \p dim is currently restricted to 0.
+       \note Only the CPU backend supports \p dim other than 0.
     */
     AFAPI af_err af_sort_by_key(af_array *out_keys, af_array *out_values,
                                 const af_array keys, const af_array values,
@@ -729,6 +845,60 @@ extern "C" {
     */
     AFAPI af_err af_set_intersect(af_array *out, const af_array first, const af_array second, const bool is_unique);
 
+    /**
+       C Interface for getting unique values and the locations of their first occurrence
+
+       \param[out] values will contain the unique values from \p in
+       \param[out] idx will contain the index in \p in of the first occurrence of every value
+       \param[in] in is the input array
+       \param[in] in_order if true, the values are in the order of their first occurrence
+                  instead of ascending order
+       \return \ref AF_SUCCESS if the execution completes properly
+
+       \note This is only supported by the CPU backend.
+
+       \ingroup set_func_unique
+    */
+    AFAPI af_err af_set_unique_index(af_array *values, af_array *idx, const af_array in, const bool in_order);
+
+    /**
+       C Interface for performing union of two arrays with the locations of the values
+
+       \param[out] values will contain the union of \p first and \p second
+       \param[out] idx will contain the index of the first occurrence of every value in
+                   the elements of \p first followed by the elements of \p second
+       \param[in] first is the first array
+       \param[in] second is the second array
+       \param[in] in_order if true, the values are in the order of their first occurrence
+                  instead of ascending order
+       \return \ref AF_SUCCESS if the execution completes properly
+
+       \note This is only supported by the CPU backend.
+
+       \ingroup set_func_union
+    */
+    AFAPI af_err af_set_union_index(af_array *values, af_array *idx,
+                                    const af_array first, const af_array second, const bool in_order);
+
+    /**
+       C Interface for performing intersect of two arrays with the locations of the values
+
+       \param[out] values will contain the intersection of \p first and \p second
+       \param[out] first_idx will contain the index in \p first of the first occurrence of every value
+       \param[out] second_idx will contain the index in \p second of the first occurrence of every value
+       \param[in] first is the first array
+       \param[in] second is the second array
+       \param[in] in_order if true, the values are in the order of their first occurrence in
+                  \p first instead of ascending order
+       \return \ref AF_SUCCESS if the execution completes properly
+
+       \note This is only supported by the CPU backend.
+
+       \ingroup set_func_intersect
+    */
+    AFAPI af_err af_set_intersect_index(af_array *values, af_array *first_idx, af_array *second_idx,
+                                        const af_array first, const af_array second, const bool in_order);
+
 #ifdef __cplusplus
 }
 #endif
@@ -1152,11 +1152,40 @@ namespace af
        @{
     */
     inline array &eval(array &a) { a.eval(); return a; }
-    inline void eval(array &a, array &b) { eval(a); b.eval(); }
-    inline void eval(array &a, array &b, array &c) { eval(a, b); c.eval(); }
-    inline void eval(array &a, array &b, array &c, array &d) { eval(a, b, c); d.eval(); }
-    inline void eval(array &a, array &b, array &c, array &d, array &e) { eval(a, b, c, d); e.eval(); }
-    inline void eval(array &a, array &b, array &c, array &d, array &e, array &f) { eval(a, b, c, d, e); f.eval(); }
+
+    /// Evaluate several expressions together. Subexpressions shared by the
+    /// arrays are only computed once, in a single pass over the data.
+    AFAPI void eval(int num, array **arrays);
+
+    inline void eval(array &a, array &b)
+    {
+        array *arrays[] = {&a, &b};
+        eval(2, arrays);
+    }
+
+    inline void eval(array &a, array &b, array &c)
+    {
+        array *arrays[] = {&a, &b, &c};
+        eval(3, arrays);
+    }
+
+    inline void eval(array &a, array &b, array &c, array &d)
+    {
+        array *arrays[] = {&a, &b, &c, &d};
+        eval(4, arrays);
+    }
+
+    inline void eval(array &a, array &b, array &c, array &d, array &e)
+    {
+        array *arrays[] = {&a, &b, &c, &d, &e};
+        eval(5, arrays);
+    }
+
+    inline void eval(array &a, array &b, array &c, array &d, array &e, array &f)
+    {
+        array *arrays[] = {&a, &b, &c, &d, &e, &f};
+        eval(6, arrays);
+    }
     /**
        @}
     */
@@ -1238,6 +1267,17 @@ extern "C" {
     */
     AFAPI af_err af_eval(af_array in);
 
+    /**
+       Evaluate several arrays together
+
+       Arrays of the same type and dimensions are evaluated in a single pass,
+       computing the nodes shared by their expressions once.
+
+       \param[in] num the number of arrays
+       \param[in] arrays the arrays to evaluate
+    */
+    AFAPI af_err af_eval_multiple(int num, af_array *arrays);
+
     /**
       @}
     */
@@ -138,6 +138,8 @@ namespace af
         af_print(dot(x,y));
         }
 
+        \note optLhs and optRhs can only be one of \ref AF_MAT_NONE or \ref
+              AF_MAT_CONJ
         \note This function is not supported in GFOR
 
         \ingroup blas_func_dot
@@ -182,8 +184,8 @@ extern "C" {
         \details Performs a matrix multiplication on two arrays (lhs, rhs).
 
         \param[out] out Pointer to the output \ref af_array
-        \param[in] lhs A 2D matrix \ref af_array object
-        \param[in] rhs A 2D matrix \ref af_array object
+        \param[in] lhs A 2D matrix or a batch of matrices
+        \param[in] rhs A 2D matrix or a batch of matrices
         \param[in] optLhs Transpose operation before the function is performed
         \param[in] optRhs Transpose operation before the function is performed
 
@@ -204,6 +206,9 @@ extern "C" {
         array x = randu(100), y = randu(100);
         print(dot<float>(x,y));
         }
+
+        \note optLhs and optRhs can only be one of \ref AF_MAT_NONE or \ref
+              AF_MAT_CONJ
         \ingroup blas_func_dot
     */
     AFAPI af_err af_dot(    af_array *out,
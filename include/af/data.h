@@ -198,6 +198,37 @@ namespace af
     */
     AFAPI uintl getSeed();
 
+    /**
+        \defgroup data_func_setrandomcounter setRandomCounter
+        Set the position in the stream of the random number generator
+
+        The CPU backend generates every value from the seed and its position
+        in the stream, so arrays generated after setting the same seed and
+        counter are identical. Setting the counters of independent tasks far
+        apart, for example to `task << 40`, splits one seed into independent
+        streams. \ref af::setSeed resets the counter to 0.
+
+        \param[in] counter is a 64 bit unsigned integer
+
+        \note The CUDA and OpenCL backends offset the streams of their
+        generators by \p counter, but do not advance it when generating
+
+        \ingroup data_mat
+        \ingroup arrayfire_func
+    */
+    AFAPI void setRandomCounter(const uintl counter);
+
+    /**
+        \defgroup data_func_getrandomcounter getRandomCounter
+        Get the position in the stream of the random number generator
+
+        \returns counter which is a 64 bit unsigned integer
+
+        \ingroup data_mat
+        \ingroup arrayfire_func
+    */
+    AFAPI uintl getRandomCounter();
+
 
     /**
         \param[in] dims is dim4 for size of all dimensions
@@ -559,6 +590,28 @@ extern "C" {
     */
     AFAPI af_err af_get_seed(uintl *seed);
 
+    /**
+        \defgroup data_func_setrandomcounter setRandomCounter
+        Set the position in the stream of the random number generator
+
+        \param[in] counter is a 64 bit unsigned integer
+
+        \ingroup data_mat
+        \ingroup arrayfire_func
+    */
+    AFAPI af_err af_set_random_counter(const uintl counter);
+
+    /**
+        \defgroup data_func_getrandomcounter getRandomCounter
+        Get the position in the stream of the random number generator
+
+        \param[out] counter which is a 64 bit unsigned integer
+
+        \ingroup data_mat
+        \ingroup arrayfire_func
+    */
+    AFAPI af_err af_get_random_counter(uintl *counter);
+
 
     /**
         \param[out] out is the generated array
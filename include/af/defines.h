@@ -218,7 +218,17 @@ typedef enum {
     ///
     /// Connectivity includes 4-connectivity neigbors and also those on Northeast, Northwest, Southeast and Southwest
     ///
-    AF_CONNECTIVITY_8 = 8
+    AF_CONNECTIVITY_8 = 8,
+
+    ///
+    /// Connectivity of volumes, includes the voxels sharing a face with the current voxel
+    ///
+    AF_CONNECTIVITY_6 = 6,
+
+    ///
+    /// Connectivity of volumes, includes the voxels sharing a face, an edge or a corner with the current voxel
+    ///
+    AF_CONNECTIVITY_26 = 26
 } af_connectivity;
 
 typedef enum {
@@ -262,6 +272,7 @@ typedef enum {
     AF_MAT_NONE       = 0,    ///< Default
     AF_MAT_TRANS      = 1,    ///< Data needs to be transposed
     AF_MAT_CTRANS     = 2,    ///< Data needs to be conjugate tansposed
+    AF_MAT_CONJ       = 4,    ///< Data needs to be conjugated
     AF_MAT_UPPER      = 32,   ///< Matrix is upper triangular
     AF_MAT_LOWER      = 64,   ///< Matrix is lower triangular
     AF_MAT_DIAG_UNIT  = 128,  ///< Matrix diagonal contains unitary values
@@ -295,6 +306,13 @@ typedef enum {
     AF_COLORMAP_BLUE    = 6     ///< Blue hue map
 } af_colormap;
 
+typedef enum {
+    AF_BINARY_ADD  = 0, ///< Sum of the values
+    AF_BINARY_MUL  = 1, ///< Product of the values
+    AF_BINARY_MIN  = 2, ///< Smallest of the values
+    AF_BINARY_MAX  = 3  ///< Largest of the values
+} af_binary_op;
+
 // Below enum is purely added for example purposes
 // it doesn't and shoudn't be used anywhere in the
 // code. No Guarantee's provided if it is used.
@@ -321,6 +339,7 @@ namespace af
     typedef af_mat_prop matProp;
     typedef af_colormap ColorMap;
     typedef af_norm_type normType;
+    typedef af_binary_op binaryOp;
 }
 
 #endif
@@ -146,6 +146,39 @@ namespace af
     ///
     /// \ingroup device_func_mem
     AFAPI void deviceGC();
+
+    /// \brief Sets the number of bytes the memory manager may hold
+    ///
+    /// Cached buffers are released when an allocation would take the memory
+    /// manager above this limit.
+    ///
+    /// \param[in] bytes the memory limit in bytes
+    ///
+    /// \ingroup device_func_mem
+    AFAPI void deviceSetMemLimit(const size_t bytes);
+
+    /// \brief Gets the number of bytes the memory manager may hold
+    ///
+    /// \ingroup device_func_mem
+    AFAPI size_t deviceGetMemLimit();
+    /// @}
+
+    /// \ingroup device_func_threads
+    /// @{
+    /// \brief Sets the number of host threads used by the CPU backend
+    ///
+    /// \param[in] nthreads the number of threads, including the calling
+    ///            thread. 0 restores the default, which is the value of the
+    ///            AF_CPU_NUM_THREADS environment variable if set and the number
+    ///            of hardware threads otherwise.
+    ///
+    /// \note This has no effect on the CUDA and OpenCL backends
+    AFAPI void setNumThreads(const int nthreads);
+
+    /// \brief Gets the number of host threads used by the CPU backend
+    ///
+    /// \returns the number of threads. Always 1 for the CUDA and OpenCL backends
+    AFAPI int getNumThreads();
     /// @}
 }
 #endif
@@ -235,6 +268,30 @@ extern "C" {
     */
     AFAPI af_err af_device_gc();
 
+    /**
+       Set the number of bytes the memory manager may hold
+       \ingroup device_func_mem
+    */
+    AFAPI af_err af_device_set_mem_limit(const size_t bytes);
+
+    /**
+       Get the number of bytes the memory manager may hold
+       \ingroup device_func_mem
+    */
+    AFAPI af_err af_device_get_mem_limit(size_t *bytes);
+
+    /**
+       Set the number of host threads used by the CPU backend
+       \ingroup device_func_threads
+    */
+    AFAPI af_err af_set_num_threads(const int nthreads);
+
+    /**
+       Get the number of host threads used by the CPU backend
+       \ingroup device_func_threads
+    */
+    AFAPI af_err af_get_num_threads(int *nthreads);
+
 #ifdef __cplusplus
 }
 #endif
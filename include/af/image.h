@@ -172,6 +172,24 @@ AFAPI array skew(const array& in, const float skew0, const float skew1, const di
 */
 AFAPI array bilateral(const array &in, const float spatial_sigma, const float chromatic_sigma, const bool is_color=false);
 
+/**
+    C++ Interface for approximate bilateral filter
+
+    Approximates \ref bilateral on a downsampled bilateral grid. The cost does
+    not depend on \p spatial_sigma, which is not limited in size.
+
+    \param[in]  in array is the input image
+    \param[in]  spatial_sigma is the spatial variance paramter
+    \param[in]  chromatic_sigma is the chromatic variance paramter
+    \param[in]  is_color indicates if the input \p in is color image or grayscale
+    \return     the processed image
+
+    \note Only supported by the CPU backend
+
+    \ingroup image_func_bilateral
+*/
+AFAPI array bilateralApprox(const array &in, const float spatial_sigma, const float chromatic_sigma, const bool is_color=false);
+
 /**
    C++ Interface for histogram
 
@@ -200,6 +218,23 @@ AFAPI array histogram(const array &in, const unsigned nbins, const double minval
  */
 AFAPI array histogram(const array &in, const unsigned nbins);
 
+/**
+   C++ Interface for weighted histogram
+
+   \param[in]  in is the input array
+   \param[in]  weights has the dimensions of \p in and is of type f32 or f64
+   \param[in]  nbins  Number of bins to populate between min and max
+   \param[in]  minval minimum bin value (accumulates -inf to min)
+   \param[in]  maxval maximum bin value (accumulates max to +inf)
+   \return     histogram array with the sum of the weights of the values in
+               each bin, of the type of \p weights
+
+   \note Weighted histograms are currently only supported by the CPU backend
+
+   \ingroup image_func_histogram
+ */
+AFAPI array histogram(const array &in, const array &weights, const unsigned nbins, const double minval, const double maxval);
+
 /**
     C++ Interface for mean shift
 
@@ -327,14 +362,46 @@ AFAPI array erode3(const array& in, const array& mask);
     </table>
 
     \param[in]  in array should be binary image of type \ref b8
-    \param[in]  connectivity can take one of the following [\ref AF_CONNECTIVITY_4 | \ref AF_CONNECTIVITY_8]
+    \param[in]  connectivity can take one of the following [\ref AF_CONNECTIVITY_4 | \ref AF_CONNECTIVITY_8 | \ref AF_CONNECTIVITY_6 | \ref AF_CONNECTIVITY_26]
     \param[in]  type is type of output array
     \return     returns array with labels indicating different regions. Throws exceptions if any issue occur.
 
+    \note Regions are numbered from 1 in the order of their first pixel in memory.
+    \note If \p in is 3d and \p connectivity is \ref AF_CONNECTIVITY_4 or \ref AF_CONNECTIVITY_8,
+          each 2d slice is labelled on its own by the CPU backend. The other backends return
+          \ref AF_ERR_BATCH for it. \ref AF_CONNECTIVITY_6 and
+          \ref AF_CONNECTIVITY_26 label \p in as a volume and are only supported by the CPU backend.
+
     \ingroup image_func_regions
 */
 AFAPI array regions(const array& in, const af::connectivity connectivity=AF_CONNECTIVITY_4, const dtype type=f32);
 
+/**
+    C++ Interface for getting regions in an image along with their statistics
+
+    The statistics are gathered while labelling, without another pass over
+    the labels. Row i of the statistics describes the region with label i+1.
+
+    \param[out] area is a \ref u32 array with the number of pixels of each region
+    \param[out] bbox is a \ref u32 array with the smallest coordinates of each region
+                along every dimension, followed by the largest ones. It has 4 columns
+                for 2d connectivity and 6 for 3d connectivity.
+    \param[out] centroid is a \ref f32 array with the mean coordinates of each region,
+                one column per dimension
+    \param[in]  in array should be binary image of type \ref b8
+    \param[in]  connectivity can take one of the following [\ref AF_CONNECTIVITY_4 | \ref AF_CONNECTIVITY_8 | \ref AF_CONNECTIVITY_6 | \ref AF_CONNECTIVITY_26]
+    \param[in]  type is type of output array
+    \return     returns array with labels indicating different regions
+
+    \note When the slices of a 3d \p in are labelled on their own, the statistics of
+          slice k are in slice k of the outputs, padded with zeros.
+    \note Only supported by the CPU backend.
+
+    \ingroup image_func_regions
+*/
+AFAPI array regionsStats(array &area, array &bbox, array &centroid, const array& in,
+                         const af::connectivity connectivity=AF_CONNECTIVITY_4, const dtype type=f32);
+
 /**
    C++ Interface for image template matching
 
@@ -642,6 +709,27 @@ extern "C" {
      */
     AFAPI af_err af_histogram(af_array *out, const af_array in, const unsigned nbins, const double minval, const double maxval);
 
+    /**
+       C Interface for weighted histogram
+
+       \param[out] out is the histogram for input array in, with the sum of
+                   the weights of the values in each bin
+       \param[in]  in is the input array
+       \param[in]  weights has the dimensions of \p in and is of type f32 or f64,
+                   which is also the type of \p out
+       \param[in]  nbins  Number of bins to populate between min and max
+       \param[in]  minval minimum bin value (accumulates -inf to min)
+       \param[in]  maxval maximum bin value (accumulates max to +inf)
+       \return     \ref AF_SUCCESS if the histogram is successfully created,
+       otherwise an appropriate error code is returned.
+
+       \note Weighted histograms are currently only supported by the CPU backend
+
+       \ingroup image_func_histogram
+     */
+    AFAPI af_err af_histogram_weighted(af_array *out, const af_array in, const af_array weights,
+                                       const unsigned nbins, const double minval, const double maxval);
+
     /**
         C Interface for image dilation (max filter)
 
@@ -713,6 +801,26 @@ extern "C" {
     */
     AFAPI af_err af_bilateral(af_array *out, const af_array in, const float spatial_sigma, const float chromatic_sigma, const bool isColor);
 
+    /**
+        C Interface for approximate bilateral filter
+
+        Approximates \ref af_bilateral on a downsampled bilateral grid. The cost
+        does not depend on \p spatial_sigma, which is not limited in size.
+
+        \param[out] out array is the processed image
+        \param[in]  in array is the input image
+        \param[in]  spatial_sigma is the spatial variance paramter
+        \param[in]  chromatic_sigma is the chromatic variance paramter
+        \param[in]  isColor indicates if the input \p in is color image or grayscale
+        \return     \ref AF_SUCCESS if the filter is applied successfully,
+        otherwise an appropriate error code is returned.
+
+        \note Only supported by the CPU backend
+
+        \ingroup image_func_bilateral
+    */
+    AFAPI af_err af_bilateral_approx(af_array *out, const af_array in, const float spatial_sigma, const float chromatic_sigma, const bool isColor);
+
     /**
         C Interface for mean shift
 
@@ -782,7 +890,7 @@ extern "C" {
 
         \param[out] out array will have labels indicating different regions
         \param[in]  in array should be binary image of type \ref b8
-        \param[in]  connectivity can take one of the following [\ref AF_CONNECTIVITY_4 | \ref AF_CONNECTIVITY_8]
+        \param[in]  connectivity can take one of the following [\ref AF_CONNECTIVITY_4 | \ref AF_CONNECTIVITY_8 | \ref AF_CONNECTIVITY_6 | \ref AF_CONNECTIVITY_26]
         \param[in]  ty is type of output array
         \return     \ref AF_SUCCESS if the regions are identified successfully,
         otherwise an appropriate error code is returned.
@@ -791,6 +899,26 @@ extern "C" {
     */
     AFAPI af_err af_regions(af_array *out, const af_array in, const af_connectivity connectivity, const af_dtype ty);
 
+    /**
+        C Interface for regions in an image along with their statistics
+
+        \param[out] out array will have labels indicating different regions
+        \param[out] area is a \ref u32 array with the number of pixels of each region
+        \param[out] bbox is a \ref u32 array with the smallest and largest coordinates of each region
+        \param[out] centroid is a \ref f32 array with the mean coordinates of each region
+        \param[in]  in array should be binary image of type \ref b8
+        \param[in]  connectivity can take one of the following [\ref AF_CONNECTIVITY_4 | \ref AF_CONNECTIVITY_8 | \ref AF_CONNECTIVITY_6 | \ref AF_CONNECTIVITY_26]
+        \param[in]  ty is type of output array
+        \return     \ref AF_SUCCESS if the regions are identified successfully,
+        otherwise an appropriate error code is returned.
+
+        \note Only supported by the CPU backend.
+
+        \ingroup image_func_regions
+    */
+    AFAPI af_err af_regions_stats(af_array *out, af_array *area, af_array *bbox, af_array *centroid,
+                                  const af_array in, const af_connectivity connectivity, const af_dtype ty);
+
     /**
        C Interface for image template matching
 
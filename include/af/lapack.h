@@ -105,6 +105,7 @@ namespace af
        \returns \p 0 if cholesky decomposition passes. If not returns the rank at which the decomposition failed.
 
        \note The input matrix **has** to be a positive definite matrix. If it is not zero, the cholesky decomposition functions return a non zero output.
+       \note On the CPU backend, \p in can be a stack of matrices along dimensions 2 and 3. Every matrix is factored and the result of the first one that fails is returned.
        \note This function is not supported in GFOR
 
        \ingroup lapack_factor_func_cholesky
@@ -120,6 +121,7 @@ namespace af
        \returns \p 0 if cholesky decomposition passes. If not returns the rank at which the decomposition failed.
 
        \note The input matrix **has** to be a positive definite matrix. If it is not zero, the cholesky decomposition functions return a non zero output.
+       \note On the CPU backend, \p in can be a stack of matrices along dimensions 2 and 3. Every matrix is factored and the result of the first one that fails is returned.
        \note This function is not supported in GFOR
 
        \ingroup lapack_factor_func_cholesky
@@ -135,6 +137,8 @@ namespace af
        \returns \p x, the matrix of unknown variables
 
        \note \p options needs to be one of \ref AF_MAT_NONE, \ref AF_MAT_LOWER or \ref AF_MAT_UPPER
+       \note On the CPU backend, \p a and \p b can be stacks of matrices along dimensions 2 and 3. Every system is solved and \p x is stacked the same way.
+       \note On the CPU backend, the solution of a square system of a stack with a singular matrix is NaN.
        \note This function is not supported in GFOR
 
        \ingroup lapack_solve_func_gen
@@ -167,6 +171,8 @@ namespace af
        \returns \p x, the inverse of the input matrix
 
        \note \p options currently needs to be \ref AF_MAT_NONE
+       \note On the CPU backend, \p in can be a stack of matrices along dimensions 2 and 3. Every matrix is inverted and the result is stacked the same way.
+       \note On the CPU backend, the inverse of a singular matrix of a stack is NaN.
        \note This function is not supported in GFOR
 
        \ingroup lapack_ops_func_inv
@@ -271,6 +277,7 @@ extern "C" {
        \param[in] is_upper a boolean determining if \p out is upper or lower triangular
 
        \note The input matrix **has** to be a positive definite matrix. If it is not zero, the cholesky decomposition functions return a non zero output.
+       \note On the CPU backend, \p in can be a stack of matrices along dimensions 2 and 3. Every matrix is factored and the result of the first one that fails is returned.
 
        \ingroup lapack_factor_func_cholesky
     */
@@ -284,6 +291,7 @@ extern "C" {
        \param[in] is_upper a boolean determining if \p in is upper or lower triangular
 
        \note The input matrix **has** to be a positive definite matrix. If it is not zero, the cholesky decomposition functions return a non zero output.
+       \note On the CPU backend, \p in can be a stack of matrices along dimensions 2 and 3. Every matrix is factored and the result of the first one that fails is returned.
 
        \ingroup lapack_factor_func_cholesky
     */
@@ -300,6 +308,8 @@ extern "C" {
        \ingroup lapack_solve_func_gen
 
        \note \p options needs to be one of \ref AF_MAT_NONE, \ref AF_MAT_LOWER or \ref AF_MAT_UPPER
+       \note On the CPU backend, \p a and \p b can be stacks of matrices along dimensions 2 and 3. Every system is solved and \p x is stacked the same way.
+       \note On the CPU backend, the solution of a square system of a stack with a singular matrix is NaN.
     */
     AFAPI af_err af_solve(af_array *x, const af_array a, const af_array b,
                           const af_mat_prop options);
@@ -331,6 +341,8 @@ extern "C" {
        \ingroup lapack_ops_func_inv
 
        \note currently options needs to be \ref AF_MAT_NONE
+       \note On the CPU backend, \p in can be a stack of matrices along dimensions 2 and 3. Every matrix is inverted and the result is stacked the same way.
+       \note On the CPU backend, the inverse of a singular matrix of a stack is NaN.
     */
     AFAPI af_err af_inverse(af_array *out, const af_array in, const af_mat_prop options);
 
@@ -255,6 +255,89 @@ AFAPI array ifft2(const array& in, const dim_t odim0=0, const dim_t odim1=0);
  */
 AFAPI array ifft3(const array& in, const dim_t odim0=0, const dim_t odim1=0, const dim_t odim2=0);
 
+/**
+   C++ Interface for real to complex fast fourier transform on one dimensional data
+
+   \param[in]  in is the real input array
+   \param[in]  odim0 is the length of the transform - used to either truncate/pad the input
+   \return     the first odim0 / 2 + 1 elements of the transform along the first dimension
+
+   \ingroup signal_func_fft_r2c
+ */
+AFAPI array fftR2C(const array& in, const dim_t odim0=0);
+
+/**
+   C++ Interface for real to complex fast fourier transform on two dimensional data
+
+   \param[in]  in is the real input array
+   \param[in]  odim0 is the length of the transform along 0th dimension - used to either truncate/pad the input
+   \param[in]  odim1 is the length of the transform along 1st dimension - used to either truncate/pad the input
+   \return     the first odim0 / 2 + 1 elements of the transform along the first dimension
+
+   \ingroup signal_func_fft_r2c
+ */
+AFAPI array fft2R2C(const array& in, const dim_t odim0=0, const dim_t odim1=0);
+
+/**
+   C++ Interface for real to complex fast fourier transform on three dimensional data
+
+   \param[in]  in is the real input array
+   \param[in]  odim0 is the length of the transform along 0th dimension - used to either truncate/pad the input
+   \param[in]  odim1 is the length of the transform along 1st dimension - used to either truncate/pad the input
+   \param[in]  odim2 is the length of the transform along 2nd dimension - used to either truncate/pad the input
+   \return     the first odim0 / 2 + 1 elements of the transform along the first dimension
+
+   \ingroup signal_func_fft_r2c
+ */
+AFAPI array fft3R2C(const array& in, const dim_t odim0=0, const dim_t odim1=0, const dim_t odim2=0);
+
+/**
+   C++ Interface for complex to real inverse fast fourier transform on one dimensional data
+
+   \param[in]  in is the non redundant half of the spectrum
+   \param[in]  is_odd is true if the length of the output is odd
+   \return     the normalized real transform
+
+   \ingroup signal_func_fft_c2r
+ */
+AFAPI array fftC2R(const array& in, const bool is_odd=false);
+
+/**
+   C++ Interface for complex to real inverse fast fourier transform on two dimensional data
+
+   \param[in]  in is the non redundant half of the spectrum
+   \param[in]  is_odd is true if the length of the output along the first dimension is odd
+   \return     the normalized real transform
+
+   \ingroup signal_func_fft_c2r
+ */
+AFAPI array fft2C2R(const array& in, const bool is_odd=false);
+
+/**
+   C++ Interface for complex to real inverse fast fourier transform on three dimensional data
+
+   \param[in]  in is the non redundant half of the spectrum
+   \param[in]  is_odd is true if the length of the output along the first dimension is odd
+   \return     the normalized real transform
+
+   \ingroup signal_func_fft_c2r
+ */
+AFAPI array fft3C2R(const array& in, const bool is_odd=false);
+
+/**
+   C++ Interface for setting the number of cached fft plans
+
+   Creating a plan is the expensive part of an fft on the CPU backend. Plans of
+   the most recently used transform shapes are kept and reused.
+
+   \param[in] num_plans is the number of plans to keep, 0 disables the cache
+
+   \note The CUDA and OpenCL backends keep a fixed number of plans
+
+   \ingroup signal_func_fft
+*/
+AFAPI void setFFTPlanCacheSize(size_t num_plans);
+
 /**
    C++ Interface for inverse fast fourier transform on any(1d, 2d, 3d) dimensional data
 
@@ -312,7 +395,7 @@ AFAPI array idft(const array& in);
    \param[in]  domain specifies if the convolution should be performed in frequency os spatial domain
    \return     the convolved array
 
-   \note The default paramter of \p domain, \ref AF_CONV_AUTO, heuristically switches between frequency and spatial domain.
+   \note The default paramter of \p domain, \ref AF_CONV_AUTO, heuristically switches between frequency and spatial domain. On the CPU backend, it stays in the spatial domain and splits rank one filters into a column and a row filter when that is cheaper.
 
    \ingroup signal_func_convolve
  */
@@ -329,7 +412,7 @@ AFAPI array convolve(const array& signal, const array& filter, const convMode mo
    \param[in]  mode indicates if the convolution should be expanded or not(where output size equals input).
    \return     the convolved array
 
-   \note The default paramter of \p domain, \ref AF_CONV_AUTO, heuristically switches between frequency and spatial domain.
+   \note The default paramter of \p domain, \ref AF_CONV_AUTO, heuristically switches between frequency and spatial domain. On the CPU backend, it stays in the spatial domain.
 
    \note Separable convolution only supports two(ONE-to-ONE and MANY-to-ONE) batch modes from the ones described in the detailed description section.
 
@@ -348,7 +431,7 @@ AFAPI array convolve(const array& col_filter, const array& row_filter, const arr
    \param[in]  domain specifies if the convolution should be performed in frequency os spatial domain
    \return     the convolved array
 
-   \note The default paramter of \p domain, \ref AF_CONV_AUTO, heuristically switches between frequency and spatial domain.
+   \note The default paramter of \p domain, \ref AF_CONV_AUTO, heuristically switches between frequency and spatial domain. On the CPU backend, it stays in the spatial domain.
 
    \ingroup signal_func_convolve1
  */
@@ -365,7 +448,7 @@ AFAPI array convolve1(const array& signal, const array& filter, const convMode m
    \param[in]  domain specifies if the convolution should be performed in frequency os spatial domain
    \return     the convolved array
 
-   \note The default paramter of \p domain, \ref AF_CONV_AUTO, heuristically switches between frequency and spatial domain.
+   \note The default paramter of \p domain, \ref AF_CONV_AUTO, heuristically switches between frequency and spatial domain. On the CPU backend, it stays in the spatial domain and splits rank one filters into a column and a row filter when that is cheaper.
 
    \ingroup signal_func_convolve2
  */
@@ -382,7 +465,7 @@ AFAPI array convolve2(const array& signal, const array& filter, const convMode m
    \param[in]  domain specifies if the convolution should be performed in frequency os spatial domain
    \return     the convolved array
 
-   \note The default paramter of \p domain, \ref AF_CONV_AUTO, heuristically switches between frequency and spatial domain.
+   \note The default paramter of \p domain, \ref AF_CONV_AUTO, heuristically switches between frequency and spatial domain. On the CPU backend, it stays in the spatial domain.
 
    \ingroup signal_func_convolve3
  */
@@ -593,6 +676,104 @@ AFAPI af_err af_ifft2(af_array *out, const af_array in, const double norm_factor
  */
 AFAPI af_err af_ifft3(af_array *out, const af_array in, const double norm_factor, const dim_t odim0, const dim_t odim1, const dim_t odim2);
 
+/**
+   C Interface for real to complex fast fourier transform on one dimensional data
+
+   \param[out] out is the first odim0 / 2 + 1 elements of the transform along the first dimension
+   \param[in]  in is the real input array
+   \param[in]  norm_factor is the normalization factor with which the input is scaled before the transformation is applied
+   \param[in]  odim0 is the length of the transform - used to either truncate/pad the input
+   \return     \ref AF_SUCCESS if the fft transform is successful,
+               otherwise an appropriate error code is returned.
+
+   \ingroup signal_func_fft_r2c
+ */
+AFAPI af_err af_fft_r2c(af_array *out, const af_array in, const double norm_factor, const dim_t odim0);
+
+/**
+   C Interface for real to complex fast fourier transform on two dimensional data
+
+   \param[out] out is the first odim0 / 2 + 1 elements of the transform along the first dimension
+   \param[in]  in is the real input array
+   \param[in]  norm_factor is the normalization factor with which the input is scaled before the transformation is applied
+   \param[in]  odim0 is the length of the transform along 0th dimension - used to either truncate/pad the input
+   \param[in]  odim1 is the length of the transform along 1st dimension - used to either truncate/pad the input
+   \return     \ref AF_SUCCESS if the fft transform is successful,
+               otherwise an appropriate error code is returned.
+
+   \ingroup signal_func_fft_r2c
+ */
+AFAPI af_err af_fft2_r2c(af_array *out, const af_array in, const double norm_factor, const dim_t odim0, const dim_t odim1);
+
+/**
+   C Interface for real to complex fast fourier transform on three dimensional data
+
+   \param[out] out is the first odim0 / 2 + 1 elements of the transform along the first dimension
+   \param[in]  in is the real input array
+   \param[in]  norm_factor is the normalization factor with which the input is scaled before the transformation is applied
+   \param[in]  odim0 is the length of the transform along 0th dimension - used to either truncate/pad the input
+   \param[in]  odim1 is the length of the transform along 1st dimension - used to either truncate/pad the input
+   \param[in]  odim2 is the length of the transform along 2nd dimension - used to either truncate/pad the input
+   \return     \ref AF_SUCCESS if the fft transform is successful,
+               otherwise an appropriate error code is returned.
+
+   \ingroup signal_func_fft_r2c
+ */
+AFAPI af_err af_fft3_r2c(af_array *out, const af_array in, const double norm_factor, const dim_t odim0, const dim_t odim1, const dim_t odim2);
+
+/**
+   C Interface for complex to real inverse fast fourier transform on one dimensional data
+
+   \param[out] out is the real transform
+   \param[in]  in is the non redundant half of the spectrum
+   \param[in]  norm_factor is the normalization factor with which the input is scaled before the transformation is applied
+   \param[in]  is_odd is true if the length of the output is odd
+   \return     \ref AF_SUCCESS if the fft transform is successful,
+               otherwise an appropriate error code is returned.
+
+   \ingroup signal_func_fft_c2r
+ */
+AFAPI af_err af_fft_c2r(af_array *out, const af_array in, const double norm_factor, const bool is_odd);
+
+/**
+   C Interface for complex to real inverse fast fourier transform on two dimensional data
+
+   \param[out] out is the real transform
+   \param[in]  in is the non redundant half of the spectrum
+   \param[in]  norm_factor is the normalization factor with which the input is scaled before the transformation is applied
+   \param[in]  is_odd is true if the length of the output along the first dimension is odd
+   \return     \ref AF_SUCCESS if the fft transform is successful,
+               otherwise an appropriate error code is returned.
+
+   \ingroup signal_func_fft_c2r
+ */
+AFAPI af_err af_fft2_c2r(af_array *out, const af_array in, const double norm_factor, const bool is_odd);
+
+/**
+   C Interface for complex to real inverse fast fourier transform on three dimensional data
+
+   \param[out] out is the real transform
+   \param[in]  in is the non redundant half of the spectrum
+   \param[in]  norm_factor is the normalization factor with which the input is scaled before the transformation is applied
+   \param[in]  is_odd is true if the length of the output along the first dimension is odd
+   \return     \ref AF_SUCCESS if the fft transform is successful,
+               otherwise an appropriate error code is returned.
+
+   \ingroup signal_func_fft_c2r
+ */
+AFAPI af_err af_fft3_c2r(af_array *out, const af_array in, const double norm_factor, const bool is_odd);
+
+/**
+   C Interface for setting the number of cached fft plans
+
+   \param[in] num_plans is the number of plans to keep, 0 disables the cache
+   \return    \ref AF_SUCCESS if the cache size was set,
+               otherwise an appropriate error code is returned.
+
+   \ingroup signal_func_fft
+*/
+AFAPI af_err af_set_fft_plan_cache_size(size_t num_plans);
+
 /**
    C Interface for convolution on one dimensional data
 
@@ -604,7 +785,7 @@ AFAPI af_err af_ifft3(af_array *out, const af_array in, const double norm_factor
    \return     \ref AF_SUCCESS if the convolution is successful,
                otherwise an appropriate error code is returned.
 
-   \note The default paramter of \p domain, \ref AF_CONV_AUTO, heuristically switches between frequency and spatial domain.
+   \note The default paramter of \p domain, \ref AF_CONV_AUTO, heuristically switches between frequency and spatial domain. On the CPU backend, it stays in the spatial domain.
 
    \ingroup signal_func_convolve1
  */
@@ -621,7 +802,7 @@ AFAPI af_err af_convolve1(af_array *out, const af_array signal, const af_array f
    \return     \ref AF_SUCCESS if the convolution is successful,
                otherwise an appropriate error code is returned.
 
-   \note The default paramter of \p domain, \ref AF_CONV_AUTO, heuristically switches between frequency and spatial domain.
+   \note The default paramter of \p domain, \ref AF_CONV_AUTO, heuristically switches between frequency and spatial domain. On the CPU backend, it stays in the spatial domain and splits rank one filters into a column and a row filter when that is cheaper.
 
    \ingroup signal_func_convolve2
  */
@@ -638,7 +819,7 @@ AFAPI af_err af_convolve2(af_array *out, const af_array signal, const af_array f
    \return     \ref AF_SUCCESS if the convolution is successful,
                otherwise an appropriate error code is returned.
 
-   \note The default paramter of \p domain, \ref AF_CONV_AUTO, heuristically switches between frequency and spatial domain.
+   \note The default paramter of \p domain, \ref AF_CONV_AUTO, heuristically switches between frequency and spatial domain. On the CPU backend, it stays in the spatial domain.
 
    \ingroup signal_func_convolve3
  */
@@ -106,6 +106,7 @@ AFAPI array cov(const array& X, const array& Y, const bool isbiased=false);
    \ingroup stat_func_median
 
    \note \p dim is -1 by default. -1 denotes the first non-signleton dimension.
+   \note The median of an empty column is NaN.
 */
 AFAPI array median(const array& in, const dim_t dim=-1);
 
@@ -171,7 +172,7 @@ AFAPI T stdev(const array& in);
    C++ Interface for median of all elements
 
    \param[in] in is the input array
-   \return    median of the entire input array
+   \return    median of the entire input array, NaN when it is empty
 
    \ingroup stat_func_median
 */
@@ -294,6 +295,8 @@ AFAPI af_err af_cov(af_array* out, const af_array X, const af_array Y, const boo
    otherwise an appropriate error code is returned.
 
    \ingroup stat_func_median
+
+   \note The median of an empty column is NaN.
 */
 AFAPI af_err af_median(af_array* out, const af_array in, const dim_t dim);
 
@@ -376,6 +379,8 @@ AFAPI af_err af_stdev_all(double *real, double *imag, const af_array in);
    otherwise an appropriate error code is returned.
 
    \ingroup stat_func_median
+
+   \note \p realVal is NaN when \p in is empty.
 */
 AFAPI af_err af_median_all(double *realVal, double *imagVal, const af_array in);
 
@@ -0,0 +1,7 @@
+#pragma once
+
+#define AF_VERSION "3.0.beta"
+#define AF_VERSION_MAJOR "3"
+#define AF_VERSION_MINOR "0"
+#define AF_VERSION_PATCH "beta"
+#define AF_REVISION "25b3cfe"
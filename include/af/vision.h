@@ -81,8 +81,8 @@ AFAPI void orb(features& feat, array& desc, const array& image, const float fast
    \param[in]  train is the array containing the data stored as training data
    \param[in]  dist_dim indicates the dimension to analyze for distance (the dimension
                indicated here must be of equal length for both query and train arrays)
-   \param[in]  n_dist is the number of smallest distances to return (currently, only 1
-               is supported)
+   \param[in]  n_dist is the number of smallest distances to return. The CUDA and
+               OpenCL backends currently support only 1.
 
    \ingroup cv_func_hamming_matcher
  */
@@ -164,8 +164,8 @@ extern "C" {
        \param[in]  train is the array containing the data stored as training data
        \param[in]  dist_dim indicates the dimension to analyze for distance (the dimension
                    indicated here must be of equal length for both query and train arrays)
-       \param[in]  n_dist is the number of smallest distances to return (currently, only 1
-                   is supported)
+       \param[in]  n_dist is the number of smallest distances to return. The CUDA and
+                   OpenCL backends currently support only 1.
 
        \ingroup cv_func_hamming_matcher
     */
@@ -18,13 +18,16 @@
 using af::dim4;
 using namespace detail;
 
-template<typename inType, typename outType, bool isColor>
+template<typename inType, typename outType, bool isColor, bool isApprox>
 static inline af_array bilateral(const af_array &in, const float &sp_sig, const float &chr_sig)
 {
-    return getHandle(bilateral<inType, outType, isColor>(getArray<inType>(in), sp_sig, chr_sig));
+    if (isApprox)
+        return getHandle(bilateralGrid<inType, outType>(getArray<inType>(in), sp_sig, chr_sig));
+    else
+        return getHandle(bilateral<inType, outType, isColor>(getArray<inType>(in), sp_sig, chr_sig));
 }
 
-template<bool isColor>
+template<bool isColor, bool isApprox>
 static af_err bilateral(af_array *out, const af_array &in, const float &s_sigma, const float &c_sigma)
 {
     try {
@@ -36,12 +39,12 @@ static af_err bilateral(af_array *out, const af_array &in, const float &s_sigma,
 
         af_array output;
         switch(type) {
-            case f64: output = bilateral<double, double, isColor> (in, s_sigma, c_sigma); break;
-            case f32: output = bilateral<float ,  float, isColor> (in, s_sigma, c_sigma); break;
-            case b8 : output = bilateral<char  ,  float, isColor> (in, s_sigma, c_sigma); break;
-            case s32: output = bilateral<int   ,  float, isColor> (in, s_sigma, c_sigma); break;
-            case u32: output = bilateral<uint  ,  float, isColor> (in, s_sigma, c_sigma); break;
-            case u8 : output = bilateral<uchar ,  float, isColor> (in, s_sigma, c_sigma); break;
+            case f64: output = bilateral<double, double, isColor, isApprox> (in, s_sigma, c_sigma); break;
+            case f32: output = bilateral<float ,  float, isColor, isApprox> (in, s_sigma, c_sigma); break;
+            case b8 : output = bilateral<char  ,  float, isColor, isApprox> (in, s_sigma, c_sigma); break;
+            case s32: output = bilateral<int   ,  float, isColor, isApprox> (in, s_sigma, c_sigma); break;
+            case u32: output = bilateral<uint  ,  float, isColor, isApprox> (in, s_sigma, c_sigma); break;
+            case u8 : output = bilateral<uchar ,  float, isColor, isApprox> (in, s_sigma, c_sigma); break;
             default : TYPE_ERROR(1, type);
         }
         std::swap(*out,output);
@@ -54,7 +57,15 @@ static af_err bilateral(af_array *out, const af_array &in, const float &s_sigma,
 af_err af_bilateral(af_array *out, const af_array in, const float spatial_sigma, const float chromatic_sigma, const bool isColor)
 {
     if (isColor)
-        return bilateral<true>(out,in,spatial_sigma,chromatic_sigma);
+        return bilateral<true , false>(out,in,spatial_sigma,chromatic_sigma);
+    else
+        return bilateral<false, false>(out,in,spatial_sigma,chromatic_sigma);
+}
+
+af_err af_bilateral_approx(af_array *out, const af_array in, const float spatial_sigma, const float chromatic_sigma, const bool isColor)
+{
+    if (isColor)
+        return bilateral<true , true>(out,in,spatial_sigma,chromatic_sigma);
     else
-        return bilateral<false>(out,in,spatial_sigma,chromatic_sigma);
+        return bilateral<false, true>(out,in,spatial_sigma,chromatic_sigma);
 }
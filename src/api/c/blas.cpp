@@ -8,6 +8,7 @@
  ********************************************************/
 
 #include <af/blas.h>
+#include <af/arith.h>
 #include <blas.hpp>
 #include <handle.hpp>
 #include <Array.hpp>
@@ -57,9 +58,11 @@ af_err af_matmul(   af_array *out,
         }
 
 
-        if (lhsInfo.ndims() > 2 ||
-            rhsInfo.ndims() > 2) {
-            AF_ERROR("matmul can not be used in batch mode", AF_ERR_BATCH);
+        // The batch dimensions have to match unless one of them is 1
+        af::dim4 lDims = lhsInfo.dims();
+        af::dim4 rDims = rhsInfo.dims();
+        for (int i = 2; i < 4; i++) {
+            DIM_ASSERT(1, lDims[i] == rDims[i] || lDims[i] == 1 || rDims[i] == 1);
         }
 
         TYPE_ASSERT(lhs_type == rhs_type);
@@ -93,11 +96,11 @@ af_err af_dot(      af_array *out,
         ArrayInfo lhsInfo = getInfo(lhs);
         ArrayInfo rhsInfo = getInfo(rhs);
 
-        if (optLhs != AF_MAT_NONE) {
+        if (optLhs != AF_MAT_NONE && optLhs != AF_MAT_CONJ) {
             AF_ERROR("Using this property is not yet supported in dot", AF_ERR_NOT_SUPPORTED);
         }
 
-        if (optRhs != AF_MAT_NONE) {
+        if (optRhs != AF_MAT_NONE && optRhs != AF_MAT_CONJ) {
             AF_ERROR("Using this property is not yet supported in dot", AF_ERR_NOT_SUPPORTED);
         }
 
@@ -112,15 +115,31 @@ af_err af_dot(      af_array *out,
 
         TYPE_ASSERT(lhs_type == rhs_type);
 
+        // The backends only conjugate the left hand side, so x . conj(y) is
+        // computed as conj(y) . x
+        const bool conjLhs = optLhs == AF_MAT_CONJ;
+        const bool conjRhs = optRhs == AF_MAT_CONJ;
+        const af_array l = (conjRhs && !conjLhs) ? rhs : lhs;
+        const af_array r = (conjRhs && !conjLhs) ? lhs : rhs;
+        const af_mat_prop opt = (conjLhs != conjRhs) ? AF_MAT_CONJ : AF_MAT_NONE;
+
         af_array output = 0;
 
         switch(lhs_type) {
-        case f32: output = dot<float  >(lhs, rhs, optLhs, optRhs);   break;
-            //case c32: output = dot<cfloat >(lhs, rhs, optLhs, optRhs);   break;
-        case f64: output = dot<double >(lhs, rhs, optLhs, optRhs);   break;
-            //case c64: output = dot<cdouble>(lhs, rhs, optLhs, optRhs);   break;
+        case f32: output = dot<float  >(l, r, opt, AF_MAT_NONE);   break;
+        case c32: output = dot<cfloat >(l, r, opt, AF_MAT_NONE);   break;
+        case f64: output = dot<double >(l, r, opt, AF_MAT_NONE);   break;
+        case c64: output = dot<cdouble>(l, r, opt, AF_MAT_NONE);   break;
         default:  TYPE_ERROR(1, lhs_type);
         }
+
+        // conj(x) . conj(y) = conj(x . y)
+        if (conjLhs && conjRhs && (lhs_type == c32 || lhs_type == c64)) {
+            af_array conjugated = 0;
+            AF_CHECK(af_conjg(&conjugated, output));
+            AF_CHECK(af_release_array(output));
+            output = conjugated;
+        }
         std::swap(*out, output);
     }
     CATCHALL
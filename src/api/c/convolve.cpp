@@ -15,8 +15,13 @@
 #include <convolve.hpp>
 #include <fftconvolve.hpp>
 #include <convolve_common.hpp>
+#include <copy.hpp>
+#include <dispatch.hpp>
 
+#include <cmath>
 #include <cstdio>
+#include <limits>
+#include <vector>
 
 using af::dim4;
 using namespace detail;
@@ -132,11 +137,19 @@ af_err convolve2_sep(af_array *out, af_array col_filter, af_array row_filter, co
 }
 
 
-template<int baseDim>
-bool isFreqDomain(const af_array &signal, const af_array filter, af_conv_domain domain)
+// Filters are only checked for rank one on the host up to this many elements
+static const dim_t CONV_MAX_SPLIT_FILTER = 1 << 12;
+
+// Picks the convolution route of the backend for AF_CONV_AUTO. The separable
+// route is only a candidate for real floating point 2D convolutions with
+// filters small enough to be split on the host. Integer signals would keep
+// the intermediate result of the column pass in their own type.
+template<dim_t baseDim>
+static ConvolveRoute pickRoute(const af_array &signal, const af_array filter, const bool expand,
+                               af_conv_domain domain, const bool allowSeparable)
 {
-    if (domain == AF_CONV_FREQ) return true;
-    if (domain != AF_CONV_AUTO) return false;
+    if (domain == AF_CONV_FREQ) return CONV_FREQ_ROUTE;
+    if (domain != AF_CONV_AUTO) return CONV_SPATIAL_ROUTE;
 
     ArrayInfo sInfo = getInfo(signal);
     ArrayInfo fInfo = getInfo(filter);
@@ -144,36 +157,83 @@ bool isFreqDomain(const af_array &signal, const af_array filter, af_conv_domain
     dim4 sdims = sInfo.dims();
     dim4 fdims = fInfo.dims();
 
-    int batch = 1;
-    for(int i = 3; i >= baseDim; i--) {
-        batch *= std::max(fdims[i], sdims[i]);
-    }
+    ConvolveBatchKind kind = identifyBatchKind<baseDim>(sdims, fdims);
+    if (kind == CONVOLVE_UNSUPPORTED_BATCH_MODE) return CONV_SPATIAL_ROUTE;
 
-    if (batch >= 10) return true;
+    const bool isSplittable = allowSeparable && sInfo.isFloating() &&
+                              !sInfo.isComplex() && !fInfo.isComplex() &&
+                              (dim_t)fdims.elements() <= CONV_MAX_SPLIT_FILTER;
 
-    if (baseDim == 1) {
-        if (fdims[0] > 128) return true;
-    }
+    return convolveRoute(baseDim, sdims, fdims, expand, sInfo.isComplex(), isSplittable);
+}
 
-    if (baseDim == 2) {
-        // maximum supported size in 2D domain
-        if (fdims[0] > 17 || fdims[1] > 17) return true;
+// Splits a filter of rank one into the column and row filters whose outer
+// product it is. The row and column through the largest coefficient are
+// taken as the factors, and every coefficient is then checked against them.
+template<typename accT>
+static bool splitFilter(af_array *colFilter, af_array *rowFilter, const af_array filter)
+{
+    const Array<accT> F = castArray<accT>(filter);
+    const dim4 fdims = F.dims();
+    const dim_t nx = fdims[0];
+    const dim_t ny = fdims[1];
+
+    std::vector<accT> h(nx * ny);
+    copyData(&h.front(), F);
 
-        // Maximum supported non square size
-        if (fdims[0] != fdims[1] && fdims[0] > 5) return true;
+    dim_t pivot = 0;
+    for (dim_t i = 1; i < nx * ny; i++) {
+        if (std::abs(h[i]) > std::abs(h[pivot])) pivot = i;
+    }
+    const accT maxval = h[pivot];
+    if (maxval == accT(0)) return false;
+
+    const dim_t p = pivot % nx;
+    const dim_t q = pivot / nx;
+    std::vector<accT> col(nx), row(ny);
+    for (dim_t i = 0; i < nx; i++) col[i] = h[q * nx + i];
+    for (dim_t j = 0; j < ny; j++) row[j] = h[j * nx + p] / maxval;
+
+    const accT tol = std::abs(maxval) * (nx + ny) * 4 * std::numeric_limits<accT>::epsilon();
+    for (dim_t j = 0; j < ny; j++) {
+        for (dim_t i = 0; i < nx; i++) {
+            if (std::abs(h[j * nx + i] - col[i] * row[j]) > tol) return false;
+        }
     }
 
-    if (baseDim == 3) {
-        if (fdims[0] > 5 || fdims[1] > 5 || fdims[2] > 5) return true;
+    *colFilter = getHandle(createHostDataArray<accT>(dim4(nx), &col.front()));
+    *rowFilter = getHandle(createHostDataArray<accT>(dim4(ny), &row.front()));
+    return true;
+}
+
+// Convolves with the factors of filter when it has rank one. Returns false,
+// leaving out alone, otherwise.
+template<bool expand>
+static bool convolve2_split(af_array *out, const af_array signal, const af_array filter)
+{
+    ArrayInfo sInfo = getInfo(signal);
+    ArrayInfo fInfo = getInfo(filter);
+
+    af_array colFilter = 0, rowFilter = 0;
+    bool isSplit = false;
+    if (sInfo.getType() == f64 || fInfo.getType() == f64) {
+        isSplit = sInfo.getType() == f64 && splitFilter<double>(&colFilter, &rowFilter, filter);
+    } else {
+        isSplit = splitFilter<float>(&colFilter, &rowFilter, filter);
     }
+    if (!isSplit) return false;
 
-    return false;
+    af_err err = convolve2_sep<expand>(out, colFilter, rowFilter, signal);
+    AF_CHECK(af_release_array(colFilter));
+    AF_CHECK(af_release_array(rowFilter));
+    AF_CHECK(err);
+    return true;
 }
 
 af_err af_convolve1(af_array *out, const af_array signal, const af_array filter, const af_conv_mode mode, af_conv_domain domain)
 {
     try {
-        if (isFreqDomain<1>(signal, filter, domain))
+        if (pickRoute<1>(signal, filter, mode == AF_CONV_EXPAND, domain, false) == CONV_FREQ_ROUTE)
             return af_fft_convolve1(out, signal, filter, mode);
     } CATCHALL;
 
@@ -186,7 +246,17 @@ af_err af_convolve1(af_array *out, const af_array signal, const af_array filter,
 af_err af_convolve2(af_array *out, const af_array signal, const af_array filter, const af_conv_mode mode, af_conv_domain domain)
 {
     try {
-        if (isFreqDomain<2>(signal, filter, domain))
+        const bool expand = mode == AF_CONV_EXPAND;
+        ConvolveRoute route = pickRoute<2>(signal, filter, expand, domain, true);
+
+        if (route == CONV_SEPARABLE_ROUTE) {
+            bool isSplit = expand ? convolve2_split<true >(out, signal, filter)
+                                  : convolve2_split<false>(out, signal, filter);
+            if (isSplit) return AF_SUCCESS;
+            route = pickRoute<2>(signal, filter, expand, domain, false);
+        }
+
+        if (route == CONV_FREQ_ROUTE)
             return af_fft_convolve2(out, signal, filter, mode);
     } CATCHALL;
 
@@ -199,7 +269,7 @@ af_err af_convolve2(af_array *out, const af_array signal, const af_array filter,
 af_err af_convolve3(af_array *out, const af_array signal, const af_array filter, const af_conv_mode mode, af_conv_domain domain)
 {
     try {
-        if (isFreqDomain<3>(signal, filter, domain))
+        if (pickRoute<3>(signal, filter, mode == AF_CONV_EXPAND, domain, false) == CONV_FREQ_ROUTE)
             return af_fft_convolve3(out, signal, filter, mode);
     } CATCHALL;
 
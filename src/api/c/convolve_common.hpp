@@ -16,3 +16,9 @@ typedef enum {
     MANY2MANY,          /* many signal, many filter */
     ONE2MANY            /* one signal, many filter  */
 } ConvolveBatchKind;
+
+typedef enum {
+    CONV_SPATIAL_ROUTE,   /* spatial kernels of the backend        */
+    CONV_SEPARABLE_ROUTE, /* separable kernels, rank one filters   */
+    CONV_FREQ_ROUTE       /* FFT convolution                       */
+} ConvolveRoute;
@@ -8,6 +8,8 @@
  ********************************************************/
 
 #include <complex>
+#include <algorithm>
+#include <vector>
 #include <af/dim4.hpp>
 #include <af/array.h>
 #include <af/data.h>
@@ -327,6 +329,22 @@ af_err af_get_seed(uintl *seed)
     return AF_SUCCESS;
 }
 
+af_err af_set_random_counter(const uintl counter)
+{
+    try {
+        setRandomCounter(counter);
+    } CATCHALL;
+    return AF_SUCCESS;
+}
+
+af_err af_get_random_counter(uintl *counter)
+{
+    try {
+        *counter = getRandomCounter();
+    } CATCHALL;
+    return AF_SUCCESS;
+}
+
 af_err af_identity(af_array *out, const unsigned ndims, const dim_t * const dims, const af_dtype type)
 {
     try {
@@ -570,6 +588,54 @@ af_err af_eval(af_array arr)
     return AF_SUCCESS;
 }
 
+template<typename T>
+static inline void evalMultiple(int num, af_array *arrays, af_dtype type)
+{
+    vector<Array<T> *> arrs;
+    for (int i = 0; i < num; i++) {
+        if (getInfo(arrays[i]).getType() == type) {
+            arrs.push_back(&getWritableArray<T>(arrays[i]));
+        }
+    }
+    evalMultiple<T>(arrs);
+}
+
+af_err af_eval_multiple(int num, af_array *arrays)
+{
+    try {
+        ARG_ASSERT(0, num >= 0);
+        ARG_ASSERT(1, num == 0 || arrays != NULL);
+
+        // Arrays of the same type are evaluated together
+        vector<af_dtype> types;
+        for (int i = 0; i < num; i++) {
+            af_dtype type = getInfo(arrays[i]).getType();
+            if (std::find(types.begin(), types.end(), type) == types.end()) {
+                types.push_back(type);
+            }
+        }
+
+        for (size_t i = 0; i < types.size(); i++) {
+            switch (types[i]) {
+            case f32: evalMultiple<float  >(num, arrays, types[i]); break;
+            case f64: evalMultiple<double >(num, arrays, types[i]); break;
+            case c32: evalMultiple<cfloat >(num, arrays, types[i]); break;
+            case c64: evalMultiple<cdouble>(num, arrays, types[i]); break;
+            case s32: evalMultiple<int    >(num, arrays, types[i]); break;
+            case u32: evalMultiple<uint   >(num, arrays, types[i]); break;
+            case u8 : evalMultiple<uchar  >(num, arrays, types[i]); break;
+            case b8 : evalMultiple<char   >(num, arrays, types[i]); break;
+            case s64: evalMultiple<intl   >(num, arrays, types[i]); break;
+            case u64: evalMultiple<uintl  >(num, arrays, types[i]); break;
+            default:
+                TYPE_ERROR(1, types[i]);
+            }
+        }
+    } CATCHALL;
+
+    return AF_SUCCESS;
+}
+
 template<typename T>
 static inline af_array diagCreate(const af_array in, const int num)
 {
@@ -202,3 +202,36 @@ af_err af_device_mem_info(size_t *alloc_bytes, size_t *alloc_buffers,
     } CATCHALL;
     return AF_SUCCESS;
 }
+
+af_err af_device_set_mem_limit(const size_t bytes)
+{
+    try {
+        setMemoryLimit(bytes);
+    } CATCHALL;
+    return AF_SUCCESS;
+}
+
+af_err af_device_get_mem_limit(size_t *bytes)
+{
+    try {
+        *bytes = getMemoryLimit();
+    } CATCHALL;
+    return AF_SUCCESS;
+}
+
+af_err af_set_num_threads(const int nthreads)
+{
+    try {
+        ARG_ASSERT(0, nthreads >= 0);
+        setNumThreads(nthreads);
+    } CATCHALL;
+    return AF_SUCCESS;
+}
+
+af_err af_get_num_threads(int *nthreads)
+{
+    try {
+        *nthreads = getNumThreads();
+    } CATCHALL;
+    return AF_SUCCESS;
+}
@@ -113,3 +113,95 @@ af_err af_ifft3(af_array *out, const af_array in, const double norm_factor, cons
     const dim_t pad[3] = {pad0, pad1, pad2};
     return ifft<3>(out, in, norm_factor, (pad0>0&&pad1>0&&pad2>0?3:0), pad);
 }
+
+template<int rank>
+static af_err fft_r2c(af_array *out, const af_array in, const double norm_factor, const dim_t npad, const dim_t * const pad)
+{
+    try {
+        ArrayInfo info = getInfo(in);
+        af_dtype type  = info.getType();
+        af::dim4 dims  = info.dims();
+
+        DIM_ASSERT(1, (dims.ndims()>=rank));
+
+        af_array output;
+        switch(type) {
+            case f32: output = getHandle(fft_r2c<float , cfloat , rank>(getArray<float >(in), norm_factor, npad, pad)); break;
+            case f64: output = getHandle(fft_r2c<double, cdouble, rank>(getArray<double>(in), norm_factor, npad, pad)); break;
+            default: TYPE_ERROR(1, type);
+        }
+        std::swap(*out,output);
+    }
+    CATCHALL;
+
+    return AF_SUCCESS;
+}
+
+template<int rank>
+static af_err fft_c2r(af_array *out, const af_array in, const double norm_factor, const bool is_odd)
+{
+    try {
+        ArrayInfo info = getInfo(in);
+        af_dtype type  = info.getType();
+        af::dim4 idims = info.dims();
+
+        DIM_ASSERT(1, (idims.ndims()>=rank));
+
+        // The input holds the first n / 2 + 1 elements of the spectrum
+        dim4 odims = idims;
+        odims[0] = 2 * (idims[0] - 1) + (is_odd ? 1 : 0);
+        DIM_ASSERT(1, odims[0] > 0);
+
+        af_array output;
+        switch(type) {
+            case c32: output = getHandle(fft_c2r<cfloat , float , rank>(getArray<cfloat >(in), norm_factor, odims)); break;
+            case c64: output = getHandle(fft_c2r<cdouble, double, rank>(getArray<cdouble>(in), norm_factor, odims)); break;
+            default: TYPE_ERROR(1, type);
+        }
+        std::swap(*out,output);
+    }
+    CATCHALL;
+
+    return AF_SUCCESS;
+}
+
+af_err af_fft_r2c(af_array *out, const af_array in, const double norm_factor, const dim_t pad0)
+{
+    const dim_t pad[1] = {pad0};
+    return fft_r2c<1>(out, in, norm_factor, (pad0>0?1:0), pad);
+}
+
+af_err af_fft2_r2c(af_array *out, const af_array in, const double norm_factor, const dim_t pad0, const dim_t pad1)
+{
+    const dim_t pad[2] = {pad0, pad1};
+    return fft_r2c<2>(out, in, norm_factor, (pad0>0&&pad1>0?2:0), pad);
+}
+
+af_err af_fft3_r2c(af_array *out, const af_array in, const double norm_factor, const dim_t pad0, const dim_t pad1, const dim_t pad2)
+{
+    const dim_t pad[3] = {pad0, pad1, pad2};
+    return fft_r2c<3>(out, in, norm_factor, (pad0>0&&pad1>0&&pad2>0?3:0), pad);
+}
+
+af_err af_fft_c2r(af_array *out, const af_array in, const double norm_factor, const bool is_odd)
+{
+    return fft_c2r<1>(out, in, norm_factor, is_odd);
+}
+
+af_err af_fft2_c2r(af_array *out, const af_array in, const double norm_factor, const bool is_odd)
+{
+    return fft_c2r<2>(out, in, norm_factor, is_odd);
+}
+
+af_err af_fft3_c2r(af_array *out, const af_array in, const double norm_factor, const bool is_odd)
+{
+    return fft_c2r<3>(out, in, norm_factor, is_odd);
+}
+
+af_err af_set_fft_plan_cache_size(size_t num_plans)
+{
+    try {
+        setFFTPlanCacheSize(num_plans);
+    } CATCHALL;
+    return AF_SUCCESS;
+}
@@ -15,6 +15,7 @@
 #include <err_common.hpp>
 #include <backend.hpp>
 #include <medfilt.hpp>
+#include <morph.hpp>
 
 using af::dim4;
 using namespace detail;
@@ -65,14 +66,21 @@ af_err af_medfilt(af_array *out, const af_array in, const dim_t wind_length, con
     return AF_SUCCESS;
 }
 
-af_err af_minfilt(af_array *out, const af_array in, const dim_t wind_length,
-                  const dim_t wind_width, const af_border_type edge_pad)
+template<typename T, bool isDilation>
+static af_array minmaxfilt(af_array const &in, dim_t w_len, dim_t w_wid, af_border_type edge_pad)
+{
+    return getHandle<T>(morphRect<T, isDilation>(getArray<T>(in), w_len, w_wid, edge_pad));
+}
+
+template<bool isDilation>
+static af_err minmaxfilt(af_array *out, const af_array in, const dim_t wind_length,
+                         const dim_t wind_width, const af_border_type edge_pad)
 {
     try {
         ARG_ASSERT(2, (wind_length==wind_width));
         ARG_ASSERT(2, (wind_length>0));
         ARG_ASSERT(3, (wind_width>0));
-        ARG_ASSERT(4, (edge_pad==AF_PAD_ZERO));
+        ARG_ASSERT(4, (edge_pad>=AF_PAD_ZERO && edge_pad<=AF_PAD_SYM));
 
         ArrayInfo info = getInfo(in);
         af::dim4 dims  = info.dims();
@@ -80,43 +88,32 @@ af_err af_minfilt(af_array *out, const af_array in, const dim_t wind_length,
         dim_t input_ndims = dims.ndims();
         DIM_ASSERT(1, (input_ndims >= 2));
 
-        af_array mask;
-        dim_t wdims[] = {wind_length, wind_width};
-        AF_CHECK(af_constant(&mask, 1, 2, wdims, info.getType()));
-
-        AF_CHECK(af_erode(out, in, mask));
-
-        AF_CHECK(af_release_array(mask));
+        af_array output;
+        af_dtype type  = info.getType();
+        switch(type) {
+            case f32: output = minmaxfilt<float , isDilation>(in, wind_length, wind_width, edge_pad); break;
+            case f64: output = minmaxfilt<double, isDilation>(in, wind_length, wind_width, edge_pad); break;
+            case b8 : output = minmaxfilt<char  , isDilation>(in, wind_length, wind_width, edge_pad); break;
+            case s32: output = minmaxfilt<int   , isDilation>(in, wind_length, wind_width, edge_pad); break;
+            case u32: output = minmaxfilt<uint  , isDilation>(in, wind_length, wind_width, edge_pad); break;
+            case u8 : output = minmaxfilt<uchar , isDilation>(in, wind_length, wind_width, edge_pad); break;
+            default : TYPE_ERROR(1, type);
+        }
+        std::swap(*out, output);
     }
     CATCHALL;
 
     return AF_SUCCESS;
 }
 
-af_err af_maxfilt(af_array *out, const af_array in, const dim_t wind_length,
+af_err af_minfilt(af_array *out, const af_array in, const dim_t wind_length,
                   const dim_t wind_width, const af_border_type edge_pad)
 {
-    try {
-        ARG_ASSERT(2, (wind_length==wind_width));
-        ARG_ASSERT(2, (wind_length>0));
-        ARG_ASSERT(3, (wind_width>0));
-        ARG_ASSERT(4, (edge_pad==AF_PAD_ZERO));
-
-        ArrayInfo info = getInfo(in);
-        af::dim4 dims  = info.dims();
-
-        dim_t input_ndims = dims.ndims();
-        DIM_ASSERT(1, (input_ndims >= 2));
-
-        af_array mask;
-        dim_t wdims[] = {wind_length, wind_width};
-        AF_CHECK(af_constant(&mask, 1, 2, wdims, info.getType()));
-
-        AF_CHECK(af_dilate(out, in, mask));
-
-        AF_CHECK(af_release_array(mask));
-    }
-    CATCHALL;
+    return minmaxfilt<false>(out, in, wind_length, wind_width, edge_pad);
+}
 
-    return AF_SUCCESS;
+af_err af_maxfilt(af_array *out, const af_array in, const dim_t wind_length,
+                  const dim_t wind_width, const af_border_type edge_pad)
+{
+    return minmaxfilt<true>(out, in, wind_length, wind_width, edge_pad);
 }
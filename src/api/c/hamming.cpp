@@ -43,6 +43,7 @@ af_err af_hamming_matcher(af_array* idx, af_array* dist, const af_array query, c
         uint train_samples = (dist_dim == 0) ? 1 : 0;
 
         DIM_ASSERT(3, qDims[dist_dim] == tDims[dist_dim]);
+        DIM_ASSERT(3, qDims[dist_dim] > 0);
         DIM_ASSERT(3, qDims[2] == 1 && qDims[3] == 1);
         DIM_ASSERT(3, qType == tType);
         DIM_ASSERT(4, tDims[2] == 1 && tDims[3] == 1);
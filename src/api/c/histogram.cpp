@@ -24,6 +24,29 @@ static inline af_array histogram(const af_array in, const unsigned &nbins,
     return getHandle(histogram<inType,outType>(getArray<inType>(in),nbins,minval,maxval));
 }
 
+template<typename inType,typename outType>
+static inline af_array histogram(const af_array in, const af_array weights, const unsigned &nbins,
+                                 const double &minval, const double &maxval)
+{
+    return getHandle(histogram<inType,outType>(getArray<inType>(in), getArray<outType>(weights),
+                                               nbins, minval, maxval));
+}
+
+template<typename outType>
+static af_array histogram(const af_array in, const af_dtype type, const af_array weights,
+                          const unsigned &nbins, const double &minval, const double &maxval)
+{
+    switch(type) {
+        case f32: return histogram<float , outType>(in, weights, nbins, minval, maxval);
+        case f64: return histogram<double, outType>(in, weights, nbins, minval, maxval);
+        case b8 : return histogram<char  , outType>(in, weights, nbins, minval, maxval);
+        case s32: return histogram<int   , outType>(in, weights, nbins, minval, maxval);
+        case u32: return histogram<uint  , outType>(in, weights, nbins, minval, maxval);
+        case u8 : return histogram<uchar , outType>(in, weights, nbins, minval, maxval);
+        default : TYPE_ERROR(1, type);
+    }
+}
+
 af_err af_histogram(af_array *out, const af_array in,
                     const unsigned nbins, const double minval, const double maxval)
 {
@@ -47,3 +70,27 @@ af_err af_histogram(af_array *out, const af_array in,
 
     return AF_SUCCESS;
 }
+
+af_err af_histogram_weighted(af_array *out, const af_array in, const af_array weights,
+                             const unsigned nbins, const double minval, const double maxval)
+{
+    try {
+        ArrayInfo info  = getInfo(in);
+        ArrayInfo winfo = getInfo(weights);
+        af_dtype type   = info.getType();
+        af_dtype wtype  = winfo.getType();
+
+        DIM_ASSERT(2, info.dims() == winfo.dims());
+
+        af_array output;
+        switch(wtype) {
+            case f32: output = histogram<float >(in, type, weights, nbins, minval, maxval); break;
+            case f64: output = histogram<double>(in, type, weights, nbins, minval, maxval); break;
+            default : TYPE_ERROR(2, wtype);
+        }
+        std::swap(*out,output);
+    }
+    CATCHALL;
+
+    return AF_SUCCESS;
+}
@@ -30,10 +30,6 @@ af_err af_inverse(af_array *out, const af_array in, const af_mat_prop options)
     try {
         ArrayInfo i_info = getInfo(in);
 
-        if (i_info.ndims() > 2) {
-            AF_ERROR("solve can not be used in batch mode", AF_ERR_BATCH);
-        }
-
         af_dtype type = i_info.getType();
 
         if (options != AF_MAT_NONE) {
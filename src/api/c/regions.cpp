@@ -24,21 +24,44 @@ static af_array regions(af_array const &in, af_connectivity connectivity)
     return getHandle<T>(regions<T>(getArray<char>(in), connectivity));
 }
 
-af_err af_regions(af_array *out, const af_array in, const af_connectivity connectivity, const af_dtype type)
+template<typename T>
+static af_array regions(af_array *area, af_array *bbox, af_array *centroid,
+                        af_array const &in, af_connectivity connectivity)
 {
-    try {
-        ARG_ASSERT(2, (connectivity==AF_CONNECTIVITY_4 || connectivity==AF_CONNECTIVITY_8));
+    Array<uint>  areaArray     = createEmptyArray<uint >(dim4());
+    Array<uint>  bboxArray     = createEmptyArray<uint >(dim4());
+    Array<float> centroidArray = createEmptyArray<float>(dim4());
+
+    af_array out = getHandle<T>(regions<T>(areaArray, bboxArray, centroidArray,
+                                           getArray<char>(in), connectivity));
 
-        ArrayInfo info = getInfo(in);
-        af::dim4 dims  = info.dims();
+    *area     = getHandle<uint >(areaArray);
+    *bbox     = getHandle<uint >(bboxArray);
+    *centroid = getHandle<float>(centroidArray);
+    return out;
+}
+
+static void checkRegionsArgs(const af_array in, const af_connectivity connectivity)
+{
+    ARG_ASSERT(2, (connectivity==AF_CONNECTIVITY_4 || connectivity==AF_CONNECTIVITY_8 ||
+                   connectivity==AF_CONNECTIVITY_6 || connectivity==AF_CONNECTIVITY_26));
 
-        dim_t in_ndims = dims.ndims();
-        DIM_ASSERT(1, (in_ndims <= 3 && in_ndims >= 2));
+    ArrayInfo info = getInfo(in);
+    af::dim4 dims  = info.dims();
 
-        af_dtype in_type = info.getType();
-        if (in_type != b8) {
-            TYPE_ERROR(1, in_type);
-        }
+    dim_t in_ndims = dims.ndims();
+    DIM_ASSERT(1, (in_ndims <= 3 && in_ndims >= 2));
+
+    af_dtype in_type = info.getType();
+    if (in_type != b8) {
+        TYPE_ERROR(1, in_type);
+    }
+}
+
+af_err af_regions(af_array *out, const af_array in, const af_connectivity connectivity, const af_dtype type)
+{
+    try {
+        checkRegionsArgs(in, connectivity);
 
         af_array output;
         switch(type) {
@@ -54,3 +77,28 @@ af_err af_regions(af_array *out, const af_array in, const af_connectivity connec
 
     return AF_SUCCESS;
 }
+
+af_err af_regions_stats(af_array *out, af_array *area, af_array *bbox, af_array *centroid,
+                        const af_array in, const af_connectivity connectivity, const af_dtype type)
+{
+    try {
+        checkRegionsArgs(in, connectivity);
+
+        af_array output;
+        af_array a, b, c;
+        switch(type) {
+            case f32: output = regions<float >(&a, &b, &c, in, connectivity); break;
+            case f64: output = regions<double>(&a, &b, &c, in, connectivity); break;
+            case s32: output = regions<int   >(&a, &b, &c, in, connectivity); break;
+            case u32: output = regions<uint  >(&a, &b, &c, in, connectivity); break;
+            default : TYPE_ERROR(0, type);
+        }
+        std::swap(*out, output);
+        std::swap(*area, a);
+        std::swap(*bbox, b);
+        std::swap(*centroid, c);
+    }
+    CATCHALL;
+
+    return AF_SUCCESS;
+}
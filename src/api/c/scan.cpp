@@ -21,9 +21,37 @@ using af::dim4;
 using namespace detail;
 
 template<af_op_t op, typename Ti, typename To>
-static inline af_array scan(const af_array in, const int dim)
+static inline af_array scan(const af_array in, const int dim, bool inclusive_scan = true)
 {
-    return getHandle(scan<op,Ti,To>(getArray<Ti>(in), dim));
+    const Array<Ti> &input = getArray<Ti>(in);
+
+    // Nothing to scan, the result is empty as well
+    if (input.elements() == 0) return getHandle(createEmptyArray<To>(input.dims()));
+
+    return getHandle(scan<op,Ti,To>(input, dim, inclusive_scan));
+}
+
+template<af_op_t op>
+static af_array scan_op(const af_array in, const int dim, bool inclusive_scan)
+{
+    af_dtype type = getInfo(in).getType();
+    af_array res;
+
+    switch(type) {
+    case f32:  res = scan<op, float  , float  >(in, dim, inclusive_scan); break;
+    case f64:  res = scan<op, double , double >(in, dim, inclusive_scan); break;
+    case c32:  res = scan<op, cfloat , cfloat >(in, dim, inclusive_scan); break;
+    case c64:  res = scan<op, cdouble, cdouble>(in, dim, inclusive_scan); break;
+    case u32:  res = scan<op, uint   , uint   >(in, dim, inclusive_scan); break;
+    case s32:  res = scan<op, int    , int    >(in, dim, inclusive_scan); break;
+    case u8:   res = scan<op, uchar  , uint   >(in, dim, inclusive_scan); break;
+    // Sums of b8 count the non zero values, as in af_accum
+    case b8:   res = scan<op == af_add_t ? af_notzero_t : op, char, uint>(in, dim, inclusive_scan); break;
+    default:
+        TYPE_ERROR(1, type);
+    }
+
+    return res;
 }
 
 
@@ -64,3 +92,27 @@ af_err af_accum(af_array *out, const af_array in, const int dim)
 
     return AF_SUCCESS;
 }
+
+af_err af_scan(af_array *out, const af_array in, const int dim, af_binary_op op, bool inclusive_scan)
+{
+    ARG_ASSERT(2, dim >= 0);
+    ARG_ASSERT(2, dim <  4);
+
+    try {
+        af_array res;
+
+        switch(op) {
+        case AF_BINARY_ADD: res = scan_op<af_add_t>(in, dim, inclusive_scan); break;
+        case AF_BINARY_MUL: res = scan_op<af_mul_t>(in, dim, inclusive_scan); break;
+        case AF_BINARY_MIN: res = scan_op<af_min_t>(in, dim, inclusive_scan); break;
+        case AF_BINARY_MAX: res = scan_op<af_max_t>(in, dim, inclusive_scan); break;
+        default:
+            AF_ERROR("Invalid binary operation", AF_ERR_ARG);
+        }
+
+        std::swap(*out, res);
+    }
+    CATCHALL;
+
+    return AF_SUCCESS;
+}
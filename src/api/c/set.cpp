@@ -111,3 +111,117 @@ af_err af_set_intersect(af_array *out, const af_array first, const af_array seco
 
     return AF_SUCCESS;
 }
+
+template<typename T>
+static inline af_array setUnique(af_array *idx, const af_array in, const bool in_order)
+{
+    Array<uint> idxArray = createEmptyArray<uint>(dim4());
+    af_array out = getHandle(setUnique(idxArray, getArray<T>(in), in_order));
+    *idx = getHandle(idxArray);
+    return out;
+}
+
+af_err af_set_unique_index(af_array *values, af_array *idx, const af_array in, const bool in_order)
+{
+    try {
+
+        af_dtype type = getInfo(in).getType();
+
+        af_array res, i;
+        switch(type) {
+        case f32: res = setUnique<float  >(&i, in, in_order); break;
+        case f64: res = setUnique<double >(&i, in, in_order); break;
+        case s32: res = setUnique<int    >(&i, in, in_order); break;
+        case u32: res = setUnique<uint   >(&i, in, in_order); break;
+        case b8:  res = setUnique<char   >(&i, in, in_order); break;
+        case u8:  res = setUnique<uchar  >(&i, in, in_order); break;
+        default: TYPE_ERROR(2, type);
+        }
+
+        std::swap(*values, res);
+        std::swap(*idx, i);
+    } CATCHALL;
+
+    return AF_SUCCESS;
+}
+
+template<typename T>
+static inline af_array setUnion(af_array *idx, const af_array first, const af_array second,
+                                const bool in_order)
+{
+    Array<uint> idxArray = createEmptyArray<uint>(dim4());
+    af_array out = getHandle(setUnion(idxArray, getArray<T>(first), getArray<T>(second), in_order));
+    *idx = getHandle(idxArray);
+    return out;
+}
+
+af_err af_set_union_index(af_array *values, af_array *idx,
+                          const af_array first, const af_array second, const bool in_order)
+{
+    try {
+
+        af_dtype first_type = getInfo(first).getType();
+        af_dtype second_type = getInfo(second).getType();
+
+        ARG_ASSERT(3, first_type == second_type);
+
+        af_array res, i;
+        switch(first_type) {
+        case f32: res = setUnion<float  >(&i, first, second, in_order); break;
+        case f64: res = setUnion<double >(&i, first, second, in_order); break;
+        case s32: res = setUnion<int    >(&i, first, second, in_order); break;
+        case u32: res = setUnion<uint   >(&i, first, second, in_order); break;
+        case b8:  res = setUnion<char   >(&i, first, second, in_order); break;
+        case u8:  res = setUnion<uchar  >(&i, first, second, in_order); break;
+        default: TYPE_ERROR(2, first_type);
+        }
+
+        std::swap(*values, res);
+        std::swap(*idx, i);
+    } CATCHALL;
+
+    return AF_SUCCESS;
+}
+
+template<typename T>
+static inline af_array setIntersect(af_array *first_idx, af_array *second_idx,
+                                    const af_array first, const af_array second,
+                                    const bool in_order)
+{
+    Array<uint> firstIdx  = createEmptyArray<uint>(dim4());
+    Array<uint> secondIdx = createEmptyArray<uint>(dim4());
+    af_array out = getHandle(setIntersect(firstIdx, secondIdx,
+                                          getArray<T>(first), getArray<T>(second), in_order));
+    *first_idx  = getHandle(firstIdx);
+    *second_idx = getHandle(secondIdx);
+    return out;
+}
+
+af_err af_set_intersect_index(af_array *values, af_array *first_idx, af_array *second_idx,
+                              const af_array first, const af_array second, const bool in_order)
+{
+    try {
+
+        af_dtype first_type = getInfo(first).getType();
+        af_dtype second_type = getInfo(second).getType();
+
+        ARG_ASSERT(4, first_type == second_type);
+
+        af_array res, f, s;
+        switch(first_type) {
+        case f32: res = setIntersect<float  >(&f, &s, first, second, in_order); break;
+        case f64: res = setIntersect<double >(&f, &s, first, second, in_order); break;
+        case s32: res = setIntersect<int    >(&f, &s, first, second, in_order); break;
+        case u32: res = setIntersect<uint   >(&f, &s, first, second, in_order); break;
+        case b8:  res = setIntersect<char   >(&f, &s, first, second, in_order); break;
+        case u8:  res = setIntersect<uchar  >(&f, &s, first, second, in_order); break;
+        default: TYPE_ERROR(3, first_type);
+        }
+
+        std::swap(*values, res);
+        std::swap(*first_idx, f);
+        std::swap(*second_idx, s);
+    } CATCHALL;
+
+    return AF_SUCCESS;
+}
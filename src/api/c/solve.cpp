@@ -31,16 +31,11 @@ af_err af_solve(af_array *out, const af_array a, const af_array b, const af_mat_
         ArrayInfo a_info = getInfo(a);
         ArrayInfo b_info = getInfo(b);
 
-        if (a_info.ndims() > 2 ||
-            b_info.ndims() > 2) {
-            AF_ERROR("solve can not be used in batch mode", AF_ERR_BATCH);
-        }
-
         af_dtype a_type = a_info.getType();
         af_dtype b_type = b_info.getType();
 
         dim4 adims = a_info.dims();
-        dim4 bdims = a_info.dims();
+        dim4 bdims = b_info.dims();
 
         ARG_ASSERT(1, a_info.isFloating());                       // Only floating and complex types
         ARG_ASSERT(2, b_info.isFloating());                       // Only floating and complex types
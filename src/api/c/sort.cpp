@@ -42,8 +42,7 @@ af_err af_sort(af_array *out, const af_array in, const unsigned dim, const bool
         af_dtype type = info.getType();
 
         DIM_ASSERT(1, info.elements() > 0);
-        // Only Dim 0 supported
-        ARG_ASSERT(2, dim == 0);
+        ARG_ASSERT(2, dim < 4);
 
         af_array val;
 
@@ -89,8 +88,7 @@ af_err af_sort_index(af_array *out, af_array *indices, const af_array in, const
         af_dtype type = info.getType();
 
         DIM_ASSERT(2, info.elements() > 0);
-        // Only Dim 0 supported
-        ARG_ASSERT(3, dim == 0);
+        ARG_ASSERT(3, dim < 4);
 
         af_array val;
         af_array idx;
@@ -164,8 +162,7 @@ af_err af_sort_by_key(af_array *out_keys, af_array *out_values,
 
         DIM_ASSERT(3, info.elements() > 0);
         DIM_ASSERT(4, info.dims() == vinfo.dims());
-        // Only Dim 0 supported
-        ARG_ASSERT(5, dim == 0);
+        ARG_ASSERT(5, dim < 4);
 
         af_array oKey;
         af_array oVal;
@@ -15,6 +15,7 @@
 #include <ops.hpp>
 #include <where.hpp>
 #include <backend.hpp>
+#include <climits>
 
 using af::dim4;
 using namespace detail;
@@ -22,8 +23,32 @@ using namespace detail;
 template<typename T>
 static inline af_array where(const af_array in)
 {
+    const Array<T> &input = getArray<T>(in);
+
+    // 32 bit indices can not address every element of larger arrays
+    if (input.elements() > (dim_t)UINT_MAX) {
+        return getHandle<uintl>(where<T, uintl>(NULL, input));
+    }
+
     // Making it more explicit that the output is uint
-    return getHandle<uint>(where<T>(getArray<T>(in)));
+    return getHandle<uint>(where<T>(input));
+}
+
+template<typename T>
+static inline af_array where(af_array *vals, const af_array in)
+{
+    const Array<T> &input = getArray<T>(in);
+    Array<T> values = createEmptyArray<T>(dim4());
+
+    af_array idx;
+    if (input.elements() > (dim_t)UINT_MAX) {
+        idx = getHandle<uintl>(where<T, uintl>(&values, input));
+    } else {
+        idx = getHandle<uint >(where<T, uint >(&values, input));
+    }
+
+    *vals = getHandle<T>(values);
+    return idx;
 }
 
 af_err af_where(af_array *idx, const af_array in)
@@ -51,3 +76,30 @@ af_err af_where(af_array *idx, const af_array in)
 
     return AF_SUCCESS;
 }
+
+af_err af_where_values(af_array *idx, af_array *vals, const af_array in)
+{
+    try {
+        af_dtype type = getInfo(in).getType();
+        af_array res, v;
+        switch(type) {
+        case f32: res = where<float  >(&v, in); break;
+        case f64: res = where<double >(&v, in); break;
+        case c32: res = where<cfloat >(&v, in); break;
+        case c64: res = where<cdouble>(&v, in); break;
+        case s32: res = where<int    >(&v, in); break;
+        case u32: res = where<uint   >(&v, in); break;
+        case s64: res = where<intl   >(&v, in); break;
+        case u64: res = where<uintl  >(&v, in); break;
+        case u8 : res = where<uchar  >(&v, in); break;
+        case b8 : res = where<char   >(&v, in); break;
+        default:
+            TYPE_ERROR(2, type);
+        }
+        std::swap(*idx, res);
+        std::swap(*vals, v);
+    }
+    CATCHALL
+
+    return AF_SUCCESS;
+}
@@ -314,7 +314,8 @@ namespace af
 
     static array::array_proxy gen_indexing(const array &ref, const index &s0, const index &s1, const index &s2, const index &s3, bool linear = false)
     {
-        ref.eval();
+        // The parent is not evaluated here, backends with lazy indexing only
+        // compute the selected elements. Assignments evaluate it themselves.
         af_index_t inds[AF_MAX_DIMS];
         inds[0] = s0.get();
         inds[1] = s1.get();
@@ -916,6 +917,13 @@ namespace af
         AF_THROW(af_eval(get()));
     }
 
+    void eval(int num, array **arrays)
+    {
+        std::vector<af_array> outputs(num);
+        for (int i = 0; i < num; i++) outputs[i] = arrays[i]->get();
+        AF_THROW(af_eval_multiple(num, num > 0 ? &outputs.front() : NULL));
+    }
+
 // array instanciations
 #define INSTANTIATE(T)                                                  \
     template<> AFAPI T *array::host() const                             \
@@ -21,4 +21,11 @@ array bilateral(const array &in, const float spatial_sigma, const float chromati
     return array(out);
 }
 
+array bilateralApprox(const array &in, const float spatial_sigma, const float chromatic_sigma, const bool is_color)
+{
+    af_array out = 0;
+    AF_THROW(af_bilateral_approx(&out, in.get(), spatial_sigma, chromatic_sigma, is_color));
+    return array(out);
+}
+
 }
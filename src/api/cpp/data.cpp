@@ -196,6 +196,18 @@ namespace af
         return seed;
     }
 
+    void setRandomCounter(const uintl counter)
+    {
+        AF_THROW(af_set_random_counter(counter));
+    }
+
+    uintl getRandomCounter()
+    {
+        uintl counter = 0;
+        AF_THROW(af_get_random_counter(&counter));
+        return counter;
+    }
+
     array range(const dim4 &dims, const int seq_dim, const af::dtype ty)
     {
         af_array out;
@@ -122,6 +122,30 @@ namespace af
                                     lock_bytes,  lock_buffers));
     }
 
+    void deviceSetMemLimit(const size_t bytes)
+    {
+        AF_THROW(af_device_set_mem_limit(bytes));
+    }
+
+    size_t deviceGetMemLimit()
+    {
+        size_t bytes = 0;
+        AF_THROW(af_device_get_mem_limit(&bytes));
+        return bytes;
+    }
+
+    void setNumThreads(const int nthreads)
+    {
+        AF_THROW(af_set_num_threads(nthreads));
+    }
+
+    int getNumThreads()
+    {
+        int nthreads = 1;
+        AF_THROW(af_get_num_threads(&nthreads));
+        return nthreads;
+    }
+
 #define INSTANTIATE(T)                                                  \
     template<> AFAPI                                                    \
     T* alloc(const size_t elements)                                     \
@@ -144,4 +144,59 @@ array idft(const array& in)
     return idft(in, 1.0, dim4(0,0,0,0));
 }
 
+array fftR2C(const array& in, const dim_t odim0)
+{
+    af_array out = 0;
+    AF_THROW(af_fft_r2c(&out, in.get(), 1.0, odim0));
+    return array(out);
+}
+
+array fft2R2C(const array& in, const dim_t odim0, const dim_t odim1)
+{
+    af_array out = 0;
+    AF_THROW(af_fft2_r2c(&out, in.get(), 1.0, odim0, odim1));
+    return array(out);
+}
+
+array fft3R2C(const array& in, const dim_t odim0, const dim_t odim1, const dim_t odim2)
+{
+    af_array out = 0;
+    AF_THROW(af_fft3_r2c(&out, in.get(), 1.0, odim0, odim1, odim2));
+    return array(out);
+}
+
+static double c2rNorm(const array& in, const bool is_odd, const int rank)
+{
+    const dim4 dims = in.dims();
+    double norm = 1.0 / (2 * (dims[0] - 1) + (is_odd ? 1 : 0));
+    for (int i = 1; i < rank; i++) norm /= dims[i];
+    return norm;
+}
+
+array fftC2R(const array& in, const bool is_odd)
+{
+    af_array out = 0;
+    AF_THROW(af_fft_c2r(&out, in.get(), c2rNorm(in, is_odd, 1), is_odd));
+    return array(out);
+}
+
+array fft2C2R(const array& in, const bool is_odd)
+{
+    af_array out = 0;
+    AF_THROW(af_fft2_c2r(&out, in.get(), c2rNorm(in, is_odd, 2), is_odd));
+    return array(out);
+}
+
+array fft3C2R(const array& in, const bool is_odd)
+{
+    af_array out = 0;
+    AF_THROW(af_fft3_c2r(&out, in.get(), c2rNorm(in, is_odd, 3), is_odd));
+    return array(out);
+}
+
+void setFFTPlanCacheSize(size_t num_plans)
+{
+    AF_THROW(af_set_fft_plan_cache_size(num_plans));
+}
+
 }
@@ -30,6 +30,13 @@ array histogram(const array &in, const unsigned nbins)
     return array(out);
 }
 
+array histogram(const array &in, const array &weights, const unsigned nbins, const double minval, const double maxval)
+{
+    af_array out = 0;
+    AF_THROW(af_histogram_weighted(&out, in.get(), weights.get(), nbins, minval, maxval));
+    return array(out);
+}
+
 array histequal(const array& in, const array& hist) { return histEqual(in, hist); }
 array histEqual(const array& in, const array& hist)
 {
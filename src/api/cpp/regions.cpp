@@ -21,4 +21,15 @@ array regions(const array& in, const af::connectivity connectivity, const af::dt
     return array(temp);
 }
 
+array regionsStats(array &area, array &bbox, array &centroid, const array& in,
+                   const af::connectivity connectivity, const af::dtype type)
+{
+    af_array temp = 0, a = 0, b = 0, c = 0;
+    AF_THROW(af_regions_stats(&temp, &a, &b, &c, in.get(), connectivity, type));
+    area     = array(a);
+    bbox     = array(b);
+    centroid = array(c);
+    return array(temp);
+}
+
 }
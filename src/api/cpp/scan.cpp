@@ -19,4 +19,11 @@ namespace af
         AF_THROW(af_accum(&out, in.get(), dim));
         return array(out);
     }
+
+    array scan(const array& in, const int dim, binaryOp op, bool inclusive_scan)
+    {
+        af_array out = 0;
+        AF_THROW(af_scan(&out, in.get(), dim, op, inclusive_scan));
+        return array(out);
+    }
 }
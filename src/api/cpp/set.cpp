@@ -50,4 +50,31 @@ array setIntersect(const array &first, const array &second, const bool is_unique
     return array(out);
 }
 
+void setUnique(array &values, array &idx, const array &in, const bool in_order)
+{
+    af_array v = 0, i = 0;
+    AF_THROW(af_set_unique_index(&v, &i, in.get(), in_order));
+    values = array(v);
+    idx    = array(i);
+}
+
+void setUnion(array &values, array &idx, const array &first, const array &second,
+              const bool in_order)
+{
+    af_array v = 0, i = 0;
+    AF_THROW(af_set_union_index(&v, &i, first.get(), second.get(), in_order));
+    values = array(v);
+    idx    = array(i);
+}
+
+void setIntersect(array &values, array &first_idx, array &second_idx,
+                  const array &first, const array &second, const bool in_order)
+{
+    af_array v = 0, f = 0, s = 0;
+    AF_THROW(af_set_intersect_index(&v, &f, &s, first.get(), second.get(), in_order));
+    values     = array(v);
+    first_idx  = array(f);
+    second_idx = array(s);
+}
+
 }
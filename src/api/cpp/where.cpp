@@ -24,4 +24,16 @@ namespace af
         AF_THROW(af_where(&out, in.get()));
         return array(out);
     }
+
+    void where(array &idx, array &values, const array &in)
+    {
+        if (gforGet()) {
+            AF_THROW_MSG("WHERE can not be used inside GFOR", AF_ERR_RUNTIME);
+        }
+
+        af_array i = 0, v = 0;
+        AF_THROW(af_where_values(&i, &v, in.get()));
+        idx    = array(i);
+        values = array(v);
+    }
 }
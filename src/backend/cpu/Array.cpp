@@ -12,8 +12,10 @@
 #include <copy.hpp>
 #include <TNJ/BufferNode.hpp>
 #include <TNJ/ScalarNode.hpp>
+#include <TNJ/IndexNode.hpp>
 #include <memory.hpp>
 #include <platform.hpp>
+#include <parallel.hpp>
 #include <cstring>
 
 namespace cpu
@@ -63,39 +65,7 @@ namespace cpu
     void Array<T>::eval()
     {
         if (isReady()) return;
-
-        this->setId(getActiveDeviceId());
-        data = std::shared_ptr<T>(memAlloc<T>(elements()), memFree<T>);
-        T *ptr = data.get();
-
-        dim4 ostrs = strides();
-        dim4 odims = dims();
-
-        for (int w = 0; w < (int)odims[3]; w++) {
-            dim_t offw = w * ostrs[3];
-
-            for (int z = 0; z < (int)odims[2]; z++) {
-                dim_t offz = z * ostrs[2] + offw;
-
-                for (int y = 0; y < (int)odims[1]; y++) {
-                    dim_t offy = y * ostrs[1] + offz;
-
-                    for (int x = 0; x < (int)odims[0]; x++) {
-                        dim_t id = x + offy;
-
-                        ptr[id] = *(T *)node->calc(x, y, z, w);
-                    }
-                }
-            }
-        }
-
-
-        ready = true;
-
-        Node_ptr prev = node;
-        prev->reset();
-        // FIXME: Replace the current node in any JIT possible trees with the new BufferNode
-        node.reset();
+        evalMultiple<T>(std::vector<Array<T> *>(1, this));
     }
 
     template<typename T>
@@ -189,6 +159,27 @@ namespace cpu
                             const std::vector<af_seq> &index,
                             bool copy)
     {
+        bool strided = false;
+        for (int i = 0; i < (int)index.size(); i++) {
+            strided |= index[i].step < 0 || (i == 0 && index[i].step > 1);
+        }
+
+        // Copies of slices of expressions, and of strided slices, are index
+        // nodes so that only the selected elements are ever computed
+        if (copy && (!parent.isReady() || strided)) {
+            dim4 pDims  = parent.dims();
+            dim4 dims   = toDims  (index, pDims);
+            dim4 offset = toOffset(index, pDims);
+
+            TNJ::IndexMap maps[4];
+            for (int i = 0; i < (int)index.size(); i++) {
+                maps[i] = TNJ::IndexMap(offset[i], index[i].step != 0 ? (dim_t)index[i].step : 1);
+            }
+
+            TNJ::IndexNode<T> *node = new TNJ::IndexNode<T>(parent.getNode(), maps);
+            return createNodeArray<T>(dims, Node_ptr(reinterpret_cast<Node *>(node)));
+        }
+
         parent.eval();
 
         dim4 dDims = parent.getDataDims();
@@ -227,6 +218,151 @@ namespace cpu
         A.eval();
     }
 
+    template<typename T>
+    void evalMultiple(std::vector<Array<T> *> arrays)
+    {
+        // Arrays sharing a tree are evaluated once. Arrays with other dims
+        // than the first are evaluated in a pass of their own.
+        std::vector<Array<T> *> outs, rest;
+        std::vector<std::pair<Array<T> *, Array<T> *> > same;
+        for (size_t i = 0; i < arrays.size(); i++) {
+            Array<T> *arr = arrays[i];
+            if (arr->isReady()) continue;
+
+            Array<T> *match = NULL;
+            for (size_t j = 0; j < outs.size() && !match; j++) {
+                if (outs[j]->node == arr->node) match = outs[j];
+            }
+
+            if (match) {
+                same.push_back(std::make_pair(arr, match));
+            } else if (outs.empty() || outs[0]->dims() == arr->dims()) {
+                outs.push_back(arr);
+            } else {
+                rest.push_back(arr);
+            }
+        }
+
+        if (outs.empty()) return;
+
+        const dim4 ostrs = outs[0]->strides();
+        const dim4 odims = outs[0]->dims();
+
+        // Flatten the trees so that every node is evaluated once per run of
+        // elements, children first. Nodes shared by several trees are only
+        // evaluated once.
+        std::vector<Node *> nodes;
+        for (size_t i = 0; i < outs.size(); i++) outs[i]->node->getNodes(nodes);
+        for (size_t i = 0; i < outs.size(); i++) outs[i]->node->reset();
+
+        const int num_nodes = (int)nodes.size();
+
+        // The roots write straight into their output unless they need more
+        // room than the values they return
+        std::vector<T *> direct(num_nodes, (T *)NULL);
+        std::vector<std::pair<int, T *> > roots;
+        bool linear = true;
+        for (size_t i = 0; i < outs.size(); i++) {
+            Array<T> *out = outs[i];
+            out->setId(getActiveDeviceId());
+            out->data = std::shared_ptr<T>(memAlloc<T>(out->elements()), memFree<T>);
+
+            const int id = out->node->getId();
+            if (!direct[id] &&
+                nodes[id]->getBufferSize() <= TNJ::VECTOR_LENGTH * (int)sizeof(T)) {
+                direct[id] = out->data.get();
+            }
+
+            roots.push_back(std::make_pair(id, out->data.get()));
+            linear &= out->node->isLinear(odims.get());
+        }
+
+        const int num_roots = (int)roots.size();
+
+        // Every range gets its own buffers so that ranges can be evaluated
+        // by different threads
+        auto evalRange = [&](dim_t begin, dim_t end, bool linear) {
+            std::vector<const void *> vals(num_nodes);
+            std::vector<std::vector<char> > bufs(num_nodes);
+            for (int i = 0; i < num_nodes; i++) {
+                if (!direct[i]) bufs[i].resize(nodes[i]->getBufferSize());
+            }
+
+            if (linear) {
+                for (dim_t idx = begin; idx < end; idx += TNJ::VECTOR_LENGTH) {
+                    int lim = (int)std::min<dim_t>(TNJ::VECTOR_LENGTH, end - idx);
+
+                    for (int i = 0; i < num_nodes; i++) {
+                        void *buf = direct[i] ? (void *)(direct[i] + idx) : bufs[i].data();
+                        vals[i] = nodes[i]->calc(idx, lim, buf, &vals[0]);
+                    }
+
+                    for (int r = 0; r < num_roots; r++) {
+                        T *out = roots[r].second + idx;
+                        const T *res = (const T *)vals[roots[r].first];
+                        if (res != out) std::copy(res, res + lim, out);
+                    }
+                }
+                return;
+            }
+
+            for (dim_t row = begin; row < end; row++) {
+                int y = (int)(row % odims[1]);
+                int z = (int)((row / odims[1]) % odims[2]);
+                int w = (int)(row / (odims[1] * odims[2]));
+                dim_t offy = y * ostrs[1] + z * ostrs[2] + w * ostrs[3];
+
+                for (int x = 0; x < (int)odims[0]; x += TNJ::VECTOR_LENGTH) {
+                    int lim = std::min(TNJ::VECTOR_LENGTH, (int)odims[0] - x);
+
+                    for (int i = 0; i < num_nodes; i++) {
+                        void *buf = direct[i] ? (void *)(direct[i] + offy + x) : bufs[i].data();
+                        vals[i] = nodes[i]->calc(x, y, z, w, lim, buf, &vals[0]);
+                    }
+
+                    for (int r = 0; r < num_roots; r++) {
+                        T *out = roots[r].second + offy + x;
+                        const T *res = (const T *)vals[roots[r].first];
+                        if (res != out) std::copy(res, res + lim, out);
+                    }
+                }
+            }
+        };
+
+        if (linear) {
+            // Ranges are whole multiples of VECTOR_LENGTH
+            dim_t num = odims.elements();
+            dim_t nvec = (num + TNJ::VECTOR_LENGTH - 1) / TNJ::VECTOR_LENGTH;
+            parallel_for(nvec, [&](dim_t begin, dim_t end) {
+                    evalRange(begin * TNJ::VECTOR_LENGTH,
+                              std::min(end * TNJ::VECTOR_LENGTH, num), true);
+                }, MIN_PARALLEL_ELEMENTS / TNJ::VECTOR_LENGTH);
+        } else {
+            dim_t rows = odims[1] * odims[2] * odims[3];
+            dim_t grain = MIN_PARALLEL_ELEMENTS / std::max<dim_t>(odims[0], 1);
+            parallel_for(rows, [&](dim_t begin, dim_t end) {
+                    evalRange(begin, end, false);
+                }, grain);
+        }
+
+        // Trees holding the evaluated nodes read the outputs from now on
+        for (size_t i = 0; i < outs.size(); i++) {
+            Array<T> *out = outs[i];
+            unsigned bytes = out->elements() * sizeof(T);
+            BufferNode<T> *buf_node = new BufferNode<T>(out->data, bytes, 0,
+                                                        odims.get(), ostrs.get());
+            Node_ptr result(reinterpret_cast<Node *>(buf_node));
+
+            out->node->setResult(result);
+            out->node = result;
+            out->ready = true;
+        }
+
+        for (size_t i = 0; i < same.size(); i++) *same[i].first = *same[i].second;
+
+        if (!rest.empty()) evalMultiple<T>(rest);
+    }
+
     template<typename T>
     void
     writeHostDataArray(Array<T> &arr, const T * const data, const size_t bytes)
@@ -258,6 +394,7 @@ namespace cpu
                                                        bool copy);      \
     template       void      destroyArray<T>          (Array<T> *A);    \
     template       void      evalArray<T>             (const Array<T> &A); \
+    template       void      evalMultiple<T>          (std::vector<Array<T> *> arrays); \
     template       Array<T>  createNodeArray<T>       (const dim4 &size, TNJ::Node_ptr node); \
     template       Array<T>::~Array        ();                          \
     template       void Array<T>::eval();                               \
@@ -65,6 +65,11 @@ namespace cpu
     template<typename T>
     void evalArray(const Array<T> &A);
 
+    // Evaluates the arrays together. Nodes shared by their trees are
+    // computed once, in a single pass over the data.
+    template<typename T>
+    void evalMultiple(std::vector<Array<T> *> arrays);
+
     // Creates a new Array object on the heap and returns a reference to it.
     template<typename T>
     void destroyArray(Array<T> *A);
@@ -143,6 +148,7 @@ namespace cpu
 
         friend void destroyArray<T>(Array<T> *arr);
         friend void evalArray<T>(const Array<T> &arr);
+        friend void evalMultiple<T>(std::vector<Array<T> *> arrays);
         friend void *getDevicePtr<T>(const Array<T>& arr);
     };
 
@@ -36,31 +36,86 @@ namespace TNJ
         Node_ptr m_lhs;
         Node_ptr m_rhs;
         BinOp<To, Ti, op> m_op;
-        To m_val;
+
+        const void *eval(int lim, void *buf, const void * const *vals)
+        {
+            To *out = (To *)buf;
+            const Ti *lhs = (const Ti *)vals[m_lhs->getId()];
+            const Ti *rhs = (const Ti *)vals[m_rhs->getId()];
+
+            for (int i = 0; i < lim; i++) {
+                out[i] = m_op.eval(lhs[i], rhs[i]);
+            }
+
+            return buf;
+        }
 
     public:
         BinaryNode(Node_ptr lhs, Node_ptr rhs) :
             Node(),
             m_lhs(lhs),
-            m_rhs(rhs),
-            m_val(0)
+            m_rhs(rhs)
         {
         }
 
-        void *calc(int x, int y, int z, int w)
+        const void *calc(int x, int y, int z, int w, int lim,
+                         void *buf, const void * const *vals)
         {
-            m_val = m_op.eval(*(Ti *)m_lhs->calc(x, y, z, w),
-                              *(Ti *)m_rhs->calc(x, y, z, w));
-            return  (void *)&m_val;
+            return eval(lim, buf, vals);
+        }
+
+        const void *calc(dim_t idx, int lim,
+                         void *buf, const void * const *vals)
+        {
+            return eval(lim, buf, vals);
+        }
+
+        bool isLinear(const dim_t *dims)
+        {
+            if (m_result) return m_result->isLinear(dims);
+            return m_lhs->isLinear(dims) && m_rhs->isLinear(dims);
+        }
+
+        int getTypeSize() { return sizeof(To); }
+
+        Node_ptr clone(CloneMap &cloned)
+        {
+            if (m_result) return m_result->clone(cloned);
+
+            Node_ptr &res = cloned[this];
+            if (!res) res = Node_ptr(new BinaryNode<To, Ti, op>(m_lhs->clone(cloned),
+                                                               m_rhs->clone(cloned)));
+            return res;
+        }
+
+        void setResult(Node_ptr result)
+        {
+            m_result = result;
+            m_lhs.reset();
+            m_rhs.reset();
+        }
+
+        void getNodes(std::vector<Node *> &nodes)
+        {
+            if (m_is_eval) return;
+            if (getResultNodes(nodes)) return;
+
+            m_lhs->getNodes(nodes);
+            m_rhs->getNodes(nodes);
+            Node::getNodes(nodes);
         }
 
         void getInfo(unsigned &len, unsigned &buf_count, unsigned &bytes)
         {
             if (m_is_eval) return;
 
-            m_lhs->getInfo(len, buf_count, bytes);
-            m_rhs->getInfo(len, buf_count, bytes);
-            len++;
+            if (m_result) {
+                m_result->getInfo(len, buf_count, bytes);
+            } else {
+                m_lhs->getInfo(len, buf_count, bytes);
+                m_rhs->getInfo(len, buf_count, bytes);
+                len++;
+            }
 
             m_is_eval = true;
             return;
@@ -68,6 +123,14 @@ namespace TNJ
 
         void reset()
         {
+            if (!m_is_eval) return;
+
+            if (m_result) {
+                m_result->reset();
+            } else {
+                m_lhs->reset();
+                m_rhs->reset();
+            }
             m_is_eval = false;
         }
     };
@@ -49,14 +49,57 @@ namespace TNJ
             }
         }
 
-        void *calc(int x, int y, int z, int w)
+        // Pointer to the first element of the row (y, z, w), broadcasting
+        // along the dimensions of length 1
+        const T *getRow(int y, int z, int w) const
         {
             dim_t l_off = 0;
             l_off += (w < (int)dims[3]) * w * strides[3];
             l_off += (z < (int)dims[2]) * z * strides[2];
             l_off += (y < (int)dims[1]) * y * strides[1];
-            l_off += (x < (int)dims[0]) * x;
-            return (void *)(ptr.get() + off + l_off);
+            return ptr.get() + off + l_off;
+        }
+
+        const void *calc(int x, int y, int z, int w, int lim,
+                         void *buf, const void * const *vals)
+        {
+            const T *in = getRow(y, z, w);
+
+            // Read directly from memory when the whole run is in bounds
+            if (x + lim <= (int)dims[0]) return in + x;
+
+            // Broadcasting along dim0
+            T *out = (T *)buf;
+            for (int i = 0; i < lim; i++) {
+                out[i] = in[(x + i < (int)dims[0]) * (x + i)];
+            }
+            return buf;
+        }
+
+        const void *calc(dim_t idx, int lim,
+                         void *buf, const void * const *vals)
+        {
+            return ptr.get() + off + idx;
+        }
+
+        bool isLinear(const dim_t *odims)
+        {
+            dim_t stride = 1;
+            for (int i = 0; i < 4; i++) {
+                if (dims[i] != odims[i]) return false;
+                if (dims[i] > 1 && strides[i] != stride) return false;
+                stride *= dims[i];
+            }
+            return true;
+        }
+
+        int getTypeSize() { return sizeof(T); }
+
+        Node_ptr clone(CloneMap &cloned)
+        {
+            Node_ptr &res = cloned[this];
+            if (!res) res = Node_ptr(new BufferNode<T>(ptr, m_bytes, off, dims, strides));
+            return res;
         }
 
         void getInfo(unsigned &len, unsigned &buf_count, unsigned &bytes)
@@ -73,7 +116,6 @@ namespace TNJ
         void reset()
         {
             m_is_eval = false;
-            off = 0;
         }
     };
 
@@ -0,0 +1,272 @@
+/*******************************************************
+ * Copyright (c) 2015, ArrayFire
+ * All rights reserved.
+ *
+ * This file is distributed under 3-clause BSD license.
+ * The complete license agreement can be obtained at:
+ * http://arrayfire.com/licenses/BSD-3-Clause
+ ********************************************************/
+
+#pragma once
+#include <af/array.h>
+#include <optypes.hpp>
+#include <algorithm>
+#include <memory>
+#include <vector>
+#include "Node.hpp"
+#include "BufferNode.hpp"
+
+namespace cpu
+{
+
+namespace TNJ
+{
+
+    // Maps the coordinates of the output along one dimension to the
+    // coordinates of the indexed tree, either as the sequence off + i * step
+    // or through a list of indices that are known to be in range.
+    struct IndexMap
+    {
+        dim_t off;
+        dim_t step;
+        std::shared_ptr<std::vector<dim_t> > idx;
+
+        IndexMap(dim_t offset = 0, dim_t stride = 1) :
+            off(offset), step(stride), idx()
+        {}
+
+        IndexMap(std::shared_ptr<std::vector<dim_t> > indices) :
+            off(0), step(1), idx(indices)
+        {}
+
+        dim_t operator()(dim_t i) const
+        {
+            return idx ? (*idx)[i] : off + i * step;
+        }
+
+        bool isUnit() const { return !idx && step == 1; }
+    };
+
+    // When dim0 is not read in order, evaluating the tree for one run of
+    // consecutive elements costs about as much as evaluating this many more
+    // elements. The whole range read is evaluated when it is cheaper than
+    // evaluating every run on its own.
+    const int INDEX_RUN_ELEMENTS = 32;
+
+    // Selects the elements of a tree. The tree is evaluated only for the
+    // elements that are read, so that slices of expressions are never
+    // computed in full.
+    //
+    // The node keeps a private copy of the tree, evaluated with buffers taken
+    // from its own buffer. The copy acts as a leaf for the rest of the
+    // expression, so nodes shared with the expression keep their ids.
+    template<typename T>
+    class IndexNode : public Node
+    {
+
+    protected:
+        Node_ptr m_child;
+        IndexMap m_maps[4];
+
+        // The tree of m_child, children first
+        std::vector<Node *> m_nodes;
+
+        // Offsets of the values of the tree and of the buffers of m_nodes
+        // into the buffer of this node
+        int m_vals_off;
+        std::vector<int> m_buf_offs;
+        int m_buf_size;
+
+        // Set when the tree is only a buffer, which is then read directly
+        const BufferNode<T> *m_buffer;
+
+        static int align(int bytes) { return (bytes + 63) & ~63; }
+
+        // Evaluates lim elements of the tree along dim0 starting at (x, y, z, w)
+        const T *evalChild(dim_t x, dim_t y, dim_t z, dim_t w, int lim, char *buf)
+        {
+            const void **vals = (const void **)(buf + m_vals_off);
+            const int num_nodes = (int)m_nodes.size();
+            for (int i = 0; i < num_nodes; i++) {
+                vals[i] = m_nodes[i]->calc((int)x, (int)y, (int)z, (int)w, lim,
+                                           buf + m_buf_offs[i], vals);
+            }
+            return (const T *)vals[num_nodes - 1];
+        }
+
+    public:
+        IndexNode(Node_ptr child, const IndexMap maps[4]) :
+            Node(),
+            m_child(),
+            m_buffer(NULL)
+        {
+            CloneMap cloned;
+            m_child = child->clone(cloned);
+            m_child->getNodes(m_nodes);
+            m_child->reset();
+
+            for (int i = 0; i < 4; i++) m_maps[i] = maps[i];
+
+            m_vals_off = align(VECTOR_LENGTH * sizeof(T));
+            m_buf_size = m_vals_off + align(m_nodes.size() * sizeof(void *));
+            for (int i = 0; i < (int)m_nodes.size(); i++) {
+                m_buf_offs.push_back(m_buf_size);
+                m_buf_size += align(m_nodes[i]->getBufferSize());
+            }
+
+            m_buffer = dynamic_cast<const BufferNode<T> *>(m_child.get());
+        }
+
+        const void *calc(int x, int y, int z, int w, int lim,
+                         void *buf, const void * const *vals)
+        {
+            const IndexMap &map = m_maps[0];
+            const dim_t yy = m_maps[1](y);
+            const dim_t zz = m_maps[2](z);
+            const dim_t ww = m_maps[3](w);
+            T *out = (T *)buf;
+
+            if (m_buffer) {
+                const T *in = m_buffer->getRow((int)yy, (int)zz, (int)ww);
+                if (map.isUnit()) return in + map.off + x;
+
+                if (map.idx) {
+                    const dim_t *idx = &(*map.idx)[x];
+                    for (int i = 0; i < lim; i++) out[i] = in[idx[i]];
+                } else {
+                    const T *src = in + map.off + x * map.step;
+                    for (int i = 0; i < lim; i++) out[i] = src[i * map.step];
+                }
+                return buf;
+            }
+
+            if (map.isUnit()) return evalChild(map.off + x, yy, zz, ww, lim, (char *)buf);
+
+            // Reversed and short strided runs need a single run of the tree
+            if (!map.idx) {
+                const dim_t first = map.off + x * map.step;
+                const dim_t last  = first + (lim - 1) * map.step;
+                const dim_t lo = std::min(first, last);
+                const dim_t len = std::max(first, last) - lo + 1;
+                if (len <= VECTOR_LENGTH) {
+                    const T *res = evalChild(lo, yy, zz, ww, (int)len, (char *)buf) + (first - lo);
+                    const dim_t step = map.step;
+                    for (int i = 0; i < lim; i++) out[i] = res[i * step];
+                    return buf;
+                }
+            }
+
+            if (lim < 1) return buf;
+
+            // Elements of the tree read by this run
+            dim_t src[VECTOR_LENGTH];
+            if (map.idx) {
+                const dim_t *idx = &(*map.idx)[x];
+                for (int i = 0; i < lim; i++) src[i] = idx[i];
+            } else {
+                for (int i = 0; i < lim; i++) src[i] = map.off + (x + i) * map.step;
+            }
+
+            dim_t lo = src[0], hi = src[0];
+            int runs = 1;
+            for (int i = 1; i < lim; i++) {
+                lo = std::min(lo, src[i]);
+                hi = std::max(hi, src[i]);
+                runs += (src[i] != src[i - 1] + 1);
+            }
+
+            // Elements close together are gathered from a few evaluations of
+            // the whole range
+            if (hi - lo < (dim_t)runs * INDEX_RUN_ELEMENTS) {
+                for (dim_t start = lo; start <= hi; start += VECTOR_LENGTH) {
+                    const int len = (int)std::min<dim_t>(VECTOR_LENGTH, hi - start + 1);
+                    const T *res = evalChild(start, yy, zz, ww, len, (char *)buf);
+                    for (int i = 0; i < lim; i++) {
+                        const dim_t pos = src[i] - start;
+                        if (pos >= 0 && pos < len) out[i] = res[pos];
+                    }
+                }
+                return buf;
+            }
+
+            for (int i = 0; i < lim;) {
+                int len = 1;
+                while (i + len < lim && src[i + len] == src[i] + len) len++;
+
+                const T *res = evalChild(src[i], yy, zz, ww, len, (char *)buf);
+                std::copy(res, res + len, out + i);
+                i += len;
+            }
+            return buf;
+        }
+
+        const void *calc(dim_t idx, int lim,
+                         void *buf, const void * const *vals)
+        {
+            // Never called, isLinear() is false
+            return NULL;
+        }
+
+        bool isLinear(const dim_t *dims)
+        {
+            if (m_result) return m_result->isLinear(dims);
+            return false;
+        }
+
+        int getTypeSize() { return sizeof(T); }
+
+        int getBufferSize() { return m_buf_size; }
+
+        Node_ptr clone(CloneMap &cloned)
+        {
+            if (m_result) return m_result->clone(cloned);
+
+            Node_ptr &res = cloned[this];
+            if (!res) res = Node_ptr(new IndexNode<T>(m_child, m_maps));
+            return res;
+        }
+
+        void setResult(Node_ptr result)
+        {
+            m_result = result;
+            m_child.reset();
+            m_nodes.clear();
+            m_buffer = NULL;
+        }
+
+        void getNodes(std::vector<Node *> &nodes)
+        {
+            if (m_is_eval) return;
+            if (getResultNodes(nodes)) return;
+
+            Node::getNodes(nodes);
+        }
+
+        void getInfo(unsigned &len, unsigned &buf_count, unsigned &bytes)
+        {
+            if (m_is_eval) return;
+
+            if (m_result) {
+                m_result->getInfo(len, buf_count, bytes);
+            } else {
+                m_child->getInfo(len, buf_count, bytes);
+                m_child->reset();
+                len++;
+            }
+
+            m_is_eval = true;
+            return;
+        }
+
+        void reset()
+        {
+            if (!m_is_eval) return;
+
+            if (m_result) m_result->reset();
+            m_is_eval = false;
+        }
+    };
+
+}
+
+}
@@ -11,7 +11,7 @@
 #include <af/array.h>
 #include <optypes.hpp>
 #include <vector>
-#include "Node.hpp"
+#include <map>
 #include <memory>
 
 namespace cpu
@@ -20,21 +20,93 @@ namespace cpu
 namespace TNJ
 {
 
+    // Number of elements along dim0 evaluated by one call to Node::calc
+    const int VECTOR_LENGTH = 256;
+
+    class Node;
+    typedef std::shared_ptr<Node> Node_ptr;
+
+    // Copies of the nodes made by Node::clone, so that nodes shared by
+    // several parents are copied once
+    typedef std::map<Node *, Node_ptr> CloneMap;
+
     class Node
     {
 
     protected:
         bool m_is_eval;
+        int m_id;
 
-    public:
-        Node() : m_is_eval(false) {}
+        // Buffer holding the values of the node once it has been evaluated.
+        // It then replaces the tree under the node in every expression.
+        Node_ptr m_result;
 
-        virtual void *calc(int x, int y, int z, int w)
+        // Adds the buffer holding the values of the node in place of its
+        // tree. Returns false when the node has not been evaluated.
+        bool getResultNodes(std::vector<Node *> &nodes)
         {
+            if (!m_result) return false;
+            m_result->getNodes(nodes);
+            m_id = m_result->getId();
             m_is_eval = true;
+            return true;
+        }
+
+    public:
+        Node() : m_is_eval(false), m_id(-1), m_result() {}
+
+        // Evaluates lim consecutive elements along dim0 starting at (x, y, z, w).
+        //
+        // vals[i] points to the values of the i-th node returned by getNodes.
+        // Children are always evaluated before their parents, so a node reads
+        // its inputs from vals[child->getId()]. buf has room for
+        // VECTOR_LENGTH values of the output type. The returned pointer is
+        // either buf or a pointer to memory owned by the node.
+        virtual const void *calc(int x, int y, int z, int w, int lim,
+                                 void *buf, const void * const *vals)
+        {
+            return NULL;
+        }
+
+        // Same as above, but idx is a linear index into the output.
+        // Only valid when isLinear() returns true for the output dims.
+        virtual const void *calc(dim_t idx, int lim,
+                                 void *buf, const void * const *vals)
+        {
             return NULL;
         }
 
+        // Returns true if every buffer in the tree has the output dimensions
+        // and is stored contiguously, i.e. the tree can be evaluated as 1D.
+        virtual bool isLinear(const dim_t *dims) { return true; }
+
+        // Size in bytes of one output value, used to size the buffers
+        // passed to calc
+        virtual int getTypeSize() { return 0; }
+
+        // Size in bytes of the buffer passed to calc. Nodes that evaluate
+        // trees of their own need room beyond their VECTOR_LENGTH values.
+        virtual int getBufferSize() { return VECTOR_LENGTH * getTypeSize(); }
+
+        // Returns a copy of the tree, sharing the memory of the buffers
+        virtual Node_ptr clone(CloneMap &cloned) = 0;
+
+        // Called once the values of the node are stored in result. Nodes with
+        // children release them and read result from then on, so trees that
+        // share the node do not evaluate it again.
+        virtual void setResult(Node_ptr result) {}
+
+        // Appends all the nodes in the tree to nodes, children before parents.
+        // Nodes shared by several parents appear only once. reset() must be
+        // called on the root before the tree is traversed again.
+        virtual void getNodes(std::vector<Node *> &nodes)
+        {
+            if (m_is_eval) return;
+            m_id = (int)nodes.size();
+            nodes.push_back(this);
+            m_is_eval = true;
+        }
+
         virtual void getInfo(unsigned &len, unsigned &buf_count, unsigned &bytes)
         {
             len = 0;
@@ -44,10 +116,10 @@ namespace TNJ
 
         virtual void reset() { m_is_eval = false;}
 
+        int getId() const { return m_id; }
+
         virtual ~Node() {}
     };
-
-    typedef std::shared_ptr<Node> Node_ptr;
 }
 
 }
@@ -26,12 +26,37 @@ namespace TNJ
     protected:
         T m_val;
 
+        const void *eval(int lim, void *buf)
+        {
+            T *out = (T *)buf;
+            for (int i = 0; i < lim; i++) {
+                out[i] = m_val;
+            }
+            return buf;
+        }
+
     public:
         ScalarNode(T val) : Node(), m_val(val) {}
 
-        void *calc(int x, int y, int z, int w)
+        const void *calc(int x, int y, int z, int w, int lim,
+                         void *buf, const void * const *vals)
+        {
+            return eval(lim, buf);
+        }
+
+        const void *calc(dim_t idx, int lim,
+                         void *buf, const void * const *vals)
+        {
+            return eval(lim, buf);
+        }
+
+        int getTypeSize() { return sizeof(T); }
+
+        Node_ptr clone(CloneMap &cloned)
         {
-            return (void *)(&m_val);
+            Node_ptr &res = cloned[this];
+            if (!res) res = Node_ptr(new ScalarNode<T>(m_val));
+            return res;
         }
 
         void getInfo(unsigned &len, unsigned &buf_count, unsigned &bytes)
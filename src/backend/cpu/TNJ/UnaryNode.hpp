@@ -36,28 +36,80 @@ namespace TNJ
     protected:
         Node_ptr m_child;
         UnOp <To, Ti, op> m_op;
-        To m_val;
+
+        const void *eval(int lim, void *buf, const void * const *vals)
+        {
+            To *out = (To *)buf;
+            const Ti *in = (const Ti *)vals[m_child->getId()];
+
+            for (int i = 0; i < lim; i++) {
+                out[i] = m_op.eval(in[i]);
+            }
+
+            return buf;
+        }
 
     public:
         UnaryNode(Node_ptr in) :
             Node(),
-            m_child(in),
-            m_val(0)
+            m_child(in)
         {
         }
 
-        void *calc(int x, int y, int z, int w)
+        const void *calc(int x, int y, int z, int w, int lim,
+                         void *buf, const void * const *vals)
         {
-            m_val = m_op.eval(*(Ti *)m_child->calc(x, y, z, w));
-            return (void *)(&m_val);
+            return eval(lim, buf, vals);
+        }
+
+        const void *calc(dim_t idx, int lim,
+                         void *buf, const void * const *vals)
+        {
+            return eval(lim, buf, vals);
+        }
+
+        bool isLinear(const dim_t *dims)
+        {
+            if (m_result) return m_result->isLinear(dims);
+            return m_child->isLinear(dims);
+        }
+
+        int getTypeSize() { return sizeof(To); }
+
+        Node_ptr clone(CloneMap &cloned)
+        {
+            if (m_result) return m_result->clone(cloned);
+
+            Node_ptr &res = cloned[this];
+            if (!res) res = Node_ptr(new UnaryNode<To, Ti, op>(m_child->clone(cloned)));
+            return res;
+        }
+
+        void setResult(Node_ptr result)
+        {
+            m_result = result;
+            m_child.reset();
+        }
+
+        void getNodes(std::vector<Node *> &nodes)
+        {
+            if (m_is_eval) return;
+            if (getResultNodes(nodes)) return;
+
+            m_child->getNodes(nodes);
+            Node::getNodes(nodes);
         }
 
         void getInfo(unsigned &len, unsigned &buf_count, unsigned &bytes)
         {
             if (m_is_eval) return;
 
-            m_child->getInfo(len, buf_count, bytes);
-            len++;
+            if (m_result) {
+                m_result->getInfo(len, buf_count, bytes);
+            } else {
+                m_child->getInfo(len, buf_count, bytes);
+                len++;
+            }
 
             m_is_eval = true;
             return;
@@ -65,6 +117,10 @@ namespace TNJ
 
         void reset()
         {
+            if (!m_is_eval) return;
+
+            if (m_result) m_result->reset();
+            else          m_child->reset();
             m_is_eval = false;
         }
     };
@@ -12,10 +12,13 @@
 #include <ArrayInfo.hpp>
 #include <Array.hpp>
 #include <bilateral.hpp>
+#include <parallel.hpp>
 #include <cmath>
 #include <algorithm>
+#include <vector>
 
 using af::dim4;
+using std::vector;
 
 namespace cpu
 {
@@ -97,9 +100,222 @@ Array<outType> bilateral(const Array<inType> &in, const float &s_sigma, const fl
     return out;
 }
 
+///////////////////////////////////////////////////////////////////////////
+// Bilateral grid
+// Paris and Durand, "A fast approximation of the bilateral filter using a
+// signal processing approach", ECCV 2006
+//
+// The pixels are accumulated into a 3D grid over the two spatial dimensions
+// and the intensity, sampled at the spatial and chromatic sigmas. A Gaussian
+// blur of the grid then does the filtering, and every pixel reads its value
+// back with trilinear interpolation. The grid has a cell per sigma squared
+// pixels, so the cost does not depend on the spatial sigma.
+///////////////////////////////////////////////////////////////////////////
+
+// Cells of the grid of one image. Larger grids are sampled more coarsely in
+// space and blurred by more cells instead.
+static const dim_t BILATERAL_GRID_MAX_CELLS = 1 << 24;
+
+// Intensity cells of the grid. A larger intensity range is sampled more
+// coarsely.
+static const dim_t BILATERAL_GRID_MAX_RANGE = 256;
+
+// Normalized Gaussian of sigma cells, truncated at two sigmas
+template<typename T>
+static vector<T> gridKernel(const double sigma)
+{
+    if (!(sigma > 0)) return vector<T>(1, T(1));
+
+    const dim_t radius = (dim_t)std::ceil(2 * sigma);
+    vector<T> kernel(2 * radius + 1);
+    T sum = 0;
+    for (dim_t k = -radius; k <= radius; k++) {
+        kernel[k + radius] = (T)std::exp(-(k * k) / (2 * sigma * sigma));
+        sum += kernel[k + radius];
+    }
+    for (size_t k = 0; k < kernel.size(); k++) kernel[k] /= sum;
+    return kernel;
+}
+
+// Blurs the grid along one axis. The axis has len elements, stride values
+// apart, and each element is made of width contiguous values. There are
+// nlines such lines, lineStride values apart.
+template<typename T>
+static void blurGridAxis(T *grid, const dim_t nlines, const dim_t lineStride,
+                         const dim_t len, const dim_t stride, const dim_t width,
+                         const vector<T> &kernel)
+{
+    const dim_t radius = kernel.size() / 2;
+    if (radius == 0) return;
+
+    parallel_for(nlines, [&](dim_t begin, dim_t end) {
+            vector<T> line(len * width);
+
+            for (dim_t l = begin; l < end; l++) {
+                T *base = grid + l * lineStride;
+                for (dim_t i = 0; i < len; i++) {
+                    std::copy(base + i * stride, base + i * stride + width, &line[i * width]);
+                }
+
+                for (dim_t i = 0; i < len; i++) {
+                    T *dst = base + i * stride;
+                    std::fill(dst, dst + width, T(0));
+
+                    const dim_t k0 = std::max(-radius, -i);
+                    const dim_t k1 = std::min(radius, len - 1 - i);
+                    for (dim_t k = k0; k <= k1; k++) {
+                        const T w = kernel[k + radius];
+                        const T *src = &line[(i + k) * width];
+                        for (dim_t c = 0; c < width; c++) dst[c] += w * src[c];
+                    }
+                }
+            }
+        }, std::max<dim_t>(1, MIN_PARALLEL_ELEMENTS / (len * width)));
+}
+
+// Filters one image of w x h pixels. Cells hold the sum of the intensities and
+// the number of pixels next to each other.
+template<typename inType, typename outType>
+static void bilateralGridImage(outType *out, const dim4 &ostrides,
+                               const inType *in, const dim4 &istrides,
+                               const dim_t w, const dim_t h,
+                               const float s_sigma, const float c_sigma)
+{
+    // NaN and infinite pixels are left out of the grid and passed through
+    // unchanged
+    outType vmin = 0, vmax = 0;
+    bool found = false;
+    for (dim_t j = 0; j < h; j++) {
+        for (dim_t i = 0; i < w; i++) {
+            const outType v = (outType)in[getIdx(istrides, i, j)];
+            if (!std::isfinite(v)) continue;
+            vmin = found ? std::min(vmin, v) : v;
+            vmax = found ? std::max(vmax, v) : v;
+            found = true;
+        }
+    }
+
+    // Sampling rates of the grid, in pixels and in intensity. The grid has
+    // an extra cell along each axis for the interpolation.
+    double srange = c_sigma;
+    if (!(srange > 0) || (vmax - vmin) / srange > BILATERAL_GRID_MAX_RANGE - 1) {
+        srange = vmax > vmin ? (vmax - vmin) / (BILATERAL_GRID_MAX_RANGE - 1) : 1.0;
+    }
+    double sspace = std::max(s_sigma, 1.f);
+
+    const vector<outType> rkernel = gridKernel<outType>(c_sigma / srange);
+    const dim_t rpad = rkernel.size() / 2;
+    const dim_t gz = (dim_t)((vmax - vmin) / srange + 0.5) + 2 + 2 * rpad;
+
+    dim_t gx, gy, spad;
+    vector<outType> skernel;
+    while (true) {
+        skernel = gridKernel<outType>(s_sigma / sspace);
+        spad = skernel.size() / 2;
+        gx = (dim_t)((w - 1) / sspace + 0.5) + 2 + 2 * spad;
+        gy = (dim_t)((h - 1) / sspace + 0.5) + 2 + 2 * spad;
+        if (gx * gy * gz <= BILATERAL_GRID_MAX_CELLS) break;
+        sspace *= std::sqrt((double)(gx * gy * gz) / BILATERAL_GRID_MAX_CELLS);
+    }
+
+    const double ispace = 1.0 / sspace;
+    const double irange = 1.0 / srange;
+    const dim_t cell = 2 * gz;
+    vector<outType> grid(gx * gy * cell, outType(0));
+    outType *gptr = &grid.front();
+
+    // Pixel rows are splatted by the grid row they round to, so that each
+    // thread owns whole grid rows
+    vector<dim_t> rows(gy + 1, h);
+    for (dim_t j = h - 1; j >= 0; j--) rows[(dim_t)(j * ispace + 0.5) + spad] = j;
+    for (dim_t g = gy - 1; g >= 0; g--) rows[g] = std::min(rows[g], rows[g + 1]);
+
+    parallel_for(gy, [&](dim_t begin, dim_t end) {
+            for (dim_t g = begin; g < end; g++) {
+                for (dim_t j = rows[g]; j < rows[g + 1]; j++) {
+                    for (dim_t i = 0; i < w; i++) {
+                        const outType v = (outType)in[getIdx(istrides, i, j)];
+                        if (!std::isfinite(v)) continue;
+                        const dim_t x = (dim_t)(i * ispace + 0.5) + spad;
+                        const dim_t z = (dim_t)((v - vmin) * irange + 0.5) + rpad;
+                        outType *c = gptr + (g * gx + x) * cell + 2 * z;
+                        c[0] += v;
+                        c[1] += 1;
+                    }
+                }
+            }
+        }, std::max<dim_t>(1, MIN_PARALLEL_ELEMENTS / (dim_t)(w * sspace)));
+
+    blurGridAxis(gptr, gx * gy, cell, gz, 2, 2, rkernel);
+    blurGridAxis(gptr, gy, gx * cell, gx, cell, cell, skernel);
+    blurGridAxis(gptr, gx, cell, gy, gx * cell, cell, skernel);
+
+    parallel_for(h, [&](dim_t begin, dim_t end) {
+            for (dim_t j = begin; j < end; j++) {
+                const double fy = j * ispace + spad;
+                const dim_t y0  = (dim_t)fy;
+                const outType wy = (outType)(fy - y0);
+
+                for (dim_t i = 0; i < w; i++) {
+                    const outType v = (outType)in[getIdx(istrides, i, j)];
+                    if (!std::isfinite(v)) {
+                        out[getIdx(ostrides, i, j)] = v;
+                        continue;
+                    }
+                    const double fx = i * ispace + spad;
+                    const double fz = (v - vmin) * irange + rpad;
+                    const dim_t x0  = (dim_t)fx;
+                    const dim_t z0  = (dim_t)fz;
+                    const outType wx = (outType)(fx - x0);
+                    const outType wz = (outType)(fz - z0);
+
+                    outType num = 0, den = 0;
+                    for (int dy = 0; dy < 2; dy++) {
+                        for (int dx = 0; dx < 2; dx++) {
+                            const outType wxy = (dy ? wy : 1 - wy) * (dx ? wx : 1 - wx);
+                            const outType *c = gptr + ((y0 + dy) * gx + x0 + dx) * cell + 2 * z0;
+                            num += wxy * ((1 - wz) * c[0] + wz * c[2]);
+                            den += wxy * ((1 - wz) * c[1] + wz * c[3]);
+                        }
+                    }
+
+                    out[getIdx(ostrides, i, j)] = den > 0 ? num / den : v;
+                }
+            }
+        }, std::max<dim_t>(1, MIN_PARALLEL_ELEMENTS / w));
+}
+
+template<typename inType, typename outType>
+Array<outType> bilateralGrid(const Array<inType> &in, const float &s_sigma, const float &c_sigma)
+{
+    const dim4 dims     = in.dims();
+    const dim4 istrides = in.strides();
+
+    Array<outType> out = createEmptyArray<outType>(dims);
+    const dim4 ostrides = out.strides();
+
+    outType *outData      = out.get();
+    const inType * inData = in.get();
+
+    const float space_ = std::max(s_sigma, 0.f);
+    const float color_ = std::max(c_sigma, 0.f);
+
+    // Channels and batches are filtered independently, like the exact path
+    for (dim_t b3 = 0; b3 < dims[3]; ++b3) {
+        for (dim_t b2 = 0; b2 < dims[2]; ++b2) {
+            bilateralGridImage<inType, outType>(outData + b2 * ostrides[2] + b3 * ostrides[3], ostrides,
+                                                inData + b2 * istrides[2] + b3 * istrides[3], istrides,
+                                                dims[0], dims[1], space_, color_);
+        }
+    }
+
+    return out;
+}
+
 #define INSTANTIATE(inT, outT)\
 template Array<outT> bilateral<inT, outT,true >(const Array<inT> &in, const float &s_sigma, const float &c_sigma);\
-template Array<outT> bilateral<inT, outT,false>(const Array<inT> &in, const float &s_sigma, const float &c_sigma);
+template Array<outT> bilateral<inT, outT,false>(const Array<inT> &in, const float &s_sigma, const float &c_sigma);\
+template Array<outT> bilateralGrid<inT, outT>(const Array<inT> &in, const float &s_sigma, const float &c_sigma);
 
 INSTANTIATE(double, double)
 INSTANTIATE(float ,  float)
@@ -13,6 +13,9 @@
 #include <cassert>
 #include <err_cpu.hpp>
 #include <err_common.hpp>
+#include <parallel.hpp>
+#include <algorithm>
+#include <vector>
 
 namespace cpu
 {
@@ -141,6 +144,75 @@ struct cblas_types<cdouble> {
 #define REINTERPRET_CAST(PTR_TYPE, X) (X)
 #endif
 
+// Matrices with all dimensions up to this size are multiplied without
+// calling into BLAS, where the call overhead dominates the work
+static const dim_t MATMUL_SMALL_DIM = 4;
+
+template<typename T>
+static inline T getConjugate(const T &in)
+{
+    return in;
+}
+
+template<>
+inline cfloat getConjugate(const cfloat &in)
+{
+    return std::conj(in);
+}
+
+template<>
+inline cdouble getConjugate(const cdouble &in)
+{
+    return std::conj(in);
+}
+
+// Writes op(src), a rows x cols matrix, to dst with a leading dimension of rows
+template<typename T>
+static void packMatrix(T *dst, const T *src, const dim_t ld, CBLAS_TRANSPOSE opt,
+                       const dim_t rows, const dim_t cols)
+{
+    for (dim_t c = 0; c < cols; c++) {
+        T *d = dst + c * rows;
+        switch (opt) {
+        case CblasNoTrans:
+            for (dim_t r = 0; r < rows; r++) d[r] = src[c * ld + r];
+            break;
+        case CblasTrans:
+            for (dim_t r = 0; r < rows; r++) d[r] = src[r * ld + c];
+            break;
+        default:
+            for (dim_t r = 0; r < rows; r++) d[r] = getConjugate(src[r * ld + c]);
+            break;
+        }
+    }
+}
+
+// C = op(A) * op(B) for small matrices. The operands are packed into buf,
+// which holds M * K + K * N elements, so the inner loop has unit strides.
+template<typename T>
+static void gemmSmall(T *C, const dim_t ldc,
+                      const T *A, const dim_t lda, CBLAS_TRANSPOSE aOpt,
+                      const T *B, const dim_t ldb, CBLAS_TRANSPOSE bOpt,
+                      const dim_t M, const dim_t N, const dim_t K, T *buf)
+{
+    T *a = buf;
+    T *b = buf + M * K;
+    packMatrix(a, A, lda, aOpt, M, K);
+    packMatrix(b, B, ldb, bOpt, K, N);
+
+    for (dim_t j = 0; j < N; j++) {
+        T *c = C + j * ldc;
+        std::fill(c, c + M, T(0));
+        for (dim_t k = 0; k < K; k++) {
+            const T bkj = b[j * K + k];
+            const T *ak = a + k * M;
+            for (dim_t i = 0; i < M; i++) c[i] += ak[i] * bkj;
+        }
+    }
+}
+
+// Multiplies every matrix along dimensions 2 and 3. A batch dimension of
+// size 1 in one of the inputs is broadcast against the other input.
 template<typename T>
 Array<T> matmul(const Array<T> &lhs, const Array<T> &rhs,
                 af_mat_prop optLhs, af_mat_prop optRhs)
@@ -150,6 +222,7 @@ Array<T> matmul(const Array<T> &lhs, const Array<T> &rhs,
 
     int aRowDim = (lOpts == CblasNoTrans) ? 0 : 1;
     int aColDim = (lOpts == CblasNoTrans) ? 1 : 0;
+    int bRowDim = (rOpts == CblasNoTrans) ? 0 : 1;
     int bColDim = (rOpts == CblasNoTrans) ? 1 : 0;
 
     dim4 lDims = lhs.dims();
@@ -158,45 +231,111 @@ Array<T> matmul(const Array<T> &lhs, const Array<T> &rhs,
     int N = rDims[bColDim];
     int K = lDims[aColDim];
 
+    const dim_t batch2 = std::max(lDims[2], rDims[2]);
+    const dim_t batch3 = std::max(lDims[3], rDims[3]);
+
     //FIXME: Leaks on errors.
-    Array<T> out = createEmptyArray<T>(af::dim4(M, N, 1, 1));
+    Array<T> out = createEmptyArray<T>(af::dim4(M, N, batch2, batch3));
     auto alpha = getScale<T, BT, 1>();
     auto beta  = getScale<T, BT, 0>();
 
     dim4 lStrides = lhs.strides();
     dim4 rStrides = rhs.strides();
-    if(rDims[bColDim] == 1) {
-        N = lDims[aColDim];
-        gemv_func<T, BT>()(
-            CblasColMajor, lOpts,
-            lDims[0], lDims[1],
-            alpha, REINTERPRET_CAST(const BT*, lhs.get()), lStrides[1],
-            REINTERPRET_CAST(const BT*, rhs.get()), rStrides[0],
-            beta, REINTERPRET_CAST(BT*, out.get()), 1);
-    } else {
-        gemm_func<T, BT>()(
-            CblasColMajor, lOpts, rOpts,
-            M, N, K,
-            alpha, REINTERPRET_CAST(const BT*, lhs.get()), lStrides[1],
-            REINTERPRET_CAST(const BT*, rhs.get()), rStrides[1],
-            beta, REINTERPRET_CAST(BT*, out.get()), out.dims()[0]);
-    }
+    dim4 oStrides = out.strides();
+
+    const T *lPtr = lhs.get();
+    const T *rPtr = rhs.get();
+    T *oPtr = out.get();
+
+    const bool isSmall = M <= MATMUL_SMALL_DIM && N <= MATMUL_SMALL_DIM && K <= MATMUL_SMALL_DIM;
+    // gemv can not conjugate the vector
+    const bool isVector = N == 1 && !(is_complex<T>::value && rOpts == CblasConjTrans);
+    const dim_t work = std::max<dim_t>(1, (dim_t)M * N * K);
+
+    // Each batch is an independent BLAS call. Small batches are grouped so
+    // that a task has enough work to be worth scheduling.
+    parallel_for(batch2 * batch3, [&](dim_t begin, dim_t end) {
+            std::vector<T> buf(isSmall ? M * K + K * N : 0);
+
+            for (dim_t b = begin; b < end; b++) {
+                const dim_t b2 = b % batch2;
+                const dim_t b3 = b / batch2;
+
+                const T *lptr = lPtr + (lDims[2] == 1 ? 0 : b2 * lStrides[2])
+                                     + (lDims[3] == 1 ? 0 : b3 * lStrides[3]);
+                const T *rptr = rPtr + (rDims[2] == 1 ? 0 : b2 * rStrides[2])
+                                     + (rDims[3] == 1 ? 0 : b3 * rStrides[3]);
+                T *optr = oPtr + b2 * oStrides[2] + b3 * oStrides[3];
+
+                if (isSmall) {
+                    gemmSmall(optr, oStrides[1],
+                              lptr, lStrides[1], lOpts,
+                              rptr, rStrides[1], rOpts,
+                              M, N, K, buf.data());
+                } else if (isVector) {
+                    gemv_func<T, BT>()(
+                        CblasColMajor, lOpts,
+                        lDims[0], lDims[1],
+                        alpha, REINTERPRET_CAST(const BT*, lptr), lStrides[1],
+                        REINTERPRET_CAST(const BT*, rptr), rStrides[bRowDim],
+                        beta, REINTERPRET_CAST(BT*, optr), 1);
+                } else {
+                    gemm_func<T, BT>()(
+                        CblasColMajor, lOpts, rOpts,
+                        M, N, K,
+                        alpha, REINTERPRET_CAST(const BT*, lptr), lStrides[1],
+                        REINTERPRET_CAST(const BT*, rptr), rStrides[1],
+                        beta, REINTERPRET_CAST(BT*, optr), oStrides[1]);
+                }
+            }
+        }, std::max<dim_t>(1, MIN_PARALLEL_ELEMENTS / work));
 
     return out;
 }
 
+// Dot product of x and y, with x conjugated when conjugate is true
+template<typename T, bool conjugate>
+T dot_func(const int N, const T *x, const int incx, const T *y, const int incy);
+
+#define BLAS_DOT_REAL(TYPE, PREFIX)                                                 \
+template<> TYPE dot_func<TYPE, false>(const int N, const TYPE *x, const int incx,   \
+                                      const TYPE *y, const int incy)                \
+{ return cblas_##PREFIX##dot(N, x, incx, y, incy); }                                \
+template<> TYPE dot_func<TYPE, true>(const int N, const TYPE *x, const int incx,    \
+                                     const TYPE *y, const int incy)                 \
+{ return cblas_##PREFIX##dot(N, x, incx, y, incy); }
+
+#define BLAS_DOT_CPLX(TYPE, PREFIX)                                                 \
+template<> TYPE dot_func<TYPE, false>(const int N, const TYPE *x, const int incx,   \
+                                      const TYPE *y, const int incy)                \
+{ TYPE out; cblas_##PREFIX##dotu_sub(N, x, incx, y, incy, &out); return out; }      \
+template<> TYPE dot_func<TYPE, true>(const int N, const TYPE *x, const int incx,    \
+                                     const TYPE *y, const int incy)                 \
+{ TYPE out; cblas_##PREFIX##dotc_sub(N, x, incx, y, incy, &out); return out; }
+
+BLAS_DOT_REAL(float  , s)
+BLAS_DOT_REAL(double , d)
+BLAS_DOT_CPLX(cfloat , c)
+BLAS_DOT_CPLX(cdouble, z)
+
+#undef BLAS_DOT_REAL
+#undef BLAS_DOT_CPLX
+
+// Only optLhs can be AF_MAT_CONJ, the C API swaps the inputs when the right
+// hand side has to be conjugated
 template<typename T>
 Array<T> dot(const Array<T> &lhs, const Array<T> &rhs,
              af_mat_prop optLhs, af_mat_prop optRhs)
 {
     int N = lhs.dims()[0];
 
-    T out = 0;
     const T *pL = lhs.get();
     const T *pR = rhs.get();
+    const int incL = lhs.strides()[0];
+    const int incR = rhs.strides()[0];
 
-    for(int i = 0; i < N; i++)
-        out += pL[i] * pR[i];
+    T out = (optLhs == AF_MAT_CONJ) ? dot_func<T, true >(N, pL, incL, pR, incR)
+                                    : dot_func<T, false>(N, pL, incL, pR, incR);
 
     return createValueArray(af::dim4(1), out);
 }
@@ -219,5 +358,7 @@ INSTANTIATE_BLAS(cdouble)
 
 INSTANTIATE_DOT(float)
 INSTANTIATE_DOT(double)
+INSTANTIATE_DOT(cfloat)
+INSTANTIATE_DOT(cdouble)
 
 }
@@ -20,6 +20,8 @@
 #include <triangle.hpp>
 
 #include <lapack_helper.hpp>
+#include <lapack_batched.hpp>
+#include <vector>
 
 namespace cpu
 {
@@ -59,16 +61,35 @@ template<typename T>
 int cholesky_inplace(Array<T> &in, const bool is_upper)
 {
     dim4 iDims = in.dims();
+    dim4 iStrides = in.strides();
     int N = iDims[0];
 
+    // LAPACK rejects the leading dimension of empty matrices
+    if (in.elements() == 0) return 0;
+
     char uplo = 'L';
     if(is_upper)
         uplo = 'U';
 
-    int info = potrf_func<T>()(AF_LAPACK_COL_MAJOR, uplo,
-                               N, in.get(), in.strides()[1]);
-
-    return info;
+    T *data = in.get();
+    cholesky_small_func<T> small = choleskySmallFunc<T>(N);
+
+    // The result of the first matrix that fails is returned
+    std::vector<int> info(iDims[2] * iDims[3]);
+    parallel_for_matrices(iDims, [&](dim_t b) {
+            const dim_t off = matrixOffset(b, iDims, iStrides);
+            if (small) {
+                info[b] = small(data + off, iStrides[1], is_upper);
+            } else {
+                info[b] = potrf_func<T>()(AF_LAPACK_COL_MAJOR, uplo,
+                                          N, data + off, iStrides[1]);
+            }
+        }, lapackBatchGrain(N));
+
+    for (size_t b = 0; b < info.size(); b++) {
+        if (info[b] != 0) return info[b];
+    }
+    return 0;
 }
 
 #define INSTANTIATE_CH(T)                                                                   \
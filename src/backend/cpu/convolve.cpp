@@ -14,6 +14,8 @@
 #include <convolve.hpp>
 #include <err_cpu.hpp>
 #include <math.hpp>
+#include <platform.hpp>
+#include <parallel.hpp>
 
 using af::dim4;
 
@@ -26,15 +28,17 @@ void one2one_1d(T *optr, T const *iptr, accT const *fptr, dim4 const &oDims,
 {
     dim_t start = (expand ? 0 : fDims[0]/2);
     dim_t end   = (expand ? oDims[0] : start + sDims[0]);
-    for(dim_t i=start; i<end; ++i) {
-        accT accum = 0.0;
-        for(dim_t f=0; f<fDims[0]; ++f) {
-            dim_t iIdx = i-f;
-            T s_val = ((iIdx>=0 &&iIdx<sDims[0])? iptr[iIdx*sStrides[0]] : T(0));
-            accum += accT(s_val * fptr[f]);
+    parallel_for(end-start, [&](dim_t begin, dim_t stop) {
+        for(dim_t i=start+begin; i<start+stop; ++i) {
+            accT accum = 0.0;
+            for(dim_t f=0; f<fDims[0]; ++f) {
+                dim_t iIdx = i-f;
+                T s_val = ((iIdx>=0 &&iIdx<sDims[0])? iptr[iIdx*sStrides[0]] : T(0));
+                accum += accT(s_val * fptr[f]);
+            }
+            optr[i-start] = T(accum);
         }
-        optr[i-start] = T(accum);
-    }
+    }, MIN_PARALLEL_ELEMENTS / fDims[0]);
 }
 
 template<typename T, typename accT, bool expand>
@@ -47,32 +51,35 @@ void one2one_2d(T *optr, T const *iptr, accT const *fptr, dim4 const &oDims,
     dim_t iStart = (expand ? 0 : fDims[0]/2);
     dim_t iEnd   = (expand ? oDims[0] : iStart + sDims[0]);
 
-    for(dim_t j=jStart; j<jEnd; ++j) {
-        dim_t joff = (j-jStart)*oStrides[1];
-
-        for(dim_t i=iStart; i<iEnd; ++i) {
+    // Columns of the output are independent
+    parallel_for(jEnd-jStart, [&](dim_t begin, dim_t end) {
+        for(dim_t j=jStart+begin; j<jStart+end; ++j) {
+            dim_t joff = (j-jStart)*oStrides[1];
 
-            accT accum = accT(0);
-            for(dim_t wj=0; wj<fDims[1]; ++wj) {
-                dim_t jIdx  = j-wj;
-                dim_t w_joff = wj*fStrides[1];
-                dim_t s_joff = jIdx * sStrides[1];
-                bool isJValid = (jIdx>=0 && jIdx<sDims[1]);
+            for(dim_t i=iStart; i<iEnd; ++i) {
 
-                for(dim_t wi=0; wi<fDims[0]; ++wi) {
-                    dim_t iIdx = i-wi;
+                accT accum = accT(0);
+                for(dim_t wj=0; wj<fDims[1]; ++wj) {
+                    dim_t jIdx  = j-wj;
+                    dim_t w_joff = wj*fStrides[1];
+                    dim_t s_joff = jIdx * sStrides[1];
+                    bool isJValid = (jIdx>=0 && jIdx<sDims[1]);
+
+                    for(dim_t wi=0; wi<fDims[0]; ++wi) {
+                        dim_t iIdx = i-wi;
+
+                        T s_val = T(0);
+                        if ( isJValid && (iIdx>=0 && iIdx<sDims[0])) {
+                            s_val = iptr[s_joff+iIdx*sStrides[0]];
+                        }
 
-                    T s_val = T(0);
-                    if ( isJValid && (iIdx>=0 && iIdx<sDims[0])) {
-                        s_val = iptr[s_joff+iIdx*sStrides[0]];
+                        accum += accT(s_val * fptr[w_joff+wi*fStrides[0]]);
                     }
-
-                    accum += accT(s_val * fptr[w_joff+wi*fStrides[0]]);
                 }
+                optr[joff+i-iStart] = T(accum);
             }
-            optr[joff+i-iStart] = T(accum);
         }
-    }
+    }, MIN_PARALLEL_ELEMENTS / (oDims[0] * fDims[0] * fDims[1]));
 }
 
 template<typename T, typename accT, bool expand>
@@ -87,43 +94,46 @@ void one2one_3d(T *optr, T const *iptr, accT const *fptr, dim4 const &oDims,
     dim_t iStart = (expand ? 0 : fDims[0]/2);
     dim_t iEnd   = (expand ? oDims[0] : iStart + sDims[0]);
 
-    for(dim_t k=kStart; k<kEnd; ++k) {
-        dim_t koff = (k-kStart)*oStrides[2];
+    // Slices of the output are independent
+    parallel_for(kEnd-kStart, [&](dim_t begin, dim_t end) {
+        for(dim_t k=kStart+begin; k<kStart+end; ++k) {
+            dim_t koff = (k-kStart)*oStrides[2];
 
-        for(dim_t j=jStart; j<jEnd; ++j) {
-            dim_t joff = (j-jStart)*oStrides[1];
+            for(dim_t j=jStart; j<jEnd; ++j) {
+                dim_t joff = (j-jStart)*oStrides[1];
 
-            for(dim_t i=iStart; i<iEnd; ++i) {
+                for(dim_t i=iStart; i<iEnd; ++i) {
 
-                accT accum = accT(0);
-                for(dim_t wk=0; wk<fDims[2]; ++wk) {
-                    dim_t kIdx  = k-wk;
-                    dim_t w_koff = wk*fStrides[2];
-                    dim_t s_koff = kIdx * sStrides[2];
-                    bool isKValid = (kIdx>=0 && kIdx<sDims[2]);
-
-                    for(dim_t wj=0; wj<fDims[1]; ++wj) {
-                        dim_t jIdx  = j-wj;
-                        dim_t w_joff = wj*fStrides[1];
-                        dim_t s_joff = jIdx * sStrides[1];
-                        bool isJValid = (jIdx>=0 && jIdx<sDims[1]);
-
-                        for(dim_t wi=0; wi<fDims[0]; ++wi) {
-                            dim_t iIdx = i-wi;
-
-                            T s_val = T(0);
-                            if ( isKValid && isJValid && (iIdx>=0 && iIdx<sDims[0])) {
-                                s_val = iptr[s_koff+s_joff+iIdx*sStrides[0]];
-                            }
+                    accT accum = accT(0);
+                    for(dim_t wk=0; wk<fDims[2]; ++wk) {
+                        dim_t kIdx  = k-wk;
+                        dim_t w_koff = wk*fStrides[2];
+                        dim_t s_koff = kIdx * sStrides[2];
+                        bool isKValid = (kIdx>=0 && kIdx<sDims[2]);
+
+                        for(dim_t wj=0; wj<fDims[1]; ++wj) {
+                            dim_t jIdx  = j-wj;
+                            dim_t w_joff = wj*fStrides[1];
+                            dim_t s_joff = jIdx * sStrides[1];
+                            bool isJValid = (jIdx>=0 && jIdx<sDims[1]);
 
-                            accum += accT(s_val * fptr[w_koff+w_joff+wi*fStrides[0]]);
+                            for(dim_t wi=0; wi<fDims[0]; ++wi) {
+                                dim_t iIdx = i-wi;
+
+                                T s_val = T(0);
+                                if ( isKValid && isJValid && (iIdx>=0 && iIdx<sDims[0])) {
+                                    s_val = iptr[s_koff+s_joff+iIdx*sStrides[0]];
+                                }
+
+                                accum += accT(s_val * fptr[w_koff+w_joff+wi*fStrides[0]]);
+                            }
                         }
                     }
-                }
-                optr[koff+joff+i-iStart] = T(accum);
-            } //i loop ends here
-        } // j loop ends here
-    } // k loop ends here
+                    optr[koff+joff+i-iStart] = T(accum);
+                } //i loop ends here
+            } // j loop ends here
+        } // k loop ends here
+    }, MIN_PARALLEL_ELEMENTS / (oDims[0] * oDims[1] * fDims[0] * fDims[1] * fDims[2]));
 }
 
 template<typename T, typename accT, dim_t baseDim, bool expand>
@@ -160,21 +170,28 @@ void convolve_nd(T *optr, T const *iptr, accT const *fptr,
         }
     }
 
-    for (dim_t b3=0; b3<batch[3]; ++b3) {
-        for (dim_t b2=0; b2<batch[2]; ++b2) {
-            for (dim_t b1=0; b1<batch[1]; ++b1) {
+    auto convolveBatch = [&](dim_t b1, dim_t b2, dim_t b3) {
+        T * out          = optr + b1 * out_step[1] + b2 * out_step[2] + b3 * out_step[3];
+        T const *in      = iptr + b1 *  in_step[1] + b2 *  in_step[2] + b3 *  in_step[3];
+        accT const *filt = fptr + b1 *filt_step[1] + b2 *filt_step[2] + b3 *filt_step[3];
 
-                T * out          = optr + b1 * out_step[1] + b2 * out_step[2] + b3 * out_step[3];
-                T const *in      = iptr + b1 *  in_step[1] + b2 *  in_step[2] + b3 *  in_step[3];
-                accT const *filt = fptr + b1 *filt_step[1] + b2 *filt_step[2] + b3 *filt_step[3];
-
-                switch(baseDim) {
-                    case 1: one2one_1d<T, accT, expand>(out, in, filt, oDims, sDims, fDims, sStrides);                     break;
-                    case 2: one2one_2d<T, accT, expand>(out, in, filt, oDims, sDims, fDims, oStrides, sStrides, fStrides); break;
-                    case 3: one2one_3d<T, accT, expand>(out, in, filt, oDims, sDims, fDims, oStrides, sStrides, fStrides); break;
-                }
-            }
+        switch(baseDim) {
+            case 1: one2one_1d<T, accT, expand>(out, in, filt, oDims, sDims, fDims, sStrides);                     break;
+            case 2: one2one_2d<T, accT, expand>(out, in, filt, oDims, sDims, fDims, oStrides, sStrides, fStrides); break;
+            case 3: one2one_3d<T, accT, expand>(out, in, filt, oDims, sDims, fDims, oStrides, sStrides, fStrides); break;
         }
+    };
+
+    // Spread the batches across threads when there are enough of them to
+    // keep every thread busy, parallelize inside each signal otherwise
+    dim4 bDims(1, batch[1], batch[2], batch[3]);
+    if (bDims.elements() >= getNumThreads()) {
+        parallel_for_batch(bDims, convolveBatch);
+    } else {
+        for (dim_t b3=0; b3<batch[3]; ++b3)
+            for (dim_t b2=0; b2<batch[2]; ++b2)
+                for (dim_t b1=0; b1<batch[1]; ++b1)
+                    convolveBatch(b1, b2, b3);
     }
 }
 
@@ -215,39 +232,41 @@ void convolve2_separable(T *optr, T const *iptr, accT const *fptr,
                         dim4 const &oDims, dim4 const &sDims, dim4 const &orgDims, dim_t fDim,
                         dim4 const &oStrides, dim4 const &sStrides, dim_t fStride)
 {
-    for(dim_t j=0; j<oDims[1]; ++j) {
+    parallel_for(oDims[1], [&](dim_t begin, dim_t end) {
+        for(dim_t j=begin; j<end; ++j) {
 
-        dim_t jOff = j*oStrides[1];
-        dim_t cj = j + (conv_dim==1)*(expand ? 0: fDim>>1);
+            dim_t jOff = j*oStrides[1];
+            dim_t cj = j + (conv_dim==1)*(expand ? 0: fDim>>1);
 
-        for(dim_t i=0; i<oDims[0]; ++i) {
+            for(dim_t i=0; i<oDims[0]; ++i) {
 
-            dim_t iOff = i*oStrides[0];
-            dim_t ci = i + (conv_dim==0)*(expand ? 0 : fDim>>1);
+                dim_t iOff = i*oStrides[0];
+                dim_t ci = i + (conv_dim==0)*(expand ? 0 : fDim>>1);
 
-            accT accum = scalar<accT>(0);
+                accT accum = scalar<accT>(0);
 
-            for(dim_t f=0; f<fDim; ++f) {
-                T f_val = fptr[f];
-                T s_val;
+                for(dim_t f=0; f<fDim; ++f) {
+                    T f_val = fptr[f];
+                    T s_val;
 
-                if (conv_dim==0) {
-                    dim_t offi = ci - f;
-                    bool isCIValid = offi>=0 && offi<sDims[0];
-                    bool isCJValid = cj>=0 && cj<sDims[1];
-                    s_val = (isCJValid && isCIValid ? iptr[cj*sDims[0]+offi] : scalar<T>(0));
-                } else {
-                    dim_t offj = cj - f;
-                    bool isCIValid = ci>=0 && ci<sDims[0];
-                    bool isCJValid = offj>=0 && offj<sDims[1];
-                    s_val = (isCJValid && isCIValid ? iptr[offj*sDims[0]+ci] : scalar<T>(0));
-                }
+                    if (conv_dim==0) {
+                        dim_t offi = ci - f;
+                        bool isCIValid = offi>=0 && offi<sDims[0];
+                        bool isCJValid = cj>=0 && cj<sDims[1];
+                        s_val = (isCJValid && isCIValid ? iptr[cj*sStrides[1]+offi*sStrides[0]] : scalar<T>(0));
+                    } else {
+                        dim_t offj = cj - f;
+                        bool isCIValid = ci>=0 && ci<sDims[0];
+                        bool isCJValid = offj>=0 && offj<sDims[1];
+                        s_val = (isCJValid && isCIValid ? iptr[offj*sStrides[1]+ci*sStrides[0]] : scalar<T>(0));
+                    }
 
-                accum += accT(s_val * f_val);
+                    accum += accT(s_val * f_val);
+                }
+                optr[iOff+jOff] = T(accum);
             }
-            optr[iOff+jOff] = T(accum);
         }
-    }
+    }, MIN_PARALLEL_ELEMENTS / (oDims[0] * fDim));
 }
 
 template<typename T, typename accT, bool expand>
@@ -301,6 +320,35 @@ Array<T> convolve2(Array<T> const& signal, Array<accT> const& c_filter, Array<ac
     return out;
 }
 
+// Cost of the separable route per unit of work, relative to one multiply-add
+// of the spatial kernels. Measured with examples/benchmarks/convolve_bench.cpp.
+static const double CONV_SEPARABLE_COST = 0.85;
+
+// The spatial kernels take filters of any size, and the separable kernels
+// are used instead when they do less work. The cost of the FFT route has not
+// been measured against FFTW yet, so AF_CONV_AUTO stays in the spatial domain
+// on this backend until it is.
+ConvolveRoute convolveRoute(const dim_t baseDim, dim4 const& sDims, dim4 const& fDims,
+                            const bool expand, const bool isComplex, const bool allowSeparable)
+{
+    if (baseDim != 2 || !allowSeparable) return CONV_SPATIAL_ROUTE;
+
+    double outElems = 1, filterElems = 1, filterLen = 0;
+    for (dim_t i = 0; i < baseDim; i++) {
+        outElems    *= expand ? sDims[i] + fDims[i] - 1 : sDims[i];
+        filterElems *= fDims[i];
+        filterLen   += fDims[i];
+    }
+
+    double fBatch = 1;
+    for (dim_t i = baseDim; i < 4; i++) fBatch *= fDims[i];
+    if (fBatch != 1 || fDims[0] == 1 || fDims[1] == 1) return CONV_SPATIAL_ROUTE;
+
+    const double spatial   = outElems * filterElems;
+    const double separable = CONV_SEPARABLE_COST * outElems * filterLen;
+    return separable < spatial ? CONV_SEPARABLE_ROUTE : CONV_SPATIAL_ROUTE;
+}
+
 #define INSTANTIATE(T, accT)                                            \
     template Array<T> convolve <T, accT, 1, true >(Array<T> const& signal, Array<accT> const& filter, ConvolveBatchKind kind); \
     template Array<T> convolve <T, accT, 1, false>(Array<T> const& signal, Array<accT> const& filter, ConvolveBatchKind kind); \
@@ -16,8 +16,17 @@
 #include <fftw3.h>
 #include <copy.hpp>
 #include <math.hpp>
+#include <memory.hpp>
+#include <cstdlib>
+#include <list>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <type_traits>
 
 using af::dim4;
+using std::string;
 
 namespace cpu
 {
@@ -39,28 +48,199 @@ struct fftw_transform;
     {                                                                   \
         typedef PRE##_plan plan_t;                                      \
         typedef PRE##_complex ctype_t;                                  \
+        typedef TY::value_type real_t;                                  \
                                                                         \
         template<typename... Args>                                      \
             plan_t create(Args... args)                                 \
         { return PRE##_plan_many_dft(args...); }                        \
-        void execute(plan_t plan) { return PRE##_execute(plan); }       \
+        template<typename... Args>                                      \
+            plan_t createR2C(Args... args)                              \
+        { return PRE##_plan_many_dft_r2c(args...); }                    \
+        template<typename... Args>                                      \
+            plan_t createC2R(Args... args)                              \
+        { return PRE##_plan_many_dft_c2r(args...); }                    \
+        void execute(plan_t plan, ctype_t *in, ctype_t *out)            \
+        { return PRE##_execute_dft(plan, in, out); }                    \
+        void executeR2C(plan_t plan, real_t *in, ctype_t *out)          \
+        { return PRE##_execute_dft_r2c(plan, in, out); }                \
+        void executeC2R(plan_t plan, ctype_t *in, real_t *out)          \
+        { return PRE##_execute_dft_c2r(plan, in, out); }                \
         void destroy(plan_t plan) { return PRE##_destroy_plan(plan); }  \
+        int alignment(void *ptr)                                        \
+        { return PRE##_alignment_of((real_t *)ptr); }                   \
+        void importWisdom(const char *file)                             \
+        { PRE##_import_wisdom_from_filename(file); }                    \
+        void exportWisdom(const char *file)                             \
+        { PRE##_export_wisdom_to_filename(file); }                      \
+        const char *suffix() { return #PRE; }                           \
     };                                                                  \
 
 
 TRANSFORM(fftwf, cfloat)
 TRANSFORM(fftw, cdouble)
 
-template<typename T, int rank, int direction>
-void fft_common(Array <T> &out, const Array<T> &in)
+// FFTW's planner is not thread safe. Plans can be executed concurrently.
+static std::recursive_mutex planner_mutex;
+
+static size_t plan_cache_size = 5;
+
+// Planner flags from AF_CPU_FFT_PLANNER, one of estimate, measure, patient.
+// Measuring takes much longer than estimating, but the plans are cached
+// and can be saved as wisdom.
+static unsigned readPlannerFlags()
+{
+    const char *env = getenv("AF_CPU_FFT_PLANNER");
+    if (env) {
+        string mode(env);
+        if (mode == "measure") return FFTW_MEASURE;
+        if (mode == "patient") return FFTW_PATIENT;
+    }
+    return FFTW_ESTIMATE;
+}
+
+static unsigned getPlannerFlags()
+{
+    static const unsigned flags = readPlannerFlags();
+    return flags;
+}
+
+// fftwPlanner caches the plans of the last used transforms, keyed on their
+// shape, layout and direction. Cached plans are executed on new arrays, so
+// the key also has the alignment of the arrays used for planning.
+//
+// When AF_CPU_FFT_WISDOM is set, FFTW wisdom is loaded from
+// $AF_CPU_FFT_WISDOM.fftw / .fftwf before the first plan is created and
+// saved again after every new measured plan.
+template<typename T>
+class fftwPlanner
+{
+    public:
+        typedef typename fftw_transform<T>::plan_t plan_t;
+        typedef std::shared_ptr<typename std::remove_pointer<plan_t>::type> plan_ptr;
+
+        static fftwPlanner& getInstance() {
+            static fftwPlanner single_instance;
+            return single_instance;
+        }
+
+        template<typename CreateFunc>
+        plan_ptr find(const string &key, CreateFunc create)
+        {
+            std::lock_guard<std::recursive_mutex> lock(planner_mutex);
+
+            map_iter iter = mIndex.find(key);
+            if (iter != mIndex.end()) {
+                // Move to the front of the LRU list
+                mPlans.splice(mPlans.begin(), mPlans, iter->second);
+                return iter->second->second;
+            }
+
+            loadWisdom();
+
+            plan_t temp = create();
+            if (temp == NULL) AF_ERROR("FFTW failed to create a plan", AF_ERR_INTERNAL);
+            plan_ptr plan(temp, destroyPlan);
+
+            if (getPlannerFlags() != FFTW_ESTIMATE) saveWisdom();
+
+            if (plan_cache_size > 0) {
+                mPlans.push_front(entry_t(key, plan));
+                mIndex[key] = mPlans.begin();
+                trim(plan_cache_size);
+            }
+
+            return plan;
+        }
+
+        void trim(size_t size)
+        {
+            std::lock_guard<std::recursive_mutex> lock(planner_mutex);
+            while (mPlans.size() > size) {
+                mIndex.erase(mPlans.back().first);
+                mPlans.pop_back();
+            }
+        }
+
+    private:
+        typedef std::pair<string, plan_ptr> entry_t;
+        typedef typename std::list<entry_t>::iterator list_iter;
+        typedef typename std::map<string, list_iter>::iterator map_iter;
+
+        fftwPlanner() : mWisdomLoaded(false) {}
+        fftwPlanner(fftwPlanner const&);
+        void operator=(fftwPlanner const&);
+
+        static void destroyPlan(plan_t plan)
+        {
+            std::lock_guard<std::recursive_mutex> lock(planner_mutex);
+            fftw_transform<T>().destroy(plan);
+        }
+
+        static string getWisdomFile()
+        {
+            const char *env = getenv("AF_CPU_FFT_WISDOM");
+            if (env == NULL) return string();
+            return string(env) + "." + fftw_transform<T>().suffix();
+        }
+
+        void loadWisdom()
+        {
+            if (mWisdomLoaded) return;
+            string file = getWisdomFile();
+            if (!file.empty()) fftw_transform<T>().importWisdom(file.c_str());
+            mWisdomLoaded = true;
+        }
+
+        void saveWisdom()
+        {
+            string file = getWisdomFile();
+            if (!file.empty()) fftw_transform<T>().exportWisdom(file.c_str());
+        }
+
+        // Most recently used plans first
+        std::list<entry_t>              mPlans;
+        std::map<string, list_iter>     mIndex;
+        bool                            mWisdomLoaded;
+};
+
+void setFFTPlanCacheSize(size_t numPlans)
+{
+    std::lock_guard<std::recursive_mutex> lock(planner_mutex);
+    plan_cache_size = numPlans;
+    fftwPlanner<cfloat >::getInstance().trim(numPlans);
+    fftwPlanner<cdouble>::getInstance().trim(numPlans);
+}
+
+template<int rank>
+static void appendKey(string &key, const int *vals)
+{
+    for (int i = 0; i < rank; i++) {
+        key.append(std::to_string(vals[i]));
+        key.append(":");
+    }
+}
+
+enum fftw_kind
+{
+    FFTW_C2C,
+    FFTW_R2C,
+    FFTW_C2R
+};
+
+// Finds or creates the plan of a transform from in to out and executes it.
+// T is the complex type of the transform. For r2c and c2r transforms, Ti
+// and To are the real and complex types, and the transform dims are those of
+// the real array.
+template<typename T, int rank, fftw_kind kind, int direction, typename Ti, typename To>
+void fft_common(Array<To> &out, const Array<Ti> &in)
 {
     int in_dims[rank];
     int in_embed[rank];
     int out_embed[rank];
 
-    const dim4 idims = in.dims();
+    const dim4 tdims = (kind == FFTW_C2R) ? out.dims() : in.dims();
 
-    computeDims<rank>(in_dims  , idims);
+    computeDims<rank>(in_dims  , tdims);
     computeDims<rank>(in_embed , in.getDataDims());
     computeDims<rank>(out_embed, out.getDataDims());
 
@@ -68,30 +248,95 @@ void fft_common(Array <T> &out, const Array<T> &in)
     const dim4 ostrides = out.strides();
 
     typedef typename fftw_transform<T>::ctype_t ctype_t;
-    typename fftw_transform<T>::plan_t plan;
+    typedef typename fftw_transform<T>::real_t real_t;
 
     fftw_transform<T> transform;
 
     int batch = 1;
     for (int i = rank; i < 4; i++) {
-        batch *= idims[i];
+        batch *= tdims[i];
     }
 
-    plan = transform.create(rank,
-                            in_dims,
-                            (int)batch,
-                            (ctype_t *)in.get(),
-                            in_embed, (int)istrides[0],
-                            (int)istrides[rank],
-                            (ctype_t *)out.get(),
-                            out_embed, (int)ostrides[0],
-                            (int)ostrides[rank],
-                            direction ? FFTW_FORWARD : FFTW_BACKWARD,
-                            FFTW_ESTIMATE);
-
-    transform.execute(plan);
-    transform.destroy(plan);
+    void *iptr = (void *)in.get();
+    void *optr = (void *)out.get();
+    const bool inplace = iptr == optr;
+
+    // Measuring overwrites the arrays, so it is done on scratch buffers.
+    // These are allocated like every other array, so they have the same
+    // alignment as buffers with no offset.
+    unsigned flags = getPlannerFlags();
+    const bool scratch = flags != FFTW_ESTIMATE &&
+                         transform.alignment(iptr) == 0 &&
+                         transform.alignment(optr) == 0;
+    if (!scratch) flags = FFTW_ESTIMATE;
+
+    string key = std::to_string(kind) + ":" + std::to_string(rank) + ":";
+    appendKey<rank>(key, in_dims);
+    appendKey<rank>(key, in_embed);
+    appendKey<rank>(key, out_embed);
+    key += std::to_string(istrides[0]) + ":" + std::to_string(istrides[rank]) + ":" +
+           std::to_string(ostrides[0]) + ":" + std::to_string(ostrides[rank]) + ":" +
+           std::to_string(batch) + ":" + std::to_string(direction) + ":" +
+           std::to_string(inplace) + ":" + std::to_string(flags) + ":" +
+           std::to_string(transform.alignment(iptr)) + ":" +
+           std::to_string(transform.alignment(optr));
+
+    auto create = [&]() {
+        void *pin = iptr;
+        void *pout = optr;
+        Ti *in_buf = NULL;
+        To *out_buf = NULL;
 
+        if (scratch) {
+            in_buf = memAlloc<Ti>(in.getDataDims().elements());
+            out_buf = inplace ? (To *)in_buf : memAlloc<To>(out.getDataDims().elements());
+            pin = in_buf;
+            pout = out_buf;
+        }
+
+        typename fftw_transform<T>::plan_t plan;
+        switch (kind) {
+            case FFTW_C2C:
+                plan = transform.create(rank, in_dims, batch,
+                                        (ctype_t *)pin, in_embed,
+                                        (int)istrides[0], (int)istrides[rank],
+                                        (ctype_t *)pout, out_embed,
+                                        (int)ostrides[0], (int)ostrides[rank],
+                                        direction ? FFTW_FORWARD : FFTW_BACKWARD,
+                                        flags);
+                break;
+            case FFTW_R2C:
+                plan = transform.createR2C(rank, in_dims, batch,
+                                           (real_t *)pin, in_embed,
+                                           (int)istrides[0], (int)istrides[rank],
+                                           (ctype_t *)pout, out_embed,
+                                           (int)ostrides[0], (int)ostrides[rank],
+                                           flags);
+                break;
+            case FFTW_C2R:
+                plan = transform.createC2R(rank, in_dims, batch,
+                                           (ctype_t *)pin, in_embed,
+                                           (int)istrides[0], (int)istrides[rank],
+                                           (real_t *)pout, out_embed,
+                                           (int)ostrides[0], (int)ostrides[rank],
+                                           flags);
+                break;
+        }
+
+        if (scratch) {
+            memFree(in_buf);
+            if (!inplace) memFree(out_buf);
+        }
+        return plan;
+    };
+
+    typename fftwPlanner<T>::plan_ptr plan = fftwPlanner<T>::getInstance().find(key, create);
+
+    switch (kind) {
+        case FFTW_C2C: transform.execute   (plan.get(), (ctype_t *)iptr, (ctype_t *)optr); break;
+        case FFTW_R2C: transform.executeR2C(plan.get(), (real_t  *)iptr, (ctype_t *)optr); break;
+        case FFTW_C2R: transform.executeC2R(plan.get(), (ctype_t *)iptr, (real_t  *)optr); break;
+    }
 }
 
 void computePaddedDims(dim4 &pdims,
@@ -113,7 +358,7 @@ Array<outType> fft(Array<inType> const &in, double norm_factor, dim_t const npad
     computePaddedDims(pdims, in.dims(), npad, pad);
 
     Array<outType> ret = padArray<inType, outType>(in, pdims);
-    fft_common<outType, rank, true>(ret, ret);
+    fft_common<outType, rank, FFTW_C2C, true>(ret, ret);
     return ret;
 }
 
@@ -126,11 +371,50 @@ Array<T> ifft(Array<T> const &in, double norm_factor, dim_t const npad, dim_t co
     computePaddedDims(pdims, in.dims(), npad, pad);
 
     Array<T> ret = padArray<T, T>(in, pdims, scalar<T>(0), norm_factor);
-    fft_common<T, rank, false>(ret, ret);
+    fft_common<T, rank, FFTW_C2C, false>(ret, ret);
 
     return ret;
 }
 
+template<typename Tr, typename Tc, int rank>
+Array<Tc> fft_r2c(Array<Tr> const &in, double norm_factor, dim_t const npad, dim_t const * const pad)
+{
+    ARG_ASSERT(1, rank >= 1 && rank <= 3);
+
+    dim4 pdims(1);
+    computePaddedDims(pdims, in.dims(), npad, pad);
+
+    // r2c plans leave their input untouched, so contiguous input without
+    // padding or scaling is transformed directly
+    Array<Tr> tmp = in;
+    if (npad > 0 || norm_factor != 1.0 || !in.isLinear() || in.getOffset() != 0) {
+        tmp = padArray<Tr, Tr>(in, pdims, scalar<Tr>(0), norm_factor);
+    }
+
+    // Only the non redundant half of the Hermitian spectrum is stored
+    dim4 odims = pdims;
+    odims[0] = pdims[0] / 2 + 1;
+
+    Array<Tc> out = createEmptyArray<Tc>(odims);
+    fft_common<Tc, rank, FFTW_R2C, true>(out, tmp);
+
+    return out;
+}
+
+template<typename Tc, typename Tr, int rank>
+Array<Tr> fft_c2r(Array<Tc> const &in, double norm_factor, dim4 const &odims)
+{
+    ARG_ASSERT(1, rank >= 1 && rank <= 3);
+
+    // c2r plans overwrite their input
+    Array<Tc> tmp = padArray<Tc, Tc>(in, in.dims(), scalar<Tc>(0), norm_factor);
+
+    Array<Tr> out = createEmptyArray<Tr>(odims);
+    fft_common<Tc, rank, FFTW_C2R, false>(out, tmp);
+
+    return out;
+}
+
 #define INSTANTIATE1(T1, T2)\
     template Array<T2> fft <T1, T2, 1, true >(const Array<T1> &in, double norm_factor, dim_t const npad, dim_t const * const pad); \
     template Array<T2> fft <T1, T2, 2, true >(const Array<T1> &in, double norm_factor, dim_t const npad, dim_t const * const pad); \
@@ -150,4 +434,15 @@ INSTANTIATE1(double , cdouble)
 INSTANTIATE2(cfloat )
 INSTANTIATE2(cdouble)
 
+#define INSTANTIATE_REAL(Tr, Tc)                                        \
+    template Array<Tc> fft_r2c<Tr, Tc, 1>(const Array<Tr> &in, double norm_factor, dim_t const npad, dim_t const * const pad); \
+    template Array<Tc> fft_r2c<Tr, Tc, 2>(const Array<Tr> &in, double norm_factor, dim_t const npad, dim_t const * const pad); \
+    template Array<Tc> fft_r2c<Tr, Tc, 3>(const Array<Tr> &in, double norm_factor, dim_t const npad, dim_t const * const pad); \
+    template Array<Tr> fft_c2r<Tc, Tr, 1>(const Array<Tc> &in, double norm_factor, dim4 const &odims); \
+    template Array<Tr> fft_c2r<Tc, Tr, 2>(const Array<Tc> &in, double norm_factor, dim4 const &odims); \
+    template Array<Tr> fft_c2r<Tc, Tr, 3>(const Array<Tc> &in, double norm_factor, dim4 const &odims);
+
+INSTANTIATE_REAL(float , cfloat )
+INSTANTIATE_REAL(double, cdouble)
+
 }
@@ -18,4 +18,12 @@ Array<outType> fft(Array<inType> const &in, double norm_factor, dim_t const npad
 template<typename T, int rank>
 Array<T> ifft(Array<T> const &in, double norm_factor, dim_t const npad, dim_t const * const pad);
 
+template<typename Tr, typename Tc, int rank>
+Array<Tc> fft_r2c(Array<Tr> const &in, double norm_factor, dim_t const npad, dim_t const * const pad);
+
+template<typename Tc, typename Tr, int rank>
+Array<Tr> fft_c2r(Array<Tc> const &in, double norm_factor, af::dim4 const &odims);
+
+void setFFTPlanCacheSize(size_t numPlans);
+
 }
@@ -13,23 +13,189 @@
 #include <Array.hpp>
 #include <err_cpu.hpp>
 #include <handle.hpp>
+#include <dispatch.hpp>
+#include <parallel.hpp>
+#include <algorithm>
+#include <cstring>
+#include <limits>
+#include <utility>
+#include <vector>
+
+#if defined(_WIN32) || defined(_MSC_VER)
+#include <intrin.h>
+#endif
 
 using af::dim4;
+using std::vector;
 
 namespace cpu
 {
 
-#if defined(_WIN32) || defined(_MSC_VER)
+// Descriptors are packed into 64 bit words. The last word is padded with
+// zeros, which never add to the distance.
+typedef uintl word_t;
 
-#include <intrin.h>
-#define __builtin_popcount __popcnt
+// Distance and train index of a match. Comparing the pairs breaks ties
+// between equal distances by the lower index.
+typedef std::pair<uint, uint> match_t;
+
+// The queries of a block are compared against a block of train descriptors
+// while it is in cache, before moving on to the next train block
+static const dim_t HAMMING_QUERY_BLOCK = 32;
+static const dim_t HAMMING_TRAIN_BLOCK = 512;
+
+#if defined(__POPCNT__) || (defined(_MSC_VER) && defined(_M_X64))
+
+#if defined(_MSC_VER)
+#define __builtin_popcountll __popcnt64
+#endif
+
+// Hamming distance of two descriptors of W words, or of nwords words when W
+// is 0, using the popcount instruction
+template<int W>
+static inline uint descDistance(const word_t *a, const word_t *b, const int nwords)
+{
+    const int n = W > 0 ? W : nwords;
+    uint dist = 0;
+    for (int i = 0; i < n; i++) {
+        dist += (uint)__builtin_popcountll(a[i] ^ b[i]);
+    }
+    return dist;
+}
+
+#else
+
+static const word_t POPCOUNT_M1  = 0x5555555555555555ULL;
+static const word_t POPCOUNT_M2  = 0x3333333333333333ULL;
+static const word_t POPCOUNT_M4  = 0x0F0F0F0F0F0F0F0FULL;
+static const word_t POPCOUNT_H01 = 0x0101010101010101ULL;
+
+// Number of bits set in each byte of v
+static inline word_t byteCounts(word_t v)
+{
+    v = v - ((v >> 1) & POPCOUNT_M1);
+    v = (v & POPCOUNT_M2) + ((v >> 2) & POPCOUNT_M2);
+    return (v + (v >> 4)) & POPCOUNT_M4;
+}
+
+// Hamming distance of two descriptors of W words, or of nwords words when W
+// is 0, without a popcount instruction. The byte counts of up to 31 words
+// fit in a byte, so they are added together before the horizontal sum and a
+// 256 bit descriptor costs a single multiply.
+template<int W>
+static inline uint descDistance(const word_t *a, const word_t *b, const int nwords)
+{
+    const int n = W > 0 ? W : nwords;
+    uint dist = 0;
+    for (int i = 0; i < n; i += 31) {
+        const int e = std::min(n, i + 31);
+        word_t acc = 0;
+        for (int j = i; j < e; j++) {
+            acc += byteCounts(a[j] ^ b[j]);
+        }
+        dist += (uint)((acc * POPCOUNT_H01) >> 56);
+    }
+    return dist;
+}
 
 #endif
 
+// Copies the descriptors of in, which run along dist_dim, into rows of
+// nwords words each
 template<typename T>
-inline uint hamming_distance(T v1, T v2)
+static vector<word_t> packDescriptors(const Array<T> &in, const uint dist_dim, const int nwords)
+{
+    const uint sample_dim = (dist_dim == 0) ? 1 : 0;
+    const dim4 dims    = in.dims();
+    const dim4 strides = in.strides();
+    const dim_t len    = dims[dist_dim];
+    const dim_t num    = dims[sample_dim];
+
+    vector<word_t> packed(num * nwords, 0);
+    const T *ptr = in.get();
+
+    parallel_for(num, [&](dim_t begin, dim_t end) {
+            for (dim_t i = begin; i < end; i++) {
+                const T *src = ptr + i * strides[sample_dim];
+                char *dst = (char *)&packed[i * nwords];
+                for (dim_t k = 0; k < len; k++) {
+                    std::memcpy(dst + k * sizeof(T), src + k * strides[dist_dim], sizeof(T));
+                }
+            }
+        }, std::max<dim_t>(1, MIN_PARALLEL_ELEMENTS / std::max<dim_t>(1, len)));
+
+    return packed;
+}
+
+// Finds the n_dist closest train descriptors of every query. Each query keeps
+// a max-heap of its best matches so far, and the distance at the top of the
+// heap rejects most train descriptors with a single comparison. Blocks of
+// queries are distributed over the thread pool.
+template<int W>
+static void matchDescriptors(uint *iPtr, uint *dPtr,
+                             const word_t *qPtr, const dim_t nQuery,
+                             const word_t *tPtr, const dim_t nTrain,
+                             const int nwords, const uint n_dist)
 {
-    return __builtin_popcount(v1 ^ v2);
+    const dim_t nblocks = divup(nQuery, HAMMING_QUERY_BLOCK);
+    const dim_t work    = HAMMING_QUERY_BLOCK * nTrain * nwords;
+
+    parallel_for(nblocks, [&](dim_t begin, dim_t end) {
+            vector<match_t> heaps(HAMMING_QUERY_BLOCK * n_dist);
+            vector<uint> sizes(HAMMING_QUERY_BLOCK);
+            vector<uint> bounds(HAMMING_QUERY_BLOCK);
+
+            for (dim_t b = begin; b < end; b++) {
+                const dim_t q0 = b * HAMMING_QUERY_BLOCK;
+                const dim_t nq = std::min(HAMMING_QUERY_BLOCK, nQuery - q0);
+
+                std::fill(sizes.begin(), sizes.end(), 0);
+                std::fill(bounds.begin(), bounds.end(), std::numeric_limits<uint>::max());
+
+                for (dim_t t0 = 0; t0 < nTrain; t0 += HAMMING_TRAIN_BLOCK) {
+                    const dim_t t1 = std::min(nTrain, t0 + HAMMING_TRAIN_BLOCK);
+
+                    for (dim_t q = 0; q < nq; q++) {
+                        const word_t *query = qPtr + (q0 + q) * nwords;
+                        match_t *heap = &heaps[q * n_dist];
+                        uint size  = sizes[q];
+                        uint bound = bounds[q];
+
+                        for (dim_t j = t0; j < t1; j++) {
+                            const uint dist = descDistance<W>(query, tPtr + j * nwords, nwords);
+                            if (dist >= bound) continue;
+
+                            // Train indices only grow, so a new match with
+                            // the distance of the worst one never replaces it
+                            if (size < n_dist) {
+                                heap[size++] = match_t(dist, (uint)j);
+                                std::push_heap(heap, heap + size);
+                                if (size == n_dist) bound = heap[0].first;
+                            } else {
+                                std::pop_heap(heap, heap + n_dist);
+                                heap[n_dist - 1] = match_t(dist, (uint)j);
+                                std::push_heap(heap, heap + n_dist);
+                                bound = heap[0].first;
+                            }
+                        }
+
+                        sizes[q]  = size;
+                        bounds[q] = bound;
+                    }
+                }
+
+                for (dim_t q = 0; q < nq; q++) {
+                    match_t *heap = &heaps[q * n_dist];
+                    std::sort_heap(heap, heap + sizes[q]);
+
+                    const dim_t off = (q0 + q) * n_dist;
+                    for (uint k = 0; k < sizes[q]; k++) {
+                        iPtr[off + k] = heap[k].second;
+                        dPtr[off + k] = heap[k].first;
+                    }
+                }
+            }
+        }, std::max<dim_t>(1, MIN_PARALLEL_ELEMENTS / std::max<dim_t>(1, work)));
 }
 
 template<typename T>
@@ -41,54 +207,31 @@ void hamming_matcher(Array<uint>& idx, Array<uint>& dist,
     const dim4 qDims = query.dims();
     const dim4 tDims = train.dims();
 
-    if (n_dist > 1) {
-        CPU_NOT_SUPPORTED();
-    }
-
-    const unsigned distLength = qDims[dist_dim];
-    const unsigned nQuery = qDims[sample_dim];
-    const unsigned nTrain = tDims[sample_dim];
+    const dim_t distLength = qDims[dist_dim];
+    const dim_t nQuery = qDims[sample_dim];
+    const dim_t nTrain = tDims[sample_dim];
+    const int nwords = divup(distLength * sizeof(T), sizeof(word_t));
 
     const dim4 outDims(n_dist, nQuery);
 
     idx  = createEmptyArray<uint>(outDims);
     dist = createEmptyArray<uint>(outDims);
 
-    const T* qPtr = query.get();
-    const T* tPtr = train.get();
+    const vector<word_t> qPacked = packDescriptors(query, dist_dim, nwords);
+    const vector<word_t> tPacked = packDescriptors(train, dist_dim, nwords);
+
+    const word_t* qPtr = qPacked.data();
+    const word_t* tPtr = tPacked.data();
     uint* iPtr = idx.get();
     uint* dPtr = dist.get();
 
-    for (unsigned i = 0; i < nQuery; i++) {
-        unsigned best_dist = limit_max<unsigned>();
-        unsigned best_idx  = 0;
-
-        for (unsigned j = 0; j < nTrain; j++) {
-            unsigned local_dist = 0;
-            for (unsigned k = 0; k < distLength; k++) {
-                size_t qIdx, tIdx;
-                if (sample_dim == 0) {
-                    qIdx = k * qDims[0] + i;
-                    tIdx = k * tDims[0] + j;
-                }
-                else {
-                    qIdx = i * qDims[0] + k;
-                    tIdx = j * tDims[0] + k;
-                }
-
-                local_dist += hamming_distance(qPtr[qIdx], tPtr[tIdx]);
-            }
-
-            if (local_dist < best_dist) {
-                best_dist = local_dist;
-                best_idx  = j;
-            }
-        }
-
-        size_t oIdx;
-        oIdx = i;
-        iPtr[oIdx] = best_idx;
-        dPtr[oIdx] = best_dist;
+    // Fixed widths for the common descriptor sizes, 256 bits for ORB
+    switch (nwords) {
+        case 1:  matchDescriptors<1>(iPtr, dPtr, qPtr, nQuery, tPtr, nTrain, nwords, n_dist); break;
+        case 2:  matchDescriptors<2>(iPtr, dPtr, qPtr, nQuery, tPtr, nTrain, nwords, n_dist); break;
+        case 4:  matchDescriptors<4>(iPtr, dPtr, qPtr, nQuery, tPtr, nTrain, nwords, n_dist); break;
+        case 8:  matchDescriptors<8>(iPtr, dPtr, qPtr, nQuery, tPtr, nTrain, nwords, n_dist); break;
+        default: matchDescriptors<0>(iPtr, dPtr, qPtr, nQuery, tPtr, nTrain, nwords, n_dist); break;
     }
 }
 
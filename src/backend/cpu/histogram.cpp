@@ -11,44 +11,188 @@
 #include <af/defines.h>
 #include <ArrayInfo.hpp>
 #include <Array.hpp>
+#include <copy.hpp>
+#include <dispatch.hpp>
 #include <histogram.hpp>
+#include <parallel.hpp>
+#include <platform.hpp>
+#include <algorithm>
+#include <vector>
 
 using af::dim4;
+using std::vector;
 
 namespace cpu
 {
 
-template<typename inType, typename outType>
-Array<outType> histogram(const Array<inType> &in, const unsigned &nbins, const double &minval, const double &maxval)
+// Batches are only split over several threads when each part has at least
+// this many elements
+static const dim_t HIST_MIN_CHUNK_ELEMENTS = 1 << 16;
+
+// Maps values to bins. The bin width is inverted once, so each value costs a
+// multiply instead of a division. Values below minval go to the first bin and
+// values above maxval to the last one.
+template<typename T>
+class HistBinner
+{
+    double minval;
+    double scale;
+    int nbins;
+
+public:
+    HistBinner(const unsigned nbins, const double minval, const double maxval)
+        : minval(minval), nbins(nbins)
+    {
+        // The width is a float, as in the CUDA and OpenCL kernels
+        const float step = (maxval - minval) / (float)nbins;
+        scale = 1.0 / step;
+    }
+
+    int operator()(const T val) const
+    {
+        const double pos = (val - minval) * scale;
+        if (!(pos >= 0)) return 0;
+        return pos < nbins ? (int)pos : nbins - 1;
+    }
+};
+
+// 8 bit values look their bin up in a table
+template<typename T>
+class HistTableBinner
+{
+    int table[256];
+
+public:
+    HistTableBinner(const unsigned nbins, const double minval, const double maxval)
+    {
+        const HistBinner<int> binner(nbins, minval, maxval);
+        for (int i = 0; i < 256; i++) {
+            table[i] = binner((int)(T)i);
+        }
+    }
+
+    int operator()(const T val) const
+    {
+        return table[(uchar)val];
+    }
+};
+
+template<> class HistBinner<uchar> : public HistTableBinner<uchar>
+{
+public:
+    HistBinner(const unsigned nbins, const double minval, const double maxval)
+        : HistTableBinner<uchar>(nbins, minval, maxval) {}
+};
+
+template<> class HistBinner<char> : public HistTableBinner<char>
+{
+public:
+    HistBinner(const unsigned nbins, const double minval, const double maxval)
+        : HistTableBinner<char>(nbins, minval, maxval) {}
+};
+
+template<typename inType, typename outType, bool isWeighted>
+static void histChunk(outType *bins, const inType *in, const outType *weights,
+                      const dim_t num, const HistBinner<inType> &binner)
+{
+    for (dim_t i = 0; i < num; i++) {
+        const int bin = binner(in[i]);
+        if (isWeighted) bins[bin] += weights[i];
+        else            bins[bin]++;
+    }
+}
+
+// Whether the first two dimensions of in are stored without gaps
+template<typename T>
+static bool isContiguous2D(const Array<T> &in)
 {
-    float step = (maxval - minval)/(float)nbins;
+    const dim4 dims    = in.dims();
+    const dim4 strides = in.strides();
+    return strides[0] == 1 && (dims[1] == 1 || strides[1] == dims[0]);
+}
 
+// Histograms of every 2D batch of in. Batches along dimensions 2 and 3 run
+// concurrently. When there are fewer batches than threads, each batch is also
+// split into chunks with bins of their own, which are added up in order at
+// the end, so weighted sums do not depend on the scheduling.
+template<typename inType, typename outType, bool isWeighted>
+static Array<outType> histogramImpl(const Array<inType> &in, const Array<outType> *weights,
+                                    const unsigned nbins, const double minval, const double maxval)
+{
     const dim4 inDims  = in.dims();
-    dim4 iStrides      = in.strides();
-    dim4 outDims       = dim4(nbins,1,inDims[2],inDims[3]);
+    const dim4 outDims = dim4(nbins, 1, inDims[2], inDims[3]);
     Array<outType> out = createValueArray<outType>(outDims, outType(0));
-    dim4 oStrides      = out.strides();
-    dim_t nElems    = inDims[0]*inDims[1];
-
-    outType *outData    = out.get();
-    const inType* inData= in.get();
-
-    for(dim_t b3 = 0; b3 < outDims[3]; b3++) {
-        for(dim_t b2 = 0; b2 < outDims[2]; b2++) {
-            for(dim_t i=0; i<nElems; i++) {
-                int bin = (int)((inData[i] - minval) / step);
-                bin = std::max(bin, 0);
-                bin = std::min(bin, (int)(nbins - 1));
-                outData[bin]++;
+
+    // Each batch is read as one contiguous run of elements. The inputs are
+    // evaluated in place first, so that their handles keep the result.
+    in.eval();
+    const Array<inType> input = isContiguous2D(in) ? in : copyArray<inType>(in);
+    Array<outType> wts = createEmptyArray<outType>(dim4());
+    if (isWeighted) {
+        weights->eval();
+        wts = isContiguous2D(*weights) ? *weights : copyArray<outType>(*weights);
+    }
+
+    const dim4 iStrides = input.strides();
+    const dim4 wStrides = wts.strides();
+    const dim_t nElems  = inDims[0] * inDims[1];
+    const dim_t nbatch  = inDims[2] * inDims[3];
+
+    const dim_t nthreads = getNumThreads();
+    const dim_t nchunks  = nbatch >= nthreads ? 1 :
+        std::max<dim_t>(1, std::min(divup(nthreads, nbatch), nElems / HIST_MIN_CHUNK_ELEMENTS));
+    const dim_t chunk    = divup(nElems, nchunks);
+
+    const HistBinner<inType> binner(nbins, minval, maxval);
+    const inType *inData  = input.get();
+    const outType *wData  = isWeighted ? wts.get() : NULL;
+    outType *outData      = out.get();
+    vector<outType> partial(nchunks > 1 ? nbatch * nchunks * nbins : 0, outType(0));
+
+    parallel_for(nbatch * nchunks, [&](dim_t begin, dim_t end) {
+            for (dim_t t = begin; t < end; t++) {
+                const dim_t b     = t / nchunks;
+                const dim_t b2    = b % inDims[2];
+                const dim_t b3    = b / inDims[2];
+                const dim_t first = (t % nchunks) * chunk;
+                const dim_t num   = std::min(nElems - first, chunk);
+
+                const inType *iptr  = inData + b2 * iStrides[2] + b3 * iStrides[3] + first;
+                const outType *wptr = isWeighted ? wData + b2 * wStrides[2] + b3 * wStrides[3] + first : NULL;
+
+                outType *bins = nchunks > 1 ? &partial[t * nbins] : outData + b * nbins;
+                histChunk<inType, outType, isWeighted>(bins, iptr, wptr, num, binner);
             }
-            inData  += iStrides[2];
-            outData += oStrides[2];
-        }
+        });
+
+    if (nchunks > 1) {
+        parallel_for(nbatch, [&](dim_t begin, dim_t end) {
+                for (dim_t b = begin; b < end; b++) {
+                    outType *bins = outData + b * nbins;
+                    for (dim_t c = 0; c < nchunks; c++) {
+                        const outType *part = &partial[(b * nchunks + c) * nbins];
+                        for (unsigned k = 0; k < nbins; k++) bins[k] += part[k];
+                    }
+                }
+            });
     }
 
     return out;
 }
 
+template<typename inType, typename outType>
+Array<outType> histogram(const Array<inType> &in, const unsigned &nbins, const double &minval, const double &maxval)
+{
+    return histogramImpl<inType, outType, false>(in, NULL, nbins, minval, maxval);
+}
+
+template<typename inType, typename outType>
+Array<outType> histogram(const Array<inType> &in, const Array<outType> &weights,
+                         const unsigned &nbins, const double &minval, const double &maxval)
+{
+    return histogramImpl<inType, outType, true>(in, &weights, nbins, minval, maxval);
+}
+
 #define INSTANTIATE(in_t,out_t)\
 template Array<out_t> histogram(const Array<in_t> &in, const unsigned &nbins, const double &minval, const double &maxval);
 
@@ -59,4 +203,19 @@ INSTANTIATE(int   , uint)
 INSTANTIATE(uint  , uint)
 INSTANTIATE(uchar , uint)
 
+#define INSTANTIATE_WEIGHTED(in_t,out_t)\
+template Array<out_t> histogram(const Array<in_t> &in, const Array<out_t> &weights,\
+                                const unsigned &nbins, const double &minval, const double &maxval);
+
+#define INSTANTIATE_WEIGHTS(out_t)      \
+    INSTANTIATE_WEIGHTED(float , out_t) \
+    INSTANTIATE_WEIGHTED(double, out_t) \
+    INSTANTIATE_WEIGHTED(char  , out_t) \
+    INSTANTIATE_WEIGHTED(int   , out_t) \
+    INSTANTIATE_WEIGHTED(uint  , out_t) \
+    INSTANTIATE_WEIGHTED(uchar , out_t)
+
+INSTANTIATE_WEIGHTS(float )
+INSTANTIATE_WEIGHTS(double)
+
 }
@@ -15,4 +15,9 @@ namespace cpu
 template<typename inType, typename outType>
 Array<outType> histogram(const Array<inType> &in, const unsigned &nbins, const double &minval, const double &maxval);
 
+// Adds up the weights of the values falling in each bin
+template<typename inType, typename outType>
+Array<outType> histogram(const Array<inType> &in, const Array<outType> &weights,
+                         const unsigned &nbins, const double &minval, const double &maxval);
+
 }
@@ -11,12 +11,17 @@
 #include <af/defines.h>
 #include <ArrayInfo.hpp>
 #include <Array.hpp>
+#include <copy.hpp>
 #include <index.hpp>
 #include <handle.hpp>
 #include <err_cpu.hpp>
+#include <cstdlib>
+#include <memory>
 #include <vector>
 
 using af::dim4;
+using std::shared_ptr;
+using std::vector;
 
 namespace cpu
 {
@@ -25,7 +30,7 @@ static inline
 dim_t trimIndex(dim_t idx, const dim_t &len)
 {
     dim_t ret_val = idx;
-    dim_t offset  = abs(ret_val)%len;
+    dim_t offset  = std::abs(ret_val)%len;
     if (ret_val<0) {
         ret_val = offset-1;
     } else if (ret_val>=len) {
@@ -34,79 +39,61 @@ dim_t trimIndex(dim_t idx, const dim_t &len)
     return ret_val;
 }
 
+template<typename I>
+TNJ::IndexMap createIndexMap(const Array<I> &indices, const dim_t len)
+{
+    indices.eval();
+    const Array<I> idx = indices.isOwner() ? indices : copyArray<I>(indices);
+
+    const dim_t num = idx.elements();
+    const I *ptr = idx.get();
+
+    shared_ptr<vector<dim_t> > vals(new vector<dim_t>(num));
+    dim_t *dst = vals->data();
+
+    // Only the indices out of range go through the wraparound
+    for (dim_t i = 0; i < num; i++) {
+        const dim_t val = (dim_t)ptr[i];
+        dst[i] = (val >= 0 && val < len) ? val : trimIndex(val, len);
+    }
+
+    return TNJ::IndexMap(vals);
+}
+
+// Index arrays are converted to uint first, as on the other backends, so that
+// negative indices wrap through their unsigned value
+static TNJ::IndexMap getIndexMap(const af_array indices, const dim_t len)
+{
+    return createIndexMap(castArray<uint>(indices), len);
+}
+
 template<typename T>
 Array<T> index(const Array<T>& in, const af_index_t idxrs[])
 {
-    bool isSeq[4];
-    std::vector<af_seq> seqs(4, af_span);
-    // create seq vector to retrieve output
-    // dimensions, offsets & offsets
+    vector<af_seq> seqs(4, af_span);
     for (dim_t x=0; x<4; ++x) {
-        if (idxrs[x].isSeq) {
-            seqs[x] = idxrs[x].idx.seq;
-        }
-        isSeq[x] = idxrs[x].isSeq;
+        if (idxrs[x].isSeq) seqs[x] = idxrs[x].idx.seq;
     }
 
-    // rettrieve
     dim4 iDims = in.dims();
-    dim4 dDims = in.getDataDims();
     dim4 oDims = toDims  (seqs, iDims);
-    dim4 iOffs = toOffset(seqs, dDims);
-    dim4 iStrds= toStride(seqs, dDims);
+    dim4 iOffs = toOffset(seqs, iDims);
 
-    std::vector< Array<uint> > idxArrs(4, createEmptyArray<uint>(dim4()));
-    // look through indexs to read af_array indexs
+    // The indices of every dimension are resolved once, so that the output
+    // is a node selecting from the input, fused with the rest of the
+    // expression
+    TNJ::IndexMap maps[4];
     for (dim_t x=0; x<4; ++x) {
-        if (!isSeq[x]) {
-            idxArrs[x] = castArray<uint>(idxrs[x].idx.arr);
-            // set output array ith dimension value
-            oDims[x] = idxArrs[x].elements();
-        }
-    }
-
-    Array<T> out = createEmptyArray<T>(oDims);
-    dim4 oStrides= out.strides();
-
-    const T *src = in.get();
-    T *dst = out.get();
-
-    const uint* ptr0 = idxArrs[0].get();
-    const uint* ptr1 = idxArrs[1].get();
-    const uint* ptr2 = idxArrs[2].get();
-    const uint* ptr3 = idxArrs[3].get();
-
-    for (dim_t l=0; l<oDims[3]; ++l) {
-
-        dim_t lOff   = l*oStrides[3];
-        dim_t inIdx3 = trimIndex(isSeq[3] ? l+iOffs[3] : ptr3[l], iDims[3]);
-        dim_t inOff3 = inIdx3*iStrds[3];
-
-        for (dim_t k=0; k<oDims[2]; ++k) {
-
-            dim_t kOff   = k*oStrides[2];
-            dim_t inIdx2 = trimIndex(isSeq[2] ? k+iOffs[2] : ptr2[k], iDims[2]);
-            dim_t inOff2 = inIdx2*iStrds[2];
-
-            for (dim_t j=0; j<oDims[1]; ++j) {
-
-                dim_t jOff   = j*oStrides[1];
-                dim_t inIdx1 = trimIndex(isSeq[1] ? j+iOffs[1] : ptr1[j], iDims[1]);
-                dim_t inOff1 = inIdx1*iStrds[1];
-
-                for (dim_t i=0; i<oDims[0]; ++i) {
-
-                    dim_t iOff   = i*oStrides[0];
-                    dim_t inIdx0 = trimIndex(isSeq[0] ? i+iOffs[0] : ptr0[i], iDims[0]);
-                    dim_t inOff0 = inIdx0*iStrds[0];
-
-                    dst[lOff+kOff+jOff+iOff] = src[inOff3+inOff2+inOff1+inOff0];
-                }
-            }
+        if (idxrs[x].isSeq) {
+            maps[x] = TNJ::IndexMap(iOffs[x], seqs[x].step != 0 ? (dim_t)seqs[x].step : 1);
+        } else {
+            maps[x] = getIndexMap(idxrs[x].idx.arr, iDims[x]);
+            oDims[x] = maps[x].idx->size();
         }
     }
 
-    return out;
+    TNJ::IndexNode<T> *node = new TNJ::IndexNode<T>(in.getNode(), maps);
+    return createNodeArray<T>(oDims, TNJ::Node_ptr(reinterpret_cast<TNJ::Node *>(node)));
 }
 
 #define INSTANTIATE(T) \
@@ -123,4 +110,15 @@ INSTANTIATE(int    )
 INSTANTIATE(uchar  )
 INSTANTIATE(char   )
 
+#define INSTANTIATE_MAP(I) \
+    template TNJ::IndexMap createIndexMap<I>(const Array<I> &indices, const dim_t len);
+
+INSTANTIATE_MAP(float  )
+INSTANTIATE_MAP(double )
+INSTANTIATE_MAP(int    )
+INSTANTIATE_MAP(uint   )
+INSTANTIATE_MAP(intl   )
+INSTANTIATE_MAP(uintl  )
+INSTANTIATE_MAP(uchar  )
+
 }
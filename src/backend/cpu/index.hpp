@@ -8,10 +8,16 @@
  ********************************************************/
 
 #include <Array.hpp>
+#include <TNJ/IndexNode.hpp>
 
 namespace cpu
 {
 
+// Maps the output coordinates along a dimension of length len to the values
+// of indices. Values out of range wrap around as in af::index.
+template<typename I>
+TNJ::IndexMap createIndexMap(const Array<I> &indices, const dim_t len);
+
 template<typename T>
 Array<T> index(const Array<T>& in, const af_index_t idxrs[]);
 
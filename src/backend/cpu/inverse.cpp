@@ -20,9 +20,11 @@
 #include <err_cpu.hpp>
 
 #include <lapack_helper.hpp>
-#include <lu.hpp>
+#include <lapack_getrf.hpp>
+#include <lapack_batched.hpp>
 #include <identity.hpp>
 #include <solve.hpp>
+#include <vector>
 
 namespace cpu
 {
@@ -57,13 +59,48 @@ Array<T> inverse(const Array<T> &in)
         return solve(in, I);
     }
 
-    Array<T> A = copyArray<T>(in);
-
-    Array<int> pivot = lu_inplace<T>(A, false);
+    dim4 iDims = in.dims();
+    // Single matrices are inverted by LAPACK and return its result, as on
+    // the other backends. Stacks use the small kernels and report singular
+    // matrices with NaN.
+    const bool isBatch = iDims[2] * iDims[3] > 1;
+    inverse_small_func<T> small = isBatch ? inverseSmallFunc<T>(M) : NULL;
+
+    if (small) {
+        Array<T> out = createEmptyArray<T>(iDims);
+        dim4 iStrides = in.strides();
+        dim4 oStrides = out.strides();
+        const T *iptr = in.get();
+        T *optr = out.get();
+
+        parallel_for_matrices(iDims, [&](dim_t b) {
+                small(iptr + matrixOffset(b, iDims, iStrides), iStrides[1],
+                      optr + matrixOffset(b, iDims, oStrides), oStrides[1]);
+            }, lapackBatchGrain(M));
+
+        return out;
+    }
 
-    getri_func<T>()(AF_LAPACK_COL_MAJOR, M,
-                    A.get(), A.strides()[1],
-                    pivot.get());
+    Array<T> A = copyArray<T>(in);
+    dim4 aStrides = A.strides();
+    T *aptr = A.get();
+
+    parallel_for_matrices(iDims, [&](dim_t b) {
+            T *mat = aptr + matrixOffset(b, iDims, aStrides);
+            std::vector<int> pivot(M);
+
+            int info = getrf_func<T>()(AF_LAPACK_COL_MAJOR, M, M,
+                                       mat, aStrides[1],
+                                       pivot.data());
+            if (info > 0 && isBatch) {
+                fillSingular(mat, aStrides[1], M, M);
+                return;
+            }
+
+            getri_func<T>()(AF_LAPACK_COL_MAJOR, M,
+                            mat, aStrides[1],
+                            pivot.data());
+        }, lapackBatchGrain(M));
 
     return A;
 }
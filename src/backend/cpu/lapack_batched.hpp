@@ -0,0 +1,269 @@
+/*******************************************************
+ * Copyright (c) 2015, ArrayFire
+ * All rights reserved.
+ *
+ * This file is distributed under 3-clause BSD license.
+ * The complete license agreement can be obtained at:
+ * http://arrayfire.com/licenses/BSD-3-Clause
+ ********************************************************/
+
+#pragma once
+#include <af/defines.h>
+#include <af/dim4.hpp>
+#include <parallel.hpp>
+#include <algorithm>
+#include <cmath>
+#include <complex>
+#include <limits>
+
+// Helpers for the dense linear algebra functions that work on stacks of
+// matrices along dimensions 2 and 3.
+//
+// Square matrices of up to LAPACK_SMALL_SIZE rows are handled by kernels
+// unrolled for their size, which keep the matrix in local arrays instead of
+// calling LAPACK. Larger matrices call LAPACK once per matrix. In both cases
+// the matrices of the stack are distributed over the thread pool.
+
+namespace cpu
+{
+    const int LAPACK_SMALL_SIZE = 8;
+
+    // Matrices per task, so that every task does some work even for stacks
+    // of tiny or empty matrices
+    static inline dim_t lapackBatchGrain(const dim_t n)
+    {
+        const dim_t m = std::max<dim_t>(n, 1);
+        return std::max<dim_t>(1, MIN_PARALLEL_ELEMENTS / (m * m * m));
+    }
+
+    // Offset of matrix b of a stack of the given dims in an array of the
+    // given strides
+    static inline dim_t matrixOffset(const dim_t b, const af::dim4 &dims,
+                                     const af::dim4 &strides)
+    {
+        return (b % dims[2]) * strides[2] + (b / dims[2]) * strides[3];
+    }
+
+    // Calls func(b) for every matrix b of a stack of the given dims,
+    // distributing the matrices over the thread pool
+    template<typename Func>
+    void parallel_for_matrices(const af::dim4 &dims, Func func, dim_t grain = 1)
+    {
+        parallel_for(dims[2] * dims[3],
+                     [&](dim_t begin, dim_t end) {
+                         for (dim_t b = begin; b < end; b++) func(b);
+                     }, grain);
+    }
+
+    template<typename T> static inline T nanValue(T)
+    { return std::numeric_limits<T>::quiet_NaN(); }
+    template<typename T> static inline std::complex<T> nanValue(std::complex<T>)
+    { return std::complex<T>(nanValue(T()), nanValue(T())); }
+
+    // Square systems of a stack with a zero pivot have no unique solution.
+    // Every element of their result is set to NaN, whichever path solved them.
+    template<typename T>
+    static inline void fillSingular(T *out, const dim_t ld, const int rows, const int cols)
+    {
+        for (int c = 0; c < cols; c++) {
+            for (int r = 0; r < rows; r++) out[c * ld + r] = nanValue(T());
+        }
+    }
+
+    namespace small
+    {
+        // The pivot magnitude used by LAPACK
+        template<typename T> static inline double magnitude(T v)
+        { return std::abs(v); }
+        template<typename T> static inline double magnitude(std::complex<T> v)
+        { return std::abs(v.real()) + std::abs(v.imag()); }
+
+        template<typename T> static inline T conjugate(T v)
+        { return v; }
+        template<typename T> static inline std::complex<T> conjugate(std::complex<T> v)
+        { return std::conj(v); }
+
+        // LU factorization with partial pivoting of a, stored as a[col][row].
+        // Returns 0, or the 1 based column of the first zero pivot.
+        template<typename T, int N>
+        static inline int lu(T (&a)[N][N], int (&piv)[N])
+        {
+            int info = 0;
+            for (int j = 0; j < N; j++) {
+                int p = j;
+                double pmax = magnitude(a[j][j]);
+                for (int i = j + 1; i < N; i++) {
+                    const double m = magnitude(a[j][i]);
+                    if (m > pmax) { pmax = m; p = i; }
+                }
+
+                piv[j] = p;
+                if (pmax == 0) {
+                    if (!info) info = j + 1;
+                    continue;
+                }
+
+                if (p != j) {
+                    for (int c = 0; c < N; c++) std::swap(a[c][j], a[c][p]);
+                }
+
+                const T inv = T(1) / a[j][j];
+                for (int i = j + 1; i < N; i++) a[j][i] *= inv;
+
+                for (int c = j + 1; c < N; c++) {
+                    const T f = a[c][j];
+                    for (int i = j + 1; i < N; i++) a[c][i] -= a[j][i] * f;
+                }
+            }
+            return info;
+        }
+
+        // Solves for x in place with the factors computed by lu
+        template<typename T, int N>
+        static inline void luSolve(const T (&a)[N][N], const int (&piv)[N], T (&x)[N])
+        {
+            for (int j = 0; j < N; j++) std::swap(x[j], x[piv[j]]);
+
+            for (int j = 0; j < N; j++) {
+                for (int i = j + 1; i < N; i++) x[i] -= a[j][i] * x[j];
+            }
+
+            for (int j = N - 1; j >= 0; j--) {
+                x[j] /= a[j][j];
+                for (int i = 0; i < j; i++) x[i] -= a[j][i] * x[j];
+            }
+        }
+
+        template<typename T, int N>
+        static inline void load(T (&a)[N][N], const T *in, const dim_t ld)
+        {
+            for (int c = 0; c < N; c++) {
+                for (int r = 0; r < N; r++) a[c][r] = in[c * ld + r];
+            }
+        }
+
+        // Solves a * x = b for the nrhs columns of b, in place. Returns the
+        // value of lu.
+        template<typename T, int N>
+        int solve(const T *A, const dim_t lda, T *B, const dim_t ldb, const int nrhs)
+        {
+            T a[N][N];
+            int piv[N];
+            load(a, A, lda);
+            const int info = lu(a, piv);
+            if (info) {
+                fillSingular(B, ldb, N, nrhs);
+                return info;
+            }
+
+            for (int k = 0; k < nrhs; k++) {
+                T x[N];
+                for (int i = 0; i < N; i++) x[i] = B[k * ldb + i];
+                luSolve(a, piv, x);
+                for (int i = 0; i < N; i++) B[k * ldb + i] = x[i];
+            }
+            return 0;
+        }
+
+        template<typename T, int N>
+        int inverse(const T *A, const dim_t lda, T *out, const dim_t ldo)
+        {
+            T a[N][N];
+            int piv[N];
+            load(a, A, lda);
+            const int info = lu(a, piv);
+            if (info) {
+                fillSingular(out, ldo, N, N);
+                return info;
+            }
+
+            for (int k = 0; k < N; k++) {
+                T x[N];
+                for (int i = 0; i < N; i++) x[i] = T(i == k ? 1 : 0);
+                luSolve(a, piv, x);
+                for (int i = 0; i < N; i++) out[k * ldo + i] = x[i];
+            }
+            return 0;
+        }
+
+        // Cholesky factorization in place, reading and writing only the
+        // triangle given by is_upper, as potrf does. Returns 0, or the order
+        // of the first leading minor that is not positive definite.
+        template<typename T, int N>
+        int cholesky(T *A, const dim_t lda, const bool is_upper)
+        {
+            // Lower triangular factor, stored as l[col][row]
+            T l[N][N];
+            for (int c = 0; c < N; c++) {
+                for (int r = c; r < N; r++) {
+                    l[c][r] = is_upper ? conjugate(A[r * lda + c]) : A[c * lda + r];
+                }
+            }
+
+            int info = 0;
+            for (int j = 0; j < N; j++) {
+                double d = std::real(l[j][j]);
+                for (int k = 0; k < j; k++) d -= std::norm(l[k][j]);
+                if (!(d > 0)) {
+                    info = j + 1;
+                    break;
+                }
+
+                d = std::sqrt(d);
+                l[j][j] = T(d);
+                for (int i = j + 1; i < N; i++) {
+                    T s = l[j][i];
+                    for (int k = 0; k < j; k++) s -= l[k][i] * conjugate(l[k][j]);
+                    l[j][i] = s / T(d);
+                }
+            }
+
+            const int done = info ? info - 1 : N;
+            for (int c = 0; c < done; c++) {
+                for (int r = c; r < N; r++) {
+                    if (is_upper) A[r * lda + c] = conjugate(l[c][r]);
+                    else          A[c * lda + r] = l[c][r];
+                }
+            }
+            return info;
+        }
+    }
+
+    template<typename T>
+    using solve_small_func = int (*)(const T *, const dim_t, T *, const dim_t, const int);
+
+    template<typename T>
+    using inverse_small_func = int (*)(const T *, const dim_t, T *, const dim_t);
+
+    template<typename T>
+    using cholesky_small_func = int (*)(T *, const dim_t, const bool);
+
+#define SMALL_FUNCS(FUNC, T)                                            \
+    { NULL,                                                             \
+      small::FUNC<T, 1>, small::FUNC<T, 2>, small::FUNC<T, 3>, small::FUNC<T, 4>, \
+      small::FUNC<T, 5>, small::FUNC<T, 6>, small::FUNC<T, 7>, small::FUNC<T, 8> }
+
+    // The kernels for n x n matrices, NULL when n is too large
+    template<typename T>
+    solve_small_func<T> solveSmallFunc(const dim_t n)
+    {
+        static const solve_small_func<T> funcs[] = SMALL_FUNCS(solve, T);
+        return n <= LAPACK_SMALL_SIZE ? funcs[n] : NULL;
+    }
+
+    template<typename T>
+    inverse_small_func<T> inverseSmallFunc(const dim_t n)
+    {
+        static const inverse_small_func<T> funcs[] = SMALL_FUNCS(inverse, T);
+        return n <= LAPACK_SMALL_SIZE ? funcs[n] : NULL;
+    }
+
+    template<typename T>
+    cholesky_small_func<T> choleskySmallFunc(const dim_t n)
+    {
+        static const cholesky_small_func<T> funcs[] = SMALL_FUNCS(cholesky, T);
+        return n <= LAPACK_SMALL_SIZE ? funcs[n] : NULL;
+    }
+
+#undef SMALL_FUNCS
+}
@@ -0,0 +1,34 @@
+/*******************************************************
+ * Copyright (c) 2015, ArrayFire
+ * All rights reserved.
+ *
+ * This file is distributed under 3-clause BSD license.
+ * The complete license agreement can be obtained at:
+ * http://arrayfire.com/licenses/BSD-3-Clause
+ ********************************************************/
+
+#pragma once
+#include <types.hpp>
+#include <lapack_helper.hpp>
+
+// The LU factorization of LAPACK, shared by lu and inverse
+namespace cpu
+{
+    template<typename T>
+    using getrf_func_def = int (*)(ORDER_TYPE, int, int,
+                                   T*, int,
+                                   int*);
+
+    template<typename T> getrf_func_def<T> getrf_func();
+
+#define GETRF_FUNC( TYPE, PREFIX )                                  \
+    template<> inline getrf_func_def<TYPE> getrf_func<TYPE>()       \
+    { return & LAPACK_NAME(PREFIX##getrf); }
+
+    GETRF_FUNC(float  , s)
+    GETRF_FUNC(double , d)
+    GETRF_FUNC(cfloat , c)
+    GETRF_FUNC(cdouble, z)
+
+#undef GETRF_FUNC
+}
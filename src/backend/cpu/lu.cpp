@@ -20,29 +20,11 @@
 
 #include <range.hpp>
 #include <lapack_helper.hpp>
+#include <lapack_getrf.hpp>
 
 namespace cpu
 {
 
-template<typename T>
-using getrf_func_def = int (*)(ORDER_TYPE, int, int,
-                               T*, int,
-                               int*);
-
-#define LU_FUNC_DEF( FUNC )                                     \
-template<typename T> FUNC##_func_def<T> FUNC##_func();
-
-
-#define LU_FUNC( FUNC, TYPE, PREFIX )                           \
-template<> FUNC##_func_def<TYPE>     FUNC##_func<TYPE>()        \
-{ return & LAPACK_NAME(PREFIX##FUNC); }
-
-LU_FUNC_DEF( getrf )
-LU_FUNC(getrf , float  , s)
-LU_FUNC(getrf , double , d)
-LU_FUNC(getrf , cfloat , c)
-LU_FUNC(getrf , cdouble, z)
-
 template<typename T>
 void lu_split(Array<T> &lower, Array<T> &upper, const Array<T> &in)
 {
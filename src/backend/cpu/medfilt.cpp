@@ -13,13 +13,258 @@
 #include <Array.hpp>
 #include <medfilt.hpp>
 #include <err_cpu.hpp>
+#include <parallel.hpp>
 #include <algorithm>
+#include <type_traits>
+#include <vector>
 
 using af::dim4;
 
 namespace cpu
 {
 
+// Integer inputs whose values span at most this many bins use the constant
+// time histogram filter
+static const dim_t MEDFILT_SMALL_BINS = 256;
+
+// Integer inputs whose values span at most this many bins use a sliding two
+// level histogram
+static const dim_t MEDFILT_LARGE_BINS = 65536;
+
+// Windows smaller than this are cheaper to keep sorted than to histogram
+static const dim_t MEDFILT_MIN_HIST_WINDOW = 9;
+
+// Columns of output filtered by one task. The histograms are rebuilt at the
+// start of every strip.
+static const dim_t MEDFILT_MIN_STRIP = 32;
+
+// Index of x reflected into [0, n) without repeating the edge element
+static inline dim_t reflect(dim_t x, const dim_t n)
+{
+    if (n == 1) return 0;
+    const dim_t period = 2 * (n - 1);
+    x %= period;
+    if (x < 0) x += period;
+    return x < n ? x : period - x;
+}
+
+// The padded image of one input image. Element (a, b) is the input at
+// (a - w_len / 2, b - w_wid / 2), so the window of the output at (i, j) is
+// the block starting at (i, j).
+template<typename T, af_border_type pad>
+static void padImage(T *pptr, const dim_t pd0, const dim_t pd1,
+                     const T *iptr, const dim4 &dims, const dim4 &strides,
+                     const dim_t w_len, const dim_t w_wid)
+{
+    for (dim_t b = 0; b < pd1; b++) {
+        dim_t col = b - w_wid / 2;
+        bool isColOff = col < 0 || col >= dims[1];
+        if (pad == AF_PAD_SYM) col = reflect(col, dims[1]);
+
+        for (dim_t a = 0; a < pd0; a++) {
+            dim_t row = a - w_len / 2;
+            bool isRowOff = row < 0 || row >= dims[0];
+            if (pad == AF_PAD_SYM) row = reflect(row, dims[0]);
+
+            if (pad == AF_PAD_ZERO && (isRowOff || isColOff)) {
+                pptr[b * pd0 + a] = T(0);
+            } else {
+                pptr[b * pd0 + a] = iptr[col * strides[1] + row * strides[0]];
+            }
+        }
+    }
+}
+
+// Median of a window of n values given the values at ranks n / 2 - 1 and
+// n / 2. Windows with an even number of values average the two.
+template<typename T>
+static inline T median(const T lo, const T hi, const dim_t n)
+{
+    return (n % 2 == 0) ? (lo + hi) / 2 : hi;
+}
+
+// Bin of the histogram holding the value of the given rank
+template<typename C>
+static inline dim_t findRank(const C *hist, const uint rank)
+{
+    uint sum = 0;
+    dim_t b = 0;
+    while (sum + hist[b] <= rank) sum += hist[b++];
+    return b;
+}
+
+// Constant time median filter of Perreault and Hebert, "Median Filtering in
+// Constant Time", IEEE TIP 2007. Every row of the padded image has a
+// histogram of the w_wid values to the right of column j. Moving to the next
+// column updates each of them with one removal and one insertion. The window
+// histogram is the sum of w_len adjacent row histograms, and moving down a
+// column adds one row histogram and subtracts another.
+template<typename T>
+static void medfiltSmallHist(T *optr, const dim4 &ostrides, const dim4 &dims,
+                             const T *pptr, const dim_t pd0,
+                             const dim_t w_len, const dim_t w_wid,
+                             const dim_t j0, const dim_t j1, const T offset)
+{
+    const dim_t nbins = MEDFILT_SMALL_BINS;
+    const dim_t n = w_len * w_wid;
+
+    std::vector<unsigned short> rows(pd0 * nbins, 0);
+    std::vector<uint> kernel(nbins);
+
+    for (dim_t b = j0; b < j0 + w_wid; b++) {
+        for (dim_t a = 0; a < pd0; a++) {
+            rows[a * nbins + (dim_t)(pptr[b * pd0 + a] - offset)]++;
+        }
+    }
+
+    for (dim_t j = j0; j < j1; j++) {
+        if (j > j0) {
+            const T *rem = pptr + (j - 1) * pd0;
+            const T *add = pptr + (j + w_wid - 1) * pd0;
+            for (dim_t a = 0; a < pd0; a++) {
+                rows[a * nbins + (dim_t)(rem[a] - offset)]--;
+                rows[a * nbins + (dim_t)(add[a] - offset)]++;
+            }
+        }
+
+        std::fill(kernel.begin(), kernel.end(), 0);
+        for (dim_t a = 0; a < w_len; a++) {
+            const unsigned short *h = &rows[a * nbins];
+            for (dim_t k = 0; k < nbins; k++) kernel[k] += h[k];
+        }
+
+        for (dim_t i = 0; i < dims[0]; i++) {
+            if (i > 0) {
+                const unsigned short *add = &rows[(i + w_len - 1) * nbins];
+                const unsigned short *rem = &rows[(i - 1) * nbins];
+                for (dim_t k = 0; k < nbins; k++) kernel[k] += add[k] - rem[k];
+            }
+
+            const T lo = (T)(findRank(&kernel.front(), (n - 1) / 2) + offset);
+            const T hi = (T)(findRank(&kernel.front(), n / 2) + offset);
+            optr[j * ostrides[1] + i * ostrides[0]] = median(lo, hi, n);
+        }
+    }
+}
+
+// Sliding histogram of Huang et al. for values spanning up to 16 bits. A
+// coarse histogram of the high byte narrows the search to 256 fine bins.
+// Moving down a column removes one row of the window and inserts another.
+template<typename T>
+static void medfiltLargeHist(T *optr, const dim4 &ostrides, const dim4 &dims,
+                             const T *pptr, const dim_t pd0,
+                             const dim_t w_len, const dim_t w_wid,
+                             const dim_t j0, const dim_t j1, const T offset)
+{
+    const dim_t n = w_len * w_wid;
+
+    std::vector<uint> fine(MEDFILT_LARGE_BINS, 0);
+    std::vector<uint> coarse(MEDFILT_LARGE_BINS >> 8, 0);
+
+    auto update = [&](const dim_t a, const dim_t b, const int delta) {
+        const dim_t v = (dim_t)(pptr[b * pd0 + a] - offset);
+        fine[v] += delta;
+        coarse[v >> 8] += delta;
+    };
+
+    auto value = [&](const uint rank) {
+        uint sum = 0;
+        dim_t c = 0;
+        while (sum + coarse[c] <= rank) sum += coarse[c++];
+        dim_t f = c << 8;
+        while (sum + fine[f] <= rank) sum += fine[f++];
+        return (T)(f + offset);
+    };
+
+    for (dim_t j = j0; j < j1; j++) {
+        for (dim_t b = j; b < j + w_wid; b++) {
+            for (dim_t a = 0; a < w_len; a++) update(a, b, 1);
+        }
+
+        for (dim_t i = 0; i < dims[0]; i++) {
+            if (i > 0) {
+                for (dim_t b = j; b < j + w_wid; b++) {
+                    update(i - 1, b, -1);
+                    update(i + w_len - 1, b, 1);
+                }
+            }
+            optr[j * ostrides[1] + i * ostrides[0]] = median(value((n - 1) / 2), value(n / 2), n);
+        }
+
+        // Empty the histograms for the next column
+        for (dim_t b = j; b < j + w_wid; b++) {
+            for (dim_t a = dims[0] - 1; a < dims[0] - 1 + w_len; a++) update(a, b, -1);
+        }
+    }
+}
+
+// Keeps the window sorted. Moving down a column sorts the w_wid values that
+// leave and enter the window and merges them with the window in one pass.
+template<typename T>
+static void medfiltSorted(T *optr, const dim4 &ostrides, const dim4 &dims,
+                          const T *pptr, const dim_t pd0,
+                          const dim_t w_len, const dim_t w_wid,
+                          const dim_t j0, const dim_t j1)
+{
+    const dim_t n = w_len * w_wid;
+
+    std::vector<T> wind(n), merged(n), rem(w_wid), add(w_wid);
+
+    for (dim_t j = j0; j < j1; j++) {
+        for (dim_t b = 0; b < w_wid; b++) {
+            std::copy(pptr + (j + b) * pd0, pptr + (j + b) * pd0 + w_len, &wind[b * w_len]);
+        }
+        std::sort(wind.begin(), wind.end());
+
+        for (dim_t i = 0; i < dims[0]; i++) {
+            if (i > 0) {
+                for (dim_t b = 0; b < w_wid; b++) {
+                    rem[b] = pptr[(j + b) * pd0 + i - 1];
+                    add[b] = pptr[(j + b) * pd0 + i + w_len - 1];
+                }
+                std::sort(rem.begin(), rem.end());
+                std::sort(add.begin(), add.end());
+
+                dim_t k = 0, r = 0, s = 0;
+                for (dim_t e = 0; e < n; e++) {
+                    const T v = wind[e];
+                    if (r < w_wid && !(rem[r] < v) && !(v < rem[r])) {
+                        r++;
+                        continue;
+                    }
+                    while (s < w_wid && add[s] < v) merged[k++] = add[s++];
+                    merged[k++] = v;
+                }
+                while (s < w_wid) merged[k++] = add[s++];
+                wind.swap(merged);
+            }
+
+            optr[j * ostrides[1] + i * ostrides[0]] = median(wind[(n - 1) / 2], wind[n / 2], n);
+        }
+    }
+}
+
+// Smallest value and number of histogram bins needed for the values of
+// integer types. Floating point values are never binned.
+template<typename T>
+static typename std::enable_if<std::is_integral<T>::value, dim_t>::type
+valueBins(const std::vector<T> &vals, T &offset)
+{
+    offset = T(0);
+    if (vals.empty()) return 1;
+    auto range = std::minmax_element(vals.begin(), vals.end());
+    offset = *range.first;
+    return (dim_t)(*range.second) - (dim_t)(*range.first) + 1;
+}
+
+template<typename T>
+static typename std::enable_if<!std::is_integral<T>::value, dim_t>::type
+valueBins(const std::vector<T> &vals, T &offset)
+{
+    offset = T(0);
+    return MEDFILT_LARGE_BINS + 1;
+}
+
 template<typename T, af_border_type pad>
 Array<T> medfilt(const Array<T> &in, dim_t w_len, dim_t w_wid)
 {
@@ -28,109 +273,51 @@ Array<T> medfilt(const Array<T> &in, dim_t w_len, dim_t w_wid)
     Array<T> out        = createEmptyArray<T>(dims);
     const dim4 ostrides = out.strides();
 
-    std::vector<T> wind_vals;
-    wind_vals.reserve(w_len*w_wid);
-
-    T const * in_ptr = in.get();
-    T * out_ptr = out.get();
-
-    for(int b3=0; b3<(int)dims[3]; b3++) {
-
-        for(int b2=0; b2<(int)dims[2]; b2++) {
-
-            for(int col=0; col<(int)dims[1]; col++) {
-
-                int ocol_off = col*ostrides[1];
-
-                for(int row=0; row<(int)dims[0]; row++) {
-
-                    wind_vals.clear();
-
-                    for(int wj=0; wj<(int)w_wid; ++wj) {
-
-                        bool isColOff = false;
-
-                        int im_col = col + wj-w_wid/2;
-                        int im_coff;
-                        switch(pad) {
-                            case AF_PAD_ZERO:
-                                im_coff = im_col * istrides[1];
-                                if (im_col < 0 || im_col>=(int)dims[1])
-                                    isColOff = true;
-                                break;
-                            case AF_PAD_SYM:
-                                {
-                                    if (im_col < 0) {
-                                        im_col *= -1;
-                                        isColOff = true;
-                                    }
-
-                                    if (im_col>=(int)dims[1]) {
-                                        im_col = 2*((int)dims[1]-1) - im_col;
-                                        isColOff = true;
-                                    }
-
-                                    im_coff = im_col * istrides[1];
-                                }
-                                break;
-                        }
-
-                        for(int wi=0; wi<(int)w_len; ++wi) {
-
-                            bool isRowOff = false;
-
-                            int im_row = row + wi-w_len/2;
-                            int im_roff;
-                            switch(pad) {
-                                case AF_PAD_ZERO:
-                                    im_roff = im_row * istrides[0];
-                                    if (im_row < 0 || im_row>=(int)dims[0])
-                                        isRowOff = true;
-                                    break;
-                                case AF_PAD_SYM:
-                                    {
-                                        if (im_row < 0) {
-                                            im_row *= -1;
-                                            isRowOff = true;
-                                        }
-
-                                        if (im_row>=(int)dims[0]) {
-                                            im_row = 2*((int)dims[0]-1) - im_row;
-                                            isRowOff = true;
-                                        }
-
-                                        im_roff = im_row * istrides[0];
-                                    }
-                                    break;
-                            }
-
-                            if(isRowOff || isColOff) {
-                                switch(pad) {
-                                    case AF_PAD_ZERO:
-                                        wind_vals.push_back(0);
-                                        break;
-                                    case AF_PAD_SYM:
-                                        wind_vals.push_back(in_ptr[im_coff+im_roff]);
-                                        break;
-                                }
-                            } else
-                                wind_vals.push_back(in_ptr[im_coff+im_roff]);
-                        }
-                    }
+    const dim_t pd0 = dims[0] + w_len - 1;
+    const dim_t pd1 = dims[1] + w_wid - 1;
+    const dim_t nimages = dims[2] * dims[3];
 
-                    std::stable_sort(wind_vals.begin(),wind_vals.end());
-                    int off = wind_vals.size()/2;
-                    if (wind_vals.size()%2==0)
-                        out_ptr[ocol_off+row*ostrides[0]] = (wind_vals[off]+wind_vals[off-1])/2;
-                    else {
-                        out_ptr[ocol_off+row*ostrides[0]] = wind_vals[off];
-                    }
+    // Padding every image up front lets the filters read the windows
+    // without checking the borders
+    std::vector<T> padded(pd0 * pd1 * nimages);
+    parallel_for(nimages, [&](dim_t begin, dim_t end) {
+            for (dim_t img = begin; img < end; img++) {
+                const dim_t b2 = img % dims[2];
+                const dim_t b3 = img / dims[2];
+                padImage<T, pad>(&padded[img * pd0 * pd1], pd0, pd1,
+                                 in.get() + b2 * istrides[2] + b3 * istrides[3],
+                                 dims, istrides, w_len, w_wid);
+            }
+        }, std::max<dim_t>(1, MIN_PARALLEL_ELEMENTS / (pd0 * pd1)));
+
+    T offset;
+    const dim_t bins = valueBins(padded, offset);
+    const bool isLargeWindow = std::min(w_len, w_wid) >= MEDFILT_MIN_HIST_WINDOW;
+
+    // Every strip of columns of every image is filtered independently
+    const dim_t strip   = std::max(MEDFILT_MIN_STRIP, 2 * w_wid);
+    const dim_t nstrips = (dims[1] + strip - 1) / strip;
+
+    parallel_for(nimages * nstrips, [&](dim_t begin, dim_t end) {
+            for (dim_t idx = begin; idx < end; idx++) {
+                const dim_t img = idx / nstrips;
+                const dim_t j0  = (idx % nstrips) * strip;
+                const dim_t j1  = std::min(j0 + strip, dims[1]);
+
+                const dim_t b2 = img % dims[2];
+                const dim_t b3 = img / dims[2];
+                T *optr = out.get() + b2 * ostrides[2] + b3 * ostrides[3];
+                const T *pptr = &padded[img * pd0 * pd1];
+
+                if (isLargeWindow && bins <= MEDFILT_SMALL_BINS) {
+                    medfiltSmallHist(optr, ostrides, dims, pptr, pd0, w_len, w_wid, j0, j1, offset);
+                } else if (isLargeWindow && bins <= MEDFILT_LARGE_BINS) {
+                    medfiltLargeHist(optr, ostrides, dims, pptr, pd0, w_len, w_wid, j0, j1, offset);
+                } else {
+                    medfiltSorted(optr, ostrides, dims, pptr, pd0, w_len, w_wid, j0, j1);
                 }
             }
-            in_ptr  += istrides[2];
-            out_ptr += ostrides[2];
-        }
-    }
+        }, 1);
 
     return out;
 }
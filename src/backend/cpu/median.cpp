@@ -0,0 +1,167 @@
+/*******************************************************
+ * Copyright (c) 2015, ArrayFire
+ * All rights reserved.
+ *
+ * This file is distributed under 3-clause BSD license.
+ * The complete license agreement can be obtained at:
+ * http://arrayfire.com/licenses/BSD-3-Clause
+ ********************************************************/
+
+#include <af/dim4.hpp>
+#include <af/defines.h>
+#include <Array.hpp>
+#include <copy.hpp>
+#include <median.hpp>
+#include <parallel.hpp>
+#include <sort_helper.hpp>
+#include <algorithm>
+#include <mutex>
+#include <vector>
+
+using af::dim4;
+using std::vector;
+
+namespace cpu
+{
+
+// Median of v[0, n), reordering v. The upper middle value is selected first,
+// the lower one of an even length is then the largest value below it.
+template<typename Ti, typename To>
+static To selectMedian(Ti *v, const dim_t n)
+{
+    const dim_t hi = n / 2;
+    std::nth_element(v, v + hi, v + n);
+    if (n % 2 == 1) return (To)v[hi];
+
+    const Ti lo = *std::max_element(v, v + hi);
+    return ((To)lo + (To)v[hi]) / (To)2;
+}
+
+// Columns gathered together when the median runs along dimensions other
+// than 0, so that the strided reads use whole cache lines
+static const dim_t MEDIAN_COLUMN_BLOCK = 16;
+
+template<typename Ti, typename To>
+Array<To> median(const Array<Ti> &in, const int dim)
+{
+    const dim4 dims    = in.dims();
+    const dim4 strides = in.strides();
+
+    dim4 odims = dims;
+    odims[dim] = 1;
+    Array<To> out = createEmptyArray<To>(odims);
+    const dim4 ostrides = out.strides();
+
+    const dim_t n     = dims[dim];
+    const dim_t ncols = dims.elements() / n;
+
+    // Consecutive columns are next to each other along dimension 0
+    const dim_t run   = (dim == 0) ? 1 : dims[0];
+    const dim_t block = std::min(run, MEDIAN_COLUMN_BLOCK);
+
+    const Ti *iptr = in.get();
+    To *optr = out.get();
+
+    parallel_for(ncols, [&](dim_t begin, dim_t end) {
+            vector<Ti> vals(n * block);
+
+            for (dim_t col = begin; col < end; ) {
+                const dim_t nb = std::min(std::min(block, end - col), run - col % run);
+
+                const Ti *src = iptr + columnOffset(col, dims, strides, dim);
+                for (dim_t i = 0; i < n; i++) {
+                    const Ti *row = src + i * strides[dim];
+                    for (dim_t b = 0; b < nb; b++) vals[b * n + i] = row[b * strides[0]];
+                }
+
+                To *dst = optr + columnOffset(col, dims, ostrides, dim);
+                for (dim_t b = 0; b < nb; b++) {
+                    dst[b * ostrides[0]] = selectMedian<Ti, To>(&vals[b * n], n);
+                }
+
+                col += nb;
+            }
+        }, std::max<dim_t>(1, MIN_PARALLEL_ELEMENTS / n));
+
+    return out;
+}
+
+// Leading bits of the keys counted by the histogram pass of median_all
+static const int MEDIAN_RADIX_BITS = 16;
+
+// The median of all the values is found without copying them. A parallel
+// histogram of the leading bits of the radix sort keys gives the buckets
+// holding the middle values, and only the values of those buckets are
+// gathered and selected from.
+template<typename Ti, typename To>
+To median_all(const Array<Ti> &in)
+{
+    typedef typename radix_traits<Ti>::key_t key_t;
+    const int bits  = std::min<int>(MEDIAN_RADIX_BITS, 8 * sizeof(key_t));
+    const int shift = 8 * sizeof(key_t) - bits;
+    const dim_t nbuckets = (dim_t)1 << bits;
+
+    // Sub arrays are not contiguous. The input is evaluated in place first,
+    // so that its handle keeps the result.
+    in.eval();
+    const Array<Ti> input = in.isOwner() ? in : copyArray<Ti>(in);
+    const Ti *ptr = input.get();
+    const dim_t n = input.elements();
+
+    // Ranks of the lower and upper middle values, equal for odd lengths
+    const dim_t lo = (n - 1) / 2;
+    const dim_t hi = n / 2;
+
+    // Each range has its own histogram, which has to be worth filling
+    const dim_t grain = std::max(MIN_PARALLEL_ELEMENTS, 16 * nbuckets);
+
+    std::mutex lock;
+    vector<dim_t> hist(nbuckets, 0);
+    parallel_for(n, [&](dim_t begin, dim_t end) {
+            vector<dim_t> local(nbuckets, 0);
+            for (dim_t i = begin; i < end; i++) {
+                local[radix_traits<Ti>::key(ptr[i]) >> shift]++;
+            }
+
+            std::lock_guard<std::mutex> guard(lock);
+            for (dim_t b = 0; b < nbuckets; b++) hist[b] += local[b];
+        }, grain);
+
+    // Buckets of the middle values and rank of the first value of bucket blo
+    dim_t blo = 0, base = 0;
+    while (base + hist[blo] <= lo) base += hist[blo++];
+    dim_t bhi = blo, last = base + hist[blo];
+    while (last <= hi) last += hist[++bhi];
+
+    vector<Ti> vals;
+    vals.reserve(last - base);
+    parallel_for(n, [&](dim_t begin, dim_t end) {
+            vector<Ti> local;
+            for (dim_t i = begin; i < end; i++) {
+                const key_t b = radix_traits<Ti>::key(ptr[i]) >> shift;
+                if (b >= (key_t)blo && b <= (key_t)bhi) local.push_back(ptr[i]);
+            }
+
+            std::lock_guard<std::mutex> guard(lock);
+            vals.insert(vals.end(), local.begin(), local.end());
+        }, grain);
+
+    Ti *vptr = &vals.front();
+    std::nth_element(vptr, vptr + (hi - base), vptr + vals.size());
+    if (lo == hi) return (To)vptr[hi - base];
+
+    const Ti vlo = *std::max_element(vptr, vptr + (hi - base));
+    return ((To)vlo + (To)vptr[hi - base]) / (To)2;
+}
+
+#define INSTANTIATE(Ti, To)                                                 \
+    template Array<To> median<Ti, To>(const Array<Ti> &in, const int dim);  \
+    template To median_all<Ti, To>(const Array<Ti> &in);
+
+INSTANTIATE(float , float )
+INSTANTIATE(double, double)
+INSTANTIATE(int   , float )
+INSTANTIATE(uint  , float )
+INSTANTIATE(uchar , float )
+
+}
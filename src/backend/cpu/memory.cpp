@@ -10,141 +10,236 @@
 #include <memory.hpp>
 #include <err_cpu.hpp>
 #include <types.hpp>
-#include <map>
+#include <unordered_map>
+#include <vector>
 #include <dispatch.hpp>
 #include <cstdlib>
 #include <mutex>
 
 namespace cpu
 {
-    class Manager
+    // Buffers are aligned for the widest SIMD loads
+    static const size_t ALIGNMENT = 64;
+
+    // Smallest buffer handed out by the memory manager
+    static const size_t MIN_BYTES = 1024;
+
+    // Every power of two is split into this many size classes, so a reused
+    // buffer is at most 25% larger than requested
+    static const unsigned BIN_SPLIT = 4;
+    static const unsigned NUM_BINS  = 64 * BIN_SPLIT;
+
+    // Returns the size class of a request and rounds bytes up to its size
+    static unsigned getBin(size_t &bytes)
     {
-        public:
-        static bool initialized;
-        Manager()
-        {
-            initialized = true;
+        if (bytes <= MIN_BYTES) {
+            bytes = MIN_BYTES;
+            return 0;
         }
 
-        ~Manager()
-        {
-            garbageCollect();
-        }
-    };
+        size_t n = bytes - 1;
+        unsigned p = 0;
+        while (n >> (p + 1)) p++;
 
-    bool Manager::initialized = false;
+        // n >> shift is in [BIN_SPLIT, 2 * BIN_SPLIT)
+        const unsigned shift = p - 2;
+        const size_t sub = n >> shift;
+        bytes = (sub + 1) << shift;
 
-    static void managerInit()
-    {
-        if(Manager::initialized == false)
-            static Manager pm = Manager();
+        // MIN_BYTES is 2^10, sizes up to it are in bin 0
+        return (p - 10) * BIN_SPLIT + (unsigned)(sub - BIN_SPLIT) + 1;
     }
 
-    typedef struct
+    static void *alignedAlloc(size_t bytes)
     {
-        bool is_free;
-        size_t bytes;
-    } mem_info;
-
-    static size_t used_bytes = 0;
-    static size_t used_buffers = 0;
-    static size_t total_bytes = 0;
-    typedef std::map<void *, mem_info> mem_t;
-    typedef mem_t::iterator mem_iter;
-
-    mem_t memory_map;
-    std::mutex memory_map_mutex;
+        void *ptr = NULL;
+#if defined(_WIN32) || defined(_MSC_VER)
+        ptr = _aligned_malloc(bytes, ALIGNMENT);
+#else
+        if (posix_memalign(&ptr, ALIGNMENT, bytes) != 0) ptr = NULL;
+#endif
+        return ptr;
+    }
 
-    template<typename T>
-    void freeWrapper(T *ptr)
+    static void alignedFree(void *ptr)
     {
-        free((void *)ptr);
+#if defined(_WIN32) || defined(_MSC_VER)
+        _aligned_free(ptr);
+#else
+        free(ptr);
+#endif
     }
 
-    void garbageCollect()
+    class MemoryManager
     {
-        for(mem_iter iter = memory_map.begin(); iter != memory_map.end(); ++iter) {
-            if ((iter->second).is_free) {
-                total_bytes -= iter->second.bytes;
-                freeWrapper(iter->first);
+        std::mutex mutex;
+
+        // Buffers owned by the manager and their size
+        std::unordered_map<void *, size_t> buffers;
+
+        // Free buffers, indexed by size class
+        std::vector<std::vector<void *> > bins;
+
+        size_t total_bytes;
+        size_t used_bytes;
+        size_t used_buffers;
+        size_t limit;
+
+        void release(void *ptr)
+        {
+            std::unordered_map<void *, size_t>::iterator iter = buffers.find(ptr);
+            total_bytes -= iter->second;
+            buffers.erase(iter);
+            alignedFree(ptr);
+        }
+
+        // Releases free buffers, largest first, until at most bytes are held
+        void evict(size_t bytes)
+        {
+            for (int b = NUM_BINS - 1; b >= 0 && total_bytes > bytes; b--) {
+                std::vector<void *> &bin = bins[b];
+                while (!bin.empty() && total_bytes > bytes) {
+                    release(bin.back());
+                    bin.pop_back();
+                }
             }
         }
 
-        mem_iter memory_curr = memory_map.begin();
-        mem_iter memory_end  = memory_map.end();
+    public:
+        MemoryManager() :
+            bins(NUM_BINS), total_bytes(0), used_bytes(0), used_buffers(0),
+            limit(DEFAULT_MEM_LIMIT)
+        {
+        }
 
-        while(memory_curr != memory_end) {
-            if (memory_curr->second.is_free) {
-                memory_map.erase(memory_curr++);
-            } else {
-                ++memory_curr;
-            }
+        ~MemoryManager()
+        {
+            garbageCollect();
         }
-    }
 
-    template<typename T>
-    T* memAlloc(const size_t &elements)
-    {
-        managerInit();
+        void *alloc(size_t bytes)
+        {
+            unsigned b = getBin(bytes);
 
-        T* ptr = NULL;
-        size_t alloc_bytes = divup(sizeof(T) * elements, 1024) * 1024;
+            std::lock_guard<std::mutex> lock(mutex);
 
-        if (elements > 0) {
-            std::lock_guard<std::mutex> lock(memory_map_mutex);
+            void *ptr = NULL;
+            if (!bins[b].empty()) {
+                ptr = bins[b].back();
+                bins[b].pop_back();
+            } else {
+                // Make room for the new buffer in the cache
+                if (total_bytes + bytes > limit) {
+                    evict(limit > bytes ? limit - bytes : 0);
+                }
 
-            // FIXME: Add better checks for garbage collection
-            // Perhaps look at total memory available as a metric
-            if (memory_map.size() > MAX_BUFFERS || used_bytes >= MAX_BYTES) {
-                garbageCollect();
+                ptr = alignedAlloc(bytes);
+                if (ptr == NULL) {
+                    evict(0);
+                    ptr = alignedAlloc(bytes);
+                    if (ptr == NULL) {
+                        AF_ERROR("Unable to allocate memory", AF_ERR_NO_MEM);
+                    }
+                }
+
+                buffers[ptr] = bytes;
+                total_bytes += bytes;
             }
 
-            for(mem_iter iter = memory_map.begin(); iter != memory_map.end(); ++iter) {
-                mem_info info = iter->second;
-                if (info.is_free && info.bytes == alloc_bytes) {
-                    iter->second.is_free = false;
-                    used_bytes += alloc_bytes;
-                    used_buffers++;
-                    return (T *)iter->first;
+            used_bytes += bytes;
+            used_buffers++;
+            return ptr;
+        }
+
+        void free(void *ptr)
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+
+            std::unordered_map<void *, size_t>::iterator iter = buffers.find(ptr);
+
+            if (iter != buffers.end()) {
+                size_t bytes = iter->second;
+                used_bytes -= bytes;
+                used_buffers--;
+
+                if (total_bytes > limit) {
+                    release(ptr);
+                } else {
+                    bins[getBin(bytes)].push_back(ptr);
                 }
+            } else {
+                ::free(ptr); // Free it because we are not sure what the size is
             }
+        }
+
+        void garbageCollect()
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            evict(0);
+        }
 
-            // Perform garbage collection if memory can not be allocated
-            ptr = (T *)malloc(alloc_bytes);
+        void setLimit(size_t bytes)
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            limit = bytes;
+            evict(limit);
+        }
 
-            mem_info info = {false, alloc_bytes};
-            memory_map[ptr] = info;
+        size_t getLimit()
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            return limit;
+        }
 
-            used_bytes += alloc_bytes;
-            used_buffers++;
-            total_bytes -= alloc_bytes;
+        void info(size_t *alloc_bytes, size_t *alloc_buffers,
+                  size_t *lock_bytes,  size_t *lock_buffers)
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            if (alloc_bytes   ) *alloc_bytes   = total_bytes;
+            if (alloc_buffers ) *alloc_buffers = buffers.size();
+            if (lock_bytes    ) *lock_bytes    = used_bytes;
+            if (lock_buffers  ) *lock_buffers  = used_buffers;
         }
-        return ptr;
+    };
+
+    static MemoryManager& getMemoryManager()
+    {
+        static MemoryManager manager;
+        return manager;
     }
 
-    template<typename T>
-    void memFree(T *ptr)
+    void garbageCollect()
     {
-        std::lock_guard<std::mutex> lock(memory_map_mutex);
+        getMemoryManager().garbageCollect();
+    }
 
-        mem_iter iter = memory_map.find((void *)ptr);
+    void setMemoryLimit(size_t bytes)
+    {
+        getMemoryManager().setLimit(bytes);
+    }
 
-        if (iter != memory_map.end()) {
-            iter->second.is_free = true;
-            used_bytes -= iter->second.bytes;
-            used_buffers--;
-        } else {
-            freeWrapper(ptr); // Free it because we are not sure what the size is
-        }
+    size_t getMemoryLimit()
+    {
+        return getMemoryManager().getLimit();
+    }
+
+    template<typename T>
+    T* memAlloc(const size_t &elements)
+    {
+        if (elements == 0) return NULL;
+        return (T *)getMemoryManager().alloc(sizeof(T) * elements);
+    }
+
+    template<typename T>
+    void memFree(T *ptr)
+    {
+        getMemoryManager().free((void *)ptr);
     }
 
     void deviceMemoryInfo(size_t *alloc_bytes, size_t *alloc_buffers,
                           size_t *lock_bytes,  size_t *lock_buffers)
     {
-        if (alloc_bytes   ) *alloc_bytes   = total_bytes;
-        if (alloc_buffers ) *alloc_buffers = memory_map.size();
-        if (lock_bytes    ) *lock_bytes    = used_bytes;
-        if (lock_buffers  ) *lock_buffers  = used_buffers;
+        getMemoryManager().info(alloc_bytes, alloc_buffers, lock_bytes, lock_buffers);
     }
 
     template<typename T>
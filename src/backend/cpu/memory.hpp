@@ -20,8 +20,15 @@ namespace cpu
     static const unsigned MAX_BUFFERS = 100;
     static const unsigned MAX_BYTES = 100 * (1 << 20);
 
+    // Bytes the memory manager may hold before it releases free buffers, the
+    // same default as on the CUDA and OpenCL backends
+    static const size_t DEFAULT_MEM_LIMIT = (size_t)1 << 30;
+
     void deviceMemoryInfo(size_t *alloc_bytes, size_t *alloc_buffers,
                           size_t *lock_bytes,  size_t *lock_buffers);
     void garbageCollect();
     void pinnedGarbageCollect();
+
+    void setMemoryLimit(size_t bytes);
+    size_t getMemoryLimit();
 }
@@ -12,7 +12,11 @@
 #include <ArrayInfo.hpp>
 #include <Array.hpp>
 #include <morph.hpp>
+#include <parallel.hpp>
+#include <dispatch.hpp>
 #include <algorithm>
+#include <limits>
+#include <vector>
 
 using af::dim4;
 
@@ -28,9 +32,205 @@ static inline unsigned getIdx(const dim4 &strides,
             i * strides[0]);
 }
 
+// Vectors of values filtered together when running along dimensions other
+// than 0
+static const dim_t MORPH_CHUNK = 64;
+
+template<typename T, bool isDilation>
+struct minmax_op
+{
+    // Value that never changes the result, used outside of the image
+    static T identity()
+    {
+        typedef std::numeric_limits<T> limits;
+        if (isDilation) return limits::has_infinity ? -limits::infinity() : limits::lowest();
+        else            return limits::has_infinity ?  limits::infinity() : limits::max();
+    }
+
+    T operator()(const T &a, const T &b) const
+    {
+        return isDilation ? std::max(a, b) : std::min(a, b);
+    }
+};
+
+// Index of x reflected into [0, n) without repeating the edge element
+static inline dim_t reflect(dim_t x, const dim_t n)
+{
+    if (n == 1) return 0;
+    const dim_t period = 2 * (n - 1);
+    x %= period;
+    if (x < 0) x += period;
+    return x < n ? x : period - x;
+}
+
+// Running minimum or maximum of width w along a line of n elements, using
+// the van Herk / Gil-Werman algorithm. It takes 3 comparisons per element
+// whatever the width. Element k of the line is the vector of len values
+// starting at iptr + k * istride, and its result goes to optr + k * ostride.
+// g and h are scratch buffers of (n + 2 * w) * len values.
+//
+// Outside of the line AF_PAD_ZERO ignores the window and AF_PAD_SYM
+// reflects it back in.
+template<typename T, bool isDilation, af_border_type pad>
+static void minmaxLine(T *optr, const dim_t ostride,
+                       const T *iptr, const dim_t istride,
+                       const dim_t n, const dim_t len, const dim_t w,
+                       T *g, T *h)
+{
+    minmax_op<T, isDilation> op;
+    const T id = minmax_op<T, isDilation>::identity();
+
+    // The padded line is split into blocks of w elements. g holds the
+    // running result from the start of each block and h the one from the
+    // end, so any window is covered by the end of one block and the start of
+    // the next.
+    const dim_t R  = w / 2;
+    const dim_t np = divup(n + w - 1, w) * w;
+
+    auto source = [&](const dim_t a) -> const T * {
+        const dim_t s = a - R;
+        if (s >= 0 && s < n) return iptr + s * istride;
+        if (pad == AF_PAD_SYM && a < n + w - 1) return iptr + reflect(s, n) * istride;
+        return NULL;
+    };
+
+    for (dim_t a = 0; a < np; a++) {
+        const T *src = source(a);
+        T *ga = g + a * len;
+        if (a % w == 0) {
+            if (src) std::copy(src, src + len, ga);
+            else     std::fill(ga, ga + len, id);
+        } else if (src) {
+            for (dim_t v = 0; v < len; v++) ga[v] = op(ga[v - len], src[v]);
+        } else {
+            std::copy(ga - len, ga, ga);
+        }
+    }
+
+    for (dim_t a = np - 1; a >= 0; a--) {
+        const T *src = source(a);
+        T *ha = h + a * len;
+        if (a % w == w - 1) {
+            if (src) std::copy(src, src + len, ha);
+            else     std::fill(ha, ha + len, id);
+        } else if (src) {
+            for (dim_t v = 0; v < len; v++) ha[v] = op(ha[v + len], src[v]);
+        } else {
+            std::copy(ha + len, ha + 2 * len, ha);
+        }
+    }
+
+    for (dim_t i = 0; i < n; i++) {
+        const T *hi = h + i * len;
+        const T *gi = g + (i + w - 1) * len;
+        T *oi = optr + i * ostride;
+        for (dim_t v = 0; v < len; v++) oi[v] = op(hi[v], gi[v]);
+    }
+}
+
+// Filters along dimension d with a width of w. The output is contiguous.
+// The input is contiguous as well except for the first pass along
+// dimension 0, which reads the strides of the input array.
+template<typename T, bool isDilation, af_border_type pad>
+static void minmaxPass(T *optr, const T *iptr, const dim4 &dims,
+                       const dim4 &istrides, const int d, const dim_t w)
+{
+    const dim_t n = dims[d];
+    const dim_t nbuf = n + 2 * w;
+
+    if (d == 0) {
+        parallel_for(dims[1] * dims[2] * dims[3], [&](dim_t begin, dim_t end) {
+                std::vector<T> g(nbuf), h(nbuf);
+                for (dim_t line = begin; line < end; line++) {
+                    const dim_t j  = line % dims[1];
+                    const dim_t b2 = (line / dims[1]) % dims[2];
+                    const dim_t b3 = line / (dims[1] * dims[2]);
+                    minmaxLine<T, isDilation, pad>(optr + line * n, 1,
+                                                   iptr + getIdx(istrides, 0, j, b2, b3), istrides[0],
+                                                   n, 1, w, &g.front(), &h.front());
+                }
+            }, std::max<dim_t>(1, MIN_PARALLEL_ELEMENTS / (3 * nbuf)));
+        return;
+    }
+
+    // Every element along d is the contiguous block of the lower dimensions,
+    // split into chunks that are filtered together
+    dim_t len = 1;
+    for (int i = 0; i < d; i++) len *= dims[i];
+    dim_t outer = 1;
+    for (int i = d + 1; i < 4; i++) outer *= dims[i];
+
+    const dim_t nchunks = divup(len, MORPH_CHUNK);
+
+    parallel_for(outer * nchunks, [&](dim_t begin, dim_t end) {
+            std::vector<T> g(nbuf * MORPH_CHUNK), h(nbuf * MORPH_CHUNK);
+            for (dim_t idx = begin; idx < end; idx++) {
+                const dim_t o = idx / nchunks;
+                const dim_t c = (idx % nchunks) * MORPH_CHUNK;
+                const dim_t off = o * n * len + c;
+                minmaxLine<T, isDilation, pad>(optr + off, len, iptr + off, len,
+                                               n, std::min(MORPH_CHUNK, len - c), w,
+                                               &g.front(), &h.front());
+            }
+        }, std::max<dim_t>(1, MIN_PARALLEL_ELEMENTS / (3 * nbuf * MORPH_CHUNK)));
+}
+
+// Erosion or dilation with a flat rectangular window, one pass per
+// dimension of the window. The passes alternate between the output and a
+// scratch array so the last one writes the output.
+template<typename T, bool isDilation, af_border_type pad>
+static Array<T> minmaxFilter(const Array<T> &in, const dim4 &window, const int npasses)
+{
+    const dim4 dims = in.dims();
+    Array<T> out = createEmptyArray<T>(dims);
+    std::vector<T> tmp(npasses > 1 ? dims.elements() : 0);
+
+    const dim4 cstrides(1, dims[0], dims[0] * dims[1], dims[0] * dims[1] * dims[2]);
+    const T *src = in.get();
+    for (int d = 0; d < npasses; d++) {
+        T *dst = ((npasses - 1 - d) % 2 == 0) ? out.get() : &tmp.front();
+        minmaxPass<T, isDilation, pad>(dst, src, dims, d == 0 ? in.strides() : cstrides, d, window[d]);
+        src = dst;
+    }
+
+    return out;
+}
+
+// True when every element of the mask is set, so the window is a rectangle
+template<typename T>
+static bool isFlatMask(const Array<T> &mask)
+{
+    const dim4 mdims    = mask.dims();
+    const dim4 mstrides = mask.strides();
+    const T *mptr       = mask.get();
+
+    for (dim_t k = 0; k < mdims[2]; k++) {
+        for (dim_t j = 0; j < mdims[1]; j++) {
+            for (dim_t i = 0; i < mdims[0]; i++) {
+                if (!(mptr[getIdx(mstrides, i, j, k)] > (T)0)) return false;
+            }
+        }
+    }
+    return true;
+}
+
+template<typename T, bool isDilation>
+Array<T> morphRect(const Array<T> &in, const dim_t w_len, const dim_t w_wid,
+                   const af_border_type pad)
+{
+    const dim4 window(w_len, w_wid, 1, 1);
+    if (pad == AF_PAD_SYM) return minmaxFilter<T, isDilation, AF_PAD_SYM >(in, window, 2);
+    else                   return minmaxFilter<T, isDilation, AF_PAD_ZERO>(in, window, 2);
+}
+
 template<typename T, bool isDilation>
 Array<T> morph(const Array<T> &in, const Array<T> &mask)
 {
+    // Flat windows are separable
+    if (isFlatMask(mask)) {
+        return minmaxFilter<T, isDilation, AF_PAD_ZERO>(in, mask.dims(), 2);
+    }
+
     const dim4 dims       = in.dims();
     const dim4 window     = mask.dims();
     const dim_t R0     = window[0]/2;
@@ -41,50 +241,42 @@ Array<T> morph(const Array<T> &in, const Array<T> &mask)
     Array<T> out         = createEmptyArray<T>(dims);
     const dim4 ostrides   = out.strides();
 
-    T* outData            = out.get();
-    const T*   inData     = in.get();
     const T*   filter     = mask.get();
 
-    for(dim_t b3=0; b3<dims[3]; ++b3) {
-        for(dim_t b2=0; b2<dims[2]; ++b2) {
-            // either channels or batch is handled by outer most loop
-            for(dim_t j=0; j<dims[1]; ++j) {
-                // j steps along 2nd dimension
-                for(dim_t i=0; i<dims[0]; ++i) {
-                    // i steps along 1st dimension
-                    T filterResult = inData[ getIdx(istrides, i, j) ];
+    // j steps along 2nd dimension, channels or batch along 3rd and 4th
+    parallel_for_batch(dims, [&](dim_t j, dim_t b2, dim_t b3) {
+        T* outData        = out.get() + b2 * ostrides[2] + b3 * ostrides[3];
+        const T*   inData = in.get()  + b2 * istrides[2] + b3 * istrides[3];
 
-                    // wj,wi steps along 2nd & 1st dimensions of filter window respectively
-                    for(dim_t wj=0; wj<window[1]; wj++) {
-                        for(dim_t wi=0; wi<window[0]; wi++) {
+        for(dim_t i=0; i<dims[0]; ++i) {
+            // i steps along 1st dimension
+            T filterResult = inData[ getIdx(istrides, i, j) ];
 
-                            dim_t offj = j+wj-R1;
-                            dim_t offi = i+wi-R0;
+            // wj,wi steps along 2nd & 1st dimensions of filter window respectively
+            for(dim_t wj=0; wj<window[1]; wj++) {
+                for(dim_t wi=0; wi<window[0]; wi++) {
 
-                            T maskValue = filter[ getIdx(fstrides, wi, wj) ];
+                    dim_t offj = j+wj-R1;
+                    dim_t offi = i+wi-R0;
 
-                            if ((maskValue > (T)0) && offi>=0 && offj>=0 && offi<dims[0] && offj<dims[1]) {
+                    T maskValue = filter[ getIdx(fstrides, wi, wj) ];
 
-                                T inValue   = inData[ getIdx(istrides, offi, offj) ];
+                    if ((maskValue > (T)0) && offi>=0 && offj>=0 && offi<dims[0] && offj<dims[1]) {
 
-                                if (isDilation)
-                                    filterResult = std::max(filterResult, inValue);
-                                else
-                                    filterResult = std::min(filterResult, inValue);
-                            }
+                        T inValue   = inData[ getIdx(istrides, offi, offj) ];
 
-                        } // window 1st dimension loop ends here
-                    } // filter window loop ends here
+                        if (isDilation)
+                            filterResult = std::max(filterResult, inValue);
+                        else
+                            filterResult = std::min(filterResult, inValue);
+                    }
 
-                    outData[ getIdx(ostrides, i, j) ] = filterResult;
-                } //1st dimension loop ends here
-            } // 2nd dimension loop ends here
+                } // window 1st dimension loop ends here
+            } // filter window loop ends here
 
-            // next iteration will be next batch if any
-            outData += ostrides[2];
-            inData  += istrides[2];
-        }
-    }
+            outData[ getIdx(ostrides, i, j) ] = filterResult;
+        } //1st dimension loop ends here
+    }, MIN_PARALLEL_ELEMENTS / (dims[0] * window[0] * window[1]));
 
     return out;
 }
@@ -92,6 +284,10 @@ Array<T> morph(const Array<T> &in, const Array<T> &mask)
 template<typename T, bool isDilation>
 Array<T> morph3d(const Array<T> &in, const Array<T> &mask)
 {
+    if (isFlatMask(mask)) {
+        return minmaxFilter<T, isDilation, AF_PAD_ZERO>(in, mask.dims(), 3);
+    }
+
     const dim4 dims       = in.dims();
     const dim4 window     = mask.dims();
     const dim_t R0     = window[0]/2;
@@ -104,14 +300,16 @@ Array<T> morph3d(const Array<T> &in, const Array<T> &mask)
     Array<T> out         = createEmptyArray<T>(dims);
     const dim4 ostrides   = out.strides();
 
-    T* outData            = out.get();
-    const T*   inData     = in.get();
     const T*   filter     = mask.get();
 
-    for(dim_t batchId=0; batchId<bCount; ++batchId) {
-        // either channels or batch is handled by outer most loop
-        for(dim_t k=0; k<dims[2]; ++k) {
-            // k steps along 3rd dimension
+    // k steps along 3rd dimension, channels or batch along the 4th
+    parallel_for(dims[2] * bCount, [&](dim_t begin, dim_t end) {
+        for(dim_t idx=begin; idx<end; ++idx) {
+            const dim_t k       = idx % dims[2];
+            const dim_t batchId = idx / dims[2];
+            T* outData          = out.get() + batchId * ostrides[3];
+            const T*   inData   = in.get()  + batchId * istrides[3];
+
             for(dim_t j=0; j<dims[1]; ++j) {
                 // j steps along 2nd dimension
                 for(dim_t i=0; i<dims[0]; ++i) {
@@ -147,11 +345,8 @@ Array<T> morph3d(const Array<T> &in, const Array<T> &mask)
                     outData[ getIdx(ostrides, i, j, k) ] = filterResult;
                 } //1st dimension loop ends here
             } // 2nd dimension loop ends here
-        } // 3rd dimension loop ends here
-        // next iteration will be next batch if any
-        outData += ostrides[3];
-        inData  += istrides[3];
-    }
+        }
+    }, MIN_PARALLEL_ELEMENTS / (dims[0] * dims[1] * window[0] * window[1] * window[2]));
 
     return out;
 }
@@ -160,7 +355,11 @@ Array<T> morph3d(const Array<T> &in, const Array<T> &mask)
     template Array<T> morph  <T, true >(const Array<T> &in, const Array<T> &mask);\
     template Array<T> morph  <T, false>(const Array<T> &in, const Array<T> &mask);\
     template Array<T> morph3d<T, true >(const Array<T> &in, const Array<T> &mask);\
-    template Array<T> morph3d<T, false>(const Array<T> &in, const Array<T> &mask);
+    template Array<T> morph3d<T, false>(const Array<T> &in, const Array<T> &mask);\
+    template Array<T> morphRect<T, true >(const Array<T> &in, const dim_t w_len, const dim_t w_wid, \
+                                          const af_border_type pad);                              \
+    template Array<T> morphRect<T, false>(const Array<T> &in, const dim_t w_len, const dim_t w_wid, \
+                                          const af_border_type pad);
 
 INSTANTIATE(float )
 INSTANTIATE(double)
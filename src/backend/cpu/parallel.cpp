@@ -0,0 +1,194 @@
+/*******************************************************
+ * Copyright (c) 2015, ArrayFire
+ * All rights reserved.
+ *
+ * This file is distributed under 3-clause BSD license.
+ * The complete license agreement can be obtained at:
+ * http://arrayfire.com/licenses/BSD-3-Clause
+ ********************************************************/
+
+#include <parallel.hpp>
+#include <platform.hpp>
+#include <err_cpu.hpp>
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstdlib>
+#include <exception>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace cpu
+{
+
+// Set on threads that are executing a parallel_for range
+static thread_local bool in_parallel = false;
+
+static int getDefaultNumThreads()
+{
+    const char *env = getenv("AF_CPU_NUM_THREADS");
+    if (env) {
+        int num = atoi(env);
+        if (num > 0) return num;
+    }
+
+    int num = (int)std::thread::hardware_concurrency();
+    return num > 0 ? num : 1;
+}
+
+class ThreadPool
+{
+    std::vector<std::thread> workers;
+
+    std::mutex job_mutex;   // Serializes calls to run()
+    std::mutex mutex;
+    std::condition_variable start_cv;
+    std::condition_variable done_cv;
+
+    // Current job
+    const std::function<void(dim_t, dim_t)> *func;
+    dim_t num;
+    dim_t chunk;
+    std::atomic<dim_t> next;
+    std::exception_ptr error;
+    unsigned generation;
+    int active;
+    bool stop;
+
+    // Grabs ranges of the current job until none are left
+    void work()
+    {
+        in_parallel = true;
+        while (true) {
+            dim_t begin = next.fetch_add(chunk);
+            if (begin >= num) break;
+            dim_t end = std::min(begin + chunk, num);
+            try {
+                (*func)(begin, end);
+            } catch (...) {
+                std::lock_guard<std::mutex> lock(mutex);
+                if (!error) error = std::current_exception();
+                next = num;
+            }
+        }
+        in_parallel = false;
+    }
+
+    void loop(unsigned seen)
+    {
+        while (true) {
+            {
+                std::unique_lock<std::mutex> lock(mutex);
+                start_cv.wait(lock, [&] { return stop || generation != seen; });
+                if (stop) return;
+                seen = generation;
+            }
+
+            work();
+
+            std::lock_guard<std::mutex> lock(mutex);
+            if (--active == 0) done_cv.notify_one();
+        }
+    }
+
+    void start(int num_threads)
+    {
+        stop = false;
+        for (int i = 0; i < num_threads - 1; i++) {
+            workers.push_back(std::thread(&ThreadPool::loop, this, generation));
+        }
+    }
+
+    void join()
+    {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            stop = true;
+        }
+        start_cv.notify_all();
+        for (auto &worker : workers) worker.join();
+        workers.clear();
+    }
+
+public:
+    ThreadPool() :
+        func(NULL), num(0), chunk(1), next(0),
+        generation(0), active(0), stop(false)
+    {
+        start(getDefaultNumThreads());
+    }
+
+    ~ThreadPool() { join(); }
+
+    int size() { return (int)workers.size() + 1; }
+
+    void resize(int num_threads)
+    {
+        std::lock_guard<std::mutex> job_lock(job_mutex);
+        join();
+        start(num_threads);
+    }
+
+    void run(dim_t n, const std::function<void(dim_t, dim_t)> &f, dim_t grain)
+    {
+        std::lock_guard<std::mutex> job_lock(job_mutex);
+
+        // A few ranges per thread to balance uneven work
+        const dim_t nchunks = std::min<dim_t>((n + grain - 1) / grain, 4 * size());
+
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            func   = &f;
+            num    = n;
+            chunk  = (n + nchunks - 1) / nchunks;
+            next   = 0;
+            error  = std::exception_ptr();
+            active = (int)workers.size();
+            generation++;
+        }
+        start_cv.notify_all();
+
+        // The calling thread works on the job too
+        work();
+
+        std::unique_lock<std::mutex> lock(mutex);
+        done_cv.wait(lock, [&] { return active == 0; });
+        func = NULL;
+
+        if (error) std::rethrow_exception(error);
+    }
+};
+
+static ThreadPool& getThreadPool()
+{
+    static ThreadPool pool;
+    return pool;
+}
+
+int getNumThreads()
+{
+    return getThreadPool().size();
+}
+
+void setNumThreads(int num)
+{
+    ARG_ASSERT(0, num >= 0);
+    getThreadPool().resize(num > 0 ? num : getDefaultNumThreads());
+}
+
+void parallel_for(dim_t num, const std::function<void(dim_t, dim_t)> &func,
+                  dim_t grain)
+{
+    if (num <= 0) return;
+
+    grain = std::max<dim_t>(grain, 1);
+    if (num <= grain || in_parallel || getNumThreads() == 1) {
+        func(0, num);
+        return;
+    }
+
+    getThreadPool().run(num, func, grain);
+}
+
+}
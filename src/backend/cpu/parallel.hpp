@@ -0,0 +1,47 @@
+/*******************************************************
+ * Copyright (c) 2015, ArrayFire
+ * All rights reserved.
+ *
+ * This file is distributed under 3-clause BSD license.
+ * The complete license agreement can be obtained at:
+ * http://arrayfire.com/licenses/BSD-3-Clause
+ ********************************************************/
+
+#pragma once
+#include <af/defines.h>
+#include <af/dim4.hpp>
+#include <functional>
+
+namespace cpu
+{
+    // Kernels doing a few operations per element only go parallel above this
+    // many elements
+    const dim_t MIN_PARALLEL_ELEMENTS = 1 << 15;
+
+    // Splits [0, num) into contiguous ranges of at least grain iterations and
+    // calls func(begin, end) for each of them on the thread pool. Returns when
+    // all ranges are done.
+    //
+    // Calls made from inside func run serially on the current thread, so
+    // kernels can parallelize their outer loops without worrying about
+    // nesting. The first exception thrown by func is rethrown here.
+    void parallel_for(dim_t num, const std::function<void(dim_t, dim_t)> &func,
+                      dim_t grain = 1);
+
+    // Calls func(j, k, l) for every index of dimensions 1, 2 and 3 of dims,
+    // distributing the iterations over the thread pool. This is the shape of
+    // the outer batch loops of most kernels.
+    template<typename Func>
+    void parallel_for_batch(const af::dim4 &dims, Func func, dim_t grain = 1)
+    {
+        const dim_t d1 = dims[1];
+        const dim_t d2 = dims[2];
+
+        parallel_for(dims[1] * dims[2] * dims[3],
+                     [&](dim_t begin, dim_t end) {
+                         for (dim_t b = begin; b < end; b++) {
+                             func(b % d1, (b / d1) % d2, b / (d1 * d2));
+                         }
+                     }, grain);
+    }
+}
@@ -23,4 +23,12 @@ namespace cpu {
     int getActiveDeviceId();
 
     void sync(int device);
+
+    // Number of threads used by the backend, including the calling thread.
+    // Defaults to the value of AF_CPU_NUM_THREADS if set, the number of
+    // hardware threads otherwise.
+    int getNumThreads();
+
+    // Resizes the thread pool. 0 restores the default.
+    void setNumThreads(int num);
 }
@@ -8,115 +8,225 @@
  ********************************************************/
 
 #include <type_traits>
-#include <random>
 #include <algorithm>
-#include <functional>
 #include <limits>
-#include <type_traits>
+#include <mutex>
+#include <cmath>
 #include <af/array.h>
 #include <af/dim4.hpp>
 #include <af/defines.h>
 #include <Array.hpp>
 #include <random.hpp>
+#include <parallel.hpp>
 
 namespace cpu
 {
 
 using namespace std;
 
-template<typename T>
-using is_arithmetic_t       = typename enable_if< is_arithmetic<T>::value,      function<T()>>::type;
-template<typename T>
-using is_complex_t          = typename enable_if< is_complex<T>::value,         function<T()>>::type;
-template<typename T>
-using is_floating_point_t   = typename enable_if< is_floating_point<T>::value,  function<T()>>::type;
+///////////////////////////////////////////////////////////////////////////
+// Philox4x32-10 counter based generator
+// Salmon et al., "Parallel random numbers: as easy as 1, 2, 3", SC 2011
+//
+// Every call to philox returns 4 random words that depend only on the 64 bit
+// seed and the 64 bit block counter. The arrays are filled from consecutive
+// blocks starting at the global counter, so the values are the same for any
+// number of threads.
+///////////////////////////////////////////////////////////////////////////
+
+static const uint PHILOX_M0 = 0xD2511F53;
+static const uint PHILOX_M1 = 0xCD9E8D57;
+static const uint PHILOX_W0 = 0x9E3779B9;
+static const uint PHILOX_W1 = 0xBB67AE85;
 
-template<typename T, typename GenType>
-is_arithmetic_t<T>
-urand(GenType &generator)
+static inline void philoxRound(uint ctr[4], const uint key[2])
 {
-    typedef typename conditional<   is_floating_point<T>::value,
-                                    uniform_real_distribution<T>,
-#if OS_WIN
-                                    uniform_int_distribution<unsigned>>::type dist;
-#else
-                                    uniform_int_distribution<T >> ::type dist;
-#endif
-    return bind(dist(), generator);
+    const uintl p0 = (uintl)PHILOX_M0 * ctr[0];
+    const uintl p1 = (uintl)PHILOX_M1 * ctr[2];
+
+    const uint c0 = (uint)(p1 >> 32) ^ ctr[1] ^ key[0];
+    const uint c2 = (uint)(p0 >> 32) ^ ctr[3] ^ key[1];
+
+    ctr[0] = c0;
+    ctr[1] = (uint)p1;
+    ctr[2] = c2;
+    ctr[3] = (uint)p0;
 }
 
-template<typename T, typename GenType>
-is_complex_t<T>
-urand(GenType &generator)
+static inline void philox(uint out[4], const uintl seed, const uintl block)
 {
-    auto func = urand<typename T::value_type>(generator);
-    return [func] () { return T(func(), func());};
+    uint key[2] = {(uint)seed, (uint)(seed >> 32)};
+    out[0] = (uint)block;
+    out[1] = (uint)(block >> 32);
+    out[2] = 0;
+    out[3] = 0;
+
+    for (int i = 0; i < 10; i++) {
+        if (i > 0) {
+            key[0] += PHILOX_W0;
+            key[1] += PHILOX_W1;
+        }
+        philoxRound(out, key);
+    }
 }
 
-template<typename T, typename GenType>
-is_floating_point_t<T>
-nrand(GenType &generator)
+///////////////////////////////////////////////////////////////////////////
+// Conversion of the random words to values
+///////////////////////////////////////////////////////////////////////////
+
+// Uniform in [0, 1) with all the bits of the mantissa random
+static inline float toFloat(uint a)
 {
-    return bind(normal_distribution<T>(), generator);
+    return (a >> 8) * (1.0f / 16777216.0f);
 }
 
-template<typename T, typename GenType>
-is_complex_t<T>
-nrand(GenType &generator)
+static inline double toDouble(uint a, uint b)
 {
-    auto func = nrand<typename T::value_type>(generator);
-    return [func] () { return T(func(), func());};
+    const uintl bits = ((uintl)a << 32) | b;
+    return (bits >> 11) * (1.0 / 9007199254740992.0);
 }
 
-static default_random_engine generator;
-static unsigned long long gen_seed = 0;
-static bool is_first = true;
-#define GLOBAL 1
+// Type of the values making up an element of type T
+template<typename T> struct random_traits
+{
+    typedef T value_t;
+};
 
-template<typename T>
-Array<T> randn(const af::dim4 &dims)
+template<> struct random_traits<cfloat>
 {
-    static unsigned long long my_seed = 0;
-    if (is_first) {
-        setSeed(gen_seed);
-        my_seed = gen_seed;
-    }
+    typedef float value_t;
+};
 
-    static auto gen = nrand<T>(generator);
+template<> struct random_traits<cdouble>
+{
+    typedef double value_t;
+};
 
-    if (my_seed != gen_seed) {
-        gen = nrand<T>(generator);
-    }
+// Fills the values of one block. vals holds the real parts and imaginary
+// parts of complex types next to each other.
+template<typename T> static inline void uniformBlock(T *vals, const uint *r);
 
-    Array<T> outArray = createEmptyArray<T>(dims);
-    T *outPtr = outArray.get();
-    generate(outPtr, outPtr + outArray.elements(), gen);
-    return outArray;
+template<> inline void uniformBlock(float *vals, const uint *r)
+{
+    for (int i = 0; i < 4; i++) vals[i] = toFloat(r[i]);
+}
+
+template<> inline void uniformBlock(double *vals, const uint *r)
+{
+    vals[0] = toDouble(r[0], r[1]);
+    vals[1] = toDouble(r[2], r[3]);
+}
+
+template<> inline void uniformBlock(int *vals, const uint *r)
+{
+    // Non negative like std::uniform_int_distribution<int>
+    for (int i = 0; i < 4; i++) vals[i] = (int)(r[i] >> 1);
+}
+
+template<> inline void uniformBlock(uint *vals, const uint *r)
+{
+    for (int i = 0; i < 4; i++) vals[i] = r[i];
+}
+
+template<> inline void uniformBlock(uchar *vals, const uint *r)
+{
+    for (int i = 0; i < 4; i++) vals[i] = (uchar)(r[i] >> 24);
 }
 
+template<> inline void uniformBlock(char *vals, const uint *r)
+{
+    for (int i = 0; i < 4; i++) vals[i] = (char)(r[i] >> 31);
+}
+
+// Box-Muller transform of pairs of uniform values in place. The loop has no
+// dependencies between iterations so the compiler can vectorize it.
 template<typename T>
-Array<T> randu(const af::dim4 &dims)
+static void boxMuller(T *vals, const dim_t num)
 {
-    static unsigned long long my_seed = 0;
-    if (is_first) {
-        setSeed(gen_seed);
-        my_seed = gen_seed;
+    const T two_pi = (T)(2.0 * 3.14159265358979323846);
+    for (dim_t i = 0; i < num; i += 2) {
+        // 1 - u is in (0, 1], so the log is finite
+        const T r = std::sqrt((T)(-2) * std::log((T)1 - vals[i]));
+        const T theta = two_pi * vals[i + 1];
+        vals[i]     = r * std::sin(theta);
+        vals[i + 1] = r * std::cos(theta);
     }
+}
 
-    static auto gen = urand<T>(generator);
+///////////////////////////////////////////////////////////////////////////
+// Generator state
+///////////////////////////////////////////////////////////////////////////
 
-    if (my_seed != gen_seed) {
-        gen = urand<T>(generator);
-    }
+static std::mutex random_mutex;
+static uintl gen_seed = 0;
+static uintl gen_counter = 0;
+
+// Reserves num blocks of the stream, returning the seed and the first block
+static void reserveBlocks(const uintl num, uintl &seed, uintl &first)
+{
+    std::lock_guard<std::mutex> lock(random_mutex);
+    seed = gen_seed;
+    first = gen_counter;
+    gen_counter += num;
+}
+
+// Blocks generated together before converting them to the output
+static const dim_t RANDOM_CHUNK_BLOCKS = 64;
+
+template<typename T, bool isNormal>
+static Array<T> generate(const af::dim4 &dims)
+{
+    typedef typename random_traits<T>::value_t value_t;
+    // A block has 4 random words, 64 bit values take 2 of them
+    const dim_t per_block = sizeof(value_t) == 8 ? 2 : 4;
+    const dim_t values_per_elem = is_complex<T>::value ? 2 : 1;
 
     Array<T> outArray = createEmptyArray<T>(dims);
-    T *outPtr = outArray.get();
-    for (int i = 0; i < (int)outArray.elements(); i++) {
-        outPtr[i] = gen();
-    }
+    value_t *outPtr = (value_t *)outArray.get();
+
+    const dim_t num = outArray.elements() * values_per_elem;
+    const dim_t blocks = (num + per_block - 1) / per_block;
+    const dim_t chunks = (blocks + RANDOM_CHUNK_BLOCKS - 1) / RANDOM_CHUNK_BLOCKS;
+
+    uintl seed, first;
+    reserveBlocks(blocks, seed, first);
+
+    parallel_for(chunks, [&](dim_t begin, dim_t end) {
+            value_t vals[RANDOM_CHUNK_BLOCKS * 4];
+            uint r[4];
+
+            for (dim_t c = begin; c < end; c++) {
+                const dim_t b0 = c * RANDOM_CHUNK_BLOCKS;
+                const dim_t nb = std::min(RANDOM_CHUNK_BLOCKS, blocks - b0);
+
+                for (dim_t b = 0; b < nb; b++) {
+                    philox(r, seed, first + b0 + b);
+                    uniformBlock<value_t>(vals + b * per_block, r);
+                }
+
+                if (isNormal) boxMuller(vals, nb * per_block);
+
+                const dim_t off = b0 * per_block;
+                const dim_t len = std::min(nb * per_block, num - off);
+                std::copy(vals, vals + len, outPtr + off);
+            }
+        }, std::max<dim_t>(1, MIN_PARALLEL_ELEMENTS / (RANDOM_CHUNK_BLOCKS * per_block)));
+
     return outArray;
 }
 
+template<typename T>
+Array<T> randn(const af::dim4 &dims)
+{
+    return generate<T, true>(dims);
+}
+
+template<typename T>
+Array<T> randu(const af::dim4 &dims)
+{
+    return generate<T, false>(dims);
+}
+
 #define INSTANTIATE_UNIFORM(T)                              \
     template Array<T>  randu<T>    (const af::dim4 &dims);
 
@@ -127,6 +237,7 @@ INSTANTIATE_UNIFORM(cdouble)
 INSTANTIATE_UNIFORM(int)
 INSTANTIATE_UNIFORM(uint)
 INSTANTIATE_UNIFORM(uchar)
+INSTANTIATE_UNIFORM(char)
 
 #define INSTANTIATE_NORMAL(T)                              \
     template Array<T>  randn<T>(const af::dim4 &dims);
@@ -136,40 +247,29 @@ INSTANTIATE_NORMAL(double)
 INSTANTIATE_NORMAL(cfloat)
 INSTANTIATE_NORMAL(cdouble)
 
-
-template<>
-Array<char> randu(const af::dim4 &dims)
-{
-    static unsigned long long my_seed = 0;
-    if (is_first) {
-        setSeed(gen_seed);
-        my_seed = gen_seed;
-    }
-
-    static auto gen = urand<float>(generator);
-
-    if (my_seed != gen_seed) {
-        gen = urand<float>(generator);
-    }
-
-    Array<char> outArray = createEmptyArray<char>(dims);
-    char *outPtr = outArray.get();
-    for (int i = 0; i < (int)outArray.elements(); i++) {
-        outPtr[i] = gen() > 0.5;
-    }
-    return outArray;
-}
-
 void setSeed(const uintl seed)
 {
-    generator.seed(seed);
-    is_first = false;
+    std::lock_guard<std::mutex> lock(random_mutex);
     gen_seed = seed;
+    gen_counter = 0;
 }
 
 uintl getSeed()
 {
+    std::lock_guard<std::mutex> lock(random_mutex);
     return gen_seed;
 }
 
+void setRandomCounter(const uintl counter)
+{
+    std::lock_guard<std::mutex> lock(random_mutex);
+    gen_counter = counter;
+}
+
+uintl getRandomCounter()
+{
+    std::lock_guard<std::mutex> lock(random_mutex);
+    return gen_counter;
+}
+
 }
@@ -20,4 +20,7 @@ namespace cpu
 
     void setSeed(const uintl seed);
     uintl getSeed();
+
+    void setRandomCounter(const uintl counter);
+    uintl getRandomCounter();
 }
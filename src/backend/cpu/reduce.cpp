@@ -13,46 +13,24 @@
 #include <Array.hpp>
 #include <reduce.hpp>
 #include <ops.hpp>
-#include <functional>
+#include <parallel.hpp>
+#include <algorithm>
 #include <complex>
 
 using af::dim4;
 
 namespace cpu
 {
-    template<af_op_t op, typename Ti, typename To, int D>
-    struct reduce_dim
-    {
-        void operator()(To *out, const dim4 &ostrides, const dim4 &odims,
-                        const Ti *in , const dim4 &istrides, const dim4 &idims,
-                        const int dim)
-        {
-            static const int D1 = D - 1;
-            static reduce_dim<op, Ti, To, D1> reduce_dim_next;
-            for (dim_t i = 0; i < odims[D1]; i++) {
-                 reduce_dim_next(out + i * ostrides[D1],
-                                 ostrides, odims,
-                                 in  + i * istrides[D1],
-                                 istrides, idims,
-                                 dim);
-            }
-        }
-    };
-
     template<af_op_t op, typename Ti, typename To>
-    struct reduce_dim<op, Ti, To, 0>
+    struct reduce_dim
     {
 
         Transform<Ti, To, op> transform;
         Binary<To, op> reduce;
-        void operator()(To *out, const dim4 &ostrides, const dim4 &odims,
-                        const Ti *in , const dim4 &istrides, const dim4 &idims,
-                        const int dim)
+        void operator()(To *out, const Ti *in, const dim_t stride, const dim_t len)
         {
-            dim_t stride = istrides[dim];
-
             To out_val = reduce.init();
-            for (dim_t i = 0; i < idims[dim]; i++) {
+            for (dim_t i = 0; i < len; i++) {
                 To in_val = transform(in[i * stride]);
                 out_val = reduce(in_val, out_val);
             }
@@ -61,11 +39,6 @@ namespace cpu
         }
     };
 
-    template<af_op_t op, typename Ti, typename To>
-    using reduce_dim_func = std::function<void(To*,const dim4&, const dim4&,
-                                                const Ti*, const dim4&, const dim4&,
-                                                const int)>;
-
     template<af_op_t op, typename Ti, typename To>
     Array<To> reduce(const Array<Ti> &in, const int dim)
     {
@@ -73,13 +46,45 @@ namespace cpu
         odims[dim] = 1;
 
         Array<To> out = createEmptyArray<To>(odims);
-        static reduce_dim_func<op, Ti, To>  reduce_funcs[4] = { reduce_dim<op, Ti, To, 1>()
-                                                              , reduce_dim<op, Ti, To, 2>()
-                                                              , reduce_dim<op, Ti, To, 3>()
-                                                              , reduce_dim<op, Ti, To, 4>()};
 
-        reduce_funcs[in.ndims() - 1](out.get(), out.strides(), out.dims(),
-                                    in.get(), in.strides(), in.dims(), dim);
+        const dim4 ostrides = out.strides();
+        const dim4 istrides = in.strides();
+        const dim_t stride  = istrides[dim];
+        const dim_t len     = in.dims()[dim];
+
+        To *outPtr = out.get();
+        const Ti *inPtr = in.get();
+
+        // Every output element is independent. Split the rows of the output
+        // across threads, or the columns when there is only one row.
+        const dim_t nrows = odims[1] * odims[2] * odims[3];
+        const dim_t grain = MIN_PARALLEL_ELEMENTS / std::max<dim_t>(len, 1);
+
+        auto reduceRows = [&](dim_t begin, dim_t end, dim_t xbegin, dim_t xend) {
+            reduce_dim<op, Ti, To> reduce_op;
+            for (dim_t row = begin; row < end; row++) {
+                dim_t j = row % odims[1];
+                dim_t k = (row / odims[1]) % odims[2];
+                dim_t l = row / (odims[1] * odims[2]);
+
+                To *o = outPtr + j * ostrides[1] + k * ostrides[2] + l * ostrides[3];
+                const Ti *i = inPtr + j * istrides[1] + k * istrides[2] + l * istrides[3];
+
+                for (dim_t x = xbegin; x < xend; x++) {
+                    reduce_op(o + x, i + x * istrides[0], stride, len);
+                }
+            }
+        };
+
+        if (nrows == 1) {
+            parallel_for(odims[0], [&](dim_t begin, dim_t end) {
+                    reduceRows(0, 1, begin, end);
+                }, grain);
+        } else {
+            parallel_for(nrows, [&](dim_t begin, dim_t end) {
+                    reduceRows(begin, end, 0, odims[0]);
+                }, grain / std::max<dim_t>(odims[0], 1));
+        }
 
         return out;
     }
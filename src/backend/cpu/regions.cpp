@@ -11,189 +11,412 @@
 #include <af/defines.h>
 #include <ArrayInfo.hpp>
 #include <Array.hpp>
+#include <copy.hpp>
 #include <regions.hpp>
 #include <err_cpu.hpp>
-#include <math.hpp>
-#include <map>
-#include <set>
+#include <parallel.hpp>
+#include <platform.hpp>
+#include <dispatch.hpp>
 #include <algorithm>
+#include <cstdlib>
+#include <limits>
+#include <vector>
 
 using af::dim4;
+using std::vector;
 
 namespace cpu
 {
 
-template<typename T>
-class LabelNode
+// Provisional labels are kept in one flat union-find array. Every label
+// points to itself or to a smaller label of the same region, so the root of
+// a region is its smallest label, which belongs to its first pixel in memory
+// order.
+static inline uint findRoot(const uint *parent, uint l)
 {
-private:
-    T label;
-    T minLabel;
-    unsigned rank;
-    LabelNode* parent;
-
-public:
-    LabelNode() : label(0), minLabel(0), rank(0), parent(this) { }
-    LabelNode(T label) : label(label), minLabel(label), rank(0), parent(this) { }
+    while (parent[l] < l) l = parent[l];
+    return l;
+}
 
-    T getLabel()
-    {
-        return label;
+// Points every label on the path from l to its root at root
+static inline void setRoot(uint *parent, uint l, const uint root)
+{
+    while (parent[l] < l) {
+        const uint next = parent[l];
+        parent[l] = root;
+        l = next;
     }
+    parent[l] = root;
+}
 
-    T getMinLabel()
-    {
-        return minLabel;
-    }
+// Joins the regions of labels a and b and returns the root of the result
+static inline uint merge(uint *parent, const uint a, const uint b)
+{
+    if (a == b) return a;
+    const uint root = std::min(findRoot(parent, a), findRoot(parent, b));
+    setRoot(parent, a, root);
+    setRoot(parent, b, root);
+    return root;
+}
 
-    LabelNode* getParent()
-    {
-        return parent;
-    }
+// Area, bounding box and coordinate sums of a region
+struct RegionStats
+{
+    uint area;
+    uint lo[3];
+    uint hi[3];
+    double sum[3];
 
-    unsigned getRank()
-    {
-        return rank;
-    }
+    RegionStats() : area(0) {}
 
-    void setMinLabel(T l)
+    void add(const uint i, const uint j, const uint k)
     {
-        minLabel = l;
+        const uint pos[3] = {i, j, k};
+        for (int d = 0; d < 3; d++) {
+            lo[d] = area ? std::min(lo[d], pos[d]) : pos[d];
+            hi[d] = area ? std::max(hi[d], pos[d]) : pos[d];
+            sum[d] = (area ? sum[d] : 0) + pos[d];
+        }
+        area++;
     }
 
-    void setParent(LabelNode* p)
+    void add(const RegionStats &other)
     {
-        parent = p;
+        for (int d = 0; d < 3; d++) {
+            lo[d] = area ? std::min(lo[d], other.lo[d]) : other.lo[d];
+            hi[d] = area ? std::max(hi[d], other.hi[d]) : other.hi[d];
+            sum[d] = (area ? sum[d] : 0) + other.sum[d];
+        }
+        area += other.area;
     }
+};
 
-    void setRank(unsigned r)
+// Lines [begin, end) of one image, labelled by a single thread. A line is a
+// column of a 2D image or a slice of a volume. The provisional labels of a
+// strip start after the linear index of its first pixel, so the strips of
+// all the images never share labels.
+struct LabelStrip
+{
+    dim_t image;
+    dim_t begin;
+    dim_t end;
+    uint first;
+    uint count;
+    vector<RegionStats> stats;
+
+    uint newLabel(uint *parent)
     {
-        rank = r;
+        const uint l = first + count++;
+        parent[l] = l;
+        return l;
     }
 };
 
-template<typename T>
-static LabelNode<T>* find(LabelNode<T>* x)
+// Labels the columns of a strip of a 2D image, using the decision tree of
+// Wu et al. for 8-connectivity: the pixel above (b) is a neighbour of all the
+// others, so when it is set no merge is needed, and the pixels on the left
+// (a, d) only have to be merged with the one on the right (c).
+template<bool full_conn, bool withStats>
+static void labelColumns(uint *lab, uint *parent, const char *in,
+                         const dim_t d0, LabelStrip &strip)
 {
-    if (x->getParent() != x)
-        x->setParent(find(x->getParent()));
-    return x->getParent();
+    for (dim_t j = strip.begin; j < strip.end; j++) {
+        const char *src = in + j * d0;
+        uint *cur = lab + j * d0;
+        const uint *prev = (j > strip.begin) ? cur - d0 : NULL;
+
+        for (dim_t i = 0; i < d0; i++) {
+            if (!src[i]) {
+                cur[i] = 0;
+                continue;
+            }
+
+            const uint d = (i > 0) ? cur[i - 1] : 0;
+            uint l;
+            if (!prev) {
+                l = d ? d : strip.newLabel(parent);
+            } else if (full_conn) {
+                const uint a = (i > 0) ? prev[i - 1] : 0;
+                const uint b = prev[i];
+                const uint c = (i + 1 < d0) ? prev[i + 1] : 0;
+                if (b)      l = b;
+                else if (c) l = a ? merge(parent, c, a) : (d ? merge(parent, c, d) : c);
+                else if (a) l = a;
+                else if (d) l = d;
+                else        l = strip.newLabel(parent);
+            } else {
+                const uint b = prev[i];
+                if (b && d) l = merge(parent, b, d);
+                else if (b) l = b;
+                else if (d) l = d;
+                else        l = strip.newLabel(parent);
+            }
+            cur[i] = l;
+
+            if (withStats) {
+                if (l - strip.first >= strip.stats.size()) strip.stats.resize(strip.count);
+                strip.stats[l - strip.first].add(i, j, 0);
+            }
+        }
+    }
 }
 
-template<typename T>
-static void setUnion(LabelNode<T>* x, LabelNode<T>* y)
+// Offsets of the neighbours of a voxel that come before it in memory
+struct Neighbour { int di, dj, dk; };
+
+static vector<Neighbour> previousNeighbours(const af_connectivity connectivity)
 {
-    LabelNode<T>* xRoot = find(x);
-    LabelNode<T>* yRoot = find(y);
-    if (xRoot == yRoot)
-        return;
+    vector<Neighbour> nbrs;
+    for (int dk = -1; dk <= 0; dk++) {
+        for (int dj = -1; dj <= 1; dj++) {
+            for (int di = -1; di <= 1; di++) {
+                if (dk == 0 && (dj > 0 || (dj == 0 && di >= 0))) continue;
+                if (connectivity == AF_CONNECTIVITY_6 && std::abs(di) + std::abs(dj) + std::abs(dk) != 1) continue;
+                Neighbour n = {di, dj, dk};
+                nbrs.push_back(n);
+            }
+        }
+    }
+    return nbrs;
+}
 
-    T xMinLabel = xRoot->getMinLabel();
-    T yMinLabel = yRoot->getMinLabel();
-    xRoot->setMinLabel(min(xMinLabel, yMinLabel));
-    yRoot->setMinLabel(min(xMinLabel, yMinLabel));
-
-    if (xRoot->getRank() < yRoot->getRank())
-        xRoot->setParent(yRoot);
-    else if (xRoot->getRank() > yRoot->getRank())
-        yRoot->setParent(xRoot);
-    else {
-        yRoot->setParent(xRoot);
-        xRoot->setRank(xRoot->getRank() + 1);
+// Label of voxel (i, j, k) from its labelled neighbours, merging them. Slices
+// before kmin belong to another strip and are skipped.
+static inline uint neighbourLabel(const uint *lab, uint *parent, const vector<Neighbour> &nbrs,
+                                  const dim_t i, const dim_t j, const dim_t k, const dim_t kmin,
+                                  const dim_t d0, const dim_t d1)
+{
+    uint l = 0;
+    for (size_t n = 0; n < nbrs.size(); n++) {
+        const dim_t ni = i + nbrs[n].di;
+        const dim_t nj = j + nbrs[n].dj;
+        const dim_t nk = k + nbrs[n].dk;
+        if (ni < 0 || ni >= d0 || nj < 0 || nj >= d1 || nk < kmin) continue;
+
+        const uint m = lab[(nk * d1 + nj) * d0 + ni];
+        if (!m) continue;
+        l = l ? merge(parent, l, m) : m;
     }
+    return l;
 }
 
-template<typename T>
-Array<T> regions(const Array<char> &in, af_connectivity connectivity)
+// Labels the slices of a strip of a volume
+template<bool withStats>
+static void labelSlices(uint *lab, uint *parent, const char *in, const dim4 &dims,
+                        const vector<Neighbour> &nbrs, LabelStrip &strip)
 {
-    const dim4 in_dims = in.dims();
-
-    // Create output placeholder
-    Array<T> out = createValueArray(in_dims, (T)0);
-
-    const char *in_ptr  = in.get();
-          T    *out_ptr = out.get();
-
-    // Map labels
-    typedef typename std::map<T, LabelNode<T>* > label_map_t;
-    typedef typename label_map_t::iterator label_map_iterator_t;
-
-    label_map_t lmap;
-
-    // Initial label
-    T label = (T)1;
-
-    for (int j = 0; j < (int)in_dims[1]; j++) {
-        for (int i = 0; i < (int)in_dims[0]; i++) {
-            int idx = j * in_dims[0] + i;
-            if (in_ptr[idx] != 0) {
-                std::vector<T> l;
-
-                // Test neighbors
-                if (i > 0 && out_ptr[j * (int)in_dims[0] + i-1] > 0)
-                    l.push_back(out_ptr[j * in_dims[0] + i-1]);
-                if (j > 0 && out_ptr[(j-1) * (int)in_dims[0] + i] > 0)
-                    l.push_back(out_ptr[(j-1) * in_dims[0] + i]);
-                if (connectivity == AF_CONNECTIVITY_8 && i > 0 && j > 0 && out_ptr[(j-1) * in_dims[0] + i-1] > 0)
-                    l.push_back(out_ptr[(j-1) * in_dims[0] + i-1]);
-                if (connectivity == AF_CONNECTIVITY_8 && i < (int)in_dims[0] - 1 && j > 0 && out_ptr[(j-1) * in_dims[0] + i+1] != 0)
-                    l.push_back(out_ptr[(j-1) * in_dims[0] + i+1]);
-
-                if (!l.empty()) {
-                    T minl = l[0];
-                    for (size_t k = 0; k < l.size(); k++) {
-                        minl = min(l[k], minl);
-                        label_map_iterator_t cur_map = lmap.find(l[k]);
-                        LabelNode<T> *node = cur_map->second;
-                        // Group labels of the same region under a disjoint set
-                        for (size_t m = k+1; m < l.size(); m++)
-                            setUnion(node, lmap.find(l[m])->second);
-                    }
-                    // Set label to smallest neighbor label
-                    out_ptr[idx] = minl;
+    const dim_t d0 = dims[0];
+    const dim_t d1 = dims[1];
+
+    for (dim_t k = strip.begin; k < strip.end; k++) {
+        for (dim_t j = 0; j < d1; j++) {
+            const dim_t off = (k * d1 + j) * d0;
+            for (dim_t i = 0; i < d0; i++) {
+                if (!in[off + i]) {
+                    lab[off + i] = 0;
+                    continue;
                 }
-                else {
-                    // Insert new label in map
-                    LabelNode<T> *node = new LabelNode<T>(label);
-                    lmap.insert(std::pair<T, LabelNode<T>* >(label, node));
-                    out_ptr[idx] = label++;
+
+                uint l = neighbourLabel(lab, parent, nbrs, i, j, k, strip.begin, d0, d1);
+                if (!l) l = strip.newLabel(parent);
+                lab[off + i] = l;
+
+                if (withStats) {
+                    if (l - strip.first >= strip.stats.size()) strip.stats.resize(strip.count);
+                    strip.stats[l - strip.first].add(i, j, k);
                 }
             }
         }
     }
+}
 
-    std::set<T> removed;
+// Merges the regions of the first line of strip with the line before it
+static void mergeBorder(const uint *lab, uint *parent, const dim4 &dims, const af_connectivity connectivity,
+                        const vector<Neighbour> &nbrs, const LabelStrip &strip)
+{
+    const dim_t d0 = dims[0];
+    const dim_t d1 = dims[1];
+
+    if (connectivity == AF_CONNECTIVITY_4 || connectivity == AF_CONNECTIVITY_8) {
+        const bool full_conn = (connectivity == AF_CONNECTIVITY_8);
+        const uint *cur  = lab + strip.begin * d0;
+        const uint *prev = cur - d0;
+        for (dim_t i = 0; i < d0; i++) {
+            if (!cur[i]) continue;
+            if (prev[i]) merge(parent, cur[i], prev[i]);
+            if (full_conn && i > 0 && prev[i - 1]) merge(parent, cur[i], prev[i - 1]);
+            if (full_conn && i + 1 < d0 && prev[i + 1]) merge(parent, cur[i], prev[i + 1]);
+        }
+        return;
+    }
 
-    for (int j = 0; j < (int)in_dims[1]; j++) {
-        for (int i = 0; i < (int)in_dims[0]; i++) {
-            int idx = j * (int)in_dims[0] + i;
-            if (in_ptr[idx] != 0) {
-                T l = out_ptr[idx];
-                label_map_iterator_t cur_map = lmap.find(l);
+    const dim_t k = strip.begin;
+    for (dim_t j = 0; j < d1; j++) {
+        for (dim_t i = 0; i < d0; i++) {
+            const uint l = lab[(k * d1 + j) * d0 + i];
+            if (!l) continue;
+            for (size_t n = 0; n < nbrs.size(); n++) {
+                if (nbrs[n].dk == 0) continue;
+                const dim_t ni = i + nbrs[n].di;
+                const dim_t nj = j + nbrs[n].dj;
+                if (ni < 0 || ni >= d0 || nj < 0 || nj >= d1) continue;
+                const uint m = lab[((k - 1) * d1 + nj) * d0 + ni];
+                if (m) merge(parent, l, m);
+            }
+        }
+    }
+}
 
-                if (cur_map != lmap.end()) {
-                    LabelNode<T>* node = cur_map->second;
+// Connected component labelling with a flat union-find array.
+//
+// The lines of every image are split into strips that are labelled in
+// parallel. The strips are then stitched together by merging the regions
+// across their borders, and the labels are flattened into consecutive
+// numbers, in the order of the first pixel of each region. With 4 and 8
+// connectivity every 2D slice of in is labelled on its own, with 6 and 26
+// connectivity in is a single volume.
+template<typename T, bool withStats>
+static Array<T> labelRegions(const Array<char> &in, const af_connectivity connectivity,
+                             vector<vector<RegionStats> > &imageStats)
+{
+    const dim4 dims = in.dims();
+    const bool is3D = (connectivity == AF_CONNECTIVITY_6 || connectivity == AF_CONNECTIVITY_26);
+    const bool full_conn = (connectivity == AF_CONNECTIVITY_8);
+
+    // Provisional labels start at the index of a pixel plus one
+    const dim_t nElems = dims[0] * dims[1] * dims[2];
+    if (nElems >= (dim_t)std::numeric_limits<uint>::max()) {
+        AF_ERROR("Too many elements to label", AF_ERR_SIZE);
+    }
 
-                    LabelNode<T>* node_root = find(node);
-                    out_ptr[idx] = node_root->getMinLabel();
+    // The scans read the pixels in memory order. The input is evaluated in
+    // place first, so that its handle keeps the result.
+    in.eval();
+    const Array<char> input = in.isOwner() ? in : copyArray<char>(in);
+    const char *iptr = input.get();
+
+    const dim_t nimages   = is3D ? 1 : dims[2];
+    const dim_t nlines    = is3D ? dims[2] : dims[1];
+    const dim_t lineSize  = is3D ? dims[0] * dims[1] : dims[0];
+    const dim_t imageSize = nlines * lineSize;
+
+    // Enough strips to keep the threads busy, each worth a task of its own
+    const dim_t nthreads = getNumThreads();
+    const dim_t nstrips  = std::max<dim_t>(1, std::min(std::min(nlines, divup(nthreads, nimages)),
+                                                       imageSize / MIN_PARALLEL_ELEMENTS));
+    const dim_t stripLines = divup(nlines, nstrips);
+
+    vector<LabelStrip> strips;
+    vector<dim_t> firstStrip(nimages + 1);
+    for (dim_t img = 0; img < nimages; img++) {
+        firstStrip[img] = strips.size();
+        for (dim_t l = 0; l < nlines; l += stripLines) {
+            LabelStrip strip;
+            strip.image = img;
+            strip.begin = l;
+            strip.end   = std::min(nlines, l + stripLines);
+            strip.first = (uint)(img * imageSize + l * lineSize + 1);
+            strip.count = 0;
+            strips.push_back(strip);
+        }
+    }
+    firstStrip[nimages] = strips.size();
+
+    vector<uint> labels(nElems);
+    vector<uint> parents(nElems + 1);
+    uint *lab    = &labels.front();
+    uint *parent = &parents.front();
+    parent[0] = 0;
+
+    const vector<Neighbour> nbrs = is3D ? previousNeighbours(connectivity) : vector<Neighbour>();
+
+    parallel_for(strips.size(), [&](dim_t begin, dim_t end) {
+            for (dim_t s = begin; s < end; s++) {
+                LabelStrip &strip = strips[s];
+                const dim_t off = strip.image * imageSize;
+                if (is3D)
+                    labelSlices<withStats>(lab + off, parent, iptr + off, dims, nbrs, strip);
+                else if (full_conn)
+                    labelColumns<true , withStats>(lab + off, parent, iptr + off, dims[0], strip);
+                else
+                    labelColumns<false, withStats>(lab + off, parent, iptr + off, dims[0], strip);
+            }
+        });
+
+    // Images never share labels, so they are stitched and flattened in
+    // parallel. Flattening in increasing order finds the final label of the
+    // parent of every label already set.
+    imageStats.resize(withStats ? nimages : 0);
+    parallel_for(nimages, [&](dim_t begin, dim_t end) {
+            for (dim_t img = begin; img < end; img++) {
+                for (dim_t s = firstStrip[img] + 1; s < firstStrip[img + 1]; s++) {
+                    const dim_t off = img * imageSize;
+                    mergeBorder(lab + off, parent, dims, connectivity, nbrs, strips[s]);
+                }
 
-                    // Mark removed labels (those that are part of a region
-                    // that contains a smaller label)
-                    if (node->getMinLabel() < l || node_root->getMinLabel() < l)
-                        removed.insert(l);
-                    if (node->getLabel() > node->getMinLabel())
-                        removed.insert(node->getLabel());
+                uint n = 0;
+                for (dim_t s = firstStrip[img]; s < firstStrip[img + 1]; s++) {
+                    const LabelStrip &strip = strips[s];
+                    for (uint l = strip.first; l < strip.first + strip.count; l++) {
+                        if (parent[l] < l) {
+                            parent[l] = parent[parent[l]];
+                        } else {
+                            parent[l] = ++n;
+                            if (withStats) imageStats[img].push_back(RegionStats());
+                        }
+                        if (withStats) imageStats[img][parent[l] - 1].add(strip.stats[l - strip.first]);
+                    }
                 }
             }
-        }
+        }, 1);
+
+    Array<T> out = createEmptyArray<T>(dims);
+    T *optr = out.get();
+    parallel_for(nElems, [&](dim_t begin, dim_t end) {
+            for (dim_t i = begin; i < end; i++) optr[i] = (T)parent[lab[i]];
+        }, MIN_PARALLEL_ELEMENTS);
+
+    return out;
+}
+
+template<typename T>
+Array<T> regions(const Array<char> &in, af_connectivity connectivity)
+{
+    vector<vector<RegionStats> > stats;
+    return labelRegions<T, false>(in, connectivity, stats);
+}
+
+template<typename T>
+Array<T> regions(Array<uint> &area, Array<uint> &bbox, Array<float> &centroid,
+                 const Array<char> &in, af_connectivity connectivity)
+{
+    vector<vector<RegionStats> > stats;
+    Array<T> out = labelRegions<T, true>(in, connectivity, stats);
+
+    // One row per label and one batch per labelled image. Images with fewer
+    // regions than the others are padded with zeros.
+    const int nd = (connectivity == AF_CONNECTIVITY_6 || connectivity == AF_CONNECTIVITY_26) ? 3 : 2;
+    const dim_t nimages = stats.size();
+    dim_t nlabels = 0;
+    for (dim_t img = 0; img < nimages; img++) {
+        nlabels = std::max<dim_t>(nlabels, stats[img].size());
     }
 
-    // Calculate final neighbors (ensure final labels are sequential)
-    for (int j = 0; j < (int)in_dims[1]; j++) {
-        for (int i = 0; i < (int)in_dims[0]; i++) {
-            int idx = j * (int)in_dims[0] + i;
-            if (out_ptr[idx] > 0) {
-                out_ptr[idx] -= distance(removed.begin(), removed.lower_bound(out_ptr[idx]));
+    area     = createValueArray<uint >(dim4(nlabels, 1     , nimages), 0);
+    bbox     = createValueArray<uint >(dim4(nlabels, 2 * nd, nimages), 0);
+    centroid = createValueArray<float>(dim4(nlabels, nd    , nimages), 0);
+
+    uint  *aptr = area.get();
+    uint  *bptr = bbox.get();
+    float *cptr = centroid.get();
+    for (dim_t img = 0; img < nimages; img++) {
+        for (dim_t l = 0; l < (dim_t)stats[img].size(); l++) {
+            const RegionStats &s = stats[img][l];
+            aptr[img * nlabels + l] = s.area;
+            for (int d = 0; d < nd; d++) {
+                bptr[(img * 2 * nd + d     ) * nlabels + l] = s.lo[d];
+                bptr[(img * 2 * nd + d + nd) * nlabels + l] = s.hi[d];
+                cptr[(img * nd + d) * nlabels + l] = (float)(s.sum[d] / s.area);
             }
         }
     }
@@ -202,7 +425,10 @@ Array<T> regions(const Array<char> &in, af_connectivity connectivity)
 }
 
 #define INSTANTIATE(T)\
-    template Array<T> regions<T>(const Array<char> &in, af_connectivity connectivity);
+    template Array<T> regions<T>(const Array<char> &in, af_connectivity connectivity);  \
+    template Array<T> regions<T>(Array<uint> &area, Array<uint> &bbox,                  \
+                                 Array<float> &centroid, const Array<char> &in,         \
+                                 af_connectivity connectivity);
 
 INSTANTIATE(float )
 INSTANTIATE(double)
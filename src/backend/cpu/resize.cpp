@@ -14,6 +14,7 @@
 #include <math.hpp>
 #include <types.hpp>
 #include <af/traits.hpp>
+#include <parallel.hpp>
 
 namespace cpu
 {
@@ -134,11 +135,14 @@ namespace cpu
                  const af::dim4 &ostrides, const af::dim4 &istrides)
     {
         resize_op<T, method> op;
-        for(dim_t y = 0; y < odims[1]; y++) {
-            for(dim_t x = 0; x < odims[0]; x++) {
-                op(outPtr, inPtr, odims, idims, ostrides, istrides, x, y);
+        const dim_t batch = odims[2] * odims[3];
+        parallel_for(odims[1], [&](dim_t begin, dim_t end) {
+            for(dim_t y = begin; y < end; y++) {
+                for(dim_t x = 0; x < odims[0]; x++) {
+                    op(outPtr, inPtr, odims, idims, ostrides, istrides, x, y);
+                }
             }
-        }
+        }, MIN_PARALLEL_ELEMENTS / (odims[0] * batch));
     }
 
     template<typename T>
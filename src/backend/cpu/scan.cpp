@@ -12,100 +12,214 @@
 #include <af/defines.h>
 #include <ArrayInfo.hpp>
 #include <Array.hpp>
+#include <copy.hpp>
+#include <dispatch.hpp>
+#include <parallel.hpp>
+#include <platform.hpp>
 #include <scan.hpp>
 #include <ops.hpp>
+#include <algorithm>
+#include <vector>
 
 using af::dim4;
+using std::vector;
 
 namespace cpu
 {
-    template<af_op_t op, typename Ti, typename To, int D>
-    struct scan_dim
+    // Elements of dimension 0 swept together when scanning along the other
+    // dimensions. Every row of the block is combined with the row before it.
+    static const dim_t SCAN_ROW_BLOCK = 1024;
+
+    // Scans are only split along the scanned dimension when every part has
+    // at least this many elements
+    static const dim_t SCAN_MIN_CHUNK_ELEMENTS = 1 << 16;
+
+    // Scans nrows rows of len elements, stride elements apart. The first
+    // row is combined with init, or with the identity of op when init is
+    // NULL. Exclusive scans shift the result down by one row.
+    template<af_op_t op, typename Ti, typename To, bool inclusive>
+    static void scanRows(To *out, const Ti *in, const dim_t stride,
+                         const dim_t nrows, const dim_t len, const To *init)
     {
-        void operator()(To *out, const dim4 ostrides, const dim4 odims,
-                        const Ti *in , const dim4 istrides, const dim4 idims,
-                        const int dim)
-        {
-            const int D1 = D - 1;
-            for (dim_t i = 0; i < odims[D1]; i++) {
-                scan_dim<op, Ti, To, D1>()(out + i * ostrides[D1],
-                                           ostrides, odims,
-                                           in  + i * istrides[D1],
-                                           istrides, idims,
-                                           dim);
-                if (D1 == dim) break;
+        Transform<Ti, To, op> transform;
+        Binary<To, op> scan;
+
+        // A single vector keeps its running value in a register
+        if (len == 1) {
+            To acc = init ? *init : scan.init();
+            for (dim_t k = 0; k < nrows; k++) {
+                To val = transform(in[k * stride]);
+                if (!inclusive) out[k * stride] = acc;
+                acc = scan(val, acc);
+                if (inclusive) out[k * stride] = acc;
             }
+            return;
         }
-    };
 
+        for (dim_t i = 0; i < len; i++) {
+            To first = init ? init[i] : scan.init();
+            out[i] = inclusive ? scan(transform(in[i]), first) : first;
+        }
+
+        for (dim_t k = 1; k < nrows; k++) {
+            const Ti *src  = in  + (inclusive ? k : k - 1) * stride;
+            const To *prev = out + (k - 1) * stride;
+            To *dst = out + k * stride;
+            for (dim_t i = 0; i < len; i++) {
+                dst[i] = scan(transform(src[i]), prev[i]);
+            }
+        }
+    }
+
+    // Combines nrows rows of len elements, stride elements apart, into total
     template<af_op_t op, typename Ti, typename To>
-    struct scan_dim<op, Ti, To, 0>
+    static void reduceRows(To *total, const Ti *in, const dim_t stride,
+                           const dim_t nrows, const dim_t len)
     {
-        void operator()(To *out, const dim4 ostrides, const dim4 odims,
-                        const Ti *in , const dim4 istrides, const dim4 idims,
-                        const int dim)
-        {
-
-            dim_t istride = istrides[dim];
-            dim_t ostride = ostrides[dim];
-
-            Transform<Ti, To, op> transform;
-            // FIXME: Change the name to something better
-            Binary<To, op> scan;
-
-            To out_val = scan.init();
-            for (dim_t i = 0; i < idims[dim]; i++) {
-                To in_val = transform(in[i * istride]);
-                out_val = scan(in_val, out_val);
-                out[i * ostride] = out_val;
+        Transform<Ti, To, op> transform;
+        Binary<To, op> scan;
+
+        for (dim_t i = 0; i < len; i++) total[i] = scan.init();
+        for (dim_t k = 0; k < nrows; k++) {
+            const Ti *src = in + k * stride;
+            for (dim_t i = 0; i < len; i++) {
+                total[i] = scan(transform(src[i]), total[i]);
             }
         }
-    };
+    }
 
-    template<af_op_t op, typename Ti, typename To>
-    Array<To> scan(const Array<Ti>& in, const int dim)
+    // The input is viewed as outer blocks of n rows, each row holding the
+    // inner elements of the dimensions before dim. Blocks of up to
+    // SCAN_ROW_BLOCK columns are scanned independently, so scans along
+    // dimensions 1 to 3 read whole rows instead of strided columns.
+    //
+    // When there are fewer blocks than threads, the rows are also split into
+    // chunks. The totals of every chunk are computed in parallel first, then
+    // scanned to give the starting values of the chunks, which are finally
+    // scanned in parallel.
+    template<af_op_t op, typename Ti, typename To, bool inclusive>
+    static void scanBlocked(To *out, const Ti *in, const dim4 &dims, const int dim)
     {
-        dim4 dims = in.dims();
+        dim_t inner = 1, outer = 1;
+        for (int i = 0; i < dim; i++) inner *= dims[i];
+        for (int i = dim + 1; i < 4; i++) outer *= dims[i];
+        const dim_t n = dims[dim];
+
+        const dim_t block   = std::min(inner, SCAN_ROW_BLOCK);
+        const dim_t nblocks = divup(inner, block);
+        const dim_t nunits  = outer * nblocks;
+
+        const dim_t nthreads = getNumThreads();
+        const dim_t nchunks  = nunits >= nthreads ? 1 :
+            std::max<dim_t>(1, std::min(divup(nthreads, nunits), n * block / SCAN_MIN_CHUNK_ELEMENTS));
+        const dim_t chunk    = divup(n, nchunks);
+
+        // Column range and offset of the first element of a unit
+        auto unitOffset = [&](dim_t u, dim_t &len) {
+            const dim_t o  = u / nblocks;
+            const dim_t i0 = (u % nblocks) * block;
+            len = std::min(block, inner - i0);
+            return o * n * inner + i0;
+        };
+
+        const dim_t grain = std::max<dim_t>(1, MIN_PARALLEL_ELEMENTS / (chunk * block));
+
+        if (nchunks == 1) {
+            parallel_for(nunits, [&](dim_t begin, dim_t end) {
+                    for (dim_t u = begin; u < end; u++) {
+                        dim_t len;
+                        const dim_t off = unitOffset(u, len);
+                        scanRows<op, Ti, To, inclusive>(out + off, in + off, inner, n, len, NULL);
+                    }
+                }, grain);
+            return;
+        }
 
-        Array<To> out = createValueArray<To>(dims, 0);
+        vector<To> starts(nunits * nchunks * block);
+
+        parallel_for(nunits * nchunks, [&](dim_t begin, dim_t end) {
+                for (dim_t t = begin; t < end; t++) {
+                    const dim_t u = t / nchunks;
+                    const dim_t c = t % nchunks;
+                    const dim_t k0 = c * chunk;
+                    if (c == nchunks - 1 || k0 >= n) continue;
+
+                    dim_t len;
+                    const dim_t off = unitOffset(u, len) + k0 * inner;
+                    reduceRows<op, Ti, To>(&starts[(t + 1) * block], in + off, inner,
+                                           std::min(chunk, n - k0), len);
+                }
+            }, grain);
+
+        // Chunk c starts from the totals of chunks 0 to c-1
+        Binary<To, op> scan;
+        for (dim_t u = 0; u < nunits; u++) {
+            To *s = &starts[u * nchunks * block];
+            for (dim_t i = 0; i < block; i++) s[i] = scan.init();
+            for (dim_t c = 1; c < nchunks; c++) {
+                for (dim_t i = 0; i < block; i++) {
+                    s[c * block + i] = scan(s[c * block + i], s[(c - 1) * block + i]);
+                }
+            }
+        }
 
-        switch (in.ndims()) {
-        case 1:
-            scan_dim<op, Ti, To, 1>()(out.get(), out.strides(), out.dims(),
-                                      in.get(), in.strides(), in.dims(), dim);
-            break;
+        parallel_for(nunits * nchunks, [&](dim_t begin, dim_t end) {
+                for (dim_t t = begin; t < end; t++) {
+                    const dim_t u = t / nchunks;
+                    const dim_t c = t % nchunks;
+                    const dim_t k0 = c * chunk;
+                    if (k0 >= n) continue;
+
+                    dim_t len;
+                    const dim_t off = unitOffset(u, len) + k0 * inner;
+                    scanRows<op, Ti, To, inclusive>(out + off, in + off, inner,
+                                                    std::min(chunk, n - k0), len,
+                                                    &starts[t * block]);
+                }
+            }, grain);
+    }
 
-        case 2:
-            scan_dim<op, Ti, To, 2>()(out.get(), out.strides(), out.dims(),
-                                      in.get(), in.strides(), in.dims(), dim);
-            break;
+    template<af_op_t op, typename Ti, typename To>
+    Array<To> scan(const Array<Ti>& in, const int dim, bool inclusive_scan)
+    {
+        dim4 dims = in.dims();
 
-        case 3:
-            scan_dim<op, Ti, To, 3>()(out.get(), out.strides(), out.dims(),
-                                      in.get(), in.strides(), in.dims(), dim);
-            break;
+        Array<To> out = createEmptyArray<To>(dims);
 
-        case 4:
-            scan_dim<op, Ti, To, 4>()(out.get(), out.strides(), out.dims(),
-                                      in.get(), in.strides(), in.dims(), dim);
-            break;
-        }
+        // Rows are read as contiguous runs of elements. The input is
+        // evaluated in place first, so that its handle keeps the result.
+        in.eval();
+        const Array<Ti> input = in.isOwner() ? in : copyArray<Ti>(in);
+
+        if (inclusive_scan)
+            scanBlocked<op, Ti, To, true >(out.get(), input.get(), dims, dim);
+        else
+            scanBlocked<op, Ti, To, false>(out.get(), input.get(), dims, dim);
 
         return out;
     }
 
 #define INSTANTIATE(ROp, Ti, To)                                        \
-    template Array<To> scan<ROp, Ti, To>(const Array<Ti> &in, const int dim); \
+    template Array<To> scan<ROp, Ti, To>(const Array<Ti> &in, const int dim, bool inclusive_scan); \
+
+#define INSTANTIATE_SCAN_OP(ROp)                \
+    INSTANTIATE(ROp, float  , float  )          \
+    INSTANTIATE(ROp, double , double )          \
+    INSTANTIATE(ROp, cfloat , cfloat )          \
+    INSTANTIATE(ROp, cdouble, cdouble)          \
+    INSTANTIATE(ROp, int    , int    )          \
+    INSTANTIATE(ROp, uint   , uint   )          \
+    INSTANTIATE(ROp, uchar  , uint   )
 
     //accum
-    INSTANTIATE(af_add_t, float  , float  )
-    INSTANTIATE(af_add_t, double , double )
-    INSTANTIATE(af_add_t, cfloat , cfloat )
-    INSTANTIATE(af_add_t, cdouble, cdouble)
-    INSTANTIATE(af_add_t, int    , int    )
-    INSTANTIATE(af_add_t, uint   , uint   )
+    INSTANTIATE_SCAN_OP(af_add_t)
     INSTANTIATE(af_add_t, char   , int    )
-    INSTANTIATE(af_add_t, uchar  , uint   )
     INSTANTIATE(af_notzero_t, char  , uint   )
 
+    INSTANTIATE_SCAN_OP(af_mul_t)
+    INSTANTIATE_SCAN_OP(af_min_t)
+    INSTANTIATE_SCAN_OP(af_max_t)
+    INSTANTIATE(af_mul_t, char  , uint   )
+    INSTANTIATE(af_min_t, char  , uint   )
+    INSTANTIATE(af_max_t, char  , uint   )
 }
@@ -18,16 +18,211 @@
 #include <sort.hpp>
 #include <err_cpu.hpp>
 #include <vector>
+#include <cstring>
+#include <limits>
 
 namespace cpu
 {
     using namespace std;
     using af::dim4;
 
+    // Inputs smaller than this are always sorted
+    static const dim_t SET_HASH_MIN_ELEMENTS = 1 << 12;
+
+    // The hash tables are abandoned for sorting when more than this fraction
+    // of the values are distinct, as the distinct values are sorted anyway
+    static const double SET_HASH_MAX_UNIQUE_FRACTION = 0.25;
+
+    // The number of distinct values is estimated from the first
+    // 1 / SET_HASH_PROBE_DIVISOR of the values. Inputs with mostly distinct
+    // values are sorted when more than SET_HASH_MAX_PROBE_UNIQUE_FRACTION of
+    // those are distinct.
+    static const dim_t  SET_HASH_PROBE_DIVISOR = 16;
+    static const double SET_HASH_MAX_PROBE_UNIQUE_FRACTION = 0.9;
+
+    // Keys are equal by value, with all the NaNs the same key
+    template<typename T>
+    static inline bool sameKey(const T &a, const T &b)
+    {
+        return a == b || (a != a && b != b);
+    }
+
+    // Ascending order with the NaNs last, which keeps the ordering strict weak
+    template<typename T>
+    static inline bool keyLess(const T &a, const T &b)
+    {
+        return a < b || (b != b && a == a);
+    }
+
+    // Open addressing hash table mapping the distinct values to their position
+    // in the order of insertion. Floating point values are compared by value,
+    // so 0 and -0 are the same key, and all the NaNs are one key.
+    template<typename T>
+    class SetHash
+    {
+        vector<T> keys;
+        vector<uint> pos;   // position + 1 of the key, 0 for empty slots
+        int bits;
+        dim_t count;
+
+        size_t slot(const T &key) const
+        {
+            const T val = key != key ? std::numeric_limits<T>::quiet_NaN() : key + T(0);
+            unsigned long long h = 0;
+            memcpy(&h, &val, sizeof(T));
+            h *= 0x9E3779B97F4A7C15ULL;
+            return (size_t)(h >> (64 - bits));
+        }
+
+        void grow()
+        {
+            vector<T> oldKeys;
+            vector<uint> oldPos;
+            oldKeys.swap(keys);
+            oldPos.swap(pos);
+
+            bits++;
+            keys.resize((size_t)1 << bits);
+            pos.assign((size_t)1 << bits, 0);
+
+            const size_t mask = keys.size() - 1;
+            for (size_t i = 0; i < oldPos.size(); i++) {
+                if (!oldPos[i]) continue;
+                size_t s = slot(oldKeys[i]);
+                while (pos[s]) s = (s + 1) & mask;
+                keys[s] = oldKeys[i];
+                pos[s]  = oldPos[i];
+            }
+        }
+
+    public:
+        SetHash(const dim_t capacity) : bits(4), count(0)
+        {
+            while (((dim_t)1 << bits) < 2 * capacity) bits++;
+            keys.resize((size_t)1 << bits);
+            pos.assign((size_t)1 << bits, 0);
+        }
+
+        dim_t size() const { return count; }
+
+        // Position of key, which is added with position size() when missing
+        dim_t insert(const T &key)
+        {
+            if (2 * (count + 1) > (dim_t)keys.size()) grow();
+
+            const size_t mask = keys.size() - 1;
+            size_t s = slot(key);
+            while (pos[s]) {
+                if (sameKey(keys[s], key)) return pos[s] - 1;
+                s = (s + 1) & mask;
+            }
+            keys[s] = key;
+            pos[s]  = (uint)(++count);
+            return count - 1;
+        }
+
+        // Position of key, or -1 when it is missing
+        dim_t find(const T &key) const
+        {
+            const size_t mask = keys.size() - 1;
+            size_t s = slot(key);
+            while (pos[s]) {
+                if (sameKey(keys[s], key)) return pos[s] - 1;
+                s = (s + 1) & mask;
+            }
+            return -1;
+        }
+    };
+
+    // Adds the values of ptr[0, n) to table, appending the new ones to vals and
+    // the index of their first occurrence, plus offset, to idx. Stops and
+    // returns false when the table grows beyond maxUnique values.
+    template<typename T>
+    static bool hashInsert(SetHash<T> &table, vector<T> &vals, vector<uint> &idx,
+                           const T *ptr, const dim_t n, const dim_t offset,
+                           const dim_t maxUnique)
+    {
+        for (dim_t i = 0; i < n; i++) {
+            const dim_t count = table.size();
+            if (table.insert(ptr[i]) == count) {
+                if (count >= maxUnique) return false;
+                vals.push_back(ptr[i]);
+                idx.push_back((uint)(i + offset));
+            }
+        }
+        return true;
+    }
+
+    // Reorders vals and idx in ascending order of the values
+    template<typename T>
+    static void sortByValue(vector<T> &vals, vector<uint> &idx)
+    {
+        vector<dim_t> order(vals.size());
+        for (size_t i = 0; i < order.size(); i++) order[i] = i;
+        std::sort(order.begin(), order.end(),
+                  [&](dim_t a, dim_t b) { return keyLess(vals[a], vals[b]); });
+
+        vector<T> sVals(vals.size());
+        vector<uint> sIdx(idx.size());
+        for (size_t i = 0; i < order.size(); i++) {
+            sVals[i] = vals[order[i]];
+            sIdx[i]  = idx[order[i]];
+        }
+        vals.swap(sVals);
+        idx.swap(sIdx);
+    }
+
+    template<typename T>
+    static Array<T> createVectorArray(const vector<T> &vals)
+    {
+        if (vals.empty()) return createEmptyArray<T>(dim4(0));
+        return createHostDataArray<T>(dim4(vals.size()), &vals.front());
+    }
+
+    // Contiguous copy of in, when it is not one already
+    template<typename T>
+    static Array<T> linear(const Array<T> &in)
+    {
+        in.eval();
+        return in.isOwner() ? in : copyArray<T>(in);
+    }
+
+    // Sorted distinct values of first and second, found with a hash table.
+    // Returns false when there are too many of them for hashing to pay off.
+    template<typename T>
+    static bool hashUnique(vector<T> &vals, const Array<T> &first, const Array<T> *second)
+    {
+        const dim_t n = first.elements() + (second ? second->elements() : 0);
+        if (n < SET_HASH_MIN_ELEMENTS) return false;
+
+        const dim_t maxUnique = (dim_t)(SET_HASH_MAX_UNIQUE_FRACTION * n);
+        SetHash<T> table(std::min<dim_t>(maxUnique, 1 << 16));
+        vector<uint> idx;
+
+        const Array<T> a = linear(first);
+        const dim_t probe = std::min<dim_t>(a.elements(), n / SET_HASH_PROBE_DIVISOR);
+        if (!hashInsert(table, vals, idx, a.get(), probe, 0, maxUnique)) return false;
+        if (table.size() > SET_HASH_MAX_PROBE_UNIQUE_FRACTION * probe) return false;
+
+        if (!hashInsert(table, vals, idx, a.get() + probe, a.elements() - probe, probe, maxUnique)) return false;
+        if (second) {
+            const Array<T> b = linear(*second);
+            if (!hashInsert(table, vals, idx, b.get(), b.elements(), 0, maxUnique)) return false;
+        }
+
+        std::sort(vals.begin(), vals.end(), keyLess<T>);
+        return true;
+    }
+
     template<typename T>
     Array<T> setUnique(const Array<T> &in,
                         const bool is_sorted)
     {
+        vector<T> vals;
+        if (!is_sorted && hashUnique<T>(vals, in, NULL)) {
+            return createVectorArray(vals);
+        }
+
         Array<T> out = createEmptyArray<T>(af::dim4());
         if (is_sorted) out = copyArray<T>(in);
         else           out = sort<T, 1>(in, 0);
@@ -46,15 +241,18 @@ namespace cpu
                        const Array<T> &second,
                        const bool is_unique)
     {
+        vector<T> vals;
+        if (!is_unique && hashUnique<T>(vals, first, &second)) {
+            return createVectorArray(vals);
+        }
+
         Array<T> uFirst = first;
         Array<T> uSecond = second;
 
         if (!is_unique) {
-            // FIXME: Perhaps copy + unique would do ?
             uFirst  = setUnique(first, false);
             uSecond = setUnique(second, false);
         }
-
         dim_t first_elements  = uFirst.elements();
         dim_t second_elements = uSecond.elements();
         dim_t elements = first_elements + second_elements;
@@ -104,10 +302,107 @@ namespace cpu
         return out;
     }
 
+    template<typename T>
+    Array<T> setUnique(Array<uint> &idx, const Array<T> &in, const bool in_order)
+    {
+        const Array<T> input = linear(in);
+        const dim_t n = input.elements();
+
+        SetHash<T> table(std::min<dim_t>(n, 1 << 16));
+        vector<T> vals;
+        vector<uint> first;
+        hashInsert(table, vals, first, input.get(), n, 0, n);
+
+        if (!in_order) sortByValue(vals, first);
+
+        idx = createVectorArray(first);
+        return createVectorArray(vals);
+    }
+
+    template<typename T>
+    Array<T> setUnion(Array<uint> &idx, const Array<T> &first, const Array<T> &second,
+                      const bool in_order)
+    {
+        const Array<T> a = linear(first);
+        const Array<T> b = linear(second);
+        const dim_t n = a.elements() + b.elements();
+
+        SetHash<T> table(std::min<dim_t>(n, 1 << 16));
+        vector<T> vals;
+        vector<uint> pos;
+        hashInsert(table, vals, pos, a.get(), a.elements(), 0, n);
+        hashInsert(table, vals, pos, b.get(), b.elements(), a.elements(), n);
+
+        if (!in_order) sortByValue(vals, pos);
+
+        idx = createVectorArray(pos);
+        return createVectorArray(vals);
+    }
+
+    template<typename T>
+    Array<T> setIntersect(Array<uint> &first_idx, Array<uint> &second_idx,
+                          const Array<T> &first, const Array<T> &second,
+                          const bool in_order)
+    {
+        const Array<T> a = linear(first);
+        const Array<T> b = linear(second);
+
+        SetHash<T> table(std::min<dim_t>(a.elements(), 1 << 16));
+        vector<T> vals;
+        vector<uint> pos;
+        hashInsert(table, vals, pos, a.get(), a.elements(), 0, a.elements());
+
+        // First occurrence in second of every distinct value of first
+        const uint missing = ~0u;
+        vector<uint> match(vals.size(), missing);
+        const T *bptr = b.get();
+        const dim_t nb = b.elements();
+        for (dim_t i = 0; i < nb; i++) {
+            const dim_t k = table.find(bptr[i]);
+            if (k >= 0 && match[k] == missing) match[k] = (uint)i;
+        }
+
+        vector<T> common;
+        vector<uint> fIdx, sIdx;
+        for (size_t k = 0; k < vals.size(); k++) {
+            if (match[k] == missing) continue;
+            common.push_back(vals[k]);
+            fIdx.push_back(pos[k]);
+            sIdx.push_back(match[k]);
+        }
+
+        if (!in_order) {
+            // Both index arrays follow the order of the values
+            vector<uint> order(common.size());
+            for (size_t i = 0; i < order.size(); i++) order[i] = i;
+            vector<T> keys = common;
+            sortByValue(keys, order);
+
+            vector<uint> f(order.size()), s(order.size());
+            for (size_t i = 0; i < order.size(); i++) {
+                f[i] = fIdx[order[i]];
+                s[i] = sIdx[order[i]];
+            }
+            common.swap(keys);
+            fIdx.swap(f);
+            sIdx.swap(s);
+        }
+
+        first_idx  = createVectorArray(fIdx);
+        second_idx = createVectorArray(sIdx);
+        return createVectorArray(common);
+    }
+
 #define INSTANTIATE(T)                                                  \
     template Array<T> setUnique<T>(const Array<T> &in, const bool is_sorted); \
     template Array<T> setUnion<T>(const Array<T> &first, const Array<T> &second, const bool is_unique); \
     template Array<T> setIntersect<T>(const Array<T> &first, const Array<T> &second, const bool is_unique); \
+    template Array<T> setUnique<T>(Array<uint> &idx, const Array<T> &in, const bool in_order); \
+    template Array<T> setUnion<T>(Array<uint> &idx, const Array<T> &first, const Array<T> &second, \
+                                  const bool in_order);                 \
+    template Array<T> setIntersect<T>(Array<uint> &first_idx, Array<uint> &second_idx, \
+                                      const Array<T> &first, const Array<T> &second, \
+                                      const bool in_order);             \
 
     INSTANTIATE(float)
     INSTANTIATE(double)
@@ -20,6 +20,8 @@
 #include <err_cpu.hpp>
 
 #include <lapack_helper.hpp>
+#include <lapack_batched.hpp>
+#include <vector>
 
 namespace cpu
 {
@@ -108,13 +110,22 @@ Array<T> triangleSolve(const Array<T> &A, const Array<T> &b, const af_mat_prop o
     int N = B.dims()[0];
     int NRHS = B.dims()[1];
 
-    trtrs_func<T>()(AF_LAPACK_COL_MAJOR,
-                    options & AF_MAT_UPPER ? 'U' : 'L',
-                    'N', // transpose flag
-                    options & AF_MAT_DIAG_UNIT ? 'U' : 'N',
-                    N, NRHS,
-                    A.get(), A.strides()[1],
-                    B.get(), B.strides()[1]);
+    dim4 aDims = A.dims();
+    dim4 aStrides = A.strides();
+    dim4 bStrides = B.strides();
+    const T *aptr = A.get();
+    T *bptr = B.get();
+
+    parallel_for_matrices(aDims, [&](dim_t i) {
+            trtrs_func<T>()(AF_LAPACK_COL_MAJOR,
+                            options & AF_MAT_UPPER ? 'U' : 'L',
+                            'N', // transpose flag
+                            options & AF_MAT_DIAG_UNIT ? 'U' : 'N',
+                            N, NRHS,
+                            aptr + matrixOffset(i, aDims, aStrides), aStrides[1],
+                            bptr + matrixOffset(i, aDims, bStrides), bStrides[1]);
+        }, lapackBatchGrain(N));
+
     return B;
 }
 
@@ -128,32 +139,76 @@ Array<T> solve(const Array<T> &a, const Array<T> &b, const af_mat_prop options)
         return triangleSolve<T>(a, b, options);
     }
 
-    int M = a.dims()[0];
-    int N = a.dims()[1];
+    dim4 aDims = a.dims();
+    int M = aDims[0];
+    int N = aDims[1];
     int K = b.dims()[1];
 
-
-    Array<T> A = copyArray<T>(a);
-    Array<T> B = padArray<T, T>(b, dim4(max(M, N), K));
-
-    if(M == N) {
-        Array<int> pivot = createEmptyArray<int>(dim4(N, 1, 1));
-        gesv_func<T>()(AF_LAPACK_COL_MAJOR, N, K,
-                       A.get(), A.strides()[1],
-                       pivot.get(),
-                       B.get(), B.strides()[1]);
-    } else {
-        int sM = a.strides()[1];
-        int sN = a.strides()[2] / sM;
-
-        gels_func<T>()(AF_LAPACK_COL_MAJOR, 'N',
-                       M, N, K,
-                       A.get(), A.strides()[1],
-                       B.get(), max(sM, sN));
-        B.resetDims(dim4(N, K));
+    // Single matrices are solved by LAPACK and return its result, as on the
+    // other backends. Stacks use the small kernels and report singular
+    // matrices with NaN.
+    const bool isBatch = aDims[2] * aDims[3] > 1;
+    solve_small_func<T> small = M == N && isBatch ? solveSmallFunc<T>(N) : NULL;
+
+    if (small) {
+        Array<T> B = copyArray<T>(b);
+        dim4 aStrides = a.strides();
+        dim4 bStrides = B.strides();
+        const T *aptr = a.get();
+        T *bptr = B.get();
+
+        parallel_for_matrices(aDims, [&](dim_t i) {
+                small(aptr + matrixOffset(i, aDims, aStrides), aStrides[1],
+                      bptr + matrixOffset(i, aDims, bStrides), bStrides[1], K);
+            }, lapackBatchGrain(N));
+
+        return B;
     }
 
-    return B;
+    Array<T> A = copyArray<T>(a);
+    Array<T> B = padArray<T, T>(b, dim4(max(M, N), K, aDims[2], aDims[3]));
+
+    dim4 aStrides = A.strides();
+    dim4 bStrides = B.strides();
+    T *aptr = A.get();
+    T *bptr = B.get();
+
+    parallel_for_matrices(aDims, [&](dim_t i) {
+            T *amat = aptr + matrixOffset(i, aDims, aStrides);
+            T *bmat = bptr + matrixOffset(i, aDims, bStrides);
+
+            if(M == N) {
+                std::vector<int> pivot(N);
+                int info = gesv_func<T>()(AF_LAPACK_COL_MAJOR, N, K,
+                                          amat, aStrides[1],
+                                          pivot.data(),
+                                          bmat, bStrides[1]);
+                if (info > 0 && isBatch) fillSingular(bmat, bStrides[1], N, K);
+            } else {
+                gels_func<T>()(AF_LAPACK_COL_MAJOR, 'N',
+                               M, N, K,
+                               amat, aStrides[1],
+                               bmat, bStrides[1]);
+            }
+        }, lapackBatchGrain(max(M, N)));
+
+    if (M <= N) return B;
+
+    // Only the first N rows of B hold the solution
+    Array<T> X = createEmptyArray<T>(dim4(N, K, aDims[2], aDims[3]));
+    dim4 xStrides = X.strides();
+    T *xptr = X.get();
+
+    parallel_for_matrices(aDims, [&](dim_t i) {
+            const T *bmat = bptr + matrixOffset(i, aDims, bStrides);
+            T *xmat = xptr + matrixOffset(i, aDims, xStrides);
+            for (int k = 0; k < K; k++) {
+                std::copy(bmat + k * bStrides[1], bmat + k * bStrides[1] + N,
+                          xmat + k * xStrides[1]);
+            }
+        }, lapackBatchGrain(M));
+
+    return X;
 }
 
 #define INSTANTIATE_SOLVE(T)                                            \
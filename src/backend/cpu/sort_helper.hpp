@@ -0,0 +1,229 @@
+/*******************************************************
+ * Copyright (c) 2015, ArrayFire
+ * All rights reserved.
+ *
+ * This file is distributed under 3-clause BSD license.
+ * The complete license agreement can be obtained at:
+ * http://arrayfire.com/licenses/BSD-3-Clause
+ ********************************************************/
+
+#pragma once
+#include <af/defines.h>
+#include <af/dim4.hpp>
+#include <types.hpp>
+#include <parallel.hpp>
+#include <algorithm>
+#include <functional>
+#include <limits>
+#include <numeric>
+#include <type_traits>
+#include <vector>
+#include <cstring>
+
+namespace cpu
+{
+    // Columns shorter than this are sorted with std::sort, longer ones with
+    // a radix sort
+    const dim_t MIN_RADIX_SORT_ELEMENTS = 256;
+
+    // Maps the keys to unsigned integers that sort in the same order, so the
+    // radix sort can work on their bits
+    template<typename T> struct radix_traits;
+
+#define RADIX_TRAITS_INT(T, U)                                          \
+    template<> struct radix_traits<T>                                   \
+    {                                                                   \
+        typedef U key_t;                                                \
+        static key_t key(T val)                                         \
+        {                                                               \
+            const key_t sign = (key_t)1 << (8 * sizeof(key_t) - 1);     \
+            return std::numeric_limits<T>::is_signed ? (key_t)val ^ sign : (key_t)val; \
+        }                                                               \
+    };
+
+    RADIX_TRAITS_INT(int  , uint  )
+    RADIX_TRAITS_INT(uint , uint  )
+    RADIX_TRAITS_INT(char , uchar )
+    RADIX_TRAITS_INT(uchar, uchar )
+    RADIX_TRAITS_INT(intl , uintl )
+    RADIX_TRAITS_INT(uintl, uintl )
+
+#undef RADIX_TRAITS_INT
+
+    // Negative floats have all their bits flipped, positive ones only the sign
+#define RADIX_TRAITS_FLOAT(T, U)                                        \
+    template<> struct radix_traits<T>                                   \
+    {                                                                   \
+        typedef U key_t;                                                \
+        static key_t key(T val)                                         \
+        {                                                               \
+            const key_t sign = (key_t)1 << (8 * sizeof(key_t) - 1);     \
+            key_t bits;                                                 \
+            std::memcpy(&bits, &val, sizeof(bits));                     \
+            return (bits & sign) ? ~bits : bits | sign;                 \
+        }                                                               \
+    };
+
+    RADIX_TRAITS_FLOAT(float , uint )
+    RADIX_TRAITS_FLOAT(double, uintl)
+
+#undef RADIX_TRAITS_FLOAT
+
+    // Stable LSD radix sort of key[0, n) on 8 bit digits. When idx is not
+    // NULL it is permuted along with the keys. ktmp and itmp are scratch
+    // buffers of n elements. Passes where all keys share a digit are skipped.
+    template<typename T, bool isAscending>
+    void radixSort(T *key, uint *idx, const dim_t n, T *ktmp, uint *itmp)
+    {
+        typedef typename radix_traits<T>::key_t key_t;
+        const int passes = sizeof(key_t);
+
+        std::vector<dim_t> counts(passes * 256, 0);
+        for (dim_t i = 0; i < n; i++) {
+            key_t k = radix_traits<T>::key(key[i]);
+            if (!isAscending) k = ~k;
+            for (int p = 0; p < passes; p++) {
+                counts[p * 256 + ((k >> (8 * p)) & 0xFF)]++;
+            }
+        }
+
+        T *ksrc = key, *kdst = ktmp;
+        uint *isrc = idx, *idst = itmp;
+
+        for (int p = 0; p < passes; p++) {
+            dim_t *count = &counts[p * 256];
+
+            key_t first = radix_traits<T>::key(ksrc[0]);
+            if (!isAscending) first = ~first;
+            if (count[(first >> (8 * p)) & 0xFF] == n) continue;
+
+            // Turn the counts into the offsets of the buckets
+            dim_t offset = 0;
+            for (int b = 0; b < 256; b++) {
+                dim_t c = count[b];
+                count[b] = offset;
+                offset += c;
+            }
+
+            for (dim_t i = 0; i < n; i++) {
+                key_t k = radix_traits<T>::key(ksrc[i]);
+                if (!isAscending) k = ~k;
+                dim_t dst = count[(k >> (8 * p)) & 0xFF]++;
+                kdst[dst] = ksrc[i];
+                if (idx) idst[dst] = isrc[i];
+            }
+
+            std::swap(ksrc, kdst);
+            std::swap(isrc, idst);
+        }
+
+        if (ksrc != key) {
+            std::copy(ksrc, ksrc + n, key);
+            if (idx) std::copy(isrc, isrc + n, idx);
+        }
+    }
+
+    // Sorts key[0, n) and, when idx is not NULL, permutes idx along with it.
+    // Equal keys keep their order when idx is given.
+    template<typename T, bool isAscending>
+    void sortColumn(T *key, uint *idx, const dim_t n,
+                    std::vector<T> &ktmp, std::vector<uint> &itmp)
+    {
+        if (n >= MIN_RADIX_SORT_ELEMENTS) {
+            ktmp.resize(n);
+            if (idx) itmp.resize(n);
+            radixSort<T, isAscending>(key, idx, n, &ktmp.front(), idx ? &itmp.front() : NULL);
+            return;
+        }
+
+        typedef typename std::conditional<isAscending, std::less<T>, std::greater<T> >::type Op;
+        Op op;
+
+        if (!idx) {
+            std::sort(key, key + n, op);
+            return;
+        }
+
+        // Sort the indices by key and gather the keys afterwards
+        ktmp.assign(key, key + n);
+        const T *kptr = &ktmp.front();
+        std::stable_sort(idx, idx + n, [kptr, op](uint a, uint b) {
+                return op(kptr[a], kptr[b]);
+            });
+        for (dim_t i = 0; i < n; i++) key[i] = kptr[idx[i]];
+    }
+
+    // Offset of column col in an array of the given dims and strides, where
+    // columns run along dim and are numbered over the remaining dimensions
+    static inline dim_t columnOffset(dim_t col, const af::dim4 &dims,
+                                     const af::dim4 &strides, const unsigned dim)
+    {
+        dim_t offset = 0;
+        for (int i = 0; i < 4; i++) {
+            if (i == (int)dim) continue;
+            offset += (col % dims[i]) * strides[i];
+            col /= dims[i];
+        }
+        return offset;
+    }
+
+    // Columns gathered and scattered together when sorting along dimensions
+    // other than 0, so that the strided accesses read whole cache lines
+    const dim_t SORT_COLUMN_BLOCK = 16;
+
+    // Sorts every column of in along dim. The columns are independent and
+    // are distributed over the thread pool. Each one is gathered into a
+    // contiguous buffer, sorted, and written to val. The permutation of the
+    // column is written to idx when it is not NULL, with indices local to
+    // the column.
+    template<typename T, bool isAscending>
+    void sortBatched(T *val, const af::dim4 &vstrides,
+                     uint *idx, const af::dim4 &istrides,
+                     const T *in, const af::dim4 &dims, const af::dim4 &strides,
+                     const unsigned dim)
+    {
+        const dim_t n = dims[dim];
+        const dim_t ncols = dims.elements() / n;
+
+        // Consecutive columns are next to each other along dimension 0
+        const dim_t run = (dim == 0) ? 1 : dims[0];
+        const dim_t block = std::min(run, SORT_COLUMN_BLOCK);
+
+        parallel_for(ncols, [&](dim_t begin, dim_t end) {
+                std::vector<T> key(n * block), ktmp;
+                std::vector<uint> perm(idx ? n * block : 0), itmp;
+
+                for (dim_t col = begin; col < end; ) {
+                    const dim_t nb = std::min(std::min(block, end - col), run - col % run);
+
+                    const T *iptr = in + columnOffset(col, dims, strides, dim);
+                    for (dim_t i = 0; i < n; i++) {
+                        const T *row = iptr + i * strides[dim];
+                        for (dim_t b = 0; b < nb; b++) key[b * n + i] = row[b * strides[0]];
+                    }
+
+                    for (dim_t b = 0; b < nb; b++) {
+                        uint *pptr = idx ? &perm[b * n] : NULL;
+                        if (idx) std::iota(pptr, pptr + n, 0);
+                        sortColumn<T, isAscending>(&key[b * n], pptr, n, ktmp, itmp);
+                    }
+
+                    T *vptr = val + columnOffset(col, dims, vstrides, dim);
+                    for (dim_t i = 0; i < n; i++) {
+                        T *row = vptr + i * vstrides[dim];
+                        for (dim_t b = 0; b < nb; b++) row[b * vstrides[0]] = key[b * n + i];
+                    }
+
+                    if (idx) {
+                        uint *xptr = idx + columnOffset(col, dims, istrides, dim);
+                        for (dim_t i = 0; i < n; i++) {
+                            uint *row = xptr + i * istrides[dim];
+                            for (dim_t b = 0; b < nb; b++) row[b * istrides[0]] = perm[b * n + i];
+                        }
+                    }
+
+                    col += nb;
+                }
+            }, std::max<dim_t>(1, MIN_PARALLEL_ELEMENTS / n));
+    }
+}
@@ -9,11 +9,34 @@
 
 #include <Array.hpp>
 #include <tile.hpp>
+#include <TNJ/IndexNode.hpp>
 #include <stdexcept>
+#include <memory>
+#include <vector>
 #include <err_cpu.hpp>
 
+using std::shared_ptr;
+using std::vector;
+
 namespace cpu
 {
+    // Maps the coordinates along a dimension tiled num times to the
+    // coordinates of the input of length len
+    static TNJ::IndexMap tileMap(const dim_t len, const dim_t num)
+    {
+        if (num == 1) return TNJ::IndexMap();
+
+        // Broadcasting reads the same element with a zero step
+        if (len == 1) return TNJ::IndexMap(0, 0);
+
+        shared_ptr<vector<dim_t> > idx(new vector<dim_t>(len * num));
+        dim_t *ptr = idx->data();
+        for (dim_t n = 0; n < num; n++) {
+            for (dim_t i = 0; i < len; i++) *ptr++ = i;
+        }
+        return TNJ::IndexMap(idx);
+    }
+
     template<typename T>
     Array<T> tile(const Array<T> &in, const af::dim4 &tileDims)
     {
@@ -25,37 +48,16 @@ namespace cpu
             throw std::runtime_error("Elements are 0");
         }
 
-        Array<T> out = createEmptyArray<T>(oDims);
-
-        T* outPtr = out.get();
-        const T* inPtr = in.get();
-
-        const af::dim4 ist = in.strides();
-        const af::dim4 ost = out.strides();
-
-        for(dim_t ow = 0; ow < oDims[3]; ow++) {
-            const dim_t iw = ow % iDims[3];
-            const dim_t iW = iw * ist[3];
-            const dim_t oW = ow * ost[3];
-            for(dim_t oz = 0; oz < oDims[2]; oz++) {
-                const dim_t iz = oz % iDims[2];
-                const dim_t iZW = iW + iz * ist[2];
-                const dim_t oZW = oW + oz * ost[2];
-                for(dim_t oy = 0; oy < oDims[1]; oy++) {
-                    const dim_t iy = oy % iDims[1];
-                    const dim_t iYZW = iZW + iy * ist[1];
-                    const dim_t oYZW = oZW + oy * ost[1];
-                    for(dim_t ox = 0; ox < oDims[0]; ox++) {
-                        const dim_t ix = ox % iDims[0];
-                        const dim_t iMem = iYZW + ix;
-                        const dim_t oMem = oYZW + ox;
-                        outPtr[oMem] = inPtr[iMem];
-                    }
-                }
-            }
+        // The output reads the input in place, and is only materialized
+        // when it is evaluated. Consumers in the same expression read the
+        // input directly.
+        TNJ::IndexMap maps[4];
+        for (int d = 0; d < 4; d++) {
+            maps[d] = tileMap(iDims[d], tileDims[d]);
         }
 
-        return out;
+        TNJ::IndexNode<T> *node = new TNJ::IndexNode<T>(in.getNode(), maps);
+        return createNodeArray<T>(oDims, TNJ::Node_ptr(reinterpret_cast<TNJ::Node *>(node)));
     }
 
 #define INSTANTIATE(T)                                                         \
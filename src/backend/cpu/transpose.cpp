@@ -12,7 +12,10 @@
 #include <ArrayInfo.hpp>
 #include <Array.hpp>
 #include <transpose.hpp>
+#include <dispatch.hpp>
+#include <parallel.hpp>
 
+#include <algorithm>
 #include <utility>
 #include <cassert>
 
@@ -40,41 +43,59 @@ T getConjugate(const T &in)
 template<>
 cfloat getConjugate(const cfloat &in)
 {
-    return std::conj(in);
+    return cfloat(in.real(), -in.imag());
 }
 
 template<>
 cdouble getConjugate(const cdouble &in)
 {
-    return std::conj(in);
+    return cdouble(in.real(), -in.imag());
+}
+
+// Side of the square tiles the matrices are transposed in. A tile of the
+// input and a tile of the output fit in the L1 cache together, and each row
+// of a tile spans whole cache lines.
+static const dim_t TILE_DIM = 32;
+
+template<typename T, bool conjugate>
+static inline T getValue(const T &in)
+{
+    return conjugate ? getConjugate(in) : in;
 }
 
 template<typename T, bool conjugate>
 void transpose_(T *out, const T *in, const af::dim4 &odims, const af::dim4 &idims,
                 const af::dim4 &ostrides, const af::dim4 &istrides)
 {
-    for (dim_t l = 0; l < odims[3]; ++l) {
-        for (dim_t k = 0; k < odims[2]; ++k) {
-            // Outermost loop handles batch mode
-            // if input has no data along third dimension
-            // this loop runs only once
-            for (dim_t j = 0; j < odims[1]; ++j) {
-                for (dim_t i = 0; i < odims[0]; ++i) {
-                    // calculate array indices based on offsets and strides
-                    // the helper getIdx takes care of indices
-                    const dim_t inIdx  = getIdx(istrides,j,i,k,l);
-                    const dim_t outIdx = getIdx(ostrides,i,j,k,l);
-                    if(conjugate)
-                        out[outIdx] = getConjugate(in[inIdx]);
-                    else
-                        out[outIdx] = in[inIdx];
+    const dim_t tiles0 = divup(odims[0], TILE_DIM);
+    const dim_t tiles1 = divup(odims[1], TILE_DIM);
+    const dim_t batch2 = odims[2];
+
+    // Every task transposes one strip of tiles across the output columns
+    parallel_for(tiles1 * odims[2] * odims[3], [&](dim_t begin, dim_t end) {
+        for (dim_t t = begin; t < end; t++) {
+            const dim_t tj = t % tiles1;
+            const dim_t k  = (t / tiles1) % batch2;
+            const dim_t l  = t / (tiles1 * batch2);
+
+            const T *iptr = in  + k * istrides[2] + l * istrides[3];
+                  T *optr = out + k * ostrides[2] + l * ostrides[3];
+
+            const dim_t j0 = tj * TILE_DIM;
+            const dim_t j1 = std::min(j0 + TILE_DIM, odims[1]);
+
+            for (dim_t ti = 0; ti < tiles0; ti++) {
+                const dim_t i0 = ti * TILE_DIM;
+                const dim_t i1 = std::min(i0 + TILE_DIM, odims[0]);
+
+                for (dim_t j = j0; j < j1; j++) {
+                    for (dim_t i = i0; i < i1; i++) {
+                        optr[j * ostrides[1] + i] = getValue<T, conjugate>(iptr[i * istrides[1] + j]);
+                    }
                 }
             }
-            // outData and inData pointers doesn't need to be
-            // offset as the getIdx function is taking care
-            // of the batch parameter
         }
-    }
+    }, std::max<dim_t>(1, MIN_PARALLEL_ELEMENTS / (TILE_DIM * std::max<dim_t>(odims[0], 1))));
 }
 
 template<typename T>
@@ -105,31 +126,46 @@ Array<T> transpose(const Array<T> &in, const bool conjugate)
 template<typename T, bool conjugate>
 void transpose_inplace(T *in, const af::dim4 &idims, const af::dim4 &istrides)
 {
-    for (dim_t l = 0; l < idims[3]; ++l) {
-        for (dim_t k = 0; k < idims[2]; ++k) {
-            // Outermost loop handles batch mode
-            // if input has no data along third dimension
-            // this loop runs only once
-            //
-            // Run only bottom triangle. std::swap swaps with upper triangle
-            for (dim_t j = 0; j < idims[1]; ++j) {
-                for (dim_t i = j + 1; i < idims[0]; ++i) {
-                    // calculate array indices based on offsets and strides
-                    // the helper getIdx takes care of indices
-                    const dim_t iIdx  = getIdx(istrides,j,i,k,l);
-                    const dim_t oIdx = getIdx(istrides,i,j,k,l);
-                    if(conjugate) {
-                        in[iIdx] = getConjugate(in[iIdx]);
-                        in[oIdx] = getConjugate(in[oIdx]);
-                        std::swap(in[iIdx], in[oIdx]);
+    const dim_t tiles = divup(idims[0], TILE_DIM);
+    const dim_t batch2 = idims[2];
+
+    // Every task owns one row of tiles on and below the diagonal and swaps
+    // them with the matching column of tiles above it, so no two tasks
+    // touch the same element
+    parallel_for(tiles * idims[2] * idims[3], [&](dim_t begin, dim_t end) {
+        for (dim_t t = begin; t < end; t++) {
+            const dim_t tj = t % tiles;
+            const dim_t k  = (t / tiles) % batch2;
+            const dim_t l  = t / (tiles * batch2);
+
+            T *ptr = in + k * istrides[2] + l * istrides[3];
+
+            const dim_t j0 = tj * TILE_DIM;
+            const dim_t j1 = std::min(j0 + TILE_DIM, idims[1]);
+
+            for (dim_t ti = 0; ti <= tj; ti++) {
+                const dim_t i0 = ti * TILE_DIM;
+                const dim_t i1 = std::min(i0 + TILE_DIM, idims[0]);
+
+                for (dim_t j = j0; j < j1; j++) {
+                    // On diagonal tiles only the elements below the diagonal
+                    // are swapped
+                    const dim_t iend = (ti == tj) ? j : i1;
+                    for (dim_t i = i0; i < iend; i++) {
+                        T &a = ptr[j * istrides[1] + i];
+                        T &b = ptr[i * istrides[1] + j];
+                        T tmp = getValue<T, conjugate>(a);
+                        a = getValue<T, conjugate>(b);
+                        b = tmp;
                     }
-                    else {
-                        std::swap(in[iIdx], in[oIdx]);
+                    if (conjugate && ti == tj) {
+                        T &d = ptr[j * istrides[1] + j];
+                        d = getValue<T, conjugate>(d);
                     }
                 }
             }
         }
-    }
+    }, std::max<dim_t>(1, MIN_PARALLEL_ELEMENTS / (TILE_DIM * std::max<dim_t>(idims[0], 1))));
 }
 
 template<typename T>
@@ -12,56 +12,146 @@
 #include <af/defines.h>
 #include <ArrayInfo.hpp>
 #include <Array.hpp>
+#include <dispatch.hpp>
 #include <memory.hpp>
+#include <parallel.hpp>
+#include <platform.hpp>
 #include <where.hpp>
 #include <ops.hpp>
+#include <algorithm>
 #include <vector>
 
 using af::dim4;
+using std::vector;
 
 namespace cpu
 {
-    template<typename T>
-    Array<uint> where(const Array<T> &in)
-    {
-        const dim_t *dims    = in.dims().get();
-        const dim_t *strides = in.strides().get();
-        static const T zero = scalar<T>(0);
-
-        const T *iptr = in.get();
-        uint *out_vec  = memAlloc<uint>(in.elements());
+    // Chunks of the input are counted and compacted by different threads
+    // when each of them has at least this many elements
+    static const dim_t WHERE_MIN_CHUNK_ELEMENTS = 1 << 16;
 
+    // Counts the non zero elements with linear indices in [begin, end). When
+    // optr is not NULL, their indices are also written to optr, and their
+    // values to vptr when it is not NULL. Sub arrays are read through their
+    // strides.
+    template<typename T, typename I>
+    static dim_t compactRange(I *optr, T *vptr, const T *iptr,
+                              const dim4 &dims, const dim4 &strides,
+                              dim_t begin, const dim_t end)
+    {
+        const T zero = scalar<T>(0);
+        const dim_t d0 = dims[0], d1 = dims[1], d2 = dims[2];
+        const dim_t s0 = strides[0];
         dim_t count = 0;
-        dim_t idx = 0;
-        for (dim_t w = 0; w < dims[3]; w++) {
-            uint offw = w * strides[3];
-
-            for (dim_t z = 0; z < dims[2]; z++) {
-                uint offz = offw + z * strides[2];
 
-                for (dim_t y = 0; y < dims[1]; y++) {
-                    uint offy = y * strides[1] + offz;
+        while (begin < end) {
+            const dim_t x = begin % d0;
+            const dim_t r = begin / d0;
+            const dim_t y = r % d1;
+            const dim_t z = (r / d1) % d2;
+            const dim_t w = r / (d1 * d2);
 
-                    for (dim_t x = 0; x < dims[0]; x++) {
+            const T *src = iptr + x * s0 + y * strides[1] + z * strides[2] + w * strides[3];
+            const dim_t num = std::min(d0 - x, end - begin);
 
-                        T val = iptr[offy + x];
-                        if (val != zero) {
-                            out_vec[count] = idx;
-                            count++;
-                        }
-                        idx++;
+            if (!optr) {
+                for (dim_t k = 0; k < num; k++) {
+                    count += (src[k * s0] != zero);
+                }
+            } else {
+                for (dim_t k = 0; k < num; k++) {
+                    const T val = src[k * s0];
+                    if (val != zero) {
+                        if (vptr) vptr[count] = val;
+                        optr[count++] = (I)(begin + k);
                     }
                 }
             }
+            begin += num;
+        }
+
+        return count;
+    }
+
+    // A single thread compacts the input in one pass, into buffers as large
+    // as the input, and copies the result out. This reads the input once
+    // instead of twice.
+    template<typename T, typename I>
+    static Array<I> whereSerial(Array<T> *vals, const Array<T> &in)
+    {
+        const dim_t n = in.elements();
+
+        I *optr = memAlloc<I>(n);
+        T *vptr = vals ? memAlloc<T>(n) : NULL;
+        const dim_t count = compactRange<T, I>(optr, vptr, in.get(), in.dims(), in.strides(), 0, n);
+
+        const dim4 odims(count);
+        Array<I> out = count > 0 ? createHostDataArray<I>(odims, optr) : createEmptyArray<I>(odims);
+        if (vals) {
+            *vals = count > 0 ? createHostDataArray<T>(odims, vptr) : createEmptyArray<T>(odims);
         }
 
-        Array<uint> out = createHostDataArray(dim4(count), out_vec);
-        memFree<uint>(out_vec);
+        memFree<I>(optr);
+        if (vptr) memFree<T>(vptr);
+        return out;
+    }
+
+    // The non zero elements of every chunk are counted first. The counts
+    // are scanned to give the position of the first output of every chunk,
+    // and the chunks then write their indices, and values, straight into
+    // outputs of the right size.
+    template<typename T, typename I>
+    Array<I> where(Array<T> *vals, const Array<T> &in)
+    {
+        const dim4 dims    = in.dims();
+        const dim4 strides = in.strides();
+        const dim_t n      = in.elements();
+
+        const dim_t nchunks = std::max<dim_t>(1, std::min<dim_t>(getNumThreads(),
+                                                                 n / WHERE_MIN_CHUNK_ELEMENTS));
+        if (nchunks == 1) return whereSerial<T, I>(vals, in);
+
+        const dim_t chunk = divup(n, nchunks);
+
+        const T *iptr = in.get();
+        vector<dim_t> offsets(nchunks + 1, 0);
+
+        parallel_for(nchunks, [&](dim_t begin, dim_t end) {
+                for (dim_t c = begin; c < end; c++) {
+                    offsets[c + 1] = compactRange<T, I>(NULL, NULL, iptr, dims, strides,
+                                                        c * chunk, std::min(n, (c + 1) * chunk));
+                }
+            });
+
+        for (dim_t c = 0; c < nchunks; c++) offsets[c + 1] += offsets[c];
+
+        Array<I> out = createEmptyArray<I>(dim4(offsets[nchunks]));
+        if (vals) *vals = createEmptyArray<T>(dim4(offsets[nchunks]));
+
+        I *optr = out.get();
+        T *vptr = vals ? vals->get() : NULL;
+
+        parallel_for(nchunks, [&](dim_t begin, dim_t end) {
+                for (dim_t c = begin; c < end; c++) {
+                    compactRange<T, I>(optr + offsets[c], vptr ? vptr + offsets[c] : NULL,
+                                       iptr, dims, strides,
+                                       c * chunk, std::min(n, (c + 1) * chunk));
+                }
+            });
+
         return out;
     }
 
-#define INSTANTIATE(T)                                  \
-    template Array<uint> where<T>(const Array<T> &in);    \
+    template<typename T>
+    Array<uint> where(const Array<T> &in)
+    {
+        return where<T, uint>(NULL, in);
+    }
+
+#define INSTANTIATE(T)                                                  \
+    template Array<uint> where<T>(const Array<T> &in);                  \
+    template Array<uint > where<T, uint >(Array<T> *vals, const Array<T> &in); \
+    template Array<uintl> where<T, uintl>(Array<T> *vals, const Array<T> &in); \
 
     INSTANTIATE(float  )
     INSTANTIATE(cfloat )
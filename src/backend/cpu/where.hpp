@@ -14,4 +14,9 @@ namespace cpu
 {
     template<typename T>
     Array<uint> where(const Array<T>& in);
+
+    // Indices of the non zero elements of in, as I, which is uint or uintl.
+    // The values of those elements are also returned when vals is not NULL.
+    template<typename T, typename I>
+    Array<I> where(Array<T> *vals, const Array<T> &in);
 }
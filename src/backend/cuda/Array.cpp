@@ -223,6 +223,12 @@ namespace cuda
         A.eval();
     }
 
+    template<typename T>
+    void evalMultiple(std::vector<Array<T> *> arrays)
+    {
+        for (size_t i = 0; i < arrays.size(); i++) arrays[i]->eval();
+    }
+
     template<typename T>
     void
     writeHostDataArray(Array<T> &arr, const T * const data, const size_t bytes)
@@ -269,6 +275,7 @@ namespace cuda
                                                        bool copy);      \
     template       void      destroyArray<T>          (Array<T> *A);    \
     template       void      evalArray<T>             (const Array<T> &A); \
+    template       void      evalMultiple<T>          (std::vector<Array<T> *> arrays); \
     template       Array<T>  createNodeArray<T>       (const dim4 &size, JIT::Node_ptr node); \
     template       Array<T>::~Array        ();                          \
     template       void Array<T>::eval();                               \
@@ -80,6 +80,10 @@ namespace cuda
     template<typename T>
     void evalArray(const Array<T> &A);
 
+    // Evaluates the arrays. Each array is still evaluated on its own.
+    template<typename T>
+    void evalMultiple(std::vector<Array<T> *> arrays);
+
     // Creates a new Array object on the heap and returns a reference to it.
     template<typename T>
     void destroyArray(Array<T> *A);
@@ -15,4 +15,9 @@ namespace cuda
 template<typename inType, typename outType, bool isColor>
 Array<outType> bilateral(const Array<inType> &in, const float &s_sigma, const float &c_sigma);
 
+// Approximation of bilateral on a bilateral grid. The channels of color
+// images are filtered independently.
+template<typename inType, typename outType>
+Array<outType> bilateralGrid(const Array<inType> &in, const float &s_sigma, const float &c_sigma);
+
 }
@@ -103,9 +103,22 @@ BLAS_FUNC(gemv, cfloat, C)
 BLAS_FUNC(gemv, double, D)
 BLAS_FUNC(gemv, cdouble,Z)
 
-BLAS_FUNC_DEF(dot)
-BLAS_FUNC(dot, float,  S)
-BLAS_FUNC(dot, double, D)
+// Dot product with the first vector conjugated when conjugate is true
+template<typename T, bool conjugate>
+typename dot_func_def_t<T>::dot_func_def
+dot_func();
+
+#define BLAS_DOT_FUNC( TYPE, CONJUGATE, FUNC )  \
+template<> typename dot_func_def_t<TYPE>::dot_func_def       dot_func<TYPE, CONJUGATE>()  { return &cublas##FUNC; }
+
+BLAS_DOT_FUNC(float,   false, Sdot)
+BLAS_DOT_FUNC(float,   true,  Sdot)
+BLAS_DOT_FUNC(double,  false, Ddot)
+BLAS_DOT_FUNC(double,  true,  Ddot)
+BLAS_DOT_FUNC(cfloat,  false, Cdotu)
+BLAS_DOT_FUNC(cfloat,  true,  Cdotc)
+BLAS_DOT_FUNC(cdouble, false, Zdotu)
+BLAS_DOT_FUNC(cdouble, true,  Zdotc)
 
 BLAS_FUNC_DEF(trsm)
 BLAS_FUNC(trsm, float,  S)
@@ -132,6 +145,10 @@ Array<T> matmul(const Array<T> &lhs, const Array<T> &rhs,
     int N = rDims[bColDim];
     int K = lDims[aColDim];
 
+    if (lDims[2] * lDims[3] > 1 || rDims[2] * rDims[3] > 1) {
+        AF_ERROR("Batched matmul is not supported in the CUDA backend", AF_ERR_NOT_SUPPORTED);
+    }
+
     Array<T> out = createEmptyArray<T>(af::dim4(M, N, 1, 1));
     T alpha = scalar<T>(1);
     T beta  = scalar<T>(0);
@@ -176,11 +193,13 @@ Array<T> dot(const Array<T> &lhs, const Array<T> &rhs,
 
     T out;
 
-    CUBLAS_CHECK(dot_func<T>()(getHandle(),
-                               N,
-                               lhs.get(), lhs.strides()[0],
-                               rhs.get(), rhs.strides()[0],
-                               &out));
+    // Only optLhs can be AF_MAT_CONJ
+    auto func = (optLhs == AF_MAT_CONJ) ? dot_func<T, true>() : dot_func<T, false>();
+    CUBLAS_CHECK(func(getHandle(),
+                      N,
+                      lhs.get(), lhs.strides()[0],
+                      rhs.get(), rhs.strides()[0],
+                      &out));
 
     return createValueArray(af::dim4(1), out);
 }
@@ -227,6 +246,8 @@ INSTANTIATE_BLAS(cdouble)
 
 INSTANTIATE_DOT(float)
 INSTANTIATE_DOT(double)
+INSTANTIATE_DOT(cfloat)
+INSTANTIATE_DOT(cdouble)
 
 #define INSTANTIATE_TRSM(TYPE)                                                          \
     template void trsm<TYPE>(const Array<TYPE> &lhs, Array<TYPE> &rhs,                  \
@@ -105,6 +105,10 @@ Array<T> cholesky(int *info, const Array<T> &in, const bool is_upper)
 template<typename T>
 int cholesky_inplace(Array<T> &in, const bool is_upper)
 {
+    if (in.ndims() > 2) {
+        AF_ERROR("cholesky can not be used in batch mode", AF_ERR_BATCH);
+    }
+
     dim4 iDims = in.dims();
     int N = iDims[0];
 
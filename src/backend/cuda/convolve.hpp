@@ -19,4 +19,10 @@ Array<T> convolve(Array<T> const& signal, Array<accT> const& filter, ConvolveBat
 template<typename T, typename accT, bool expand>
 Array<T> convolve2(Array<T> const& signal, Array<accT> const& c_filter, Array<accT> const& r_filter);
 
+// Route of AF_CONV_AUTO for a signal and filter of these sizes. The separable
+// route is only returned when allowSeparable is set, and the filter then
+// still has to turn out to be of rank one.
+ConvolveRoute convolveRoute(const dim_t baseDim, af::dim4 const& sDims, af::dim4 const& fDims,
+                            const bool expand, const bool isComplex, const bool allowSeparable);
+
 }
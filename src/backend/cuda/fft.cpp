@@ -128,6 +128,11 @@ void find_cufft_plan(cufftHandle &plan, int rank, int *n,
     planner.mAvailSlotIndex = (slot_index + 1)%cuFFTPlanner::MAX_PLAN_CACHE;
 }
 
+void setFFTPlanCacheSize(size_t numPlans)
+{
+    // The cuFFT planner keeps a fixed number of plans
+}
+
 template<typename T>
 struct cufft_transform;
 
@@ -221,6 +226,18 @@ Array<T> ifft(Array<T> const &in, double norm_factor, dim_t const npad, dim_t co
     return ret;
 }
 
+template<typename Tr, typename Tc, int rank>
+Array<Tc> fft_r2c(Array<Tr> const &in, double norm_factor, dim_t const npad, dim_t const * const pad)
+{
+    CUDA_NOT_SUPPORTED();
+}
+
+template<typename Tc, typename Tr, int rank>
+Array<Tr> fft_c2r(Array<Tc> const &in, double norm_factor, dim4 const &odims)
+{
+    CUDA_NOT_SUPPORTED();
+}
+
 #define INSTANTIATE1(T1, T2)\
     template Array<T2> fft <T1, T2, 1, true >(const Array<T1> &in, double norm_factor, dim_t const npad, dim_t const * const pad); \
     template Array<T2> fft <T1, T2, 2, true >(const Array<T1> &in, double norm_factor, dim_t const npad, dim_t const * const pad); \
@@ -240,4 +257,15 @@ INSTANTIATE1(double , cdouble)
 INSTANTIATE2(cfloat )
 INSTANTIATE2(cdouble)
 
+#define INSTANTIATE_REAL(Tr, Tc)\
+    template Array<Tc> fft_r2c<Tr, Tc, 1>(const Array<Tr> &in, double norm_factor, dim_t const npad, dim_t const * const pad); \
+    template Array<Tc> fft_r2c<Tr, Tc, 2>(const Array<Tr> &in, double norm_factor, dim_t const npad, dim_t const * const pad); \
+    template Array<Tc> fft_r2c<Tr, Tc, 3>(const Array<Tr> &in, double norm_factor, dim_t const npad, dim_t const * const pad); \
+    template Array<Tr> fft_c2r<Tc, Tr, 1>(const Array<Tc> &in, double norm_factor, dim4 const &odims); \
+    template Array<Tr> fft_c2r<Tc, Tr, 2>(const Array<Tc> &in, double norm_factor, dim4 const &odims); \
+    template Array<Tr> fft_c2r<Tc, Tr, 3>(const Array<Tc> &in, double norm_factor, dim4 const &odims);
+
+INSTANTIATE_REAL(float , cfloat )
+INSTANTIATE_REAL(double, cdouble)
+
 }
@@ -49,6 +49,13 @@ Array<outType> histogram(const Array<inType> &in, const unsigned &nbins, const d
     return out;
 }
 
+template<typename inType, typename outType>
+Array<outType> histogram(const Array<inType> &in, const Array<outType> &weights,
+                         const unsigned &nbins, const double &minval, const double &maxval)
+{
+    CUDA_NOT_SUPPORTED();
+}
+
 #define INSTANTIATE(in_t,out_t)\
 template Array<out_t> histogram(const Array<in_t> &in, const unsigned &nbins, const double &minval, const double &maxval);
 
@@ -59,4 +66,19 @@ INSTANTIATE(int   , uint)
 INSTANTIATE(uint  , uint)
 INSTANTIATE(uchar , uint)
 
+#define INSTANTIATE_WEIGHTED(in_t,out_t)\
+template Array<out_t> histogram(const Array<in_t> &in, const Array<out_t> &weights,\
+                                const unsigned &nbins, const double &minval, const double &maxval);
+
+#define INSTANTIATE_WEIGHTS(out_t)      \
+    INSTANTIATE_WEIGHTED(float , out_t) \
+    INSTANTIATE_WEIGHTED(double, out_t) \
+    INSTANTIATE_WEIGHTED(char  , out_t) \
+    INSTANTIATE_WEIGHTED(int   , out_t) \
+    INSTANTIATE_WEIGHTED(uint  , out_t) \
+    INSTANTIATE_WEIGHTED(uchar , out_t)
+
+INSTANTIATE_WEIGHTS(float )
+INSTANTIATE_WEIGHTS(double)
+
 }
@@ -21,6 +21,7 @@ namespace kernel
     static const int THREADS = 256;
     static const int BLOCKS  = 64;
     static unsigned long long seed = 0;
+    static unsigned long long counter = 0;
     static curandState_t *states[DeviceManager::MAX_DEVICES];
     static bool is_init[DeviceManager::MAX_DEVICES] = {0};
 
@@ -94,10 +95,10 @@ namespace kernel
     }
 
     __global__ static void
-    setup_kernel(curandState_t *states, unsigned long long seed)
+    setup_kernel(curandState_t *states, unsigned long long seed, unsigned long long offset)
     {
         unsigned tid = blockDim.x * blockIdx.x + threadIdx.x;
-        curand_init(seed, tid, 0, &states[tid]);
+        curand_init(seed, tid, offset, &states[tid]);
     }
 
     template<typename T>
@@ -136,7 +137,7 @@ namespace kernel
             CUDA_CHECK(cudaMalloc(&states[device], BLOCKS * THREADS * sizeof(curandState_t)));
         }
 
-        setup_kernel<<<BLOCKS, THREADS>>>(states[device], seed);
+        setup_kernel<<<BLOCKS, THREADS>>>(states[device], seed, counter);
         POST_LAUNCH_CHECK();
         is_init[device] = true;
     }
@@ -165,7 +166,7 @@ namespace kernel
         if (!states[device]) {
             CUDA_CHECK(cudaMalloc(&states[device], BLOCKS * THREADS * sizeof(curandState_t)));
 
-            setup_kernel<<<BLOCKS, THREADS>>>(states[device], seed);
+            setup_kernel<<<BLOCKS, THREADS>>>(states[device], seed, counter);
 
             POST_LAUNCH_CHECK();
         }
@@ -0,0 +1,76 @@
+/*******************************************************
+ * Copyright (c) 2015, ArrayFire
+ * All rights reserved.
+ *
+ * This file is distributed under 3-clause BSD license.
+ * The complete license agreement can be obtained at:
+ * http://arrayfire.com/licenses/BSD-3-Clause
+ ********************************************************/
+
+#include <af/dim4.hpp>
+#include <af/defines.h>
+#include <af/seq.h>
+#include <Array.hpp>
+#include <arith.hpp>
+#include <cast.hpp>
+#include <copy.hpp>
+#include <math.hpp>
+#include <median.hpp>
+#include <reorder.hpp>
+#include <sort.hpp>
+#include <algorithm>
+#include <vector>
+
+using af::dim4;
+
+namespace cuda
+{
+    // The values are sorted along dimension 0 and the middle ones picked
+    template<typename Ti, typename To>
+    Array<To> median(const Array<Ti> &in, const int dim)
+    {
+        // Swapping dim with dimension 0 is its own inverse
+        dim4 order(0, 1, 2, 3);
+        std::swap(order[0], order[dim]);
+
+        const Array<Ti> input = (dim == 0) ? in : reorder<Ti>(in, order);
+        Array<Ti> sorted = sort<Ti, true>(input, 0);
+
+        const dim_t n = sorted.dims()[0];
+        std::vector<af_seq> index(4, af_span);
+        index[0] = af_make_seq((n - 1) / 2, (n - 1) / 2, 1);
+        Array<To> out = cast<To, Ti>(createSubArray<Ti>(sorted, index));
+
+        if (n % 2 == 0) {
+            index[0] = af_make_seq(n / 2, n / 2, 1);
+            Array<To> right = cast<To, Ti>(createSubArray<Ti>(sorted, index));
+
+            const dim4 odims = out.dims();
+            Array<To> sum = arithOp<To, af_add_t>(out, right, odims);
+            out = arithOp<To, af_mul_t>(sum, createValueArray<To>(odims, scalar<To>(0.5)), odims);
+        }
+
+        return (dim == 0) ? out : reorder<To>(out, order);
+    }
+
+    template<typename Ti, typename To>
+    To median_all(const Array<Ti> &in)
+    {
+        Array<Ti> flat = copyArray<Ti>(in);
+        flat.modDims(dim4(in.elements()));
+
+        To val;
+        copyData(&val, median<Ti, To>(flat, 0));
+        return val;
+    }
+
+#define INSTANTIATE(Ti, To)                                                 \
+    template Array<To> median<Ti, To>(const Array<Ti> &in, const int dim);  \
+    template To median_all<Ti, To>(const Array<Ti> &in);
+
+    INSTANTIATE(float , float )
+    INSTANTIATE(double, double)
+    INSTANTIATE(int   , float )
+    INSTANTIATE(uint  , float )
+    INSTANTIATE(uchar , float )
+}
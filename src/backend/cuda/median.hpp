@@ -0,0 +1,22 @@
+/*******************************************************
+ * Copyright (c) 2015, ArrayFire
+ * All rights reserved.
+ *
+ * This file is distributed under 3-clause BSD license.
+ * The complete license agreement can be obtained at:
+ * http://arrayfire.com/licenses/BSD-3-Clause
+ ********************************************************/
+
+#include <af/array.h>
+#include <Array.hpp>
+
+namespace cuda
+{
+    // Median of the values along dim. Integer types have a floating point
+    // median, To is float for them and T otherwise.
+    template<typename Ti, typename To>
+    Array<To> median(const Array<Ti> &in, const int dim);
+
+    template<typename Ti, typename To>
+    To median_all(const Array<Ti> &in);
+}
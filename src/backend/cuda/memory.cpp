@@ -105,6 +105,7 @@ namespace cuda
     static size_t used_bytes[DeviceManager::MAX_DEVICES] = {0};
     static size_t used_buffers[DeviceManager::MAX_DEVICES] = {0};
     static size_t total_bytes[DeviceManager::MAX_DEVICES] = {0};
+    static size_t mem_limit = DEFAULT_MEM_LIMIT;
     typedef std::map<void *, mem_info> mem_t;
     typedef mem_t::iterator mem_iter;
 
@@ -144,7 +145,7 @@ namespace cuda
 
             // FIXME: Add better checks for garbage collection
             // Perhaps look at total memory available as a metric
-            if (memory_maps[n].size() >= MAX_BUFFERS || used_bytes[n] >= MAX_BYTES) {
+            if (memory_maps[n].size() >= MAX_BUFFERS || used_bytes[n] >= mem_limit) {
                 garbageCollect();
             }
 
@@ -200,6 +201,19 @@ namespace cuda
         if (lock_buffers  ) *lock_buffers  = used_buffers[n];
     }
 
+    void setMemoryLimit(size_t bytes)
+    {
+        mem_limit = bytes;
+        if (used_bytes[getActiveDeviceId()] >= mem_limit) {
+            garbageCollect();
+        }
+    }
+
+    size_t getMemoryLimit()
+    {
+        return mem_limit;
+    }
+
     //////////////////////////////////////////////////////////////////////////////
     mem_t pinned_maps;
     static size_t pinned_used_bytes = 0;
@@ -18,4 +18,9 @@ Array<T> morph(const Array<T> &in, const Array<T> &mask);
 template<typename T, bool isDilation>
 Array<T> morph3d(const Array<T> &in, const Array<T> &mask);
 
+// Erosion or dilation with a w_len x w_wid window of ones
+template<typename T, bool isDilation>
+Array<T> morphRect(const Array<T> &in, const dim_t w_len, const dim_t w_wid,
+                   const af_border_type pad);
+
 }
@@ -12,6 +12,7 @@
 #include <ArrayInfo.hpp>
 #include <Array.hpp>
 #include <morph.hpp>
+#include <math.hpp>
 #include <kernel/morph.hpp>
 #include <err_cuda.hpp>
 
@@ -44,7 +45,20 @@ Array<T>  morph(const Array<T> &in, const Array<T> &mask)
     return out;
 }
 
+template<typename T, bool isDilation>
+Array<T> morphRect(const Array<T> &in, const dim_t w_len, const dim_t w_wid,
+                   const af_border_type pad)
+{
+    if (pad != AF_PAD_ZERO)
+        AF_ERROR("Only AF_PAD_ZERO is supported in cuda minfilt and maxfilt currently", AF_ERR_NOT_SUPPORTED);
+
+    Array<T> mask = createValueArray<T>(dim4(w_len, w_wid), scalar<T>(1));
+    return morph<T, isDilation>(in, mask);
+}
+
 }
 
 #define INSTANTIATE(T, ISDILATE)                                        \
-    template Array<T> morph  <T, ISDILATE>(const Array<T> &in, const Array<T> &mask);
+    template Array<T> morph  <T, ISDILATE>(const Array<T> &in, const Array<T> &mask); \
+    template Array<T> morphRect<T, ISDILATE>(const Array<T> &in, const dim_t w_len,     \
+                                             const dim_t w_wid, const af_border_type pad);
@@ -362,4 +362,14 @@ void sync(int device)
     setDevice(currDevice);
 }
 
+int getNumThreads()
+{
+    return 1;
+}
+
+void setNumThreads(int num)
+{
+    // Nothing here
+}
+
 }
@@ -46,6 +46,11 @@ int setDevice(int device);
 
 void sync(int device);
 
+// Host threads are only used by the CPU backend
+int getNumThreads();
+
+void setNumThreads(int num);
+
 cudaDeviceProp getDeviceProp(int device);
 
 struct cudaDevice_t {
@@ -52,6 +52,7 @@ namespace cuda
     void setSeed(const uintl seed)
     {
         kernel::seed = seed;
+        kernel::counter = 0;
         kernel::setup_states();
     }
 
@@ -60,5 +61,15 @@ namespace cuda
         return kernel::seed;
     }
 
+    // Every cuRAND state skips counter values of its sequence
+    void setRandomCounter(const uintl counter)
+    {
+        kernel::counter = counter;
+        kernel::setup_states();
+    }
 
+    uintl getRandomCounter()
+    {
+        return kernel::counter;
+    }
 }
@@ -23,10 +23,18 @@ namespace cuda
 template<typename T>
 Array<T>  regions(const Array<char> &in, af_connectivity connectivity)
 {
+    if (connectivity == AF_CONNECTIVITY_6 || connectivity == AF_CONNECTIVITY_26) {
+        CUDA_NOT_SUPPORTED();
+    }
     ARG_ASSERT(2, (connectivity==AF_CONNECTIVITY_4 || connectivity==AF_CONNECTIVITY_8));
 
     const dim4 dims = in.dims();
 
+    // The kernels label a single image
+    if (dims[2] > 1) {
+        AF_ERROR("regions can not be used in batch mode", AF_ERR_BATCH);
+    }
+
     Array<T>  out  = createEmptyArray<T>(dims);
 
     // Create bindless texture object for the equiv map.
@@ -53,13 +61,25 @@ Array<T>  regions(const Array<char> &in, af_connectivity connectivity)
         case AF_CONNECTIVITY_8:
             ::regions<T, true,  2>(out, in, tex);
             break;
+        default:
+            break;
     }
 
     return out;
 }
 
+template<typename T>
+Array<T> regions(Array<uint> &area, Array<uint> &bbox, Array<float> &centroid,
+                 const Array<char> &in, af_connectivity connectivity)
+{
+    CUDA_NOT_SUPPORTED();
+}
+
 #define INSTANTIATE(T)\
-    template Array<T>  regions<T>(const Array<char> &in, af_connectivity connectivity);
+    template Array<T>  regions<T>(const Array<char> &in, af_connectivity connectivity);    \
+    template Array<T>  regions<T>(Array<uint> &area, Array<uint> &bbox,                    \
+                                  Array<float> &centroid, const Array<char> &in,           \
+                                  af_connectivity connectivity);
 
 INSTANTIATE(float )
 INSTANTIATE(double)
@@ -15,4 +15,8 @@ namespace cuda
 template<typename T>
 Array<T> regions(const Array<char> &in, af_connectivity connectivity);
 
+template<typename T>
+Array<T> regions(Array<uint> &area, Array<uint> &bbox, Array<float> &centroid,
+                 const Array<char> &in, af_connectivity connectivity);
+
 }
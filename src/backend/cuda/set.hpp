@@ -22,4 +22,22 @@ namespace cuda
     template<typename T> Array<T> setIntersect(const Array<T> &first,
                                                const Array<T> &second,
                                                const bool is_unique);
+
+    // Distinct values in the order of their first occurrence, or in ascending
+    // order when in_order is false, with the indices of those occurrences.
+    // The union indices point into the values of first followed by second.
+    template<typename T> Array<T> setUnique(Array<uint> &idx,
+                                            const Array<T> &in,
+                                            const bool in_order);
+
+    template<typename T> Array<T> setUnion(Array<uint> &idx,
+                                           const Array<T> &first,
+                                           const Array<T> &second,
+                                           const bool in_order);
+
+    template<typename T> Array<T> setIntersect(Array<uint> &first_idx,
+                                               Array<uint> &second_idx,
+                                               const Array<T> &first,
+                                               const Array<T> &second,
+                                               const bool in_order);
 }
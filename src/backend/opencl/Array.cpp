@@ -254,6 +254,12 @@ namespace opencl
         A.eval();
     }
 
+    template<typename T>
+    void evalMultiple(std::vector<Array<T> *> arrays)
+    {
+        for (size_t i = 0; i < arrays.size(); i++) arrays[i]->eval();
+    }
+
     template<typename T>
     void
     writeHostDataArray(Array<T> &arr, const T * const data, const size_t bytes)
@@ -303,6 +309,7 @@ namespace opencl
                                                        bool copy);      \
     template       void      destroyArray<T>          (Array<T> *A);    \
     template       void      evalArray<T>             (const Array<T> &A); \
+    template       void      evalMultiple<T>          (std::vector<Array<T> *> arrays); \
     template       Array<T>  createNodeArray<T>       (const dim4 &size, JIT::Node_ptr node); \
     template       Array<T>::~Array        ();                          \
     template       void Array<T>::eval();                               \
@@ -67,9 +67,29 @@ BLAS_FUNC(gemv, double,     D)
 BLAS_FUNC(gemv, cfloat,     C)
 BLAS_FUNC(gemv, cdouble,    Z)
 
-BLAS_FUNC_DEF( dot )
-BLAS_FUNC(dot, float,       S)
-BLAS_FUNC(dot, double,      D)
+// Dot product with the first vector conjugated when conjugate is true
+template<typename T, bool conjugate>
+struct dot_func;
+
+#define BLAS_DOT_FUNC(TYPE, CONJUGATE, FUNC)                            \
+template<>                                                              \
+struct dot_func<TYPE, CONJUGATE>                                        \
+{                                                                       \
+    template<typename... Args>                                          \
+    clblasStatus                                                        \
+    operator() (Args... args) { return clblas##FUNC(args...); }         \
+};
+
+BLAS_DOT_FUNC(float,   false, Sdot)
+BLAS_DOT_FUNC(float,   true,  Sdot)
+BLAS_DOT_FUNC(double,  false, Ddot)
+BLAS_DOT_FUNC(double,  true,  Ddot)
+BLAS_DOT_FUNC(cfloat,  false, Cdotu)
+BLAS_DOT_FUNC(cfloat,  true,  Cdotc)
+BLAS_DOT_FUNC(cdouble, false, Zdotu)
+BLAS_DOT_FUNC(cdouble, true,  Zdotc)
+
+#undef BLAS_DOT_FUNC
 
 #undef BLAS_FUNC_DEF
 #undef BLAS_FUNC
@@ -92,6 +112,10 @@ Array<T> matmul(const Array<T> &lhs, const Array<T> &rhs,
     int N = rDims[bColDim];
     int K = lDims[aColDim];
 
+    if (lDims[2] * lDims[3] > 1 || rDims[2] * rDims[3] > 1) {
+        AF_ERROR("Batched matmul is not supported in the OpenCL backend", AF_ERR_NOT_SUPPORTED);
+    }
+
     //FIXME: Leaks on errors.
     Array<T> out = createEmptyArray<T>(af::dim4(M, N, 1, 1));
     auto alpha = scalar<T>(1);
@@ -133,16 +157,12 @@ Array<T> matmul(const Array<T> &lhs, const Array<T> &rhs,
     return out;
 }
 
-template<typename T>
-Array<T> dot(const Array<T> &lhs, const Array<T> &rhs,
-             af_mat_prop optLhs, af_mat_prop optRhs)
+template<typename T, bool conjugate>
+static void dot_(Array<T> &out, const Array<T> &lhs, const Array<T> &rhs)
 {
-    initBlas();
-
     int N = lhs.dims()[0];
-    dot_func<T> dot;
+    dot_func<T, conjugate> dot;
     cl::Event event;
-    auto out = createEmptyArray<T>(af::dim4(1));
     cl::Buffer scratch(getContext(), CL_MEM_READ_WRITE, sizeof(T) * N);
     CLBLAS_CHECK(
         dot(N,
@@ -152,6 +172,21 @@ Array<T> dot(const Array<T> &lhs, const Array<T> &rhs,
             scratch(),
             1, &getQueue()(), 0, nullptr, &event())
         );
+}
+
+template<typename T>
+Array<T> dot(const Array<T> &lhs, const Array<T> &rhs,
+             af_mat_prop optLhs, af_mat_prop optRhs)
+{
+    initBlas();
+
+    auto out = createEmptyArray<T>(af::dim4(1));
+    // Only optLhs can be AF_MAT_CONJ
+    if (optLhs == AF_MAT_CONJ) {
+        dot_<T, true >(out, lhs, rhs);
+    } else {
+        dot_<T, false>(out, lhs, rhs);
+    }
     return out;
 }
 
@@ -174,4 +209,6 @@ Array<T> dot(const Array<T> &lhs, const Array<T> &rhs,
 
 INSTANTIATE_DOT(float)
 INSTANTIATE_DOT(double)
+INSTANTIATE_DOT(cfloat)
+INSTANTIATE_DOT(cdouble)
 }
@@ -23,6 +23,10 @@ namespace opencl
 template<typename T>
 int cholesky_inplace(Array<T> &in, const bool is_upper)
 {
+    if (in.ndims() > 2) {
+        AF_ERROR("cholesky can not be used in batch mode", AF_ERR_BATCH);
+    }
+
     try {
         initBlas();
 
@@ -14,6 +14,7 @@
 #include <convolve.hpp>
 #include <kernel/convolve.hpp>
 #include <err_opencl.hpp>
+#include <algorithm>
 
 using af::dim4;
 
@@ -61,6 +62,37 @@ Array<T> convolve(Array<T> const& signal, Array<accT> const& filter, ConvolveBat
     return out;
 }
 
+// The spatial kernels keep the filter in shared memory. Larger filters and
+// large batches go to the FFT convolution.
+ConvolveRoute convolveRoute(const dim_t baseDim, dim4 const& sDims, dim4 const& fDims,
+                            const bool expand, const bool isComplex, const bool allowSeparable)
+{
+    dim_t batch = 1;
+    for (dim_t i = 3; i >= baseDim; i--) {
+        batch *= std::max(fDims[i], sDims[i]);
+    }
+
+    if (batch >= 10) return CONV_FREQ_ROUTE;
+
+    if (baseDim == 1) {
+        if (fDims[0] > 128) return CONV_FREQ_ROUTE;
+    }
+
+    if (baseDim == 2) {
+        // maximum supported size in 2D domain
+        if (fDims[0] > 17 || fDims[1] > 17) return CONV_FREQ_ROUTE;
+
+        // Maximum supported non square size
+        if (fDims[0] != fDims[1] && fDims[0] > 5) return CONV_FREQ_ROUTE;
+    }
+
+    if (baseDim == 3) {
+        if (fDims[0] > 5 || fDims[1] > 5 || fDims[2] > 5) return CONV_FREQ_ROUTE;
+    }
+
+    return CONV_SPATIAL_ROUTE;
+}
+
 #define INSTANTIATE(T, accT)                                            \
     template Array<T> convolve <T, accT, 1, true >(Array<T> const& signal, Array<accT> const& filter, ConvolveBatchKind kind); \
     template Array<T> convolve <T, accT, 1, false>(Array<T> const& signal, Array<accT> const& filter, ConvolveBatchKind kind); \
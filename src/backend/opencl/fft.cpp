@@ -160,6 +160,11 @@ void find_clfft_plan(clfftPlanHandle &plan,
     planner.mAvailSlotIndex = (slot_index + 1)%clFFTPlanner::MAX_PLAN_CACHE;
 }
 
+void setFFTPlanCacheSize(size_t numPlans)
+{
+    // The clFFT planner keeps a fixed number of plans
+}
+
 template<typename T> struct Precision;
 template<> struct Precision<cfloat > { enum {type = CLFFT_SINGLE}; };
 template<> struct Precision<cdouble> { enum {type = CLFFT_DOUBLE}; };
@@ -278,6 +283,18 @@ Array<T> ifft(Array<T> const &in, double norm_factor, dim_t const npad, dim_t co
     return ret;
 }
 
+template<typename Tr, typename Tc, int rank>
+Array<Tc> fft_r2c(Array<Tr> const &in, double norm_factor, dim_t const npad, dim_t const * const pad)
+{
+    OPENCL_NOT_SUPPORTED();
+}
+
+template<typename Tc, typename Tr, int rank>
+Array<Tr> fft_c2r(Array<Tc> const &in, double norm_factor, dim4 const &odims)
+{
+    OPENCL_NOT_SUPPORTED();
+}
+
 #define INSTANTIATE1(T1, T2)\
     template Array<T2> fft <T1, T2, 1, true >(const Array<T1> &in, double norm_factor, dim_t const npad, dim_t const * const pad); \
     template Array<T2> fft <T1, T2, 2, true >(const Array<T1> &in, double norm_factor, dim_t const npad, dim_t const * const pad); \
@@ -297,4 +314,15 @@ INSTANTIATE1(double , cdouble)
 INSTANTIATE2(cfloat )
 INSTANTIATE2(cdouble)
 
+#define INSTANTIATE_REAL(Tr, Tc)\
+    template Array<Tc> fft_r2c<Tr, Tc, 1>(const Array<Tr> &in, double norm_factor, dim_t const npad, dim_t const * const pad); \
+    template Array<Tc> fft_r2c<Tr, Tc, 2>(const Array<Tr> &in, double norm_factor, dim_t const npad, dim_t const * const pad); \
+    template Array<Tc> fft_r2c<Tr, Tc, 3>(const Array<Tr> &in, double norm_factor, dim_t const npad, dim_t const * const pad); \
+    template Array<Tr> fft_c2r<Tc, Tr, 1>(const Array<Tc> &in, double norm_factor, dim4 const &odims); \
+    template Array<Tr> fft_c2r<Tc, Tr, 2>(const Array<Tc> &in, double norm_factor, dim4 const &odims); \
+    template Array<Tr> fft_c2r<Tc, Tr, 3>(const Array<Tc> &in, double norm_factor, dim4 const &odims);
+
+INSTANTIATE_REAL(float , cfloat )
+INSTANTIATE_REAL(double, cdouble)
+
 }
@@ -18,6 +18,14 @@ Array<outType> fft(Array<inType> const &in, double norm_factor, dim_t const npad
 template<typename T, int rank>
 Array<T> ifft(Array<T> const &in, double norm_factor, dim_t const npad, dim_t const * const pad);
 
+template<typename Tr, typename Tc, int rank>
+Array<Tc> fft_r2c(Array<Tr> const &in, double norm_factor, dim_t const npad, dim_t const * const pad);
+
+template<typename Tc, typename Tr, int rank>
+Array<Tr> fft_c2r(Array<Tc> const &in, double norm_factor, af::dim4 const &odims);
+
+void setFFTPlanCacheSize(size_t numPlans);
+
 template<typename T, int rank, bool direction>
 void fft_common(Array<T> &out, const Array<T> &in);
 
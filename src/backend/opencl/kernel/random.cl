@@ -260,15 +260,18 @@ void generate(T *one, T *two, threefry2_ctr_t *c, threefry2_key_t k)
 }
 #endif
 
+// The 64 bit counter is split in two halves. The high half is mixed into
+// the word of the seed held by the Threefry counter.
 __kernel void random(__global T *output, unsigned numel,
-                    unsigned counter, unsigned lo, unsigned hi)
+                    unsigned counter, unsigned counter_hi,
+                    unsigned lo, unsigned hi)
 {
     unsigned gid = get_group_id(0);
     unsigned off = get_local_size(0);
     unsigned tid =  off * gid * repeat + get_local_id(0);
 
     threefry2_key_t k = {{tid, lo}};
-    threefry2_ctr_t c = {{counter, hi}};
+    threefry2_ctr_t c = {{counter, hi ^ counter_hi}};
 
     T one, two;
 
@@ -38,7 +38,7 @@ namespace opencl
         static const uint THREADS = 256;
 
         static uint random_seed[2] = {0, 0};
-        static unsigned counter;
+        static uintl counter = 0;
 
         template<typename T, bool isRandu>
         struct random_name
@@ -123,16 +123,20 @@ namespace opencl
                         ranKernels[device] = new Kernel(*ranProgs[device], "random");
                     });
 
-                auto randomOp = make_kernel<cl::Buffer, uint, uint, uint, uint>(*ranKernels[device]);
+                auto randomOp = make_kernel<cl::Buffer, uint, uint, uint, uint, uint>(*ranKernels[device]);
 
                 uint groups = divup(elements, THREADS * REPEAT);
-                counter += divup(elements, THREADS * groups);
 
                 NDRange local(THREADS, 1);
                 NDRange global(THREADS * groups, 1);
 
                 randomOp(EnqueueArgs(getQueue(), global, local),
-                         out, elements, counter, random_seed[0], random_seed[1]);
+                         out, elements, (uint)counter, (uint)(counter >> 32),
+                         random_seed[0], random_seed[1]);
+
+                // Every call starts at the counter and moves it past the
+                // values it used, as the CPU backend does
+                counter += divup(elements, THREADS * groups);
                 CL_DEBUG_FINISH(getQueue());
             } catch(cl::Error ex) {
                 CL_TO_AF_ERROR(ex);
@@ -52,6 +52,7 @@ namespace opencl
     static size_t used_bytes[DeviceManager::MAX_DEVICES] = {0};
     static size_t used_buffers[DeviceManager::MAX_DEVICES] = {0};
     static size_t total_bytes[DeviceManager::MAX_DEVICES] = {0};
+    static size_t mem_limit = DEFAULT_MEM_LIMIT;
 
     typedef std::map<cl::Buffer *, mem_info> mem_t;
     typedef mem_t::iterator mem_iter;
@@ -94,7 +95,7 @@ namespace opencl
 
             // FIXME: Add better checks for garbage collection
             // Perhaps look at total memory available as a metric
-            if (memory_maps[n].size() >= MAX_BUFFERS || used_bytes[n] >= MAX_BYTES) {
+            if (memory_maps[n].size() >= MAX_BUFFERS || used_bytes[n] >= mem_limit) {
                 garbageCollect();
             }
 
@@ -150,6 +151,19 @@ namespace opencl
         if (lock_buffers  ) *lock_buffers  = used_buffers[n];
     }
 
+    void setMemoryLimit(size_t bytes)
+    {
+        mem_limit = bytes;
+        if (used_bytes[getActiveDeviceId()] >= mem_limit) {
+            garbageCollect();
+        }
+    }
+
+    size_t getMemoryLimit()
+    {
+        return mem_limit;
+    }
+
     template<typename T>
     T *memAlloc(const size_t &elements)
     {
@@ -26,8 +26,15 @@ namespace opencl
     static const unsigned MAX_BUFFERS   = 100;
     static const unsigned MAX_BYTES     = (1 << 30);
 
+    // Bytes in use before the memory manager releases free buffers, the same
+    // default as the memory limit of the CPU backend
+    static const size_t DEFAULT_MEM_LIMIT = MAX_BYTES;
+
     void deviceMemoryInfo(size_t *alloc_bytes, size_t *alloc_buffers,
                           size_t *lock_bytes,  size_t *lock_buffers);
     void garbageCollect();
     void pinnedGarbageCollect();
+
+    void setMemoryLimit(size_t bytes);
+    size_t getMemoryLimit();
 }
@@ -367,6 +367,16 @@ void sync(int device)
     }
 }
 
+int getNumThreads()
+{
+    return 1;
+}
+
+void setNumThreads(int num)
+{
+    // Nothing here
+}
+
 bool checkExtnAvailability(const Device &pDevice, std::string pName)
 {
     bool ret_val = false;
@@ -99,4 +99,9 @@ int setDevice(int device);
 
 void sync(int device);
 
+// Host threads are only used by the CPU backend
+int getNumThreads();
+
+void setNumThreads(int num);
+
 }
@@ -8,6 +8,7 @@
  ********************************************************/
 
 #include <program.hpp>
+#include <program_cache.hpp>
 #include <traits.hpp>
 #include <kernel_headers/KParam.hpp>
 #include <debug_opencl.hpp>
@@ -49,10 +50,16 @@ namespace opencl
                 std::string(" -D dim_t=") +
                 std::string(dtype_traits<dim_t>::getName());
 
+            const string buildOptions = defaults + options;
+            const string key = getProgramCacheKey(setSrc, buildOptions);
+            if (loadCachedProgram(prog, key, buildOptions)) return;
+
             prog = cl::Program(getContext(), setSrc);
             std::vector<cl::Device> targetDevices;
             targetDevices.push_back(getDevice());
-            prog.build(targetDevices, (defaults + options).c_str());
+            prog.build(targetDevices, buildOptions.c_str());
+
+            saveCachedProgram(prog, key);
 
         } catch (...) {
             SHOW_BUILD_INFO(prog);
@@ -0,0 +1,351 @@
+/*******************************************************
+ * Copyright (c) 2015, ArrayFire
+ * All rights reserved.
+ *
+ * This file is distributed under 3-clause BSD license.
+ * The complete license agreement can be obtained at:
+ * http://arrayfire.com/licenses/BSD-3-Clause
+ ********************************************************/
+
+#include <program_cache.hpp>
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <mutex>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <sys/types.h>
+#include <sys/stat.h>
+
+#if defined(_WIN32)
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#include <direct.h>
+#include <process.h>
+#include <sys/utime.h>
+#else
+#include <dirent.h>
+#include <unistd.h>
+#include <utime.h>
+#endif
+
+using cl::Program;
+using std::string;
+using std::vector;
+
+// The cache lives in AF_OPENCL_CACHE_DIR, or in .arrayfire/opencl under the
+// home directory. Setting AF_OPENCL_DISABLE_CACHE turns it off. The least
+// recently used programs are removed when the files take more than
+// AF_OPENCL_CACHE_SIZE megabytes.
+//
+// Every file holds a header, the full key and the binary of one device. The
+// key is compared when loading, so hash collisions only cost a rebuild.
+// Files are written under a temporary name and renamed, so concurrent
+// processes never read partial binaries.
+
+namespace opencl
+{
+
+static const char CACHE_MAGIC[]   = "AFCLBIN1";
+static const char CACHE_SUFFIX[]  = ".clbin";
+static const size_t CACHE_DEFAULT_SIZE_MB = 512;
+
+typedef unsigned long long hash_t;
+
+// 64 bit FNV-1a, which is the same for every platform and run
+static hash_t hashBytes(const char *data, const size_t len,
+                        hash_t h = 14695981039346656037ULL)
+{
+    for (size_t i = 0; i < len; i++) {
+        h ^= (unsigned char)data[i];
+        h *= 1099511628211ULL;
+    }
+    return h;
+}
+
+static string toHex(const hash_t val)
+{
+    char buf[17];
+    snprintf(buf, sizeof(buf), "%016llx", val);
+    return string(buf);
+}
+
+static bool makeDir(const string &path)
+{
+#if defined(_WIN32)
+    return _mkdir(path.c_str()) == 0 || errno == EEXIST;
+#else
+    return mkdir(path.c_str(), 0755) == 0 || errno == EEXIST;
+#endif
+}
+
+// Directory of the cache, empty when the cache is disabled
+static const string &getCacheDir()
+{
+    static string dir;
+    static std::once_flag flag;
+
+    std::call_once(flag, []() {
+            const char *disable = getenv("AF_OPENCL_DISABLE_CACHE");
+            if (disable != nullptr && std::strncmp(disable, "0", 1) != 0) return;
+
+            string path;
+            const char *env = getenv("AF_OPENCL_CACHE_DIR");
+            if (env != nullptr) {
+                path = env;
+                if (path.empty() || !makeDir(path)) return;
+            } else {
+#if defined(_WIN32)
+                const char *home = getenv("LOCALAPPDATA");
+#else
+                const char *home = getenv("HOME");
+#endif
+                if (home == nullptr) return;
+                path = string(home) + "/.arrayfire";
+                if (!makeDir(path)) return;
+                path += "/opencl";
+                if (!makeDir(path)) return;
+            }
+            dir = path;
+        });
+
+    return dir;
+}
+
+static hash_t getCacheLimit()
+{
+    hash_t mb = CACHE_DEFAULT_SIZE_MB;
+    const char *env = getenv("AF_OPENCL_CACHE_SIZE");
+    if (env != nullptr) mb = strtoull(env, nullptr, 10);
+    return mb << 20;
+}
+
+static string getCacheFile(const string &dir, const string &key)
+{
+    return dir + "/" + toHex(hashBytes(key.data(), key.size())) + CACHE_SUFFIX;
+}
+
+struct CacheFile
+{
+    string path;
+    hash_t size;
+    hash_t time;
+};
+
+static vector<CacheFile> listCache(const string &dir)
+{
+    vector<CacheFile> files;
+#if defined(_WIN32)
+    WIN32_FIND_DATAA data;
+    HANDLE h = FindFirstFileA((dir + "/*" + CACHE_SUFFIX).c_str(), &data);
+    if (h == INVALID_HANDLE_VALUE) return files;
+    do {
+        CacheFile f;
+        f.path = dir + "/" + data.cFileName;
+        f.size = ((hash_t)data.nFileSizeHigh << 32) | data.nFileSizeLow;
+        f.time = ((hash_t)data.ftLastWriteTime.dwHighDateTime << 32) |
+                 data.ftLastWriteTime.dwLowDateTime;
+        files.push_back(f);
+    } while (FindNextFileA(h, &data));
+    FindClose(h);
+#else
+    DIR *d = opendir(dir.c_str());
+    if (d == nullptr) return files;
+
+    const size_t slen = strlen(CACHE_SUFFIX);
+    while (struct dirent *entry = readdir(d)) {
+        const string name(entry->d_name);
+        if (name.size() <= slen ||
+            name.compare(name.size() - slen, slen, CACHE_SUFFIX) != 0) continue;
+
+        CacheFile f;
+        f.path = dir + "/" + name;
+        struct stat st;
+        if (stat(f.path.c_str(), &st) != 0) continue;
+        f.size = st.st_size;
+        f.time = st.st_mtime;
+        files.push_back(f);
+    }
+    closedir(d);
+#endif
+    return files;
+}
+
+// Removes the least recently used files until the cache fits its limit.
+// Returns the size of the files that are left.
+static hash_t trimCache(const string &dir)
+{
+    vector<CacheFile> files = listCache(dir);
+
+    hash_t total = 0;
+    for (size_t i = 0; i < files.size(); i++) total += files[i].size;
+
+    const hash_t limit = getCacheLimit();
+    if (total <= limit) return total;
+
+    std::sort(files.begin(), files.end(),
+              [](const CacheFile &a, const CacheFile &b) { return a.time < b.time; });
+
+    for (size_t i = 0; i < files.size() && total > limit; i++) {
+        if (std::remove(files[i].path.c_str()) == 0) total -= files[i].size;
+    }
+    return total;
+}
+
+// Accounts for a file of bytes written to the cache. The directory is listed
+// on the first write of the process, and again only when the writes push the
+// cache over its limit. Files written by other processes are not counted, so
+// they are trimmed on a later write.
+static void addToCache(const string &dir, const hash_t bytes)
+{
+    static std::mutex mutex;
+    static bool listed = false;
+    static hash_t total = 0;
+
+    std::lock_guard<std::mutex> lock(mutex);
+    if (listed) total += bytes;
+    if (!listed || total > getCacheLimit()) total = trimCache(dir);
+    listed = true;
+}
+
+// Marks a file as recently used
+static void touchFile(const string &file)
+{
+#if defined(_WIN32)
+    _utime(file.c_str(), nullptr);
+#else
+    utime(file.c_str(), nullptr);
+#endif
+}
+
+static string tempFileName(const string &file)
+{
+    static std::atomic<unsigned> counter(0);
+#if defined(_WIN32)
+    const int pid = _getpid();
+#else
+    const int pid = getpid();
+#endif
+    std::ostringstream name;
+    name << file << ".tmp." << pid << "." << counter++;
+    return name.str();
+}
+
+string getProgramCacheKey(const Program::Sources &sources, const string &options)
+{
+    const cl::Device &device = getDevice();
+    const cl::Platform platform = device.getInfo<CL_DEVICE_PLATFORM>();
+
+    hash_t h = 14695981039346656037ULL;
+    size_t len = 0;
+    for (size_t i = 0; i < sources.size(); i++) {
+        h = hashBytes(sources[i].first, sources[i].second, h);
+        len += sources[i].second;
+    }
+
+    std::ostringstream key;
+    key << platform.getInfo<CL_PLATFORM_NAME>()   << "\n"
+        << platform.getInfo<CL_PLATFORM_VERSION>() << "\n"
+        << device.getInfo<CL_DEVICE_NAME>()       << "\n"
+        << device.getInfo<CL_DEVICE_VERSION>()    << "\n"
+        << device.getInfo<CL_DRIVER_VERSION>()    << "\n"
+        << options << "\n"
+        << len << " " << toHex(h);
+    return key.str();
+}
+
+bool loadCachedProgram(Program &prog, const string &key, const string &options)
+{
+    const string &dir = getCacheDir();
+    if (dir.empty()) return false;
+
+    const string file = getCacheFile(dir, key);
+    std::ifstream in(file.c_str(), std::ios::binary);
+    if (!in) return false;
+
+    char magic[sizeof(CACHE_MAGIC)];
+    hash_t keyLen = 0, binLen = 0;
+    in.read(magic, sizeof(magic));
+    in.read((char *)&keyLen, sizeof(keyLen));
+    if (!in || std::memcmp(magic, CACHE_MAGIC, sizeof(magic)) != 0) return false;
+    if (keyLen != key.size()) return false;
+
+    string stored(keyLen, '\0');
+    in.read(&stored[0], keyLen);
+    in.read((char *)&binLen, sizeof(binLen));
+    if (!in || stored != key || binLen == 0) return false;
+
+    vector<char> binary(binLen);
+    in.read(&binary.front(), binLen);
+    if (!in) return false;
+
+    try {
+        vector<cl::Device> devices(1, getDevice());
+        Program::Binaries binaries(1, std::make_pair((const void *)&binary.front(),
+                                                     (size_t)binLen));
+        Program cached(getContext(), devices, binaries);
+        cached.build(devices, options.c_str());
+        prog = cached;
+    } catch (const cl::Error &) {
+        // Binaries the driver does not accept any more are rebuilt
+        return false;
+    }
+
+    touchFile(file);
+    return true;
+}
+
+void saveCachedProgram(const Program &prog, const string &key)
+{
+    const string &dir = getCacheDir();
+    if (dir.empty()) return;
+
+    vector<char *> binaries;
+    hash_t written = 0;
+    try {
+        // The program is built for the active device only, and the context
+        // may hold others, which have empty binaries
+        const vector<cl::Device> devices = prog.getInfo<CL_PROGRAM_DEVICES>();
+        binaries = prog.getInfo<CL_PROGRAM_BINARIES>();
+        const vector<size_t> sizes = prog.getInfo<CL_PROGRAM_BINARY_SIZES>();
+
+        size_t d = 0;
+        while (d < devices.size() && devices[d]() != getDevice()()) d++;
+
+        if (d < binaries.size() && d < sizes.size() && sizes[d] > 0) {
+            const string file = getCacheFile(dir, key);
+            const string temp = tempFileName(file);
+
+            const hash_t keyLen = key.size();
+            const hash_t binLen = sizes[d];
+            std::ofstream out(temp.c_str(), std::ios::binary);
+            out.write(CACHE_MAGIC, sizeof(CACHE_MAGIC));
+            out.write((const char *)&keyLen, sizeof(keyLen));
+            out.write(key.data(), keyLen);
+            out.write((const char *)&binLen, sizeof(binLen));
+            out.write(binaries[d], binLen);
+            out.close();
+
+            // Another process may have stored the same program already
+            if (!out || std::rename(temp.c_str(), file.c_str()) != 0) {
+                std::remove(temp.c_str());
+            } else {
+                written = sizeof(CACHE_MAGIC) + 2 * sizeof(hash_t) + keyLen + binLen;
+            }
+        }
+    } catch (const cl::Error &) {
+    }
+
+    for (size_t i = 0; i < binaries.size(); i++) delete[] binaries[i];
+
+    if (written > 0) addToCache(dir, written);
+}
+
+}
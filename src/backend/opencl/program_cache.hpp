@@ -0,0 +1,31 @@
+/*******************************************************
+ * Copyright (c) 2015, ArrayFire
+ * All rights reserved.
+ *
+ * This file is distributed under 3-clause BSD license.
+ * The complete license agreement can be obtained at:
+ * http://arrayfire.com/licenses/BSD-3-Clause
+ ********************************************************/
+
+#pragma once
+#include <platform.hpp>
+#include <string>
+
+namespace opencl
+{
+    // Compiled programs are kept on disk, in files named after a hash of
+    // their sources, build options, device and driver. The cache is shared
+    // by the kernels of the library and the JIT kernels.
+
+    // Key of a program built from sources with options for the active device
+    std::string getProgramCacheKey(const cl::Program::Sources &sources,
+                                   const std::string &options);
+
+    // Builds prog from the binary cached for key. Returns false when there is
+    // no usable binary, which leaves prog unchanged.
+    bool loadCachedProgram(cl::Program &prog, const std::string &key,
+                           const std::string &options);
+
+    // Stores the binary of prog, built for the active device, under key
+    void saveCachedProgram(const cl::Program &prog, const std::string &key);
+}
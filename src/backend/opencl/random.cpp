@@ -75,4 +75,14 @@ namespace opencl
         uintl lo = kernel::random_seed[1];
         return hi << 32 | lo;
     }
+
+    void setRandomCounter(const uintl counter)
+    {
+        kernel::counter = counter;
+    }
+
+    uintl getRandomCounter()
+    {
+        return kernel::counter;
+    }
 }
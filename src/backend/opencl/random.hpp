@@ -20,4 +20,7 @@ namespace opencl
 
     void setSeed(const uintl seed);
     uintl getSeed();
+
+    void setRandomCounter(const uintl counter);
+    uintl getRandomCounter();
 }
@@ -23,10 +23,18 @@ namespace opencl
 template<typename T>
 Array<T> regions(const Array<char> &in, af_connectivity connectivity)
 {
+    if (connectivity == AF_CONNECTIVITY_6 || connectivity == AF_CONNECTIVITY_26) {
+        OPENCL_NOT_SUPPORTED();
+    }
     ARG_ASSERT(2, (connectivity==AF_CONNECTIVITY_4 || connectivity==AF_CONNECTIVITY_8));
 
     const af::dim4 dims = in.dims();
 
+    // The kernels label a single image
+    if (dims[2] > 1) {
+        AF_ERROR("regions can not be used in batch mode", AF_ERR_BATCH);
+    }
+
     Array<T> out  = createEmptyArray<T>(dims);
 
     switch(connectivity) {
@@ -36,13 +44,25 @@ Array<T> regions(const Array<char> &in, af_connectivity connectivity)
         case AF_CONNECTIVITY_8:
             kernel::regions<T, true,  2>(out, in);
             break;
+        default:
+            break;
     }
 
     return out;
 }
 
+template<typename T>
+Array<T> regions(Array<uint> &area, Array<uint> &bbox, Array<float> &centroid,
+                 const Array<char> &in, af_connectivity connectivity)
+{
+    OPENCL_NOT_SUPPORTED();
+}
+
 #define INSTANTIATE(T)                                                                  \
-    template Array<T> regions<T>(const Array<char> &in, af_connectivity connectivity);
+    template Array<T> regions<T>(const Array<char> &in, af_connectivity connectivity);  \
+    template Array<T> regions<T>(Array<uint> &area, Array<uint> &bbox,                  \
+                                 Array<float> &centroid, const Array<char> &in,         \
+                                 af_connectivity connectivity);
 
 INSTANTIATE(float )
 INSTANTIATE(double)
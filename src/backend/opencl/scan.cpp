@@ -21,8 +21,15 @@
 namespace opencl
 {
     template<af_op_t op, typename Ti, typename To>
-    Array<To> scan(const Array<Ti>& in, const int dim)
+    Array<To> scan(const Array<Ti>& in, const int dim, bool inclusive_scan)
     {
+        // The kernels combine the results of their blocks with additions, so
+        // exclusive scans and the other operations are only done by the CPU
+        // backend
+        if (!inclusive_scan || (op != af_add_t && op != af_notzero_t)) {
+            OPENCL_NOT_SUPPORTED();
+        }
+
         Array<To> out = createEmptyArray<To>(in.dims());
 
         try {
@@ -43,7 +50,17 @@ namespace opencl
     }
 
 #define INSTANTIATE(ROp, Ti, To)                                        \
-    template Array<To> scan<ROp, Ti, To>(const Array<Ti>& in, const int dim); \
+    template Array<To> scan<ROp, Ti, To>(const Array<Ti>& in, const int dim, bool inclusive_scan); \
+
+#define INSTANTIATE_SCAN_OP(ROp)                \
+    INSTANTIATE(ROp, float  , float  )          \
+    INSTANTIATE(ROp, double , double )          \
+    INSTANTIATE(ROp, cfloat , cfloat )          \
+    INSTANTIATE(ROp, cdouble, cdouble)          \
+    INSTANTIATE(ROp, int    , int    )          \
+    INSTANTIATE(ROp, uint   , uint   )          \
+    INSTANTIATE(ROp, uchar  , uint   )          \
+    INSTANTIATE(ROp, char   , uint   )
 
     //accum
     INSTANTIATE(af_add_t, float  , float  )
@@ -55,4 +72,8 @@ namespace opencl
     INSTANTIATE(af_add_t, char   , int    )
     INSTANTIATE(af_add_t, uchar  , uint   )
     INSTANTIATE(af_notzero_t, char  , uint)
+
+    INSTANTIATE_SCAN_OP(af_mul_t)
+    INSTANTIATE_SCAN_OP(af_min_t)
+    INSTANTIATE_SCAN_OP(af_max_t)
 }
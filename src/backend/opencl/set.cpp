@@ -136,10 +136,37 @@ namespace opencl
         }
     }
 
+    template<typename T>
+    Array<T> setUnique(Array<uint> &idx, const Array<T> &in, const bool in_order)
+    {
+        OPENCL_NOT_SUPPORTED();
+    }
+
+    template<typename T>
+    Array<T> setUnion(Array<uint> &idx, const Array<T> &first, const Array<T> &second,
+                      const bool in_order)
+    {
+        OPENCL_NOT_SUPPORTED();
+    }
+
+    template<typename T>
+    Array<T> setIntersect(Array<uint> &first_idx, Array<uint> &second_idx,
+                          const Array<T> &first, const Array<T> &second,
+                          const bool in_order)
+    {
+        OPENCL_NOT_SUPPORTED();
+    }
+
 #define INSTANTIATE(T)                                                  \
     template Array<T> setUnique<T>(const Array<T> &in, const bool is_sorted); \
     template Array<T> setUnion<T>(const Array<T> &first, const Array<T> &second, const bool is_unique); \
     template Array<T> setIntersect<T>(const Array<T> &first, const Array<T> &second, const bool is_unique); \
+    template Array<T> setUnique<T>(Array<uint> &idx, const Array<T> &in, const bool in_order); \
+    template Array<T> setUnion<T>(Array<uint> &idx, const Array<T> &first, const Array<T> &second, \
+                                  const bool in_order);                 \
+    template Array<T> setIntersect<T>(Array<uint> &first_idx, Array<uint> &second_idx, \
+                                      const Array<T> &first, const Array<T> &second, \
+                                      const bool in_order);             \
 
     INSTANTIATE(float)
     INSTANTIATE(double)
@@ -295,6 +295,10 @@ Array<T> triangleSolve(const Array<T> &A, const Array<T> &b, const af_mat_prop o
 template<typename T>
 Array<T> solve(const Array<T> &a, const Array<T> &b, const af_mat_prop options)
 {
+    if (a.ndims() > 2 || b.ndims() > 2) {
+        AF_ERROR("solve can not be used in batch mode", AF_ERR_BATCH);
+    }
+
     try {
         initBlas();
 
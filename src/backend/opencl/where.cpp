@@ -28,8 +28,16 @@ namespace opencl
     }
 
 
+    template<typename T, typename I>
+    Array<I> where(Array<T> *vals, const Array<T> &in)
+    {
+        OPENCL_NOT_SUPPORTED();
+    }
+
 #define INSTANTIATE(T)                                  \
     template Array<uint> where<T>(const Array<T> &in);  \
+    template Array<uint > where<T, uint >(Array<T> *vals, const Array<T> &in); \
+    template Array<uintl> where<T, uintl>(Array<T> *vals, const Array<T> &in); \
 
     INSTANTIATE(float  )
     INSTANTIATE(cfloat )
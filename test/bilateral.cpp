@@ -201,3 +201,95 @@ TEST(bilateral, GFOR)
         ASSERT_EQ(max<double>(abs(c_ii - b_ii)) < 1E-5, true);
     }
 }
+
+///////////////////////////////// Approximate /////////////////////////////
+//
+// A step edge between two noisy flat regions
+static af::array stepImage(const dim_t w, const dim_t h, const dim_t c = 1)
+{
+    af::array x = af::range(af::dim4(w, h, c), 0);
+    return 50 + 150 * (x > w / 2).as(f32) + 10 * af::randn(w, h, c);
+}
+
+static bool isApproxSupported()
+{
+    af_array out = 0;
+    af::array in = af::randu(8, 8);
+    return isSupported(af_bilateral_approx(&out, in.get(), 2.f, 10.f, false), out);
+}
+
+TEST(BilateralApprox, MatchesExact)
+{
+    if (!isApproxSupported()) return;
+
+    const float sigmas[] = {1.5f, 3.f, 6.f, 11.f};
+    af::array in = stepImage(160, 120);
+
+    for (int i = 0; i < 4; i++) {
+        af::array exact  = af::bilateral(in, sigmas[i], 30.f);
+        af::array approx = af::bilateralApprox(in, sigmas[i], 30.f);
+        ASSERT_EQ(in.dims(), approx.dims());
+
+        // Away from the image borders, where the exact filter clamps
+        af::array diff = af::abs(exact - approx)(af::seq(20, 139), af::seq(20, 99));
+        ASSERT_LT(af::mean<float>(diff), 1.f) << "sigma: " << sigmas[i];
+    }
+}
+
+TEST(BilateralApprox, PreservesEdges)
+{
+    if (!isApproxSupported()) return;
+
+    // Sigmas far beyond the window of the exact filter
+    af::array in = stepImage(200, 100, 3);
+    af::array out = af::bilateralApprox(in, 40.f, 30.f, true);
+    ASSERT_EQ(in.dims(), out.dims());
+
+    af::array left  = out(af::seq(0, 94), af::span, af::span);
+    af::array right = out(af::seq(106, 199), af::span, af::span);
+    ASSERT_LT(af::max<float>(af::abs(left - 50)), 5.f);
+    ASSERT_LT(af::max<float>(af::abs(right - 200)), 5.f);
+}
+
+TEST(BilateralApprox, Types)
+{
+    if (!isApproxSupported()) return;
+
+    af::array in = af::round(stepImage(64, 48));
+    af::array gold = af::bilateralApprox(in, 4.f, 30.f);
+    ASSERT_LT(af::max<float>(af::abs(gold - af::bilateralApprox(in.as(u8), 4.f, 30.f))), 1e-3);
+    ASSERT_LT(af::max<float>(af::abs(gold - af::bilateralApprox(in.as(s32), 4.f, 30.f))), 1e-3);
+}
+
+TEST(BilateralApprox, NonFinite)
+{
+    if (!isApproxSupported()) return;
+
+    af::array in = stepImage(64, 48);
+    af::array gold = af::bilateralApprox(in, 4.f, 30.f);
+
+    const float nan = af::NaN, inf = af::Inf;
+    af::array bad = in.copy();
+    bad(3, 5)   = nan;
+    bad(40, 20) = inf;
+    bad(60, 30) = -inf;
+
+    af::array out = af::bilateralApprox(bad, 4.f, 30.f);
+    std::vector<float> h(out.elements());
+    out.host(&h.front());
+
+    // Non-finite pixels pass through and leave the others alone
+    ASSERT_TRUE(std::isnan(h[3 + 5 * 64]));
+    ASSERT_EQ(inf, h[40 + 20 * 64]);
+    ASSERT_EQ(-inf, h[60 + 30 * 64]);
+
+    std::vector<float> g(gold.elements());
+    gold.host(&g.front());
+    int finite = 0;
+    for (size_t i = 0; i < h.size(); i++) {
+        if (!std::isfinite(h[i])) continue;
+        ASSERT_LT(std::abs(g[i] - h[i]), 1.f) << "at " << i;
+        finite++;
+    }
+    ASSERT_EQ(64 * 48 - 3, finite);
+}
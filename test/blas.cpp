@@ -240,3 +240,135 @@ TYPED_TEST(MatrixMultiply, MultiGPURectangleVector_CPP)
         cppMatMulCheck<TypeParam, true>(TEST_DIR"/blas/RectangleVector.test");
     }
 }
+
+// Only the CPU backend supports batched matmul
+static bool isBatchedMatmulSupported()
+{
+    af::array a = af::randu(2, 2, 2);
+    af_array out = 0;
+    return isSupported(af_matmul(&out, a.get(), a.get(), AF_MAT_NONE, AF_MAT_NONE), out);
+}
+
+template<typename T>
+void batchedMatmulCheck(const int M, const int N, const int K,
+                        const af::dim4 lBatch, const af::dim4 rBatch,
+                        const af_mat_prop optLhs, const af_mat_prop optRhs)
+{
+    if (noDoubleTests<T>()) return;
+    if (!isBatchedMatmulSupported()) return;
+
+    af::dtype ty = (af::dtype)af::dtype_traits<T>::af_type;
+    const bool lTrans = optLhs != AF_MAT_NONE;
+    const bool rTrans = optRhs != AF_MAT_NONE;
+
+    af::array a = af::randu(lTrans ? K : M, lTrans ? M : K, lBatch[2], lBatch[3], ty);
+    af::array b = af::randu(rTrans ? N : K, rTrans ? K : N, rBatch[2], rBatch[3], ty);
+    af::array c = af::matmul(a, b, optLhs, optRhs);
+
+    const int batch2 = std::max(lBatch[2], rBatch[2]);
+    const int batch3 = std::max(lBatch[3], rBatch[3]);
+    ASSERT_EQ(af::dim4(M, N, batch2, batch3), c.dims());
+
+    for (int j = 0; j < batch3; j++) {
+        for (int i = 0; i < batch2; i++) {
+            af::array ai = a(af::span, af::span, lBatch[2] == 1 ? 0 : i, lBatch[3] == 1 ? 0 : j);
+            af::array bi = b(af::span, af::span, rBatch[2] == 1 ? 0 : i, rBatch[3] == 1 ? 0 : j);
+            af::array gold = af::matmul(ai, bi, optLhs, optRhs);
+            af::array diff = af::abs(c(af::span, af::span, i, j) - gold);
+            ASSERT_LT(af::max<double>(diff), 1e-3) << "at batch: " << i << ", " << j;
+        }
+    }
+}
+
+TYPED_TEST(MatrixMultiply, Batched)
+{
+    batchedMatmulCheck<TypeParam>(8, 5, 7, af::dim4(1, 1, 3, 2), af::dim4(1, 1, 3, 2),
+                                  AF_MAT_NONE, AF_MAT_NONE);
+}
+
+TYPED_TEST(MatrixMultiply, BatchedLarge)
+{
+    batchedMatmulCheck<TypeParam>(40, 33, 20, af::dim4(1, 1, 4), af::dim4(1, 1, 4),
+                                  AF_MAT_NONE, AF_MAT_NONE);
+}
+
+TYPED_TEST(MatrixMultiply, BatchedTranspose)
+{
+    batchedMatmulCheck<TypeParam>(6, 4, 3, af::dim4(1, 1, 5), af::dim4(1, 1, 5),
+                                  AF_MAT_TRANS, AF_MAT_CTRANS);
+    batchedMatmulCheck<TypeParam>(30, 20, 25, af::dim4(1, 1, 3), af::dim4(1, 1, 3),
+                                  AF_MAT_CTRANS, AF_MAT_TRANS);
+}
+
+TYPED_TEST(MatrixMultiply, BatchedBroadcast)
+{
+    batchedMatmulCheck<TypeParam>(4, 4, 4, af::dim4(1, 1, 1, 3), af::dim4(1, 1, 6, 3),
+                                  AF_MAT_NONE, AF_MAT_NONE);
+    batchedMatmulCheck<TypeParam>(32, 1, 24, af::dim4(1, 1, 5), af::dim4(1, 1, 1),
+                                  AF_MAT_NONE, AF_MAT_NONE);
+}
+
+TEST(MatrixMultiply, BatchedMismatch)
+{
+    af::array a = af::randu(3, 3, 2);
+    af::array b = af::randu(3, 3, 3);
+    af_array out = 0;
+    ASSERT_EQ(AF_ERR_SIZE, af_matmul(&out, a.get(), b.get(), AF_MAT_NONE, AF_MAT_NONE));
+}
+
+template<typename T>
+class DotProduct : public ::testing::Test
+{
+
+};
+
+TYPED_TEST_CASE(DotProduct, TestTypes);
+
+template<typename T>
+T conjugate(T in) { return in; }
+
+template<>
+af::cfloat conjugate(af::cfloat in) { return af::cfloat(real(in), -imag(in)); }
+
+template<>
+af::cdouble conjugate(af::cdouble in) { return af::cdouble(real(in), -imag(in)); }
+
+template<typename T>
+void dotCheck(const af_mat_prop optLhs, const af_mat_prop optRhs)
+{
+    if (noDoubleTests<T>()) return;
+
+    const int N = 1000;
+    af::dtype ty = (af::dtype)af::dtype_traits<T>::af_type;
+    af::array a = af::randu(N, ty);
+    af::array b = af::randu(N, ty);
+    af::array c = af::dot(a, b, optLhs, optRhs);
+
+    vector<T> ha(N), hb(N);
+    a.host(&ha.front());
+    b.host(&hb.front());
+
+    T gold = T(0);
+    for (int i = 0; i < N; i++) {
+        T l = optLhs == AF_MAT_CONJ ? conjugate(ha[i]) : ha[i];
+        T r = optRhs == AF_MAT_CONJ ? conjugate(hb[i]) : hb[i];
+        gold = gold + l * r;
+    }
+
+    T out;
+    c.host(&out);
+    ASSERT_NEAR(real(gold), real(out), 1e-2);
+    ASSERT_NEAR(imag(gold), imag(out), 1e-2);
+}
+
+TYPED_TEST(DotProduct, Basic)
+{
+    dotCheck<TypeParam>(AF_MAT_NONE, AF_MAT_NONE);
+}
+
+TYPED_TEST(DotProduct, Conjugate)
+{
+    dotCheck<TypeParam>(AF_MAT_CONJ, AF_MAT_NONE);
+    dotCheck<TypeParam>(AF_MAT_NONE, AF_MAT_CONJ);
+    dotCheck<TypeParam>(AF_MAT_CONJ, AF_MAT_CONJ);
+}
@@ -85,3 +85,66 @@ CHOLESKY_BIG_TESTS(float, 0.05)
 CHOLESKY_BIG_TESTS(double, 1E-8)
 CHOLESKY_BIG_TESTS(cfloat, 0.05)
 CHOLESKY_BIG_TESTS(cdouble, 1E-8)
+
+template<typename T>
+void choleskyBatchTester(const int n, const int batch, double eps, bool is_upper)
+{
+    if (noDoubleTests<T>()) return;
+
+    af::dtype ty = (af::dtype)af::dtype_traits<T>::af_type;
+
+    // Prepare positive definite matrices
+    af::array in = af::constant(0, n, n, batch, ty);
+    for (int i = 0; i < batch; i++) {
+        af::array a = cpu_randu<T>(af::dim4(n, n));
+        in(af::span, af::span, i) = matmul(a.H(), a) + n * af::identity(n, n, ty);
+    }
+
+    af_array out = 0;
+    int info = -1;
+    af_err err = af_cholesky(&out, &info, in.get(), is_upper);
+    // Stacks of matrices are only factored by the CPU backend
+    if (err == AF_ERR_BATCH) return;
+    ASSERT_EQ(AF_SUCCESS, err);
+    ASSERT_EQ(0, info);
+
+    af::array res(out);
+    ASSERT_EQ(af::dim4(n, n, batch), res.dims());
+
+    for (int i = 0; i < batch; i++) {
+        af::array outi = res(af::span, af::span, i);
+        af::array ini = in(af::span, af::span, i);
+        af::array re = is_upper ? matmul(outi.H(), outi) : matmul(outi, outi.H());
+
+        ASSERT_NEAR(0, af::max<double>(af::abs(real(ini - re))), eps);
+        ASSERT_NEAR(0, af::max<double>(af::abs(imag(ini - re))), eps);
+    }
+
+    // The first matrix that is not positive definite is reported
+    in(0, 0, batch - 1) = -1;
+    ASSERT_EQ(AF_SUCCESS, af_cholesky_inplace(&info, in.get(), is_upper));
+    ASSERT_EQ(1, info);
+}
+
+#define CHOLESKY_BATCH_TESTS(T, eps)                    \
+    TEST(Cholesky, T##BatchSmallUpper)                  \
+    {                                                   \
+        choleskyBatchTester<T>(6, 100, eps, true );     \
+    }                                                   \
+    TEST(Cholesky, T##BatchSmallLower)                  \
+    {                                                   \
+        choleskyBatchTester<T>(5, 100, eps, false);     \
+    }                                                   \
+    TEST(Cholesky, T##BatchUpper)                       \
+    {                                                   \
+        choleskyBatchTester<T>(40, 5, eps, true );      \
+    }                                                   \
+    TEST(Cholesky, T##BatchLower)                       \
+    {                                                   \
+        choleskyBatchTester<T>(40, 5, eps, false);      \
+    }                                                   \
+
+CHOLESKY_BATCH_TESTS(float, 0.05)
+CHOLESKY_BATCH_TESTS(double, 1E-8)
+CHOLESKY_BATCH_TESTS(cfloat, 0.05)
+CHOLESKY_BATCH_TESTS(cdouble, 1E-8)
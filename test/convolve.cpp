@@ -667,3 +667,65 @@ TEST(GFOR, convolve2_MM)
         ASSERT_EQ(max<double>(abs(c_ii - b_ii)) < 1E-5, true);
     }
 }
+
+TEST(Convolve, Auto_RankOne)
+{
+    // A rank one filter goes through the separable kernels
+    array A = randu(100, 80, 2);
+    array K = matmul(randu(7), randu(1, 5));
+
+    for (int e = 0; e < 2; e++) {
+        convMode mode = e ? AF_CONV_EXPAND : AF_CONV_DEFAULT;
+        array spatial = convolve2(A, K, mode, AF_CONV_SPATIAL);
+        array automatic = convolve2(A, K, mode, AF_CONV_AUTO);
+        ASSERT_EQ(spatial.dims(), automatic.dims());
+        ASSERT_LT(max<double>(abs(spatial - automatic)), 1E-4);
+    }
+}
+
+// Integer signals are not split, since the factors of the filter need not
+// be integers
+TEST(Convolve, Auto_RankOne_Integer)
+{
+    array A = (100 * randu(60, 50)).as(s32);
+    array K = matmul(constant(1, 3), range(dim4(1, 5), 1) + 1);
+
+    array spatial = convolve2(A, K, AF_CONV_DEFAULT, AF_CONV_SPATIAL);
+    array automatic = convolve2(A, K, AF_CONV_DEFAULT, AF_CONV_AUTO);
+    ASSERT_EQ(0u, count<unsigned>(spatial != automatic));
+}
+
+TEST(Convolve, Auto_RankOne_SubArray)
+{
+    // The separable kernels read sub arrays through their strides
+    array A = randu(40, 30, 3);
+    array K = matmul(randu(5), randu(1, 3));
+    array S = A(seq(0, 9), span, span);
+
+    array spatial = convolve2(S, K, AF_CONV_DEFAULT, AF_CONV_SPATIAL);
+    array automatic = convolve2(S, K, AF_CONV_DEFAULT, AF_CONV_AUTO);
+    ASSERT_EQ(spatial.dims(), automatic.dims());
+    ASSERT_LT(max<double>(abs(spatial - automatic)), 1E-4);
+}
+
+TEST(Convolve, Auto_Matches)
+{
+    array A1 = randu(1000);
+    array A2 = randu(64, 48, 3);
+    array A3 = randu(16, 12, 10);
+    int sizes[] = {3, 9, 21};
+
+    for (int i = 0; i < 3; i++) {
+        int w = sizes[i];
+        array K1 = randu(w * 8);
+        array K2 = randu(w, w);
+        array K3 = randu(w / 3 + 1, w / 3 + 1, w / 3 + 1);
+
+        ASSERT_LT(max<double>(abs(convolve1(A1, K1, AF_CONV_DEFAULT, AF_CONV_SPATIAL) -
+                                  convolve1(A1, K1, AF_CONV_DEFAULT, AF_CONV_AUTO))), 1E-3);
+        ASSERT_LT(max<double>(abs(convolve2(A2, K2, AF_CONV_DEFAULT, AF_CONV_SPATIAL) -
+                                  convolve2(A2, K2, AF_CONV_DEFAULT, AF_CONV_AUTO))), 1E-3);
+        ASSERT_LT(max<double>(abs(convolve3(A3, K3, AF_CONV_DEFAULT, AF_CONV_SPATIAL) -
+                                  convolve3(A3, K3, AF_CONV_DEFAULT, AF_CONV_AUTO))), 1E-3);
+    }
+}
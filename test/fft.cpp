@@ -580,3 +580,88 @@ TEST(fft3, GFOR)
     delete[] h_b;
     delete[] h_c;
 }
+
+// Real to complex transforms are only implemented on the CPU backend
+static bool isR2CSupported()
+{
+    af::array a = af::randu(4);
+    af_array out = 0;
+    return isSupported(af_fft_r2c(&out, a.get(), 1.0, 0), out);
+}
+
+template<typename T>
+void fftR2CTest(const af::array &a, int rank)
+{
+    af::array full, half;
+    switch (rank) {
+        case 1: full = af::fft (a); half = af::fftR2C (a); break;
+        case 2: full = af::fft2(a); half = af::fft2R2C(a); break;
+        case 3: full = af::fft3(a); half = af::fft3R2C(a); break;
+    }
+
+    ASSERT_EQ(a.dims(0) / 2 + 1, half.dims(0));
+    for (int i = 1; i < 4; i++) ASSERT_EQ(a.dims(i), half.dims(i));
+
+    af::array gold = full(af::seq(0, half.dims(0) - 1), af::span, af::span, af::span);
+
+    T *h_gold = gold.host<T>();
+    T *h_half = half.host<T>();
+
+    for (int i = 0; i < (int)half.elements(); i++) {
+        ASSERT_NEAR(real(h_gold[i]), real(h_half[i]), 1e-3) << "at: " << i << std::endl;
+        ASSERT_NEAR(imag(h_gold[i]), imag(h_half[i]), 1e-3) << "at: " << i << std::endl;
+    }
+
+    delete[] h_gold;
+    delete[] h_half;
+}
+
+template<typename T>
+void fftC2RTest(const af::array &a, int rank)
+{
+    const bool is_odd = a.dims(0) % 2;
+
+    af::array b;
+    switch (rank) {
+        case 1: b = af::fftC2R (af::fftR2C (a), is_odd); break;
+        case 2: b = af::fft2C2R(af::fft2R2C(a), is_odd); break;
+        case 3: b = af::fft3C2R(af::fft3R2C(a), is_odd); break;
+    }
+
+    for (int i = 0; i < 4; i++) ASSERT_EQ(a.dims(i), b.dims(i));
+
+    T *h_a = a.host<T>();
+    T *h_b = b.host<T>();
+
+    for (int i = 0; i < (int)a.elements(); i++) {
+        ASSERT_NEAR(h_a[i], h_b[i], 1e-4) << "at: " << i << std::endl;
+    }
+
+    delete[] h_a;
+    delete[] h_b;
+}
+
+TEST(fftR2C, Even)
+{
+    if (!isR2CSupported()) return;
+    fftR2CTest<cfloat>(af::randu(64, 10), 1);
+    fftR2CTest<cfloat>(af::randu(32, 16, 3), 2);
+    fftR2CTest<cdouble>(af::randu(8, 8, 8, 2, f64), 3);
+}
+
+TEST(fftR2C, Odd)
+{
+    if (!isR2CSupported()) return;
+    fftR2CTest<cfloat>(af::randu(63, 10), 1);
+    fftR2CTest<cfloat>(af::randu(31, 15, 3), 2);
+    fftR2CTest<cdouble>(af::randu(7, 9, 5, 2, f64), 3);
+}
+
+TEST(fftC2R, RoundTrip)
+{
+    if (!isR2CSupported()) return;
+    fftC2RTest<float>(af::randu(64, 10), 1);
+    fftC2RTest<float>(af::randu(63, 10), 1);
+    fftC2RTest<float>(af::randu(32, 15, 3), 2);
+    fftC2RTest<double>(af::randu(7, 9, 5, 2, f64), 3);
+}
@@ -11,6 +11,8 @@
 #include <arrayfire.h>
 #include <af/dim4.hpp>
 #include <af/traits.hpp>
+#include <algorithm>
+#include <utility>
 #include <string>
 #include <vector>
 #include <testHelpers.hpp>
@@ -152,3 +154,106 @@ TEST(HammingMatcher, CPP)
     delete[] outIdx;
     delete[] outDist;
 }
+
+///////////////////////////////// k Nearest //////////////////////////////
+//
+template<typename T>
+void hammingKNearestTest(const dim_t feat_len, const dim_t nQuery, const dim_t nTrain,
+                         const int feat_dim, const unsigned n_dist)
+{
+    using af::array;
+    using af::dim4;
+
+    const int sample_dim = (feat_dim == 0) ? 1 : 0;
+    dim4 qDims(1), tDims(1);
+    qDims[feat_dim] = feat_len; qDims[sample_dim] = nQuery;
+    tDims[feat_dim] = feat_len; tDims[sample_dim] = nTrain;
+
+    // Few distinct values so that many distances are equal
+    af_dtype ty = (af_dtype)af::dtype_traits<T>::af_type;
+    array query = (af::randu(qDims, u32) % 4).as(ty);
+    array train = (af::randu(tDims, u32) % 4).as(ty);
+
+    af_array idx = 0, dist = 0;
+    af_err err = af_hamming_matcher(&idx, &dist, query.get(), train.get(), feat_dim, n_dist);
+    if (err == AF_ERR_NOT_SUPPORTED) return;
+    ASSERT_EQ(AF_SUCCESS, err);
+
+    vector<T> hq(query.elements()), ht(train.elements());
+    query.host(&hq.front());
+    train.host(&ht.front());
+
+    vector<uint> outIdx(n_dist * nQuery), outDist(n_dist * nQuery);
+    ASSERT_EQ(AF_SUCCESS, af_get_data_ptr((void*)&outIdx.front(),  idx));
+    ASSERT_EQ(AF_SUCCESS, af_get_data_ptr((void*)&outDist.front(), dist));
+
+    for (dim_t i = 0; i < nQuery; i++) {
+        vector<std::pair<uint, uint> > gold(nTrain);
+        for (dim_t j = 0; j < nTrain; j++) {
+            uint d = 0;
+            for (dim_t k = 0; k < feat_len; k++) {
+                dim_t qi = (feat_dim == 0) ? i * feat_len + k : k * nQuery + i;
+                dim_t ti = (feat_dim == 0) ? j * feat_len + k : k * nTrain + j;
+                T v = hq[qi] ^ ht[ti];
+                for (; v; v &= v - 1) d++;
+            }
+            gold[j] = std::make_pair(d, (uint)j);
+        }
+        std::sort(gold.begin(), gold.end());
+
+        for (unsigned k = 0; k < n_dist; k++) {
+            ASSERT_EQ(gold[k].first,  outDist[i * n_dist + k]) << "at: " << i << ", " << k;
+            ASSERT_EQ(gold[k].second, outIdx [i * n_dist + k]) << "at: " << i << ", " << k;
+        }
+    }
+
+    ASSERT_EQ(AF_SUCCESS, af_release_array(idx));
+    ASSERT_EQ(AF_SUCCESS, af_release_array(dist));
+}
+
+TYPED_TEST(HammingMatcher8, KNearest_Dim0)
+{
+    hammingKNearestTest<TypeParam>(32, 100, 1500, 0, 8);
+}
+
+TYPED_TEST(HammingMatcher8, KNearest_Dim1)
+{
+    hammingKNearestTest<TypeParam>(13, 70, 600, 1, 16);
+}
+
+TYPED_TEST(HammingMatcher32, KNearest_Dim0)
+{
+    hammingKNearestTest<TypeParam>(8, 50, 1000, 0, 5);
+}
+
+TYPED_TEST(HammingMatcher32, KNearest_Dim1)
+{
+    hammingKNearestTest<TypeParam>(19, 40, 700, 1, 1);
+}
+
+TEST(HammingMatcher, EmptyInput)
+{
+    using af::array;
+
+    // Descriptors of zero length have no distance
+    array query(0, 5, u8);
+    array train(0, 7, u8);
+
+    af_array idx = 0, dist = 0;
+    ASSERT_EQ(AF_ERR_SIZE, af_hamming_matcher(&idx, &dist, query.get(), train.get(), 0, 1));
+
+    // No queries give empty results
+    query = array(8, 0, u8);
+    train = af::constant(0, 8, 7, u8);
+
+    af_err err = af_hamming_matcher(&idx, &dist, query.get(), train.get(), 0, 2);
+    if (err == AF_ERR_NOT_SUPPORTED) return;
+    ASSERT_EQ(AF_SUCCESS, err);
+
+    dim_t elems = -1;
+    ASSERT_EQ(AF_SUCCESS, af_get_elements(&elems, idx));
+    ASSERT_EQ(0, elems);
+
+    ASSERT_EQ(AF_SUCCESS, af_release_array(idx));
+    ASSERT_EQ(AF_SUCCESS, af_release_array(dist));
+}
@@ -255,3 +255,109 @@ TEST(histogram, GFOR)
         ASSERT_EQ(max<double>(abs(c_ii - b_ii)) < 1E-5, true);
     }
 }
+
+/////////////////////////////////// Host reference //////////////////////////////////
+//
+template<typename inType, typename outType>
+vector<outType> histGold(const vector<inType> &in, const vector<outType> *weights,
+                         const af::dim4 &dims, unsigned nbins, double minval, double maxval)
+{
+    float step = (maxval - minval) / (float)nbins;
+    dim_t nElems = dims[0] * dims[1];
+    vector<outType> out(nbins * dims[2] * dims[3], outType(0));
+
+    for (dim_t i = 0; i < (dim_t)in.size(); i++) {
+        double pos = (in[i] - minval) / step;
+        int bin = pos < 0 ? 0 : pos >= nbins ? (int)(nbins - 1) : (int)pos;
+        out[(i / nElems) * nbins + bin] += weights ? (*weights)[i] : outType(1);
+    }
+    return out;
+}
+
+template<typename T>
+void histBatchTest(const af::dim4 &dims, unsigned nbins, double minval, double maxval)
+{
+    if (noDoubleTests<T>()) return;
+
+    // Values above maxval go to the last bin
+    af::array in = (minval + (maxval - minval + 20) * af::randu(dims)).as(
+                        (af::dtype)af::dtype_traits<T>::af_type);
+    af::array out = histogram(in, nbins, minval, maxval);
+
+    vector<T> h_in(in.elements());
+    in.host(&h_in.front());
+    vector<uint> gold = histGold<T, uint>(h_in, NULL, dims, nbins, minval, maxval);
+
+    ASSERT_EQ(af::dim4(nbins, 1, dims[2], dims[3]), out.dims());
+    vector<uint> h_out(out.elements());
+    out.host(&h_out.front());
+    for (size_t i = 0; i < gold.size(); i++) {
+        ASSERT_EQ(gold[i], h_out[i]) << "at: " << i;
+    }
+}
+
+TYPED_TEST(Histogram, Batched)
+{
+    histBatchTest<TypeParam>(af::dim4(300, 200, 3, 2), 40, 0, 100);
+}
+
+TYPED_TEST(Histogram, LargeThreads)
+{
+    // A single batch is split over the threads
+    af::setNumThreads(4);
+    histBatchTest<TypeParam>(af::dim4(1 << 20), 100, 0, 99);
+    af::setNumThreads(0);
+}
+
+TEST(Histogram, SubArray)
+{
+    af::array in = af::round(100 * af::randu(64, 64, 3));
+    af::array sub = in(af::seq(10, 40), af::seq(5, 60), af::span);
+
+    af::array a = histogram(sub, 50, 0, 100);
+    af::array b = histogram(sub.copy(), 50, 0, 100);
+    ASSERT_EQ(0u, af::count<unsigned>(a != b));
+}
+
+template<typename wType>
+void histWeightedTest(const af::dim4 &dims, unsigned nbins, double minval, double maxval)
+{
+    if (noDoubleTests<wType>()) return;
+
+    af::array in = af::round(255 * af::randu(dims)).as(u8);
+    af::array wts = af::randu(dims, (af::dtype)af::dtype_traits<wType>::af_type);
+
+    af_array out = 0;
+    af_err err = af_histogram_weighted(&out, in.get(), wts.get(), nbins, minval, maxval);
+    if (err == AF_ERR_NOT_SUPPORTED) return;
+    ASSERT_EQ(AF_SUCCESS, err);
+    af::array hist(out);
+
+    vector<uchar> h_in(in.elements());
+    vector<wType> h_wts(wts.elements());
+    in.host(&h_in.front());
+    wts.host(&h_wts.front());
+    vector<wType> gold = histGold<uchar, wType>(h_in, &h_wts, dims, nbins, minval, maxval);
+
+    ASSERT_EQ(af::dim4(nbins, 1, dims[2], dims[3]), hist.dims());
+    vector<wType> h_out(hist.elements());
+    hist.host(&h_out.front());
+    for (size_t i = 0; i < gold.size(); i++) {
+        ASSERT_NEAR(gold[i], h_out[i], 1e-3 * gold[i]) << "at: " << i;
+    }
+}
+
+TEST(Histogram, Weighted)
+{
+    histWeightedTest<float >(af::dim4(200, 100, 3), 64, 0, 255);
+    histWeightedTest<double>(af::dim4(1000, 1000), 256, 0, 255);
+}
+
+TEST(Histogram, WeightedMismatch)
+{
+    af::array in = af::randu(10, 10);
+    af::array wts = af::randu(10, 11);
+    af_array out = 0;
+    af_err err = af_histogram_weighted(&out, in.get(), wts.get(), 10, 0, 1);
+    ASSERT_TRUE(err == AF_ERR_SIZE || err == AF_ERR_NOT_SUPPORTED);
+}
@@ -1099,6 +1099,137 @@ TYPED_TEST(IndexedMembers, MemFuncs)
 }
 
 
+TEST(SeqIndex, JIT_Expression)
+{
+    using af::array;
+    using af::seq;
+    using af::span;
+
+    const int nx = 300, ny = 40;
+    array a = af::randu(nx, ny);
+    array b = af::randu(nx, ny);
+
+    vector<float> h_a(nx * ny), h_b(nx * ny);
+    a.host(&h_a.front());
+    b.host(&h_b.front());
+
+    // Slices of an unevaluated expression, contiguous, strided and reversed
+    array c = (a * b + 1)(span, seq(3, 12));
+    array d = (a * b + 1)(seq(2, 280, 3), seq(ny - 1, 0, -2));
+    array e = (a * b + 1)(seq(nx - 1, 0, -1), 7);
+
+    ASSERT_EQ(af::dim4(nx, 10), c.dims());
+    ASSERT_EQ(af::dim4(93, 20), d.dims());
+    ASSERT_EQ(af::dim4(nx, 1) , e.dims());
+
+    vector<float> h_c(c.elements()), h_d(d.elements()), h_e(e.elements());
+    c.host(&h_c.front());
+    d.host(&h_d.front());
+    e.host(&h_e.front());
+
+    for (int j = 0; j < 10; j++) {
+        for (int i = 0; i < nx; i++) {
+            int k = (j + 3) * nx + i;
+            ASSERT_FLOAT_EQ(h_a[k] * h_b[k] + 1, h_c[j * nx + i]);
+        }
+    }
+
+    for (int j = 0; j < 20; j++) {
+        for (int i = 0; i < 93; i++) {
+            int k = (ny - 1 - 2 * j) * nx + 2 + 3 * i;
+            ASSERT_FLOAT_EQ(h_a[k] * h_b[k] + 1, h_d[j * 93 + i]);
+        }
+    }
+
+    for (int i = 0; i < nx; i++) {
+        int k = 7 * nx + nx - 1 - i;
+        ASSERT_FLOAT_EQ(h_a[k] * h_b[k] + 1, h_e[i]);
+    }
+}
+
+TEST(ArrayIndex, JIT_Expression)
+{
+    using af::array;
+    using af::span;
+
+    const int nx = 2000, ny = 3;
+    array a = af::randu(nx, ny);
+    array b = af::randu(nx, ny);
+
+    // Indices close together, far apart and out of range
+    const int num = 600;
+    vector<int> h_idx(num);
+    for (int i = 0; i < num; i++) {
+        h_idx[i] = (i < 300) ? (i * 7) % 512 : (i * 7919) % (3 * nx) - nx;
+    }
+    array idx(num, &h_idx.front());
+
+    array expr = af::sin(a) + b;
+    array c = expr(idx, span);
+    array d = expr(span, idx(af::seq(2)) % ny);
+    array f = af::lookup(expr, idx, 0);
+
+    // The same selection from the evaluated expression
+    expr.eval();
+    array gold_c = expr(idx, span);
+    array gold_d = expr(span, idx(af::seq(2)) % ny);
+
+    ASSERT_EQ(af::dim4(num, ny), c.dims());
+    ASSERT_EQ(af::dim4(nx, 2)  , d.dims());
+    ASSERT_EQ(0, af::max<float>(af::abs(c - gold_c)));
+    ASSERT_EQ(0, af::max<float>(af::abs(d - gold_d)));
+
+    vector<float> h_expr(nx * ny), h_c(num * ny), h_f(num * ny);
+    expr.host(&h_expr.front());
+    c.host(&h_c.front());
+    f.host(&h_f.front());
+
+    // Index arrays are converted to unsigned before they wrap, lookup wraps
+    // the signed values
+    for (int j = 0; j < ny; j++) {
+        for (int i = 0; i < num; i++) {
+            int v = h_idx[i];
+            dim_t u = (unsigned)v;
+            int kc = u >= nx ? nx - u % nx - 1 : u;
+            int kf = v < 0 ? (-v) % nx - 1 : (v >= nx ? nx - v % nx - 1 : v);
+            ASSERT_FLOAT_EQ(h_expr[j * nx + kc], h_c[j * num + i]);
+            ASSERT_FLOAT_EQ(h_expr[j * nx + kf], h_f[j * num + i]);
+        }
+    }
+}
+
+TEST(ArrayIndex, JIT_Cascade)
+{
+    using af::array;
+    using af::seq;
+    using af::span;
+
+    const int nx = 500, ny = 20;
+    array a = af::randu(nx, ny);
+
+    float h_inds[] = {4, 0, 11, 3, 3};
+    array inds(5, h_inds);
+
+    // Indexing the result of indexing, combined with the indexed expression
+    array b = 2 * a + 1;
+    array r = b(seq(nx - 1, 0, -1), span);
+    array c = r(seq(10, 20), inds) + b(seq(10, 20), inds);
+
+    vector<float> h_a(nx * ny), h_c(c.elements());
+    a.host(&h_a.front());
+    c.host(&h_c.front());
+
+    ASSERT_EQ(af::dim4(11, 5), c.dims());
+    for (int j = 0; j < 5; j++) {
+        for (int i = 0; i < 11; i++) {
+            int col = (int)h_inds[j];
+            float rev = 2 * h_a[col * nx + nx - 1 - (10 + i)] + 1;
+            float fwd = 2 * h_a[col * nx + 10 + i] + 1;
+            ASSERT_FLOAT_EQ(rev + fwd, h_c[j * 11 + i]);
+        }
+    }
+}
+
 TEST(Indexing, SNIPPET_indexing_first)
 {
     using namespace af;
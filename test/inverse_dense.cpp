@@ -63,3 +63,101 @@ INVERSE_TESTS(float, 0.01)
 INVERSE_TESTS(double, 1E-5)
 INVERSE_TESTS(cfloat, 0.01)
 INVERSE_TESTS(cdouble, 1E-5)
+
+template<typename T>
+void inverseBatchTester(const int n, const int batch, double eps)
+{
+    if (noDoubleTests<T>()) return;
+
+    af::dtype ty = (af::dtype)af::dtype_traits<T>::af_type;
+    af::array A = cpu_randu<T>(af::dim4(n, n, batch)) + n * af::identity(af::dim4(n, n, batch), ty);
+
+    af_array out = 0;
+    af_err err = af_inverse(&out, A.get(), AF_MAT_NONE);
+    // Stacks of matrices are only inverted by the CPU backend
+    if (err == AF_ERR_BATCH) return;
+    ASSERT_EQ(AF_SUCCESS, err);
+
+    af::array IA(out);
+    ASSERT_EQ(af::dim4(n, n, batch), IA.dims());
+
+    af::array I2 = af::identity(n, n, ty);
+
+    for (int i = 0; i < batch; i++) {
+        af::array Ai = A(af::span, af::span, i);
+        af::array IAi = IA(af::span, af::span, i);
+        af::array I = af::matmul(Ai, IAi);
+
+        ASSERT_NEAR(0, af::max<double>(af::abs(real(I - I2))), eps);
+        ASSERT_NEAR(0, af::max<double>(af::abs(imag(I - I2))), eps);
+    }
+}
+
+#define INVERSE_BATCH_TESTS(T, eps)             \
+    TEST(INVERSE, T##BatchSmall)                \
+    {                                           \
+        inverseBatchTester<T>(6, 100, eps);     \
+    }                                           \
+    TEST(INVERSE, T##Batch)                     \
+    {                                           \
+        inverseBatchTester<T>(50, 4, eps);      \
+    }                                           \
+
+INVERSE_BATCH_TESTS(float, 0.01)
+INVERSE_BATCH_TESTS(double, 1E-5)
+INVERSE_BATCH_TESTS(cfloat, 0.01)
+INVERSE_BATCH_TESTS(cdouble, 1E-5)
+
+#if defined(AF_CPU)
+// The second matrix of the stack has a zero column. Its inverse is NaN,
+// the others are inverted as usual.
+template<typename T>
+void inverseSingularTester(const int n, double eps)
+{
+    if (noDoubleTests<T>()) return;
+
+    af::dtype ty = (af::dtype)af::dtype_traits<T>::af_type;
+    af::array A = cpu_randu<T>(af::dim4(n, n, 3)) + n * af::identity(af::dim4(n, n, 3), ty);
+    A(af::span, 1, 1) = 0;
+
+    af::array IA = af::inverse(A);
+
+    af::array singular = IA(af::span, af::span, 1);
+    ASSERT_TRUE(af::allTrue<bool>(af::isNaN(real(singular))));
+
+    af::array I2 = af::identity(n, n, ty);
+    for (int i = 0; i < 3; i += 2) {
+        af::array I = af::matmul(A(af::span, af::span, i), IA(af::span, af::span, i));
+        ASSERT_NEAR(0, af::max<double>(af::abs(real(I - I2))), eps);
+    }
+}
+
+#define INVERSE_SINGULAR_TESTS(T, eps)          \
+    TEST(INVERSE, T##SingularSmall)             \
+    {                                           \
+        inverseSingularTester<T>(5, eps);       \
+    }                                           \
+    TEST(INVERSE, T##Singular)                  \
+    {                                           \
+        inverseSingularTester<T>(30, eps);      \
+    }
+
+INVERSE_SINGULAR_TESTS(float, 0.01)
+INVERSE_SINGULAR_TESTS(cdouble, 1E-5)
+
+// Empty matrices and stacks give empty results
+TEST(INVERSE, Empty)
+{
+    af::array A(af::dim4(0, 0, 1, 1));
+    ASSERT_EQ(0, (int)af::inverse(A).elements());
+    ASSERT_EQ(0, (int)af::solve(A, A).elements());
+
+    af::array S(af::dim4(0, 0, 4, 1));
+    ASSERT_EQ(0, (int)af::inverse(S).elements());
+    ASSERT_EQ(0, (int)af::solve(S, S).elements());
+
+    af::array C;
+    ASSERT_EQ(0, af::cholesky(C, S));
+    ASSERT_EQ(0, (int)C.elements());
+}
+#endif
@@ -65,3 +65,150 @@ TEST(JIT, CPP_JIT_HASH)
         delete[] hF2;
     }
 }
+
+TEST(JIT, CPP_JIT_SHARED_SUBTREE)
+{
+    using af::array;
+
+    const int num = 1000;
+
+    array a = af::randu(num);
+    array b = af::randu(num);
+
+    array d = a + b;
+    array f = d * d + d;
+
+    float *hA = a.host<float>();
+    float *hB = b.host<float>();
+    float *hF = f.host<float>();
+
+    for (int i = 0; i < num; i++) {
+        float valD = hA[i] + hB[i];
+        ASSERT_NEAR(hF[i], valD * valD + valD, 1e-5);
+    }
+
+    delete[] hA;
+    delete[] hB;
+    delete[] hF;
+}
+
+TEST(JIT, CPP_JIT_NON_LINEAR)
+{
+    using af::array;
+
+    const int nx = 1000;
+    const int ny = 10;
+
+    array a = af::randu(nx, ny);
+    array b = a(af::seq(3, 702), af::span) * 2 + 1;
+    af::dim4 bdims = b.dims();
+
+    ASSERT_EQ(700, bdims[0]);
+    ASSERT_EQ(ny , bdims[1]);
+
+    float *hA = a.host<float>();
+    float *hB = b.host<float>();
+
+    for (int y = 0; y < ny; y++) {
+        for (int x = 0; x < (int)bdims[0]; x++) {
+            ASSERT_NEAR(hB[y * bdims[0] + x], hA[y * nx + x + 3] * 2 + 1, 1e-5);
+        }
+    }
+
+    delete[] hA;
+    delete[] hB;
+}
+
+TEST(JIT, CPP_JIT_EVAL_MULTIPLE)
+{
+    using af::array;
+
+    const int nx = 1000;
+    const int ny = 10;
+
+    array a = af::randu(nx, ny);
+    array b = af::randu(nx, ny);
+    array d = a + b;
+
+    // Outputs sharing d, of another type and of other dimensions
+    array e = d * d;
+    array f = d + 2;
+    array g = (d > 1).as(s32);
+    array h = af::sum(a, 0) + 1;
+    array k = e;
+    af::eval(e, f, g, h, k);
+
+    // The trees of e and f hold the results now
+    array m = e + f;
+
+    float *hA = a.host<float>();
+    float *hB = b.host<float>();
+    float *hE = e.host<float>();
+    float *hF = f.host<float>();
+    float *hK = k.host<float>();
+    float *hM = m.host<float>();
+    int   *hG = g.host<int>();
+    float *hH = h.host<float>();
+
+    for (int i = 0; i < nx * ny; i++) {
+        float valD = hA[i] + hB[i];
+        ASSERT_NEAR(hE[i], valD * valD, 1e-5);
+        ASSERT_NEAR(hF[i], valD + 2, 1e-5);
+        ASSERT_NEAR(hK[i], valD * valD, 1e-5);
+        ASSERT_NEAR(hM[i], valD * valD + valD + 2, 1e-5);
+        ASSERT_EQ(hG[i], valD > 1 ? 1 : 0);
+    }
+
+    for (int y = 0; y < ny; y++) {
+        float valH = 1;
+        for (int x = 0; x < nx; x++) valH += hA[y * nx + x];
+        ASSERT_NEAR(hH[y], valH, 1e-2);
+    }
+
+    delete[] hA;
+    delete[] hB;
+    delete[] hE;
+    delete[] hF;
+    delete[] hK;
+    delete[] hM;
+    delete[] hG;
+    delete[] hH;
+}
+
+TEST(JIT, CPP_JIT_EVAL_MULTIPLE_INDEXED)
+{
+    using af::array;
+
+    const int nx = 1000;
+    const int ny = 10;
+
+    array a = af::randu(nx, ny);
+    array d = a * 2 + 1;
+    array e = d(af::seq(3, 702), af::span);
+    array f = d(af::seq(3, 702), af::span) - 1;
+
+    array *arrays[] = {&e, &f, &d};
+    af::eval(3, arrays);
+
+    float *hA = a.host<float>();
+    float *hD = d.host<float>();
+    float *hE = e.host<float>();
+    float *hF = f.host<float>();
+
+    for (int y = 0; y < ny; y++) {
+        for (int x = 0; x < 700; x++) {
+            float valD = hA[y * nx + x + 3] * 2 + 1;
+            ASSERT_NEAR(hE[y * 700 + x], valD, 1e-5);
+            ASSERT_NEAR(hF[y * 700 + x], valD - 1, 1e-5);
+        }
+    }
+
+    for (int i = 0; i < nx * ny; i++) {
+        ASSERT_NEAR(hD[i], hA[i] * 2 + 1, 1e-5);
+    }
+
+    delete[] hA;
+    delete[] hD;
+    delete[] hE;
+    delete[] hF;
+}
@@ -307,3 +307,81 @@ TEST(MedianFilter, GFOR)
         ASSERT_EQ(max<double>(abs(c_ii - b_ii)) < 1E-5, true);
     }
 }
+
+// Reference median filter on the host. Symmetric padding reflects the
+// indices without repeating the edge.
+template<typename T>
+static vector<T> medfiltGold(const vector<T> &in, const dim4 &dims,
+                             const int w, const af_border_type pad)
+{
+    vector<T> out(in.size());
+    vector<T> wind;
+    const int d0 = dims[0], d1 = dims[1];
+
+    for (int img = 0; img < (int)(dims[2] * dims[3]); img++) {
+        const T *iptr = &in[img * d0 * d1];
+        T *optr = &out[img * d0 * d1];
+        for (int j = 0; j < d1; j++) {
+            for (int i = 0; i < d0; i++) {
+                wind.clear();
+                for (int b = j - w / 2; b < j - w / 2 + w; b++) {
+                    for (int a = i - w / 2; a < i - w / 2 + w; a++) {
+                        bool isOff = a < 0 || a >= d0 || b < 0 || b >= d1;
+                        if (pad == AF_PAD_ZERO) {
+                            wind.push_back(isOff ? T(0) : iptr[b * d0 + a]);
+                        } else {
+                            int r = a < 0 ? -a : (a >= d0 ? 2 * (d0 - 1) - a : a);
+                            int c = b < 0 ? -b : (b >= d1 ? 2 * (d1 - 1) - b : b);
+                            wind.push_back(iptr[c * d0 + r]);
+                        }
+                    }
+                }
+                std::sort(wind.begin(), wind.end());
+                size_t off = wind.size() / 2;
+                optr[j * d0 + i] = (wind.size() % 2 == 0) ? (wind[off] + wind[off - 1]) / 2
+                                                          : wind[off];
+            }
+        }
+    }
+    return out;
+}
+
+template<typename T>
+void medfiltWindowSizesTest(const double range)
+{
+    if (noDoubleTests<T>()) return;
+
+    dim4 dims(61, 47, 2);
+    array input = (range * randu(dims, f64)).as((af_dtype)af::dtype_traits<T>::af_type);
+
+    vector<T> in(dims.elements());
+    input.host(&in.front());
+
+    for (int w = 2; w <= 15; w++) {
+        for (int p = 0; p < 2; p++) {
+            af_border_type pad = p == 0 ? AF_PAD_ZERO : AF_PAD_SYM;
+            array output = medfilt(input, w, w, pad);
+
+            vector<T> out(dims.elements());
+            output.host(&out.front());
+
+            vector<T> gold = medfiltGold(in, dims, w, pad);
+            for (size_t i = 0; i < gold.size(); i++) {
+                ASSERT_EQ(gold[i], out[i]) << "at: " << i << " window: " << w
+                                           << " pad: " << pad << std::endl;
+            }
+        }
+    }
+}
+
+TYPED_TEST(MedianFilter, WindowSizes)
+{
+    medfiltWindowSizesTest<TypeParam>(100);
+}
+
+TEST(MedianFilter, WindowSizesWideRange)
+{
+    // Values that fit in a 16 bit histogram and values that do not
+    medfiltWindowSizesTest<int>(60000);
+    medfiltWindowSizesTest<uint>(1e9);
+}
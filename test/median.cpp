@@ -107,3 +107,116 @@ MEDIAN0(float, int)
 MEDIAN0(float, uint)
 MEDIAN0(float, uchar)
 MEDIAN0(double, double)
+
+template<typename To, typename Ti>
+void medianDim(const dim4 dims, const int dim)
+{
+    if (noDoubleTests<Ti>()) return;
+    array a = randu(dims, (af::dtype)dtype_traits<Ti>::af_type);
+
+    af_array out = 0;
+    af_err err = af_median(&out, a.get(), dim);
+    if (err == AF_ERR_NOT_SUPPORTED) return;
+    ASSERT_EQ(AF_SUCCESS, err);
+    array b(out);
+
+    dim4 odims = dims;
+    odims[dim] = 1;
+    ASSERT_EQ(odims, b.dims());
+
+    vector<Ti> h_a(a.elements());
+    vector<To> h_b(b.elements());
+    a.host(&h_a.front());
+    b.host(&h_b.front());
+
+    dim4 strides(1, dims[0], dims[0] * dims[1], dims[0] * dims[1] * dims[2]);
+    const dim_t n = dims[dim];
+
+    for (dim_t i = 0; i < (dim_t)h_b.size(); i++) {
+        dim_t idx[4] = {i % odims[0], (i / odims[0]) % odims[1],
+                        (i / (odims[0] * odims[1])) % odims[2],
+                        i / (odims[0] * odims[1] * odims[2])};
+        dim_t off = idx[0] * strides[0] + idx[1] * strides[1] +
+                    idx[2] * strides[2] + idx[3] * strides[3];
+
+        vector<Ti> col(n);
+        for (dim_t k = 0; k < n; k++) col[k] = h_a[off + k * strides[dim]];
+        std::sort(col.begin(), col.end());
+
+        To gold = (n % 2) ? (To)col[n / 2] : ((To)col[n / 2 - 1] + (To)col[n / 2]) / 2;
+        ASSERT_NEAR(gold, h_b[i], 1e-6) << "at: " << i;
+    }
+}
+
+#define MEDIAN_DIM(To, Ti)                          \
+    TEST(medianDim, Ti##_dim0)                      \
+    {                                               \
+        medianDim<To, Ti>(dim4(300, 7, 5, 3), 0);   \
+    }                                               \
+    TEST(medianDim, Ti##_dim1)                      \
+    {                                               \
+        medianDim<To, Ti>(dim4(40, 501, 3, 2), 1);  \
+    }                                               \
+    TEST(medianDim, Ti##_dim2)                      \
+    {                                               \
+        medianDim<To, Ti>(dim4(17, 3, 100, 2), 2);  \
+    }                                               \
+    TEST(medianDim, Ti##_dim3)                      \
+    {                                               \
+        medianDim<To, Ti>(dim4(5, 9, 2, 64), 3);    \
+    }                                               \
+
+MEDIAN_DIM(float, float)
+MEDIAN_DIM(float, int)
+MEDIAN_DIM(float, uint)
+MEDIAN_DIM(float, uchar)
+MEDIAN_DIM(double, double)
+
+// The median of all the values of a matrix, not only of its first column
+TEST(median, all_2D)
+{
+    for (int n = 999; n <= 1000; n++) {
+        array a = randu(n, 37);
+        vector<float> h_a(a.elements());
+        a.host(&h_a.front());
+        std::sort(h_a.begin(), h_a.end());
+
+        const size_t mid = h_a.size() / 2;
+        float gold = (h_a.size() % 2) ? h_a[mid] : (h_a[mid - 1] + h_a[mid]) / 2;
+        ASSERT_EQ(gold, median<float>(a));
+    }
+}
+
+TEST(median, all_uchar_large)
+{
+    array a = randu(100001, 17, u8);
+    vector<uchar> h_a(a.elements());
+    a.host(&h_a.front());
+    std::nth_element(h_a.begin(), h_a.begin() + h_a.size() / 2, h_a.end());
+    ASSERT_EQ((float)h_a[h_a.size() / 2], median<float>(a));
+}
+
+// The median of no values is NaN, whatever the type of the input
+TEST(median, empty)
+{
+    const af::dtype types[] = {f32, s32, u32, u8};
+    for (int t = 0; t < 4; t++) {
+        array a(0, 3, types[t]);
+
+        double real = 0, imag = 0;
+        ASSERT_EQ(AF_SUCCESS, af_median_all(&real, &imag, a.get()));
+        ASSERT_TRUE(std::isnan(real));
+
+        af_array out = 0;
+        ASSERT_EQ(AF_SUCCESS, af_median(&out, a.get(), 0));
+        array b(out);
+        ASSERT_EQ(dim4(1, 3, 1, 1), b.dims());
+        vector<float> h_b(b.elements());
+        b.host(&h_b.front());
+        for (int i = 0; i < 3; i++) ASSERT_TRUE(std::isnan(h_b[i])) << "at: " << i;
+
+        ASSERT_EQ(AF_SUCCESS, af_median(&out, a.get(), 1));
+        array c(out);
+        ASSERT_EQ(dim4(0, 1, 1, 1), c.dims());
+    }
+}
@@ -0,0 +1,108 @@
+/*******************************************************
+ * Copyright (c) 2015, ArrayFire
+ * All rights reserved.
+ *
+ * This file is distributed under 3-clause BSD license.
+ * The complete license agreement can be obtained at:
+ * http://arrayfire.com/licenses/BSD-3-Clause
+ ********************************************************/
+
+#include <gtest/gtest.h>
+#include <arrayfire.h>
+#include <af/dim4.hpp>
+#include <af/device.h>
+#include <testHelpers.hpp>
+
+using af::array;
+using af::deviceGC;
+using af::deviceMemInfo;
+using af::randu;
+
+TEST(Memory, LockedCount)
+{
+    deviceGC();
+
+    size_t alloc_bytes, alloc_buffers, lock_bytes, lock_buffers;
+    deviceMemInfo(&alloc_bytes, &alloc_buffers, &lock_bytes, &lock_buffers);
+    size_t start_buffers = lock_buffers;
+
+    {
+        array a = randu(1000, 1000);
+        array b = randu(1000, 1000);
+        a.eval();
+        b.eval();
+
+        deviceMemInfo(&alloc_bytes, &alloc_buffers, &lock_bytes, &lock_buffers);
+        ASSERT_EQ(start_buffers + 2, lock_buffers);
+        ASSERT_GE(lock_bytes, 2 * 1000 * 1000 * sizeof(float));
+        ASSERT_GE(alloc_bytes, lock_bytes);
+        ASSERT_GE(alloc_buffers, lock_buffers);
+    }
+
+    deviceMemInfo(&alloc_bytes, &alloc_buffers, &lock_bytes, &lock_buffers);
+    ASSERT_EQ(start_buffers, lock_buffers);
+}
+
+TEST(Memory, Reuse)
+{
+    deviceGC();
+
+    {
+        array a = randu(1000, 1000);
+        a.eval();
+    }
+
+    size_t alloc_bytes, alloc_buffers, lock_bytes, lock_buffers;
+    deviceMemInfo(&alloc_bytes, &alloc_buffers, &lock_bytes, &lock_buffers);
+
+    // Freed buffers are handed out again instead of allocating new ones
+    for (int i = 0; i < 10; i++) {
+        array a = randu(1000, 1000);
+        a.eval();
+    }
+
+    size_t new_bytes, new_buffers;
+    deviceMemInfo(&new_bytes, &new_buffers, &lock_bytes, &lock_buffers);
+    ASSERT_EQ(alloc_bytes, new_bytes);
+    ASSERT_EQ(alloc_buffers, new_buffers);
+}
+
+TEST(Memory, GarbageCollect)
+{
+    {
+        array a = randu(1000, 1000);
+        array b = randu(2000, 1000);
+        a.eval();
+        b.eval();
+    }
+
+    deviceGC();
+
+    size_t alloc_bytes, alloc_buffers, lock_bytes, lock_buffers;
+    deviceMemInfo(&alloc_bytes, &alloc_buffers, &lock_bytes, &lock_buffers);
+    ASSERT_EQ(lock_bytes, alloc_bytes);
+    ASSERT_EQ(lock_buffers, alloc_buffers);
+}
+
+TEST(Memory, Limit)
+{
+    size_t limit = af::deviceGetMemLimit();
+
+    deviceGC();
+    af::deviceSetMemLimit(16 << 20);
+    ASSERT_EQ((size_t)(16 << 20), af::deviceGetMemLimit());
+
+    // Arrays of many different sizes would fill the cache without a limit
+    for (int i = 1; i <= 20; i++) {
+        array a = randu(1000 + 97 * i, 1000);
+        a.eval();
+    }
+
+    size_t alloc_bytes, alloc_buffers, lock_bytes, lock_buffers;
+    deviceMemInfo(&alloc_bytes, &alloc_buffers, &lock_bytes, &lock_buffers);
+
+    // Backends may go over the limit by the last allocation
+    ASSERT_LE(alloc_bytes, (size_t)(32 << 20));
+
+    af::deviceSetMemLimit(limit);
+}
@@ -409,3 +409,120 @@ TEST(Morph, GFOR)
         ASSERT_EQ(max<double>(abs(c_ii - b_ii)) < 1E-5, true);
     }
 }
+
+// Reference erosion or dilation with a flat w0 x w1 x w2 window on the host.
+// Parts of the window outside of the volume are ignored, or reflected back
+// into it when isSymmetric is set.
+static int reflectIndex(int x, int n)
+{
+    if (n == 1) return 0;
+    while (x < 0 || x >= n) x = x < 0 ? -x : 2 * (n - 1) - x;
+    return x;
+}
+
+template<typename T>
+static vector<T> flatMorphGold(const vector<T> &in, const dim4 &dims,
+                               const dim4 &window, bool isDilation, bool isSymmetric)
+{
+    vector<T> out(in.size());
+    const int d0 = dims[0], d1 = dims[1], d2 = dims[2];
+    for (int l = 0; l < (int)dims[3]; l++) {
+        const T *iptr = &in[l * d0 * d1 * d2];
+        T *optr = &out[l * d0 * d1 * d2];
+        for (int k = 0; k < d2; k++) {
+            for (int j = 0; j < d1; j++) {
+                for (int i = 0; i < d0; i++) {
+                    T res = iptr[(k * d1 + j) * d0 + i];
+                    for (int c = k - (int)window[2] / 2; c < k - (int)window[2] / 2 + (int)window[2]; c++) {
+                        for (int b = j - (int)window[1] / 2; b < j - (int)window[1] / 2 + (int)window[1]; b++) {
+                            for (int a = i - (int)window[0] / 2; a < i - (int)window[0] / 2 + (int)window[0]; a++) {
+                                int x = a, y = b, z = c;
+                                if (isSymmetric) {
+                                    x = reflectIndex(a, d0);
+                                    y = reflectIndex(b, d1);
+                                    z = reflectIndex(c, d2);
+                                } else if (a < 0 || b < 0 || c < 0 || a >= d0 || b >= d1 || c >= d2) {
+                                    continue;
+                                }
+                                T v = iptr[(z * d1 + y) * d0 + x];
+                                res = isDilation ? std::max(res, v) : std::min(res, v);
+                            }
+                        }
+                    }
+                    optr[(k * d1 + j) * d0 + i] = res;
+                }
+            }
+        }
+    }
+    return out;
+}
+
+template<typename T>
+void flatMorphTest(const dim4 &dims, const dim4 &window)
+{
+    if (noDoubleTests<T>()) return;
+
+    af::dtype ty = (af::dtype)af::dtype_traits<T>::af_type;
+    array input = (100 * randu(dims)).as(ty);
+    array mask = constant(1, window, ty);
+    const bool isVolume = window[2] > 1;
+
+    vector<T> in(dims.elements());
+    input.host(&in.front());
+
+    for (int d = 0; d < 2; d++) {
+        const bool isDilation = d == 1;
+        array output = isVolume ? (isDilation ? dilate3(input, mask) : erode3(input, mask))
+                                : (isDilation ? dilate(input, mask)  : erode(input, mask));
+
+        vector<T> out(dims.elements());
+        output.host(&out.front());
+
+        vector<T> gold = flatMorphGold(in, dims, window, isDilation, false);
+        for (size_t i = 0; i < gold.size(); i++) {
+            ASSERT_EQ(gold[i], out[i]) << "at: " << i << " dilation: " << isDilation << std::endl;
+        }
+    }
+}
+
+TYPED_TEST(Morph, FlatMask)
+{
+    flatMorphTest<TypeParam>(dim4(50, 37, 2), dim4(3, 3));
+    flatMorphTest<TypeParam>(dim4(50, 37, 2), dim4(4, 6));
+    flatMorphTest<TypeParam>(dim4(50, 37, 2), dim4(15, 15));
+    flatMorphTest<TypeParam>(dim4(10, 12), dim4(31, 31));
+}
+
+TYPED_TEST(Morph, FlatMaskVolume)
+{
+    flatMorphTest<TypeParam>(dim4(20, 17, 9), dim4(3, 5, 4));
+    flatMorphTest<TypeParam>(dim4(20, 17, 9, 2), dim4(7, 7, 7));
+}
+
+TEST(Morph, MinMaxFiltSymmetric)
+{
+    dim4 dims(30, 21, 2);
+    array input = randu(dims);
+    vector<float> in(dims.elements());
+    input.host(&in.front());
+
+    for (int w = 2; w <= 33; w += 5) {
+        af_array tmp = 0;
+        af_err err = af_minfilt(&tmp, input.get(), w, w, AF_PAD_SYM);
+        if (err == AF_ERR_NOT_SUPPORTED) return;
+        ASSERT_EQ(AF_SUCCESS, err);
+        array minOut(tmp);
+        array maxOut = maxfilt(input, w, w, AF_PAD_SYM);
+
+        vector<float> mn(dims.elements()), mx(dims.elements());
+        minOut.host(&mn.front());
+        maxOut.host(&mx.front());
+
+        vector<float> mnGold = flatMorphGold(in, dims, dim4(w, w), false, true);
+        vector<float> mxGold = flatMorphGold(in, dims, dim4(w, w), true, true);
+        for (size_t i = 0; i < mn.size(); i++) {
+            ASSERT_EQ(mnGold[i], mn[i]) << "at: " << i << " window: " << w << std::endl;
+            ASSERT_EQ(mxGold[i], mx[i]) << "at: " << i << " window: " << w << std::endl;
+        }
+    }
+}
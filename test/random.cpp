@@ -257,3 +257,70 @@ TYPED_TEST(Random, getSeed)
 {
     testGetSeed<TypeParam>(1234, 9876);
 }
+
+TEST(Random, setRandomCounter)
+{
+    const int num = 1024;
+
+    af::setSeed(1);
+    af::setRandomCounter(1 << 20);
+    af::array a = af::randu(num);
+
+    // Arrays generated after setting the same seed and counter are equal
+    // whatever was generated before
+    af::setSeed(1);
+    af::array b = af::randu(3 * num);
+    af::setRandomCounter(1 << 20);
+    af::array c = af::randu(num);
+
+    std::vector<float> h_a(num), h_c(num);
+    a.host((void *)&h_a[0]);
+    c.host((void *)&h_c[0]);
+
+    for (int i = 0; i < num; i++) {
+        ASSERT_EQ(h_a[i], h_c[i]) << "at: " << i;
+    }
+}
+
+#if defined(AF_CPU)
+// The CPU backend generates Philox4x32-10. The words of the first block of
+// seed 0 are the known answer of Random123 for a zero key and counter.
+TEST(Random, PhiloxKnownAnswer)
+{
+    const unsigned expected[] = {0x6627e8d5, 0xe169c58d, 0xbc57ac4c, 0x9b00dbd8};
+
+    af::setSeed(0);
+    af::array a = af::randu(4, u32);
+
+    unsigned h_a[4];
+    a.host((void *)h_a);
+
+    for (int i = 0; i < 4; i++) {
+        ASSERT_EQ(expected[i], h_a[i]) << "at: " << i;
+    }
+}
+#endif
+
+TEST(Random, Threads)
+{
+    const int num = 1 << 20;
+
+    // Values only depend on the seed and their position in the stream
+    af::setNumThreads(1);
+    af::setSeed(5);
+    af::array a = af::randn(num);
+
+    af::setNumThreads(4);
+    af::setSeed(5);
+    af::array b = af::randn(num);
+
+    af::setNumThreads(0);
+
+    std::vector<float> h_a(num), h_b(num);
+    a.host((void *)&h_a[0]);
+    b.host((void *)&h_b[0]);
+
+    for (int i = 0; i < num; i++) {
+        ASSERT_EQ(h_a[i], h_b[i]) << "at: " << i;
+    }
+}
@@ -13,6 +13,8 @@
 #include <af/defines.h>
 #include <af/traits.hpp>
 #include <af/image.h>
+#include <algorithm>
+#include <cstdlib>
 #include <vector>
 #include <iostream>
 #include <string>
@@ -250,3 +252,162 @@ TEST(Regions, Docs_4)
         ASSERT_EQ(gold[i], output[i])<<" mismatch at i="<<i<<std::endl;
     }
 }
+
+// Labels in by flood filling each region from its first pixel in memory
+// order. The slices of in are labelled on their own for 2d connectivity.
+static void regionsGold(vector<unsigned> &labels, vector<unsigned> &area,
+                        vector<unsigned> &bbox, vector<float> &centroid,
+                        const vector<char> &in, const af::dim4 &dims, af_connectivity conn)
+{
+    const bool is3D = (conn == AF_CONNECTIVITY_6 || conn == AF_CONNECTIVITY_26);
+    const int nd = is3D ? 3 : 2;
+    const int d[3] = {(int)dims[0], (int)dims[1], (int)dims[2]};
+
+    labels.assign(in.size(), 0);
+    area.clear(); bbox.clear(); centroid.clear();
+
+    unsigned next = 0;
+    int slice = -1;
+    for (size_t start = 0; start < in.size(); start++) {
+        int k0 = start / (d[0] * d[1]);
+        if (!is3D && k0 != slice) { slice = k0; next = 0; }
+        if (!in[start] || labels[start]) continue;
+
+        const unsigned l = ++next;
+        unsigned a = 0, lo[3], hi[3];
+        double sum[3] = {0, 0, 0};
+        vector<size_t> stack(1, start);
+        labels[start] = l;
+        while (!stack.empty()) {
+            size_t p = stack.back(); stack.pop_back();
+            int pos[3] = {(int)(p % d[0]), (int)((p / d[0]) % d[1]), (int)(p / (d[0] * d[1]))};
+            for (int q = 0; q < 3; q++) {
+                lo[q] = a ? std::min(lo[q], (unsigned)pos[q]) : pos[q];
+                hi[q] = a ? std::max(hi[q], (unsigned)pos[q]) : pos[q];
+                sum[q] += pos[q];
+            }
+            a++;
+            for (int dk = (is3D ? -1 : 0); dk <= (is3D ? 1 : 0); dk++)
+            for (int dj = -1; dj <= 1; dj++)
+            for (int di = -1; di <= 1; di++) {
+                int n = std::abs(di) + std::abs(dj) + std::abs(dk);
+                if (n == 0) continue;
+                if ((conn == AF_CONNECTIVITY_4 || conn == AF_CONNECTIVITY_6) && n > 1) continue;
+                int i = pos[0] + di, j = pos[1] + dj, k = pos[2] + dk;
+                if (i < 0 || i >= d[0] || j < 0 || j >= d[1] || k < 0 || k >= d[2]) continue;
+                size_t idx = ((size_t)k * d[1] + j) * d[0] + i;
+                if (in[idx] && !labels[idx]) { labels[idx] = l; stack.push_back(idx); }
+            }
+        }
+
+        area.push_back(a);
+        for (int q = 0; q < nd; q++) bbox.push_back(lo[q]);
+        for (int q = 0; q < nd; q++) bbox.push_back(hi[q]);
+        for (int q = 0; q < nd; q++) centroid.push_back(sum[q] / a);
+    }
+}
+
+static bool isRegionsSupported(af_connectivity conn)
+{
+    af_array out = 0;
+    af::array in = af::randu(8, 8) > 0.5;
+    return isSupported(af_regions(&out, in.get(), conn, f32), out);
+}
+
+static void regionsRandomTest(const af::dim4 &dims, af_connectivity conn, float density)
+{
+    if (!isRegionsSupported(conn)) return;
+
+    af::array in = af::randu(dims) < density;
+    vector<char> h_in(dims.elements());
+    in.host(&h_in.front());
+
+    vector<unsigned> gold, area, bbox;
+    vector<float> centroid;
+    regionsGold(gold, area, bbox, centroid, h_in, dims, conn);
+
+    vector<unsigned> out(dims.elements());
+    af::regions(in, conn, u32).host(&out.front());
+    for (size_t i = 0; i < out.size(); i++) {
+        ASSERT_EQ(gold[i], out[i]) << "at: " << i << std::endl;
+    }
+}
+
+TEST(Regions, Random_4)
+{
+    af::setNumThreads(4);
+    regionsRandomTest(af::dim4(700, 500), AF_CONNECTIVITY_4, 0.6f);
+    af::setNumThreads(0);
+}
+
+TEST(Regions, Random_8)
+{
+    af::setNumThreads(4);
+    regionsRandomTest(af::dim4(700, 500), AF_CONNECTIVITY_8, 0.45f);
+    af::setNumThreads(0);
+}
+
+#if defined(AF_CPU)
+// The other backends label a single image
+TEST(Regions, Batched_8)
+{
+    regionsRandomTest(af::dim4(300, 200, 3), AF_CONNECTIVITY_8, 0.45f);
+}
+#endif
+
+TEST(Regions, Volume_6)
+{
+    af::setNumThreads(4);
+    regionsRandomTest(af::dim4(60, 50, 40), AF_CONNECTIVITY_6, 0.35f);
+    af::setNumThreads(0);
+}
+
+TEST(Regions, Volume_26)
+{
+    af::setNumThreads(4);
+    regionsRandomTest(af::dim4(60, 50, 40), AF_CONNECTIVITY_26, 0.15f);
+    af::setNumThreads(0);
+}
+
+TEST(Regions, Stats)
+{
+    af_connectivity conns[] = {AF_CONNECTIVITY_8, AF_CONNECTIVITY_26};
+    af::dim4 dims[] = {af::dim4(300, 200), af::dim4(40, 30, 50)};
+
+    for (int t = 0; t < 2; t++) {
+        af_array a = 0, b = 0, c = 0, o = 0;
+        af::array in = af::randu(dims[t]) < 0.3;
+        af_err err = af_regions_stats(&o, &a, &b, &c, in.get(), conns[t], f32);
+        if (err == AF_ERR_NOT_SUPPORTED) return;
+        ASSERT_EQ(AF_SUCCESS, err);
+        af::array out(o), area(a), bbox(b), centroid(c);
+
+        vector<char> h_in(dims[t].elements());
+        in.host(&h_in.front());
+        vector<unsigned> gold, garea, gbbox;
+        vector<float> gcentroid;
+        regionsGold(gold, garea, gbbox, gcentroid, h_in, dims[t], conns[t]);
+
+        const size_t nlabels = garea.size();
+        const int nd = t == 0 ? 2 : 3;
+        ASSERT_EQ((dim_t)nlabels, area.dims(0));
+        ASSERT_EQ(2 * nd, bbox.dims(1));
+        ASSERT_EQ(nd, centroid.dims(1));
+
+        vector<unsigned> h_area(nlabels), h_bbox(nlabels * 2 * nd);
+        vector<float> h_centroid(nlabels * nd);
+        area.host(&h_area.front());
+        bbox.host(&h_bbox.front());
+        centroid.host(&h_centroid.front());
+
+        for (size_t l = 0; l < nlabels; l++) {
+            ASSERT_EQ(garea[l], h_area[l]) << "label " << l + 1;
+            for (int q = 0; q < 2 * nd; q++) {
+                ASSERT_EQ(gbbox[l * 2 * nd + q], h_bbox[q * nlabels + l]) << "label " << l + 1;
+            }
+            for (int q = 0; q < nd; q++) {
+                ASSERT_NEAR(gcentroid[l * nd + q], h_centroid[q * nlabels + l], 1e-3) << "label " << l + 1;
+            }
+        }
+    }
+}
@@ -13,6 +13,8 @@
 #include <af/traits.hpp>
 #include <af/array.h>
 #include <vector>
+#include <limits>
+#include <algorithm>
 #include <iostream>
 #include <string>
 #include <testHelpers.hpp>
@@ -164,3 +166,128 @@ TEST(Scan, CPP)
         delete[] outData;
     }
 }
+
+// Scans every dimension of in with op and compares them with a scan on the host
+template<typename T>
+static void scanOpTest(const af::dim4 &dims, af::binaryOp op, bool inclusive)
+{
+    vector<T> in(dims.elements());
+    for (size_t i = 0; i < in.size(); i++) in[i] = (T)(1 + (i * 7) % 5);
+
+    af::array input(dims, &in.front());
+
+    for (int d = 0; d < 4; d++) {
+        af_array out = 0;
+        af_err err = af_scan(&out, input.get(), d, op, inclusive);
+        if (err == AF_ERR_NOT_SUPPORTED) return;
+        ASSERT_EQ(AF_SUCCESS, err);
+
+        vector<T> outData(in.size());
+        ASSERT_EQ(AF_SUCCESS, af_get_data_ptr((void*)&outData.front(), out));
+        ASSERT_EQ(AF_SUCCESS, af_release_array(out));
+
+        dim_t stride = 1;
+        for (int i = 0; i < d; i++) stride *= dims[i];
+
+        for (size_t i = 0; i < in.size(); i++) {
+            const dim_t k = (i / stride) % dims[d];
+            T gold = op == AF_BINARY_MUL ? 1 : (T)in[i - k * stride];
+            if (op == AF_BINARY_ADD) gold = 0;
+            const dim_t last = inclusive ? k : k - 1;
+            for (dim_t j = 0; j <= last; j++) {
+                const T val = in[i - (k - j) * stride];
+                switch (op) {
+                case AF_BINARY_ADD: gold += val; break;
+                case AF_BINARY_MUL: gold *= val; break;
+                case AF_BINARY_MIN: gold = std::min(gold, val); break;
+                case AF_BINARY_MAX: gold = std::max(gold, val); break;
+                }
+            }
+            if (!inclusive && k == 0) {
+                gold = op == AF_BINARY_ADD ? 0 : op == AF_BINARY_MUL ? 1 :
+                    op == AF_BINARY_MIN ? std::numeric_limits<T>::max() : std::numeric_limits<T>::min();
+            }
+            ASSERT_EQ(gold, outData[i]) << "at: " << i << " for dim " << d;
+        }
+    }
+}
+
+TEST(Scan, Inclusive_Ops)
+{
+    scanOpTest<int>(af::dim4(33, 7, 5, 3), AF_BINARY_ADD, true);
+    scanOpTest<int>(af::dim4(33, 7, 5, 3), AF_BINARY_MIN, true);
+    scanOpTest<int>(af::dim4(33, 7, 5, 3), AF_BINARY_MAX, true);
+    scanOpTest<int>(af::dim4(5, 4, 3, 2), AF_BINARY_MUL, true);
+}
+
+TEST(Scan, Exclusive_Ops)
+{
+    scanOpTest<int>(af::dim4(33, 7, 5, 3), AF_BINARY_ADD, false);
+    scanOpTest<int>(af::dim4(33, 7, 5, 3), AF_BINARY_MIN, false);
+    scanOpTest<int>(af::dim4(33, 7, 5, 3), AF_BINARY_MAX, false);
+    scanOpTest<int>(af::dim4(5, 4, 3, 2), AF_BINARY_MUL, false);
+}
+
+// Long scans are split into chunks scanned by several threads
+TEST(Scan, Chunked)
+{
+    const int n = 1 << 20;
+    af::array in = af::round(10 * af::randu(n)) - 5;
+    in.eval();
+
+    vector<float> h_in(n);
+    in.host(&h_in.front());
+
+    af::setNumThreads(4);
+    af::array out = af::scan(in, 0, AF_BINARY_ADD, true);
+    vector<float> h_out(n);
+    out.host(&h_out.front());
+
+    float gold = 0;
+    for (int i = 0; i < n; i++) {
+        gold += h_in[i];
+        ASSERT_EQ(gold, h_out[i]) << "at: " << i;
+    }
+
+    af::array col = af::scan(af::moddims(in, 1, n), 1, AF_BINARY_ADD, true);
+    col.eval();
+    af::setNumThreads(0);
+    ASSERT_EQ(0, af::count<int>(col != af::moddims(out, 1, n)));
+}
+
+TEST(Scan, Chunked_Exclusive)
+{
+    const int n = 1 << 20;
+    af::array in = af::round(10 * af::randu(n)) - 5;
+
+    af_array out = 0;
+    af::setNumThreads(4);
+    af_err err = af_scan(&out, in.get(), 0, AF_BINARY_ADD, false);
+    af::setNumThreads(0);
+    if (err == AF_ERR_NOT_SUPPORTED) return;
+    ASSERT_EQ(AF_SUCCESS, err);
+
+    af::array inc = af::accum(in);
+    af::array exc(out);
+    ASSERT_EQ(0.0f, af::max<float>(af::abs(exc(af::seq(1, n - 1)) - inc(af::seq(0, n - 2)))));
+    ASSERT_EQ(0.0f, exc(0).scalar<float>());
+}
+
+// Empty arrays give empty results along every dimension
+TEST(Scan, EmptyInput)
+{
+    const af::dim4 shapes[] = {af::dim4(0, 5, 1, 1), af::dim4(5, 0, 1, 1), af::dim4(0, 5, 3, 1)};
+
+    for (int s = 0; s < 3; s++) {
+        af::array in(shapes[s], f32);
+        for (int d = 0; d < 3; d++) {
+            af_array out = 0;
+            ASSERT_EQ(AF_SUCCESS, af_scan(&out, in.get(), d, AF_BINARY_ADD, true));
+            af::array res(out);
+            ASSERT_EQ(0, (int)res.elements());
+            ASSERT_EQ(in.dims(), res.dims());
+
+            ASSERT_EQ(0, (int)af::accum(in, d).elements());
+        }
+    }
+}
@@ -13,6 +13,8 @@
 #include <af/traits.hpp>
 #include <af/algorithm.h>
 #include <vector>
+#include <algorithm>
+#include <cmath>
 #include <iostream>
 #include <string>
 #include <testHelpers.hpp>
@@ -161,3 +163,129 @@ SET_TESTS(double)
 SET_TESTS(int)
 SET_TESTS(uint)
 SET_TESTS(uchar)
+
+// Large inputs with few distinct values take the hashed path
+TEST(Set, Unique_Hashed)
+{
+    const int n = 1 << 16;
+    af::array in = af::floor(af::randu(n) * 1000).as(s32);
+
+    vector<int> h_in(n);
+    in.host(&h_in.front());
+    std::sort(h_in.begin(), h_in.end());
+    h_in.erase(std::unique(h_in.begin(), h_in.end()), h_in.end());
+
+    af::array out = af::setUnique(in);
+    ASSERT_EQ((dim_t)h_in.size(), out.elements());
+
+    vector<int> h_out(h_in.size());
+    out.host(&h_out.front());
+    for (size_t i = 0; i < h_in.size(); i++) {
+        ASSERT_EQ(h_in[i], h_out[i]) << "at: " << i;
+    }
+
+    af::array other = af::floor(af::randu(n) * 2000).as(s32);
+    af::array both  = af::setUnique(af::join(0, in, other));
+    ASSERT_EQ(0, af::count<int>(af::setUnion(in, other) != both));
+
+    af::array common = af::setIntersect(in, other);
+    ASSERT_EQ(0, af::count<int>(common != af::setIntersect(af::setUnique(in),
+                                                           af::setUnique(other), true)));
+}
+
+#if defined(AF_CPU)
+// All the NaNs are one value, placed after the others
+TEST(Set, Unique_Hashed_NaN)
+{
+    const int n = 1 << 14;
+    vector<float> h_in(n);
+    af::array in = af::floor(af::randu(n) * 100);
+    in.host(&h_in.front());
+    for (int i = 0; i < n; i += 97) h_in[i] = af::NaN;
+    in = af::array(n, &h_in.front());
+
+    vector<float> gold;
+    for (int i = 0; i < n; i++) if (!std::isnan(h_in[i])) gold.push_back(h_in[i]);
+    std::sort(gold.begin(), gold.end());
+    gold.erase(std::unique(gold.begin(), gold.end()), gold.end());
+
+    af::array out = af::setUnique(in);
+    ASSERT_EQ((dim_t)gold.size() + 1, out.elements());
+
+    vector<float> h_out(out.elements());
+    out.host(&h_out.front());
+    for (size_t i = 0; i < gold.size(); i++) {
+        ASSERT_EQ(gold[i], h_out[i]) << "at: " << i;
+    }
+    ASSERT_TRUE(std::isnan(h_out.back()));
+
+    af::array values, idx;
+    af::setUnique(values, idx, in, false);
+    ASSERT_EQ(out.elements(), values.elements());
+    ASSERT_EQ(0, af::count<int>(values(af::seq(0, gold.size() - 1)) !=
+                                out(af::seq(0, gold.size() - 1))));
+    // The first NaN is the first value
+    ASSERT_EQ(0u, idx(af::end).scalar<uint>());
+}
+#endif
+
+TEST(Set, Unique_Index)
+{
+    float h_in[] = {3, 1, 3, 2, 1, 5, 2};
+    af::array in(7, h_in);
+
+    af::array values, idx;
+    try {
+        af::setUnique(values, idx, in, true);
+    } catch (af::exception &e) {
+        if (e.err() == AF_ERR_NOT_SUPPORTED) return;
+        throw;
+    }
+
+    float gold_vals[] = {3, 1, 2, 5};
+    uint  gold_idx[]  = {0, 1, 3, 5};
+    ASSERT_EQ(4, values.elements());
+
+    vector<float> h_vals(4);
+    vector<uint>  h_idx(4);
+    values.host(&h_vals.front());
+    idx.host(&h_idx.front());
+    for (int i = 0; i < 4; i++) {
+        ASSERT_EQ(gold_vals[i], h_vals[i]);
+        ASSERT_EQ(gold_idx[i], h_idx[i]);
+    }
+
+    af::setUnique(values, idx, in, false);
+    ASSERT_EQ(0, af::count<int>(values != af::setUnique(in)));
+    ASSERT_EQ(0, af::count<int>(in(idx) != values));
+}
+
+TEST(Set, Union_Intersect_Index)
+{
+    af::array first  = af::floor(af::randu(5000) * 300).as(s32);
+    af::array second = af::floor(af::randu(3000) * 500).as(s32);
+
+    af::array values, idx;
+    try {
+        af::setUnion(values, idx, first, second);
+    } catch (af::exception &e) {
+        if (e.err() == AF_ERR_NOT_SUPPORTED) return;
+        throw;
+    }
+
+    ASSERT_EQ(0, af::count<int>(values != af::setUnion(first, second)));
+    ASSERT_EQ(0, af::count<int>(af::join(0, first, second)(idx) != values));
+
+    af::array fidx, sidx;
+    af::setIntersect(values, fidx, sidx, first, second, true);
+    ASSERT_EQ(0, af::count<int>(af::sort(values) != af::setIntersect(first, second)));
+    ASSERT_EQ(0, af::count<int>(first(fidx) != values));
+    ASSERT_EQ(0, af::count<int>(second(sidx) != values));
+
+    // Values in the order of their first occurrence in first
+    vector<uint> h_fidx(fidx.elements());
+    fidx.host(&h_fidx.front());
+    for (size_t i = 1; i < h_fidx.size(); i++) {
+        ASSERT_LT(h_fidx[i - 1], h_fidx[i]);
+    }
+}
@@ -117,6 +117,126 @@ void solveTriangleTester(const int n, const int k, bool is_upper, double eps)
     ASSERT_NEAR(0, af::sum<double>(af::abs(imag(B0 - B1))) / (n * k), eps);
 }
 
+template<typename T>
+void solveBatchTester(const int m, const int n, const int k, const af::dim4 batch,
+                      const af_mat_prop options, double eps)
+{
+    if (noDoubleTests<T>()) return;
+
+    const int b2 = batch[2];
+    const int b3 = batch[3];
+
+    af::array A  = cpu_randu<T>(af::dim4(m, n, b2, b3));
+    af::array X0 = cpu_randu<T>(af::dim4(n, k, b2, b3));
+    af::dtype ty = (af::dtype)af::dtype_traits<T>::af_type;
+    af::array D = 2 * n * af::identity(af::dim4(m, n, b2, b3), ty);
+    if (options & AF_MAT_UPPER) A = af::upper(A) + D;
+    if (options & AF_MAT_LOWER) A = af::lower(A) + D;
+
+    af::array B0 = af::constant(0, m, k, b2, b3, ty);
+    for (int w = 0; w < b3; w++) {
+        for (int z = 0; z < b2; z++) {
+            af::array Ai = A(af::span, af::span, z, w);
+            af::array Xi = X0(af::span, af::span, z, w);
+            B0(af::span, af::span, z, w) = af::matmul(Ai, Xi);
+        }
+    }
+
+    af_array out = 0;
+    af_err err = af_solve(&out, A.get(), B0.get(), options);
+    // Stacks of matrices are only solved by the CPU backend
+    if (err == AF_ERR_BATCH) return;
+    ASSERT_EQ(AF_SUCCESS, err);
+
+    af::array X1(out);
+    ASSERT_EQ(af::dim4(n, k, b2, b3), X1.dims());
+
+    for (int w = 0; w < b3; w++) {
+        for (int z = 0; z < b2; z++) {
+            af::array Ai = A(af::span, af::span, z, w);
+            af::array Xi = X1(af::span, af::span, z, w);
+            af::array B1 = af::matmul(Ai, Xi);
+            af::array B0i = B0(af::span, af::span, z, w);
+
+            ASSERT_NEAR(0, af::sum<double>(af::abs(real(B0i - B1))) / (m * k), eps);
+            ASSERT_NEAR(0, af::sum<double>(af::abs(imag(B0i - B1))) / (m * k), eps);
+        }
+    }
+}
+
+#define SOLVE_BATCH_TESTS(T, eps)                                               \
+    TEST(SOLVE_Batch, T##Small)                                                 \
+    {                                                                           \
+        solveBatchTester<T>(6, 6, 2, af::dim4(1, 1, 50, 2), AF_MAT_NONE, eps);  \
+    }                                                                           \
+    TEST(SOLVE_Batch, T##Square)                                                \
+    {                                                                           \
+        solveBatchTester<T>(40, 40, 5, af::dim4(1, 1, 4), AF_MAT_NONE, eps);    \
+    }                                                                           \
+    TEST(SOLVE_Batch, T##RectOver)                                              \
+    {                                                                           \
+        solveBatchTester<T>(50, 30, 3, af::dim4(1, 1, 3), AF_MAT_NONE, eps);    \
+    }                                                                           \
+    TEST(SOLVE_Batch, T##RectUnder)                                             \
+    {                                                                           \
+        solveBatchTester<T>(30, 50, 3, af::dim4(1, 1, 3), AF_MAT_NONE, eps);    \
+    }                                                                           \
+    TEST(SOLVE_Batch, T##Upper)                                                 \
+    {                                                                           \
+        solveBatchTester<T>(20, 20, 4, af::dim4(1, 1, 3, 2), AF_MAT_UPPER, eps); \
+    }                                                                           \
+    TEST(SOLVE_Batch, T##Lower)                                                 \
+    {                                                                           \
+        solveBatchTester<T>(6, 6, 4, af::dim4(1, 1, 7), AF_MAT_LOWER, eps);     \
+    }
+
+SOLVE_BATCH_TESTS(float, 0.01)
+SOLVE_BATCH_TESTS(double, 1E-5)
+SOLVE_BATCH_TESTS(cfloat, 0.01)
+SOLVE_BATCH_TESTS(cdouble, 1E-5)
+
+#undef SOLVE_BATCH_TESTS
+
+#if defined(AF_CPU)
+// The second matrix of the stack has a zero column. Its solution is NaN,
+// the others are solved as usual.
+template<typename T>
+void solveSingularTester(const int n, double eps)
+{
+    if (noDoubleTests<T>()) return;
+
+    af::dtype ty = (af::dtype)af::dtype_traits<T>::af_type;
+    af::array A = cpu_randu<T>(af::dim4(n, n, 3)) + n * af::identity(af::dim4(n, n, 3), ty);
+    A(af::span, 1, 1) = 0;
+    af::array B = cpu_randu<T>(af::dim4(n, 2, 3));
+
+    af::array X = af::solve(A, B);
+
+    af::array singular = X(af::span, af::span, 1);
+    ASSERT_TRUE(af::allTrue<bool>(af::isNaN(real(singular))));
+
+    for (int i = 0; i < 3; i += 2) {
+        af::array Bi = af::matmul(A(af::span, af::span, i), X(af::span, af::span, i));
+        ASSERT_NEAR(0, af::max<double>(af::abs(real(Bi - B(af::span, af::span, i)))), eps);
+    }
+}
+
+#define SOLVE_SINGULAR_TESTS(T, eps)            \
+    TEST(SOLVE_Batch, T##SingularSmall)         \
+    {                                           \
+        solveSingularTester<T>(5, eps);         \
+    }                                           \
+    TEST(SOLVE_Batch, T##Singular)              \
+    {                                           \
+        solveSingularTester<T>(30, eps);        \
+    }
+
+SOLVE_SINGULAR_TESTS(float, 0.01)
+SOLVE_SINGULAR_TESTS(cdouble, 1E-5)
+
+#undef SOLVE_SINGULAR_TESTS
+#endif
+
 #define SOLVE_TESTS(T, eps)                             \
     TEST(SOLVE_LU, T##Reg)                              \
     {                                                   \
@@ -147,3 +147,44 @@ TEST(Sort, CPP)
     delete[] sxData;
 }
 
+
+template<typename T>
+void sortDimTest(const unsigned dim, const bool dir)
+{
+    if (noDoubleTests<T>()) return;
+
+    af::dtype ty = (af::dtype)af::dtype_traits<T>::af_type;
+    af::array a = (af::randu(500, 6, 5, 4) * 100).as(ty);
+
+    af_array out = 0;
+    af_err err = af_sort(&out, a.get(), dim, dir);
+    // Only the CPU backend sorts along dimensions other than 0
+    if (err == AF_ERR_NOT_SUPPORTED) return;
+    ASSERT_EQ(AF_SUCCESS, err);
+    af::array b(out);
+
+    // Swap dim with 0, sort along 0 and swap back
+    unsigned order[4] = {0, 1, 2, 3};
+    std::swap(order[0], order[dim]);
+
+    af::array gold = af::sort(af::reorder(a, order[0], order[1], order[2], order[3]), 0, dir);
+    gold = af::reorder(gold, order[0], order[1], order[2], order[3]);
+
+    ASSERT_EQ(gold.elements(), b.elements());
+
+    T *h_gold = gold.host<T>();
+    T *h_b = b.host<T>();
+    for (int i = 0; i < (int)b.elements(); i++) {
+        ASSERT_EQ(h_gold[i], h_b[i]) << "at: " << i << std::endl;
+    }
+    delete[] h_gold;
+    delete[] h_b;
+}
+
+TYPED_TEST(Sort, Dims)
+{
+    for (unsigned dim = 1; dim < 4; dim++) {
+        sortDimTest<TypeParam>(dim, true);
+        sortDimTest<TypeParam>(dim, false);
+    }
+}
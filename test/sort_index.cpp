@@ -171,3 +171,32 @@ TEST(SortIndex, CPP)
     delete[] sxData;
     delete[] ixData;
 }
+
+TYPED_TEST(Sort, Dims)
+{
+    if (noDoubleTests<TypeParam>()) return;
+
+    af::dtype ty = (af::dtype)af::dtype_traits<TypeParam>::af_type;
+    af::array a = (af::randu(300, 7, 4, 3) * 100).as(ty);
+
+    for (unsigned dim = 1; dim < 4; dim++) {
+        af_array val = 0, idx = 0;
+        af_err err = af_sort_index(&val, &idx, a.get(), dim, true);
+        // Only the CPU backend sorts along dimensions other than 0
+        if (err == AF_ERR_NOT_SUPPORTED) return;
+        ASSERT_EQ(AF_SUCCESS, err);
+
+        af::array v(val), i(idx);
+
+        // Sorting is stable, so the indices match those along dimension 0
+        unsigned order[4] = {0, 1, 2, 3};
+        std::swap(order[0], order[dim]);
+        af::array gv, gi;
+        af::sort(gv, gi, af::reorder(a, order[0], order[1], order[2], order[3]), 0, true);
+        gv = af::reorder(gv, order[0], order[1], order[2], order[3]);
+        gi = af::reorder(gi, order[0], order[1], order[2], order[3]);
+
+        ASSERT_EQ(0, af::count<int>(gv != v)) << "dim: " << dim << std::endl;
+        ASSERT_EQ(0, af::count<int>(gi != i)) << "dim: " << dim << std::endl;
+    }
+}
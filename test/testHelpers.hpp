@@ -409,6 +409,15 @@ bool noDoubleTests()
     return ((isTypeDouble && !isDoubleSupported) ? true : false);
 }
 
+// Features that only some backends implement report AF_ERR_NOT_SUPPORTED on
+// the others. err is the result of a call probing the feature, and out the
+// array it made, which is released.
+inline bool isSupported(const af_err err, af_array &out)
+{
+    if (err == AF_SUCCESS && out != 0) af_release_array(out);
+    return err != AF_ERR_NOT_SUPPORTED;
+}
+
 // TODO: perform conversion on device for CUDA and OpenCL
 template<typename T>
 af_err conv_image(af_array *out, af_array in)
@@ -148,3 +148,61 @@ TEST(Tile, CPP)
     delete[] outData;
 }
 
+TEST(Tile, JIT_Expression)
+{
+    const int nx = 300, ny = 7, nz = 2;
+    af::array a = af::randu(nx, ny, nz);
+    af::array b = af::randu(nx, ny, nz);
+
+    // Tiles of an unevaluated expression along every dimension
+    af::array out = af::tile(a * b + 1, 2, 3, 2, 2);
+    ASSERT_EQ(af::dim4(2 * nx, 3 * ny, 2 * nz, 2), out.dims());
+
+    vector<float> h_a(a.elements()), h_b(b.elements()), h_out(out.elements());
+    a.host(&h_a.front());
+    b.host(&h_b.front());
+    out.host(&h_out.front());
+
+    af::dim4 odims = out.dims();
+    for (int w = 0; w < odims[3]; w++) {
+        for (int z = 0; z < odims[2]; z++) {
+            for (int y = 0; y < odims[1]; y++) {
+                for (int x = 0; x < odims[0]; x++) {
+                    int i = x % nx + (y % ny) * nx + (z % nz) * nx * ny;
+                    int o = x + odims[0] * (y + odims[1] * (z + odims[2] * w));
+                    ASSERT_FLOAT_EQ(h_a[i] * h_b[i] + 1, h_out[o]);
+                }
+            }
+        }
+    }
+}
+
+TEST(Tile, Broadcast)
+{
+    const int nx = 1000, ny = 50;
+    af::array x = af::randu(nx, ny);
+
+    // Normalization, with the mean broadcast along the rows and columns
+    af::array cols = af::tile(af::mean(x, 0), nx) - x;
+    af::array rows = x - af::tile(af::mean(x, 1), 1, ny);
+
+    vector<float> h_x(x.elements()), h_cols(x.elements()), h_rows(x.elements());
+    x.host(&h_x.front());
+    cols.host(&h_cols.front());
+    rows.host(&h_rows.front());
+
+    vector<double> cmean(ny, 0), rmean(nx, 0);
+    for (int j = 0; j < ny; j++) {
+        for (int i = 0; i < nx; i++) {
+            cmean[j] += h_x[j * nx + i] / nx;
+            rmean[i] += h_x[j * nx + i] / ny;
+        }
+    }
+
+    for (int j = 0; j < ny; j++) {
+        for (int i = 0; i < nx; i++) {
+            ASSERT_NEAR(cmean[j] - h_x[j * nx + i], h_cols[j * nx + i], 1e-5);
+            ASSERT_NEAR(h_x[j * nx + i] - rmean[i], h_rows[j * nx + i], 1e-5);
+        }
+    }
+}
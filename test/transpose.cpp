@@ -242,3 +242,35 @@ TEST(Transpose, GFOR)
         ASSERT_EQ(max<double>(abs(c_ii - b_ii)) < 1E-5, true);
     }
 }
+
+TEST(Transpose, LargeBatch)
+{
+    using namespace af;
+    // Not a multiple of the tile size along either dimension
+    const int M = 1000, N = 37, B = 3;
+    array A = randu(M, N, B);
+    array T = transpose(A);
+
+    vector<float> in(M * N * B), out(M * N * B);
+    A.host(&in.front());
+    T.host(&out.front());
+
+    ASSERT_EQ(dim4(N, M, B), T.dims());
+    for (int b = 0; b < B; b++) {
+        for (int j = 0; j < N; j++) {
+            for (int i = 0; i < M; i++) {
+                ASSERT_EQ(in[b * M * N + j * M + i], out[b * M * N + i * N + j])
+                    << "at: " << i << ", " << j << ", " << b << std::endl;
+            }
+        }
+    }
+}
+
+TEST(Transpose, Empty)
+{
+    using namespace af;
+    array A(5, 0);
+    array B(0, 5);
+    ASSERT_EQ(dim4(0, 5, 1, 1), transpose(A).dims());
+    ASSERT_EQ(dim4(5, 0, 1, 1), transpose(B).dims());
+}
@@ -105,3 +105,28 @@ void transposeInPlaceCPPTest()
     // cleanup
     delete[] outData;
 }
+
+TEST(Transpose, InPlaceConjugate)
+{
+    using namespace af;
+    array input = randu(100, 100, c32);
+    array output = transpose(input, true);
+    transposeInPlace(input, true);
+
+    vector<cfloat> outData(output.elements()), trsData(input.elements());
+    output.host(&outData.front());
+    input.host(&trsData.front());
+
+    // The diagonal is conjugated as well
+    for (int elIter = 0; elIter < (int)outData.size(); ++elIter) {
+        ASSERT_EQ(outData[elIter], trsData[elIter]) << "at: " << elIter << std::endl;
+    }
+}
+
+TEST(Transpose, InPlaceEmpty)
+{
+    using namespace af;
+    array input(0, 0);
+    transposeInPlace(input);
+    ASSERT_EQ(0, (int)input.elements());
+}
@@ -132,3 +132,60 @@ TYPED_TEST(Where, CPP)
                                                         << std::endl;
     }
 }
+
+// Sparse mask over a few chunks, compared with a compaction on the host
+static void whereLargeTest(const af::array &in)
+{
+    vector<float> h_in(in.elements());
+    in.host(&h_in.front());
+
+    af::array out = af::where(in);
+    ASSERT_EQ(u32, out.type());
+
+    vector<uint> gold;
+    for (size_t i = 0; i < h_in.size(); i++) {
+        if (h_in[i] != 0) gold.push_back(i);
+    }
+    ASSERT_EQ((dim_t)gold.size(), out.elements());
+    if (gold.empty()) return;
+
+    vector<uint> h_out(gold.size());
+    out.host(&h_out.front());
+    for (size_t i = 0; i < gold.size(); i++) {
+        ASSERT_EQ(gold[i], h_out[i]) << "at: " << i;
+    }
+}
+
+TEST(Where, LargeThreads)
+{
+    af::setNumThreads(4);
+    whereLargeTest(af::floor(af::randu(1 << 20) + 0.01f));
+    whereLargeTest(af::constant(0, 1 << 20));
+    whereLargeTest(af::constant(1, 1 << 20));
+    af::setNumThreads(0);
+}
+
+TEST(Where, LargeSubArray)
+{
+    af::array in = af::floor(af::randu(1000, 1000) + 0.1f);
+    af::setNumThreads(4);
+    whereLargeTest(in(af::seq(1, 998), af::seq(0, 999, 2)));
+    af::setNumThreads(0);
+}
+
+TYPED_TEST(Where, Values)
+{
+    if (noDoubleTests<TypeParam>()) return;
+
+    af::array in = af::floor(af::randu(500, 300) * 3);
+    in = in.as((af_dtype)af::dtype_traits<TypeParam>::af_type);
+
+    af_array idx = 0, vals = 0;
+    af_err err = af_where_values(&idx, &vals, in.get());
+    if (err == AF_ERR_NOT_SUPPORTED) return;
+    ASSERT_EQ(AF_SUCCESS, err);
+
+    af::array i(idx), v(vals);
+    ASSERT_EQ(0, af::count<int>(i != af::where(in)));
+    ASSERT_EQ(0, af::count<int>(v != in(i)));
+}